@@ -1,5 +1,6 @@
+#define BESSELJZEROS_TABLE
 #include "BesselJZeros.h"
-#include "NR.h"
+#include "NR.H"
 
 //---------------------------------------------------------------------------
 // BesselJIndex
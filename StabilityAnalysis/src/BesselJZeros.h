@@ -10,6 +10,9 @@
 #define BESSELJZEROS_H
 
 
+// The table is defined only in BesselJZeros.c, which defines
+// BESSELJZEROS_TABLE before including this file.
+#ifdef BESSELJZEROS_TABLE
 float BesselJZerosLookUp[54][4] = \
 {{ 0 , 0 , 1 , 2.405 },
 { 1 , 0 , 2 , 5.52 },
@@ -65,6 +68,9 @@ float BesselJZerosLookUp[54][4] = \
 { 51 , 5 , 7 , 28.628 },
 { 52 , 5 , 8 , 31.813 },
 { 53 , 5 , 9 , 34.983 }};
+#else
+extern float BesselJZerosLookUp[54][4];
+#endif
 
 float BesselJZero(int inJ);
 int BesselJIndex(int inV, int inN);
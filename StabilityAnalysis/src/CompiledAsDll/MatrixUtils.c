@@ -271,45 +271,174 @@ void LogDMatrix(double **inMatrix,
 
 
 //---------------------------------------------------------------------------
-// CopyFVectorToMatrixRow
+// Matrix and vector operations
 //
-// writes an FVector to a specified row of a Matrix
+// Each operation is written once, as a macro over the element type, and
+// instantiated below for float (F) and double (D) elements, so that the
+// float and double versions cannot drift apart.  See the Omega names in
+// MatrixUtils.h for the version used by the Omega calculation.
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+// CopyVectorToMatrixRow, CopyVectorToMatrixCol
+//
+// writes a vector to a specified row (column) of a Matrix
 //
 //---------------------------------------------------------------------------
-CopyFVectorToMatrixRow(float *inVector, \
-                    int inRL, \
-                    int inRH, \
-                    float **inMatrix, \
-                    int inRow)
-{
+#define DEFINE_COPY_VECTOR_TO_MATRIX_ROW(inName,inType) \
+void inName(inType *inVector, \
+            int inRL, \
+            int inRH, \
+            inType **inMatrix, \
+            int inRow) \
+{ \
+   int i; \
+ \
+   for(i=inRL;i<=inRH;i++) \
+   { \
+        inMatrix[inRow][i]=inVector[i]; \
+   } \
+}
 
-   int i;
+#define DEFINE_COPY_VECTOR_TO_MATRIX_COL(inName,inType) \
+void inName(inType *inVector, \
+            int inRL, \
+            int inRH, \
+            inType **inMatrix, \
+            int inCol) \
+{ \
+   int i; \
+ \
+   for(i=inRL;i<=inRH;i++) \
+   { \
+        inMatrix[i][inCol]=inVector[i]; \
+   } \
+}
 
-   for(i=inRL;i<=inRH;i++)
-   {
-        inMatrix[inRow][i]=inVector[i];
-   }
 
+#define DEFINE_COPY_MATRIX(inName,inType) \
+void inName(inType **inSource, inType **outTarget, \
+            int inRL, \
+            int inRH, \
+            int inCL, \
+            int inCH) \
+{ \
+   int i,j; \
+ \
+   for(i=inRL;i<=inRH;i++) \
+   { \
+        for(j=inCL;j<=inCH;j++) \
+        { \
+             outTarget[i][j]=inSource[i][j]; \
+        } \
+   } \
 }
 
 
-CopyFVectorToMatrixCol(float *inVector, \
-                    int inRL, \
-                    int inRH, \
-                    float **inMatrix, \
-                    int inCol)
-{
+#define DEFINE_TRANSPOSE_MATRIX(inName,inType) \
+void inName(inType **inSource, inType **outTarget, \
+            int inRL, \
+            int inRH, \
+            int inCL, \
+            int inCH) \
+{ \
+   int i,j; \
+ \
+   for(i=inRL;i<=inRH;i++) \
+   { \
+        for(j=inCL;j<=inCH;j++) \
+        { \
+             outTarget[j][i]=inSource[i][j]; \
+        } \
+   } \
+}
 
-   int i;
 
-   for(i=inRL;i<=inRH;i++)
-   {
-        inMatrix[i][inCol]=inVector[i];
-   }
+#define DEFINE_MULTIPLY_MATRIX(inName,inType) \
+void inName(inType **inA, inType **inB, inType **outResult, \
+            int inRLA, int inRHA, int inCLA, int inCHA, \
+            int inRLB, int inRHB, int inCLB, int inCHB) \
+{ \
+   int i,j,k; \
+ \
+   if ((inCHA-inCLA) != (inRHB-inRLB)) \
+        nrerror("Error in " #inName ":  Incompatible matrices"); \
+ \
+   for(i=inRLA;i<=inRHA;i++) \
+   { \
+        for(j=inCLB;j<=inCHB;j++) \
+        { \
+           outResult[i][j]=0; \
+           for (k=inCLA;k<=inCHA;k++) \
+           { \
+             outResult[i][j]+=inA[i][k]*inB[k][j]; \
+           } \
+        } \
+   } \
+}
 
+
+//---------------------------------------------------------------------------
+// DiagonalizeMatrix
+//
+// Diagonalize a real, symmetric matrix of dimension [1...inDim] by
+// computing the eigenvalues and eigenvectors.
+//
+// Input matrix is destroyed by this routine.
+//
+// Eigenvalues are stored in the output array, NOT sorted; the
+// corresponding Eigenvectors are stored in the columns of an output
+// matrix.  Output arrays must be allocated to the proper dimension prior
+// to calling this routine, arrays are addressed using NR convention
+// [1...N].
+//
+// This procedure uses QL reduction (tred2/tqli, or their double
+// precision versions dtred2/dtqli) to compute the eigenvalues/
+// eigenvectors.
+//
+// plk 3/10/2005
+//---------------------------------------------------------------------------
+#define DEFINE_DIAGONALIZE_MATRIX(inName,inType,inVector,inFreeVector, \
+                                  inTred2,inTqli,inCopyMatrix) \
+void inName(inType **inMatrix, \
+            int inDim, \
+            inType *outEigenValue, \
+            inType **outEigenVector) \
+{ \
+   inType *theE; \
+ \
+   theE = inVector(1,inDim); \
+   inTred2(inMatrix, inDim, outEigenValue, theE); \
+   inTqli(outEigenValue,theE,inDim,inMatrix); \
+   inFreeVector(theE,1,inDim); \
+   inCopyMatrix(inMatrix,outEigenVector,\
+                1,inDim,\
+                1,inDim); \
 }
 
 
+DEFINE_COPY_VECTOR_TO_MATRIX_ROW(CopyFVectorToMatrixRow,float)
+DEFINE_COPY_VECTOR_TO_MATRIX_ROW(CopyDVectorToMatrixRow,double)
+
+DEFINE_COPY_VECTOR_TO_MATRIX_COL(CopyFVectorToMatrixCol,float)
+DEFINE_COPY_VECTOR_TO_MATRIX_COL(CopyDVectorToMatrixCol,double)
+
+DEFINE_COPY_MATRIX(CopyFMatrix,float)
+DEFINE_COPY_MATRIX(CopyDMatrix,double)
+
+DEFINE_TRANSPOSE_MATRIX(TransposeFMatrix,float)
+DEFINE_TRANSPOSE_MATRIX(TransposeDMatrix,double)
+
+DEFINE_MULTIPLY_MATRIX(MultiplyFMatrix,float)
+DEFINE_MULTIPLY_MATRIX(MultiplyDMatrix,double)
+
+DEFINE_DIAGONALIZE_MATRIX(DiagonalizeFMatrix,float,vector,free_vector, \
+                          tred2,tqli,CopyFMatrix)
+DEFINE_DIAGONALIZE_MATRIX(DiagonalizeDMatrix,double,dvector,free_dvector, \
+                          dtred2,dtqli,CopyDMatrix)
+
+
 void PrintFMatrix(float **inMatrix,
                   int inRL,
                   int inRH,
@@ -358,125 +487,6 @@ void PrintDMatrix(double **inMatrix,
 }
 
 
-void CopyFMatrix(float **inSource, float **outTarget, \
-                  int inRL,
-                  int inRH,
-                  int inCL,
-                  int inCH)
-{
-
-   int i,j;
-
-   for(i=inRL;i<=inRH;i++)
-   {
-        for(j=inCL;j<=inCH;j++)
-        {
-             outTarget[i][j]=inSource[i][j];
-        }
-   }
-
-}
-
-
-void TransposeFMatrix(float **inSource, float **outTarget, \
-                  int inRL,
-                  int inRH,
-                  int inCL,
-                  int inCH)
-{
-
-   int i,j;
-
-   for(i=inRL;i<=inRH;i++)
-   {
-        for(j=inCL;j<=inCH;j++)
-        {
-             outTarget[j][i]=inSource[i][j];
-        }
-   }
-
-}
-
-
-void MultiplyFMatrix(float **inA, float **inB, float **outResult, \
-                  int inRLA, int inRHA, int inCLA, int inCHA, \
-                  int inRLB, int inRHB, int inCLB, int inCHB)
-{
-
-   int i,j,k;
-
-   if ((inCHA-inCLA) != (inRHB-inRLB))
-        nrerror("Error in MultiplyFMatrix:  Incompatible matrices");
-
-   for(i=inRLA;i<=inRHA;i++)
-   {
-        for(j=inCLB;j<=inCHB;j++)
-        {
-           outResult[i][j]=0;
-           for (k=inCLA;k<=inCHA;k++)
-           {
-             outResult[i][j]+=inA[i][k]*inB[k][j];
-           }
-        }
-   }
-
-}
-
-
-
-//---------------------------------------------------------------------------
-// DiagonalizeMatrix
-//
-// Diagonalize a real, symmetric matrix of dimension [1...inDim] by
-// computing the eigenvalues and eigenvectors.
-//
-// Input matrix is destroyed by this routine.
-//
-// Eigenvalues are sorted in descending order, and stored in output
-// array; corresponding Eigenvectors are stored in an output matrix.
-// Output arrays must be allocated to the proper dimension prior to
-// calling this routine, arrays are addressed using NR convention
-// [1...N].
-//
-// This procedure uses either Jacobi rotation or QL reduction to
-// compute the eigenvalues/eigenvectors.  Comment out the appropriate
-// section of code for the un-favored algorithm.
-//
-// plk 3/10/2005
-//---------------------------------------------------------------------------
-void DiagonalizeFMatrix(float **inMatrix, \
-                       int inDim, \
-                       float *outEigenValue, \
-                       float **outEigenVector)
-{
-   int nrot;
-   float *theE;
-
-
-
-   //-----------------------------------------------------------
-   // Jacobi rotation algorithm
-   //
-   //jacobi(inMatrix,inDim,outEigenValue,outEigenVector,&nrot);
-   //eigsrt(outEigenValue,outEigenVector,inDim);
-   //-----------------------------------------------------------
-
-
-   //-----------------------------------------------------------
-   // QL reduction algorithm
-   //
-   theE = vector(1,inDim);
-   tred2(inMatrix, inDim, outEigenValue, theE);
-   tqli(outEigenValue,theE,inDim,inMatrix);
-   CopyFMatrix(inMatrix,outEigenVector,\
-                1,inDim,\
-                1,inDim);
-   //----------------------------------------------------------
-
-
-}
-
-
 void PrintFVector(float *inVector, int inRL, int inRH)
 {
 
@@ -573,4 +583,4 @@ void SaveDMatrix(double **inMatrix,\
 }
 
 
- 
\ No newline at end of file
+ 
\ No newline at end of file
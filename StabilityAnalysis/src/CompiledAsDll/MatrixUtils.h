@@ -7,6 +7,54 @@
 #define MATRIXUTILS_H
 
 
+//---------------------------------------------------------------------------
+// Scalar type of the Omega matrix, its eigenvalues and eigenvectors.
+//
+// The Omega calculation is carried in single precision by default.  Define
+// OMEGA_DOUBLE at build time (e.g. -DOMEGA_DOUBLE) to carry Omega, its
+// eigenvalues and eigenvectors in double precision throughout, which
+// preserves the small eigenvalues that decide stability.  The Omega names
+// below select the F (float) or D (double) version of each utility.
+//---------------------------------------------------------------------------
+#ifdef OMEGA_DOUBLE
+
+typedef double OmegaScalar;
+
+#define omega_matrix                 dmatrix
+#define omega_vector                 dvector
+#define free_omega_matrix            free_dmatrix
+#define free_omega_vector            free_dvector
+
+#define LogOmegaMatrix               LogDMatrix
+#define LogOmegaVector               LogDVector
+#define CopyOmegaVectorToMatrixRow   CopyDVectorToMatrixRow
+#define CopyOmegaVectorToMatrixCol   CopyDVectorToMatrixCol
+#define CopyOmegaMatrix              CopyDMatrix
+#define TransposeOmegaMatrix         TransposeDMatrix
+#define MultiplyOmegaMatrix          MultiplyDMatrix
+#define DiagonalizeOmegaMatrix       DiagonalizeDMatrix
+
+#else
+
+typedef float OmegaScalar;
+
+#define omega_matrix                 matrix
+#define omega_vector                 vector
+#define free_omega_matrix            free_matrix
+#define free_omega_vector            free_vector
+
+#define LogOmegaMatrix               LogFMatrix
+#define LogOmegaVector               LogFVector
+#define CopyOmegaVectorToMatrixRow   CopyFVectorToMatrixRow
+#define CopyOmegaVectorToMatrixCol   CopyFVectorToMatrixCol
+#define CopyOmegaMatrix              CopyFMatrix
+#define TransposeOmegaMatrix         TransposeFMatrix
+#define MultiplyOmegaMatrix          MultiplyFMatrix
+#define DiagonalizeOmegaMatrix       DiagonalizeFMatrix
+
+#endif
+
+
 void OpenLogFile();
 void LogMessage(char *inMessage);
 void LogSimParams();
@@ -38,16 +86,26 @@ void LogDVector(double *inVector,
                 int inRH,
                 char *inMessage);
 
-CopyFVectorToMatrixRow(float *inVector, \
+void CopyFVectorToMatrixRow(float *inVector, \
                     int inRL, \
                     int inRH, \
                     float **inMatrix, \
                     int inRow);
-CopyFVectorToMatrixCol(float *inVector, \
+void CopyFVectorToMatrixCol(float *inVector, \
                     int inRL, \
                     int inRH, \
                     float **inMatrix, \
                     int inCol);
+void CopyDVectorToMatrixRow(double *inVector, \
+                    int inRL, \
+                    int inRH, \
+                    double **inMatrix, \
+                    int inRow);
+void CopyDVectorToMatrixCol(double *inVector, \
+                    int inRL, \
+                    int inRH, \
+                    double **inMatrix, \
+                    int inCol);
 
 
 void PrintFMatrix(float **inMatrix, int inRL, int inRH, int inCL, int inCH);
@@ -74,22 +132,39 @@ void CopyFMatrix(float **inSource, float **outTarget, \
                   int inRH,
                   int inCL,
                   int inCH);
+void CopyDMatrix(double **inSource, double **outTarget, \
+                  int inRL,
+                  int inRH,
+                  int inCL,
+                  int inCH);
 void TransposeFMatrix(float **inSource, float **outTarget, \
                   int inRL,
                   int inRH,
                   int inCL,
                   int inCH);
+void TransposeDMatrix(double **inSource, double **outTarget, \
+                  int inRL,
+                  int inRH,
+                  int inCL,
+                  int inCH);
 
 void MultiplyFMatrix(float **inA, float **inB, float **outResult, \
                   int inRLA, int inRHA, int inCLA, int inCHA, \
                   int inRLB, int inRHB, int inCLB, int inCHB);
+void MultiplyDMatrix(double **inA, double **inB, double **outResult, \
+                  int inRLA, int inRHA, int inCLA, int inCHA, \
+                  int inRLB, int inRHB, int inCLB, int inCHB);
 
                   
 void DiagonalizeFMatrix(float **inMatrix, \
                        int inDim, \
                        float *outEigenValue, \
                        float **outEigenVector);
+void DiagonalizeDMatrix(double **inMatrix, \
+                       int inDim, \
+                       double *outEigenValue, \
+                       double **outEigenVector);
 
 
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
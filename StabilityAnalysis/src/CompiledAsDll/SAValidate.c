@@ -30,10 +30,10 @@
 extern int       gNumberOfEigenFunctions;
 extern int       gNumElectrodes;
 extern double    gPeakDeformation_um;
-extern float   **gOmega;
+extern OmegaScalar **gOmega;
 extern double  **gMatrixA;
-extern float   **gEigenVector;
-extern float    *gEigenValue;
+extern OmegaScalar **gEigenVector;
+extern OmegaScalar  *gEigenValue;
 extern double  (*gMembraneShape)(double, double);
 extern float   **gElectrodeVoltage;
 extern float   **gElectrodeVoltageMap;
@@ -200,7 +200,7 @@ void TestSmallAmplitudeStability(float inVaLow_V, \
 //
 // plk 4/18/2005
 //---------------------------------------------------------------------------
-float GetDeviceStability()
+OmegaScalar GetDeviceStability()
 {
    RunFastStabilityComputation();
    return gEigenValue[1];
@@ -222,13 +222,13 @@ float GetDeviceStability()
 void RunStabilityComputation()
 {
         int      theDim;
-        float  **theOmega;
+        OmegaScalar **theOmega;
         double **theMatrixA;
         double **theMatrixASum;
 
 
 
-        theOmega = matrix(1,gNumberOfEigenFunctions, \
+        theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
         theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -264,7 +264,7 @@ void RunStabilityComputation()
         //---------------------------------------------
 
         ComputeOmegaMatrix();
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
         1,gNumberOfEigenFunctions,\
         1,gNumberOfEigenFunctions,\
         "Omega Matrix (Discrete Sum)");
@@ -274,21 +274,21 @@ void RunStabilityComputation()
         // OMEGA MATRIX DIAGONALIZATION, EIGENVALUES
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -313,13 +313,13 @@ void RunStabilityComputation()
 void RunFastStabilityComputation()
 {
         int      theDim;
-        float  **theOmega;
+        OmegaScalar **theOmega;
         double **theMatrixA;
         double **theMatrixASum;
 
 
 
-        theOmega = matrix(1,gNumberOfEigenFunctions, \
+        theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
         theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -355,7 +355,7 @@ void RunFastStabilityComputation()
         //---------------------------------------------
         //ComputegMatrixASum();
         ComputeOmegaMatrix();
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
         1,gNumberOfEigenFunctions,\
         1,gNumberOfEigenFunctions,\
         "Omega Matrix (Discrete Sum)");
@@ -365,23 +365,23 @@ void RunFastStabilityComputation()
         // OMEGA MATRIX DIAGONALIZATION, EIGENVALUES
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
 
 #if 0
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -408,25 +408,25 @@ void RunFastStabilityComputation()
 void TestStabilityMatrixEigenvectors()
 {
         int theDim;
-        float **theEigenVector_T;
-        float **theMatrixProduct;
+        OmegaScalar **theEigenVector_T;
+        OmegaScalar **theMatrixProduct;
 
         theDim = gNumberOfEigenFunctions;
-        theEigenVector_T = matrix(1,theDim, \
+        theEigenVector_T = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        theMatrixProduct = matrix(1,theDim, \
+        theMatrixProduct = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        TransposeFMatrix(gEigenVector,theEigenVector_T, \
+        TransposeOmegaMatrix(gEigenVector,theEigenVector_T, \
                          1, theDim, \
                          1, theDim);
 
-        MultiplyFMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
+        MultiplyOmegaMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
                          1, theDim, 1, theDim, \
                          1, theDim, 1, theDim);
 
-        LogFMatrix(theMatrixProduct,\
+        LogOmegaMatrix(theMatrixProduct,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Product Matrix (Omega Eigenvectors):  E*E^T");
@@ -561,15 +561,15 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
 {
    int theDim;
 
-   float **theOmega;
+   OmegaScalar **theOmega;
    double **theMatrixA;
    double **theMatrixASum;
-   float  **theOmegaResult;
-   float **theEigenVector_T;
-   float **theMatrixProduct;
-   float **theSimilarMatrix;
+   OmegaScalar **theOmegaResult;
+   OmegaScalar **theEigenVector_T;
+   OmegaScalar **theMatrixProduct;
+   OmegaScalar **theSimilarMatrix;
    double **theEPMatrix;
-   float   *thePeakDefResult;
+   OmegaScalar  *thePeakDefResult;
 
    double thePeakDef_um;
 
@@ -580,7 +580,7 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
 
 
 
-   theOmega = matrix(1,gNumberOfEigenFunctions, \
+   theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
    theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -589,9 +589,9 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
 
 
    theMaxNumberOfSimulations = 200;
-   theOmegaResult = matrix(0,theMaxNumberOfSimulations, \
+   theOmegaResult = omega_matrix(0,theMaxNumberOfSimulations, \
                     0,gNumberOfEigenFunctions);
-   thePeakDefResult = vector(0,theMaxNumberOfSimulations);
+   thePeakDefResult = omega_vector(0,theMaxNumberOfSimulations);
 
    LogMessage("--- Begin Vary-Peak-Deformation Simulation --- ");
 
@@ -644,13 +644,13 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
         // PRINT, LOG OMEGA MATRIX
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
 
 
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Omega Matrix");
@@ -661,19 +661,19 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
         //---------------------------------------------
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
         // copy current eigenvalues to the Result matrix for print out
         // at end of simulation
-        CopyFVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
+        CopyOmegaVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
 
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -682,22 +682,22 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
         //---------------------------------------------
         // TEST OMEGA EIGENVECTOR ORTHONORMALITY
         //---------------------------------------------
-        theEigenVector_T = matrix(1,theDim, \
+        theEigenVector_T = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        theMatrixProduct = matrix(1,theDim, \
+        theMatrixProduct = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        TransposeFMatrix(gEigenVector,theEigenVector_T, \
+        TransposeOmegaMatrix(gEigenVector,theEigenVector_T, \
                          1, theDim, \
                          1, theDim);
 
-        MultiplyFMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
+        MultiplyOmegaMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
                          1, theDim, 1, theDim, \
                          1, theDim, 1, theDim);
 
 
-        LogFMatrix(theMatrixProduct,\
+        LogOmegaMatrix(theMatrixProduct,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Product Matrix (Omega Eigenvectors):  E*E^T");
@@ -722,11 +722,11 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
    } // end for loop
 
    // copy peak defs. (indep. variable) to result matrix, column 0.
-   CopyFVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
+   CopyOmegaVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
 
 
 
-   LogFMatrix(theOmegaResult,\
+   LogOmegaMatrix(theOmegaResult,\
         1,theResultRow,\
         0,gNumberOfEigenFunctions,\
         "Omega Eigenvalues:  Summary");
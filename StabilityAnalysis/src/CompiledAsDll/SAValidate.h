@@ -11,6 +11,9 @@
 #define SAVALIDATE_H
 
 
+#include "MatrixUtils.h"
+
+
 void TestSmallAmplitudeStability(float inVaLow_V, \
                                  float inVaHigh_V, \
                                  float inVtLow_V, \
@@ -21,7 +24,7 @@ void TestSmallAmplitudeStability(float inVaLow_V, \
 int Ping();
 int Createdevice();
 
-float GetDeviceStability();
+OmegaScalar GetDeviceStability();
 void RunStabilityComputation();
 void RunFastStabilityComputation();
 void TestStabilityMatrixEigenvectors();
@@ -1,8 +1,16 @@
 %module Savalidate
 %{
   /* header files (optional) */
+#include "MatrixUtils.h"
 %}
 
+/* Omega scalar type, see MatrixUtils.h */
+#ifdef OMEGA_DOUBLE
+typedef double OmegaScalar;
+#else
+typedef float OmegaScalar;
+#endif
+
 /* SWIG library for creating accessor functions for arrays */
 %include carrays.i
 
@@ -14,10 +22,10 @@
 extern int       gNumberOfEigenFunctions;
 extern int       gNumElectrodes;
 extern double    gPeakDeformation_um;
-extern float   **gOmega;
+extern OmegaScalar **gOmega;
 extern double  **gMatrixA;
-extern float   **gEigenVector;
-extern float    *gEigenValue;
+extern OmegaScalar **gEigenVector;
+extern OmegaScalar  *gEigenValue;
 extern double  (*gMembraneShape)(double, double);
 extern float   **gElectrodeVoltage;
 extern float   **gElectrodeVoltageMap;
@@ -44,7 +52,7 @@ void TestSmallAmplitudeStability(float inVaLow_V, \
 int Ping();
 int Createdevice();
 
-float GetDeviceStability();
+OmegaScalar GetDeviceStability();
 void RunStabilityComputation();
 void RunFastStabilityComputation();
 void TestStabilityMatrixEigenvectors();
@@ -52,3 +60,123 @@ void TestMatrixAComputation();
 void TestMembraneEigenfunctions();
 
 void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um);
+
+
+
+/* from StabilityEnvelope.c */
+
+%array_functions(float, floatArray);
+%array_functions(double, doubleArray);
+
+int   BuildStabilityEnvelope(double inVtL_V, double inVtH_V, int inNumVt, \
+                             double inAmplL_um, double inAmplH_um, \
+                             int inNumAmpl, int inNumModes);
+int   SaveStabilityEnvelope(char *inFileName);
+int   LoadStabilityEnvelope(char *inFileName);
+void  FreeStabilityEnvelope();
+int   StabilityEnvelopeSize();
+
+float StabilityMargin(double inVoltageT_V, double inPeakDeformation_um);
+float StabilityMarginForModes(double inVoltageT_V, double *inAmpl_um);
+float StabilityMarginForVoltages(double inVoltageT_V, \
+                                 float *inElectrodeVoltage_V);
+
+
+
+/* from StabilityBatch.c */
+
+int StabilityBatchStride();
+int GetDeviceStabilityBatch(double *inParams, int inNumDevices, \
+                            float *outMinEigenvalue);
+
+
+
+/* from StabilityGradient.c */
+
+OmegaScalar GetDeviceStabilityGradient(double *outGradient);
+
+
+
+/* from StabilityMonteCarlo.c */
+
+extern int      gMonteCarloNumSamples;
+extern float   *gMonteCarloMargin;
+extern double   gMonteCarloYield;
+extern double   gMonteCarloMarginMean;
+extern double   gMonteCarloMarginSigma;
+extern double   gMonteCarloMarginMin;
+extern double   gMonteCarloMarginMax;
+
+int RunStabilityMonteCarlo(int    inNumSamples,
+                           double inSigmaDistA_um,
+                           double inSigmaDistT_um,
+                           double inSigmaTension_NByM,
+                           double inSigmaVoltage_V,
+                           long   inSeed);
+
+
+
+/* from StabilityMap.c */
+
+int   BuildStabilityMap(double inVaL_V, double inVaH_V, \
+                        double inVtL_V, double inVtH_V, \
+                        int inMinDepth, int inMaxDepth, \
+                        double inMaxCellRange);
+void  FreeStabilityMap();
+float StabilityMapValue(double inVa_V, double inVt_V);
+void  LogStabilityMap();
+
+
+
+/* from StabilityCache.c */
+
+int   OpenStabilityCache(char *inFileName);
+void  CloseStabilityCache();
+OmegaScalar GetCachedDeviceStability();
+
+
+
+/* from Equilibrium.c */
+
+int   SolveMembraneEquilibrium();
+
+
+
+/* from MembraneDynamics.c */
+
+double StepResponseSettleTime_ms(double inVaFrom_V, double inVaTo_V, \
+                                 double inDampingRatio, \
+                                 double inTolerance_um);
+int    RunStepResponseSweep(double inVaFrom_V, \
+                            double inVaToL_V, double inVaToH_V, \
+                            int inNumSteps, \
+                            double inDampingRatio, \
+                            double inTolerance_um);
+
+
+
+/* from DiskCubature.c */
+
+int   InitDiskCubature(int inNumR, int inNumPhi);
+int   SetMatrixACubature(int inNumR, int inNumPhi);
+void  TestMatrixACubature(int inNumR, int inNumPhi);
+
+
+
+/* from VoltageExchange.c */
+
+int   CreateVoltageExchange(char *inName);
+int   OpenVoltageExchange(char *inName);
+void  CloseVoltageExchange();
+int   PublishElectrodeVoltages();
+OmegaScalar GetSharedDeviceStability();
+int   RunVoltageExchangeMonitor(int inNumFrames);
+
+
+
+/* from StabilitySweep.c */
+
+void  SetStabilitySweepProgram(char *inPath);
+int   RunStabilitySweep(char *inSpecFileName, char *inDir, int inNumWorkers);
+int   MergeStabilitySweep(char *inSpecFileName, char *inDir, \
+                          char *inOutFileName);
@@ -13,17 +13,16 @@
 #include "MatrixA.h"
 #include "Eigenfunc.h"
 #include "Membrane.h"
-#include "NR.h"
+#include "NR.H"
 #include "NRUTIL.H"
 
 #include <stdio.h>
-#include <conio.h>
 #include <math.h>
 
 
-float **gOmega;
-float **gEigenVector;
-float  *gEigenValue;
+OmegaScalar **gOmega;
+OmegaScalar **gEigenVector;
+OmegaScalar  *gEigenValue;
 
 extern double gMembraneTension_NByM;      // tension = stress * thickness
 extern double gMembraneRadius_mm;
@@ -48,22 +47,25 @@ extern double **gMatrixA;
 // NOTE:  Must call procedure ComputegMatrixASum() prior to calling this
 // procedure!!
 //
+// Elements are computed in double precision and rounded once, to
+// OmegaScalar (see MatrixUtils.h).
+//
 // plk 4/18/2005
 //---------------------------------------------------------------------------
 void ComputeOmegaMatrix()
 {
    int i,j;
    int ii,jj;
-   float theDiag_MKS;
-   float theTen_MKS;
-   float theRad_MKS;
-   float theMatrixA;
+   double theDiag_MKS;
+   double theTen_MKS;
+   double theRad_MKS;
+   double theMatrixA;
 
 
-   gOmega = matrix(1,gNumberOfEigenFunctions, \
+   gOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
-   gEigenValue = vector(1,gNumberOfEigenFunctions);
-   gEigenVector = matrix(1,gNumberOfEigenFunctions, \
+   gEigenValue = omega_vector(1,gNumberOfEigenFunctions);
+   gEigenVector = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
 
 
@@ -90,17 +92,18 @@ void ComputeOmegaMatrix()
 
            // Compute matrix A elements using continuous functions,
            // numerical integration.
-           // theMatrixA = (float) RealMatrixA(i,j);
+           // theMatrixA = RealMatrixA(i,j);
 
            // Compute matrix A elements using summation over electrodes
            // of the electrode array.
-            theMatrixA = (float) RealMatrixASum(i,j);
+            theMatrixA = RealMatrixASum(i,j);
 
            // Use previously computed value of MatrixA.  See
            // ComputegMatrixASum() for method of computation.
-           //theMatrixA = (float) gMatrixA[i][j];
+           //theMatrixA = gMatrixA[i][j];
 
-           gOmega[ii][jj] = theDiag_MKS*KroneckerDelta(i,j) - theMatrixA;
+           gOmega[ii][jj] = (OmegaScalar) \
+                         (theDiag_MKS*KroneckerDelta(i,j) - theMatrixA);
         }
    }
 
@@ -0,0 +1,570 @@
+//---------------------------------------------------------------------------
+// DiskCubature.c
+//
+// Polar cubature rule for the A matrix.  See DiskCubature.h
+//
+// Nodes are numbered n = iR*gCubatureNumPhi + iPhi.  The eigenfunctions
+// are tabulated at the nodes in rectangular form, as in FastStability.c:
+//
+//    gCubatureCos[j][n]  =  |zeta_j(r_n)| * cos(v_j * phi_n)
+//    gCubatureSin[j][n]  =  |zeta_j(r_n)| * sin(v_j * phi_n)
+//
+// so that, with W_n = F(r_n,phi_n) * w_n,
+//
+//                          Nn-1
+//    Re A_jj'   =           Sum W_n * ( C_jn*C_j'n + S_jn*S_j'n )
+//                           n=0
+//
+//                          Nn-1
+//    Im A_jj'   =           Sum W_n * ( S_jn*C_j'n - C_jn*S_j'n )
+//                           n=0
+//---------------------------------------------------------------------------
+#include "DiskCubature.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "Eigenfunc.h"
+#include "ElectrodeArray.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <math.h>
+
+
+#define CUBATURE_PI  3.14159265358979
+
+
+int       gCubatureDim = 0;         // eigenfunctions tabulated
+int       gCubatureNumR = 0;
+int       gCubatureNumPhi = 0;
+int       gCubatureNumNodes = 0;
+double    gCubatureRadius_mm = 0.0;
+
+int       gMatrixACubature = 0;       // see SetMatrixACubature()
+int       gMatrixACubatureNumR = 0;
+int       gMatrixACubatureNumPhi = 0;
+
+double   *gCubatureR_MKS;          // [0...Nn-1]
+double   *gCubatureWeight_MKS;     // [0...Nn-1]  w_r * r * 2 PI/NumPhi
+int      *gCubatureElectrode;      // [0...Nn-1]  index k into
+                                   // gElectrodeVoltage, or -1
+double  **gCubatureCos;            // [0...N-1][0...Nn-1]
+double  **gCubatureSin;            // [0...N-1][0...Nn-1]
+
+
+extern int      gNumberOfEigenFunctions;
+extern int      gNumElectrodes;
+extern float  **gElectrodeVoltage;
+extern float    gElectrodeWidth_um;
+extern float    gElectrodeSpc_um;
+extern int      gMaxSRC;
+
+extern double   gMembraneRadius_mm;
+
+extern double **gBasisCos;
+extern double **gBasisSin;
+extern double   gBasisElectrodeArea_MKS;
+extern int     *gElectrodeUnderMembrane;
+
+
+
+//---------------------------------------------------------------------------
+// GaussLegendre
+//
+// Abscissas outX[1...inN] and weights outW[1...inN] of the inN point
+// Gauss-Legendre rule on [inX1,inX2].  Double precision version of NR
+// gauleg().
+//---------------------------------------------------------------------------
+void GaussLegendre(double inX1, double inX2, double *outX, double *outW, \
+                   int inN)
+{
+   int    i,j,m;
+   double z1,z,xm,xl,pp,p3,p2,p1;
+
+   m = (inN+1)/2;
+   xm = 0.5*(inX2+inX1);
+   xl = 0.5*(inX2-inX1);
+   for (i=1;i<=m;i++)
+   {
+      z = cos(CUBATURE_PI*(i-0.25)/(inN+0.5));
+      do
+      {
+         p1 = 1.0;
+         p2 = 0.0;
+         for (j=1;j<=inN;j++)
+         {
+            p3 = p2;
+            p2 = p1;
+            p1 = ((2.0*j-1.0)*z*p2-(j-1.0)*p3)/j;
+         }
+         pp = inN*(z*p1-p2)/(z*z-1.0);
+         z1 = z;
+         z = z1-p1/pp;
+      } while (fabs(z-z1) > 3.0e-14);
+
+      outX[i] = xm-xl*z;
+      outX[inN+1-i] = xm+xl*z;
+      outW[i] = 2.0*xl/((1.0-z*z)*pp*pp);
+      outW[inN+1-i] = outW[i];
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// InitDiskCubature
+//
+// Computes the nodes and weights of the inNumR x inNumPhi polar rule for
+// the current membrane radius, finds the electrode pixel beneath each
+// node, and tabulates the membrane eigenfunctions at the nodes.
+// Previously tabulated data are released.
+//
+//  return value:
+//          0    successful completion
+//          1    invalid order
+//
+// called by:  ComputeMatrixACubature(), TestMatrixACubature(),
+//             InitFastStability()
+//---------------------------------------------------------------------------
+int InitDiskCubature(int inNumR, int inNumPhi)
+{
+   int      j,k,n;
+   int      iR,iPhi;
+   int      theIndex;
+   int      theCellX,theCellY;
+   int      theMaxCell;
+   int    **theCellElectrode;
+   double   theRadius_MKS;
+   double   thePitch_MKS;
+   double   thePhi_Rad;
+   double   theMagn_MKS;
+   double   thePhase_Rad;
+   double  *theX;
+   double  *theW;
+   char     theMessage[100];
+
+   if (inNumR < 1 || inNumPhi < 1)
+   {
+      LogMessage("--- InitDiskCubature:  invalid order ---");
+      return 1;
+   }
+
+   if (gCubatureNumNodes > 0)
+   {
+      free_dvector(gCubatureR_MKS,0,gCubatureNumNodes-1);
+      free_dvector(gCubatureWeight_MKS,0,gCubatureNumNodes-1);
+      free_ivector(gCubatureElectrode,0,gCubatureNumNodes-1);
+      free_dmatrix(gCubatureCos,0,gCubatureDim-1,0,gCubatureNumNodes-1);
+      free_dmatrix(gCubatureSin,0,gCubatureDim-1,0,gCubatureNumNodes-1);
+   }
+
+   gCubatureDim = gNumberOfEigenFunctions;
+   gCubatureNumR = inNumR;
+   gCubatureNumPhi = inNumPhi;
+   gCubatureNumNodes = inNumR*inNumPhi;
+   gCubatureRadius_mm = gMembraneRadius_mm;
+
+   gCubatureR_MKS      = dvector(0,gCubatureNumNodes-1);
+   gCubatureWeight_MKS = dvector(0,gCubatureNumNodes-1);
+   gCubatureElectrode  = ivector(0,gCubatureNumNodes-1);
+   gCubatureCos = dmatrix(0,gCubatureDim-1,0,gCubatureNumNodes-1);
+   gCubatureSin = dmatrix(0,gCubatureDim-1,0,gCubatureNumNodes-1);
+
+   theRadius_MKS = gMembraneRadius_mm*1e-3;
+   thePitch_MKS = (double) gElectrodeWidth_um*1e-6 + \
+                  (double) gElectrodeSpc_um*1e-6;
+
+   // electrode pixel (k index) for each cell of the pixel grid.  Cell
+   // (i,j) spans [i,i+1)*pitch in x and [j,j+1)*pitch in y.
+   theMaxCell = gMaxSRC+2;
+   theCellElectrode = imatrix(-theMaxCell,theMaxCell-1,-theMaxCell,theMaxCell-1);
+   for (theCellX=-theMaxCell;theCellX<theMaxCell;theCellX++)
+      for (theCellY=-theMaxCell;theCellY<theMaxCell;theCellY++)
+         theCellElectrode[theCellX][theCellY] = -1;
+
+   for (k=0;k<gNumElectrodes;k++)
+   {
+      theIndex = (int) gElectrodeVoltage[k][0];
+      theCellX = (int) floor(EXCenter_MKS(theIndex)/thePitch_MKS);
+      theCellY = (int) floor(EYCenter_MKS(theIndex)/thePitch_MKS);
+      if (theCellX >= -theMaxCell && theCellX < theMaxCell && \
+          theCellY >= -theMaxCell && theCellY < theMaxCell)
+         theCellElectrode[theCellX][theCellY] = k;
+   }
+
+   theX = dvector(1,inNumR);
+   theW = dvector(1,inNumR);
+   GaussLegendre(0.0,theRadius_MKS,theX,theW,inNumR);
+
+   for (iR=0;iR<inNumR;iR++)
+   {
+      for (iPhi=0;iPhi<inNumPhi;iPhi++)
+      {
+         n = iR*inNumPhi + iPhi;
+         thePhi_Rad = 2*CUBATURE_PI*iPhi/inNumPhi;
+
+         gCubatureR_MKS[n] = theX[iR+1];
+         gCubatureWeight_MKS[n] = theW[iR+1]*theX[iR+1]* \
+                                  2*CUBATURE_PI/inNumPhi;
+
+         theCellX = (int) floor(theX[iR+1]*cos(thePhi_Rad)/thePitch_MKS);
+         theCellY = (int) floor(theX[iR+1]*sin(thePhi_Rad)/thePitch_MKS);
+         if (theCellX >= -theMaxCell && theCellX < theMaxCell && \
+             theCellY >= -theMaxCell && theCellY < theMaxCell)
+            gCubatureElectrode[n] = theCellElectrode[theCellX][theCellY];
+         else
+            gCubatureElectrode[n] = -1;
+
+         for (j=0;j<gCubatureDim;j++)
+         {
+            Eigenfunc(j,theX[iR+1],thePhi_Rad,&theMagn_MKS,&thePhase_Rad);
+            gCubatureCos[j][n] = theMagn_MKS*cos(thePhase_Rad);
+            gCubatureSin[j][n] = theMagn_MKS*sin(thePhase_Rad);
+         }
+      }
+   }
+
+   free_dvector(theX,1,inNumR);
+   free_dvector(theW,1,inNumR);
+   free_imatrix(theCellElectrode,-theMaxCell,theMaxCell-1,\
+                                 -theMaxCell,theMaxCell-1);
+
+   sprintf(theMessage,\
+           "InitDiskCubature:  %d x %d rule, %d eigenfunctions",\
+           inNumR, inNumPhi, gCubatureDim);
+   LogMessage(theMessage);
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// DiskCubatureIsCurrent
+//
+// Returns 1 if the cubature tables correspond to the current simulation
+// parameters, 0 if InitDiskCubature() must be called.
+//---------------------------------------------------------------------------
+int DiskCubatureIsCurrent()
+{
+   if (gCubatureNumNodes == 0) return 0;
+   if (gCubatureDim != gNumberOfEigenFunctions) return 0;
+   if (gCubatureRadius_mm != gMembraneRadius_mm) return 0;
+
+   return 1;
+}
+
+
+//---------------------------------------------------------------------------
+// SetMatrixACubature
+//
+// Selects the A matrix of the stability path (ComputeDeviceMatrixA()):
+// the inNumR x inNumPhi cubature rule, or the pixel sum (the default) if
+// inNumR is 0.  The eigenfunction tables are rebuilt with
+// InitFastStability(), which also tabulates the selected rule and starts
+// a new basis key for the stability cache.  Must be called after
+// Membrane() and ElectrodeArray(), and not concurrently with other calls.
+//
+//  return value:
+//          0    successful completion
+//          1    invalid order
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int SetMatrixACubature(int inNumR, int inNumPhi)
+{
+   if (inNumR == 0)
+   {
+      gMatrixACubature = 0;
+   }
+   else
+   {
+      if (inNumR < 1 || inNumPhi < 1)
+      {
+         LogMessage("--- SetMatrixACubature:  invalid order ---");
+         return 1;
+      }
+
+      gMatrixACubature = 1;
+      gMatrixACubatureNumR = inNumR;
+      gMatrixACubatureNumPhi = inNumPhi;
+   }
+
+   InitFastStability();
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeDeviceMatrixACubature
+//
+// Computes the real and imaginary parts of the A matrix [0...N-1]
+// [0...N-1] of the device with the current cubature rule.  The membrane
+// shape is the expansion of the device, using the eigenfunction
+// magnitudes as in MembraneShapeAtElectrode_MKS().  outMatrixAImag may
+// be NULL.  A is Hermitian:  Re A is symmetric, Im A antisymmetric.
+//---------------------------------------------------------------------------
+void ComputeDeviceMatrixACubature(DeviceConfig *inConfig, \
+                                  double **outMatrixAReal, \
+                                  double **outMatrixAImag)
+{
+   int    i,j,n;
+   int    theDim;
+   double theShape_MKS;
+   double theDenom_MKS;
+   double theVoltage;
+   double theVoltageT_V;
+   double theDistA_MKS;
+   double theDistT_MKS;
+   double theW_MKS;
+   double e_0 = 8.85E-12;
+
+   theDim = gCubatureDim;
+   theVoltageT_V = inConfig->VoltageT_V;
+   theDistA_MKS = inConfig->DistA_um*1e-6;
+   theDistT_MKS = inConfig->DistT_um*1e-6;
+
+   for (i=0;i<theDim;i++)
+   {
+      for (j=0;j<theDim;j++)
+      {
+         outMatrixAReal[i][j] = 0.0;
+         if (outMatrixAImag != NULL) outMatrixAImag[i][j] = 0.0;
+      }
+   }
+
+   for (n=0;n<gCubatureNumNodes;n++)
+   {
+      theShape_MKS = 0.0;
+      for (j=0;j<theDim;j++)
+         theShape_MKS += inConfig->ExpansionCoeff_MKS[j]* \
+                         sqrt(gCubatureCos[j][n]*gCubatureCos[j][n] + \
+                              gCubatureSin[j][n]*gCubatureSin[j][n]);
+
+      theVoltage = 0.0;
+      if (gCubatureElectrode[n] >= 0)
+         theVoltage = (double) inConfig->ElectrodeVoltage_V[gCubatureElectrode[n]];
+
+      // electrostatic weight function, see WeightFnForSum_MKS()
+      theDenom_MKS = theDistA_MKS - theShape_MKS;
+      theW_MKS = e_0*theVoltage*theVoltage/ \
+                 (theDenom_MKS*theDenom_MKS*theDenom_MKS);
+
+      theDenom_MKS = theDistT_MKS + theShape_MKS;
+      theW_MKS += e_0*theVoltageT_V*theVoltageT_V/ \
+                  (theDenom_MKS*theDenom_MKS*theDenom_MKS);
+
+      theW_MKS *= gCubatureWeight_MKS[n];
+
+      // accumulate the upper triangle only
+      for (i=0;i<theDim;i++)
+      {
+         for (j=i;j<theDim;j++)
+         {
+            outMatrixAReal[i][j] += theW_MKS* \
+               (gCubatureCos[i][n]*gCubatureCos[j][n] + \
+                gCubatureSin[i][n]*gCubatureSin[j][n]);
+
+            if (outMatrixAImag != NULL)
+               outMatrixAImag[i][j] += theW_MKS* \
+                  (gCubatureSin[i][n]*gCubatureCos[j][n] - \
+                   gCubatureCos[i][n]*gCubatureSin[j][n]);
+         }
+      }
+   }
+
+   for (i=0;i<theDim;i++)
+   {
+      for (j=0;j<i;j++)
+      {
+         outMatrixAReal[i][j] = outMatrixAReal[j][i];
+         if (outMatrixAImag != NULL)
+            outMatrixAImag[i][j] = -outMatrixAImag[j][i];
+      }
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeMatrixACubature
+//
+// Computes the (real) A matrix [0...N-1][0...N-1] of the current device
+// (global simulation parameters, membrane shape and electrode voltages)
+// by cubature.  Uses the current rule, or the default rule if none is
+// current.  Alternative to ComputeMatrixA() for non-uniform electrode
+// voltages;  not used by the stability path, see DiskCubature.h.
+//
+// called by:  (diagnostic, not called within the library)
+//---------------------------------------------------------------------------
+void ComputeMatrixACubature(double **outMatrixA)
+{
+   DeviceConfig theConfig;
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+   if (!DiskCubatureIsCurrent())
+      InitDiskCubature(CUBATURE_DEFAULT_NUMR,CUBATURE_DEFAULT_NUMPHI);
+
+   GetGlobalDeviceConfig(&theConfig);
+   ComputeDeviceMatrixACubature(&theConfig,outMatrixA,NULL);
+   free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+}
+
+
+//---------------------------------------------------------------------------
+// MembranePixelMatrixA
+//
+// ComputeDeviceMatrixASum() restricted to the electrode pixels under the
+// membrane (pixel center r < R), ie. the pixel sum over the domain of
+// the cubature rule.
+//
+// called by:  TestMatrixACubature()
+//---------------------------------------------------------------------------
+void MembranePixelMatrixA(DeviceConfig *inConfig, double **outMatrixA)
+{
+   int    i,j,k;
+   int    theDim;
+   double theShape_MKS;
+   double theDenom_MKS;
+   double theVoltage;
+   double theFDS_MKS;
+   double e_0 = 8.85E-12;
+
+   theDim = gCubatureDim;
+
+   for (i=0;i<theDim;i++)
+      for (j=0;j<theDim;j++)
+         outMatrixA[i][j] = 0.0;
+
+   for (k=0;k<gNumElectrodes;k++)
+   {
+      if (!gElectrodeUnderMembrane[k]) continue;
+
+      theShape_MKS = MembraneShapeAtElectrode_MKS(inConfig,k);
+      theVoltage = (double) inConfig->ElectrodeVoltage_V[k];
+
+      theDenom_MKS = inConfig->DistA_um*1e-6 - theShape_MKS;
+      theFDS_MKS = e_0*theVoltage*theVoltage/ \
+                   (theDenom_MKS*theDenom_MKS*theDenom_MKS);
+
+      theDenom_MKS = inConfig->DistT_um*1e-6 + theShape_MKS;
+      theFDS_MKS += e_0*inConfig->VoltageT_V*inConfig->VoltageT_V/ \
+                    (theDenom_MKS*theDenom_MKS*theDenom_MKS);
+
+      theFDS_MKS *= gBasisElectrodeArea_MKS;
+
+      for (i=0;i<theDim;i++)
+         for (j=0;j<theDim;j++)
+            outMatrixA[i][j] += theFDS_MKS* \
+               (gBasisCos[i][k]*gBasisCos[j][k] + \
+                gBasisSin[i][k]*gBasisSin[j][k]);
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// MaxRelDifference
+//
+// Largest |inA - inRef| relative to the largest |inRef|, or -1 if inRef
+// is zero (eg. all voltages zero).
+//
+// called by:  TestMatrixACubature()
+//---------------------------------------------------------------------------
+double MaxRelDifference(double **inA, double **inRef, int inDim)
+{
+   int    i,j;
+   double theMaxDiff;
+   double theMaxElement;
+
+   theMaxDiff = 0.0;
+   theMaxElement = 0.0;
+   for (i=0;i<inDim;i++)
+   {
+      for (j=0;j<inDim;j++)
+      {
+         if (fabs(inA[i][j]-inRef[i][j]) > theMaxDiff)
+            theMaxDiff = fabs(inA[i][j]-inRef[i][j]);
+         if (fabs(inRef[i][j]) > theMaxElement)
+            theMaxElement = fabs(inRef[i][j]);
+      }
+   }
+
+   if (theMaxElement == 0.0) return -1.0;
+   return theMaxDiff/theMaxElement;
+}
+
+
+//---------------------------------------------------------------------------
+// TestMatrixACubature
+//
+// Compares the A matrix of the current device computed with an inNumR x
+// inNumPhi cubature rule with the sum over the electrode pixels under
+// the membrane, and with the sum over all pixels (ComputeDeviceMatrixASum).
+// The matrices, and the largest differences relative to the largest
+// element of the sum, are written to the log file.  The first difference
+// is the discretization error of the pixel midpoint sum;  the second also
+// includes the pixels outside the membrane (see DiskCubature.h).
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+void TestMatrixACubature(int inNumR, int inNumPhi)
+{
+   int          i,j;
+   int          theDim;
+   double       theMaxImag;
+   double       theRelDiff;
+   double       theRelDiffAll;
+   double     **theSum;
+   double     **theSumAll;
+   double     **theReal;
+   double     **theImag;
+   DeviceConfig theConfig;
+   char         theMessage[200];
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+   if (InitDiskCubature(inNumR,inNumPhi)) return;
+
+   theDim = gCubatureDim;
+   theSum    = dmatrix(0,theDim-1,0,theDim-1);
+   theSumAll = dmatrix(0,theDim-1,0,theDim-1);
+   theReal   = dmatrix(0,theDim-1,0,theDim-1);
+   theImag   = dmatrix(0,theDim-1,0,theDim-1);
+
+   GetGlobalDeviceConfig(&theConfig);
+   MembranePixelMatrixA(&theConfig,theSum);
+   ComputeDeviceMatrixASum(&theConfig,theSumAll);
+   ComputeDeviceMatrixACubature(&theConfig,theReal,theImag);
+   free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+
+   theRelDiff = MaxRelDifference(theReal,theSum,theDim);
+   theRelDiffAll = MaxRelDifference(theReal,theSumAll,theDim);
+
+   theMaxImag = 0.0;
+   for (i=0;i<theDim;i++)
+      for (j=0;j<theDim;j++)
+         if (fabs(theImag[i][j]) > theMaxImag)
+            theMaxImag = fabs(theImag[i][j]);
+
+   LogDMatrix(theSum,0,theDim-1,0,theDim-1,"MatrixA (Electrode Sum, r < R)");
+   LogDMatrix(theSumAll,0,theDim-1,0,theDim-1,"MatrixA (Electrode Sum, all)");
+   LogDMatrix(theReal,0,theDim-1,0,theDim-1,"MatrixA (Cubature), Real");
+   LogDMatrix(theImag,0,theDim-1,0,theDim-1,"MatrixA (Cubature), Imag");
+
+   if (theRelDiff < 0.0)
+      sprintf(theMessage,"--- TestMatrixACubature:  %d x %d rule, "\
+                         "A is zero, max. |Im A| %e ---", \
+              inNumR,inNumPhi,theMaxImag);
+   else
+      sprintf(theMessage,"--- TestMatrixACubature:  %d x %d rule, "\
+                         "max. rel. difference %e (pixels r < R), "\
+                         "%e (all pixels), max. |Im A| %e ---", \
+              inNumR,inNumPhi,theRelDiff,theRelDiffAll,theMaxImag);
+   LogMessage(theMessage);
+
+   free_dmatrix(theSum,0,theDim-1,0,theDim-1);
+   free_dmatrix(theSumAll,0,theDim-1,0,theDim-1);
+   free_dmatrix(theReal,0,theDim-1,0,theDim-1);
+   free_dmatrix(theImag,0,theDim-1,0,theDim-1);
+
+   // restore the rule selected for the stability path
+   if (gMatrixACubature)
+      InitDiskCubature(gMatrixACubatureNumR,gMatrixACubatureNumPhi);
+}
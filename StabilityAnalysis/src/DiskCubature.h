@@ -0,0 +1,61 @@
+//---------------------------------------------------------------------------
+// DiskCubature.h
+//
+// Polar cubature rule over the membrane disk, for A matrix elements with
+// an electrostatic weight function that depends on both r and phi:
+//
+//                ^
+//               |
+//    A_jj'   =  | F(r,phi) * zeta_j(r,phi) * conj(zeta_j'(r,phi))  r dr dphi
+//               |
+//              ^
+//
+// The rule is the product of an inNumR point Gauss-Legendre rule in r
+// on [0,R] and an inNumPhi point trapezoidal rule in phi, which is exact
+// for trigonometric polynomials of degree less than inNumPhi.  Node
+// positions and weights (including the Jacobian r) are precomputed, and
+// the eigenfunctions are tabulated at the nodes, so that A is a single
+// weighted Gram product over the nodes.  The weight function at a node
+// uses the voltage of the electrode pixel beneath it (V_k map), so A is
+// correct for non-uniform electrode voltages; pixels that are not in the
+// electrode table are taken as grounded.
+//
+// RealMatrixA() in MatrixA.c assumes F is independent of phi and is only
+// valid for uniform array voltages.
+//
+// By default the stability path (ComputeDeviceOmega(), DeviceMinEigenvalue(),
+// the envelope, sweep and cache) uses the pixel sum ComputeDeviceMatrixASum().
+// SetMatrixACubature() selects the cubature instead, for devices with
+// non-uniform array voltages;  the selection applies to the calling process
+// only, and DeviceMinEigenvalueGradient() still differentiates the pixel sum.
+// The pixel sum also runs over the pixels outside the membrane (r >= R),
+// where the Bessel functions of Eigenfunc() do not vanish;  the cubature
+// covers the disk only.  TestMatrixACubature() therefore compares against
+// the pixel sum over the pixels under the membrane as well as against the
+// full sum.
+//---------------------------------------------------------------------------
+#ifndef DISKCUBATURE_H
+#define DISKCUBATURE_H
+
+
+#include "FastStability.h"
+
+
+#define CUBATURE_DEFAULT_NUMR     24
+#define CUBATURE_DEFAULT_NUMPHI   96
+
+
+int  InitDiskCubature(int inNumR, int inNumPhi);
+int  DiskCubatureIsCurrent();
+int  SetMatrixACubature(int inNumR, int inNumPhi);
+
+void ComputeDeviceMatrixACubature(DeviceConfig *inConfig, \
+                                  double **outMatrixAReal, \
+                                  double **outMatrixAImag);
+void ComputeMatrixACubature(double **outMatrixA);
+void MembranePixelMatrixA(DeviceConfig *inConfig, double **outMatrixA);
+double MaxRelDifference(double **inA, double **inRef, int inDim);
+void TestMatrixACubature(int inNumR, int inNumPhi);
+
+
+#endif
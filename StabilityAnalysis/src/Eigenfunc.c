@@ -10,7 +10,7 @@
 #include "Eigenfunc.h"
 #include "Membrane.h"
 #include "MatrixA.h"   // for NR integration routines
-#include "NR.h"
+#include "NR.H"
 #include <math.h>
 #include <stdio.h>
 
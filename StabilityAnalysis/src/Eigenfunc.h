@@ -16,7 +16,7 @@ void Eigenfunc(int inJIndex,\
                double *outPhase_Rad);
 
 
-void ComputeEigenProductMatrix();
+void ComputeEPMatrix(double **outEP);
 double EPMatrixElement(int inJRow, int inJCol);
 double EPIntegrandRF(double inR_MKS);
 
@@ -34,4 +34,4 @@ void SaveEigenfuncR(int inIndex, \
 
 #endif
 
- 
\ No newline at end of file
+ 
\ No newline at end of file
@@ -8,13 +8,14 @@
 //
 // plk 6/8/2005
 //---------------------------------------------------------------------------
+#define ELECTRODEARRAY_TABLE
 #include "ElectrodeArray.h"
 #include "MatrixUtils.h"
 #include "Membrane.h"
 #include "NRUTIL.H"
 
 #include <stdio.h>
-#include <conio.h>
+#include <stdlib.h>
 #include <math.h>
 
 
@@ -40,7 +41,7 @@ extern double gVoltageA_V;    // Array electrode voltage
 extern double gDistT_um;      // Transp. electr -- membr. dist.
 extern double gDistA_um;      // Electr. array -- membr. dist.
 
-void ElectrodeArray()
+int ElectrodeArray()
 {
    int k;
    int theNumElectrodeRows;
@@ -99,12 +100,9 @@ void ElectrodeArray()
       }
 
    }
-   ComputeElectrodeVoltage();
 
-
-
-
-   return;
+   // ELECTRODE_ARRAY_ error code of ComputeElectrodeVoltage()
+   return ComputeElectrodeVoltage();
 }
 
 
@@ -142,11 +140,15 @@ void ElectrodeArray()
 // electrode are computed from the ElectrodeAndSpacerLookUp table.  The voltage
 // is stored in the 1st column of gElectrodeVoltage[][]
 //
+//  return value:
+//          ELECTRODE_ARRAY_OK          (0)
+//          ELECTRODE_ARRAY_MAP_BOUNDS  electrode outside the voltage map
+//
 // called by: ElectrodeArray()
 //
 // plk 6/8/2005
 //---------------------------------------------------------------------------
-void ComputeElectrodeVoltage()
+int ComputeElectrodeVoltage()
 {
    int theVtIsTooSmall = 1;
    int theComputeErr   = 0;
@@ -159,7 +161,7 @@ void ComputeElectrodeVoltage()
    {
         theComputeErr = ComputeElectrodeVoltageForVt();
 
-        if (theComputeErr)
+        if (theComputeErr == ELECTRODE_ARRAY_VT_TOO_LOW)
         {
            gVoltageT_V += gVoltageT_V*0.10;
            sprintf(theMessage,\
@@ -180,14 +182,16 @@ void ComputeElectrodeVoltage()
    // possibly bumped up by this procedure
    gVoltageT_V = theVoltageT_V;
 
+   return theComputeErr;
 }
 
 //---------------------------------------------------------------------------
 // ComputeArrayVoltageForVt()
 //
 //  return value:
-//          0    successful completion
-//          1    Vt is too low error.
+//          ELECTRODE_ARRAY_OK          (0)  successful completion
+//          ELECTRODE_ARRAY_VT_TOO_LOW  Vt is too low error.
+//          ELECTRODE_ARRAY_MAP_BOUNDS  see SetElectrodeVoltageMap()
 //
 // called by: ComputeElectrodeVoltage()
 //
@@ -246,7 +250,7 @@ int ComputeElectrodeVoltageForVt()
           //printf("   Voltage set to zero.\n");
           //theVoltage = 0.0;
 
-          return 1;
+          return ELECTRODE_ARRAY_VT_TOO_LOW;
        }
        else
        {
@@ -263,10 +267,7 @@ int ComputeElectrodeVoltageForVt()
 
   LogMessage(theMessage);
 
-  SetElectrodeVoltageMap();
-
-
-  return 0;
+  return SetElectrodeVoltageMap();
 }
 
 
@@ -276,13 +277,18 @@ int ComputeElectrodeVoltageForVt()
 // Sets the ElectrodeVoltageMap array based on the current "raw"
 // electrode data in gElectrodeVoltage
 //
+//  return value:
+//          ELECTRODE_ARRAY_OK          (0)
+//          ELECTRODE_ARRAY_MAP_BOUNDS  an electrode lies outside the map;
+//                                      the map is incomplete
+//
 // called by:
 //      ComputeElectrodeVoltage()
 //      SetElectrodeArrayVoltage()
 //
 // 3/28/2005
 //---------------------------------------------------------------------------
-void SetElectrodeVoltageMap()
+int SetElectrodeVoltageMap()
 {
   int    k;
   int    theMapRow;
@@ -308,14 +314,12 @@ void SetElectrodeVoltageMap()
        else
        {
           LogMessage("--- SetElectrodeVoltageMap:  Map array out of bounds");
-          while(!kbhit());
-          getch();
-          return;
+          return ELECTRODE_ARRAY_MAP_BOUNDS;
        }
 
   }
 
-  return;
+  return ELECTRODE_ARRAY_OK;
 }
 
 
@@ -333,11 +337,13 @@ void SetElectrodeVoltageMap()
 // and other elements of the ElectrodeAndSpacerLookUp table are set to
 // zero.
 //
+// Returns the error code of SetElectrodeVoltageMap().
+//
 // called by:  main()
 //
 // plk 3/27/2005
 //---------------------------------------------------------------------------
-void SetElectrodeArrayVoltage(double inVoltage)
+int SetElectrodeArrayVoltage(double inVoltage)
 {
   int k;
   int theIndex;
@@ -371,10 +377,7 @@ void SetElectrodeArrayVoltage(double inVoltage)
   printf("SetElectrodeArrayVoltage:  Set array to %f V.\n",inVoltage);
   LogMessage("SetElectrodeArrayVoltage executed.");
 
-  SetElectrodeVoltageMap();
-
-  return;
-
+  return SetElectrodeVoltageMap();
 }
 
 
@@ -36,6 +36,14 @@ enum Type { EL_GND      = -1, \
              INCLENTRY  = 9999};
 
 
+#define ELECTRODE_ARRAY_OK          0
+#define ELECTRODE_ARRAY_VT_TOO_LOW  1   // Vt too low for the membrane shape
+#define ELECTRODE_ARRAY_MAP_BOUNDS  2   // electrode outside the voltage map
+
+
+// The table is defined only in ElectrodeArray.c, which defines
+// ELECTRODEARRAY_TABLE before including this file.
+#ifdef ELECTRODEARRAY_TABLE
 int ElectrodeAndSpacerLookUp[2928][9] = \
 {{ 1 , 12 , -12 , 12 , -11 , 0 , 0 , 0 , -1 } ,
 { 2 , 9 , -9 , 9 , -8 , 3 , 21 , 3 , 1 } ,
@@ -2965,13 +2973,16 @@ int ElectrodeAndSpacerLookUp[2928][9] = \
 { 2926 , 27 , 25 , 27 , 25 , 9999 , 9999 , 9999 , 4 } ,
 { 2927 , 27 , 26 , 27 , 26 , 9999 , 9999 , 9999 , 4 } ,
 { 2928 , 27 , 27 , 27 , 27 , 9999 , 9999 , 9999 , 4 }};
+#else
+extern int ElectrodeAndSpacerLookUp[2928][9];
+#endif
 
 
-void ElectrodeArray();
-void ComputeElectrodeVoltage();
+int ElectrodeArray();
+int ComputeElectrodeVoltage();
 int ComputeElectrodeVoltageForVt();
-void SetElectrodeArrayVoltage(double inVoltage);
-void SetElectrodeVoltageMap();
+int SetElectrodeArrayVoltage(double inVoltage);
+int SetElectrodeVoltageMap();
 
 int ERow(int inWireListIndex);
 int ECol(int inWireListIndex);
@@ -0,0 +1,356 @@
+//---------------------------------------------------------------------------
+// Equilibrium.c
+//
+// Newton solver for the equilibrium membrane shape.  See Equilibrium.h
+//
+// Each iteration costs one pass over the electrode array (residual and
+// Jacobian together) plus the solution of an N x N linear system.  The
+// Newton step is damped by backtracking until the residual decreases and
+// the membrane stays clear of both electrodes.  The solver starts from
+// the shape coefficients passed in (warm start); a flat membrane is used
+// if that shape touches an electrode.
+//---------------------------------------------------------------------------
+#include "Equilibrium.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <math.h>
+
+
+#define EQUILIBRIUM_MAX_BACKTRACK  12
+
+
+extern int      gFastStabilityDim;
+extern int      gFastStabilityNumElectrodes;
+extern double **gBasisShape;
+extern double  *gBasisDel2Factor;
+extern double   gBasisElectrodeArea_MKS;
+
+extern int      gNumElectrodes;
+extern double  *gExpansionCoeff_MKS;
+
+
+
+//---------------------------------------------------------------------------
+// EquilibriumResidual
+//
+// Computes the modal residual R[0...N-1] of the membrane equation for the
+// shape of the device and, if outJacobian is not NULL, its Jacobian
+// [0...N-1][0...N-1].  Returns the squared norm of the residual, or -1 if
+// the membrane touches either electrode at some electrode pixel.
+//---------------------------------------------------------------------------
+double EquilibriumResidual(DeviceConfig *inConfig, \
+                           double *outResidual, \
+                           double **outJacobian)
+{
+   int    i,j,k;
+   int    theDim;
+   double theShape_MKS;
+   double theGapA_MKS;
+   double theGapT_MKS;
+   double theVoltage;
+   double theVoltageT_V;
+   double thePressure;
+   double theFDS_MKS;
+   double theNorm;
+   double e_0 = 8.85E-12;
+
+   theDim = gFastStabilityDim;
+   theVoltageT_V = inConfig->VoltageT_V;
+
+   for (j=0;j<theDim;j++)
+   {
+      outResidual[j] = inConfig->MembraneTension_NByM*gBasisDel2Factor[j]* \
+                       inConfig->ExpansionCoeff_MKS[j];
+
+      if (outJacobian != NULL)
+         for (i=0;i<theDim;i++)
+            outJacobian[j][i] = (i == j) ? \
+               inConfig->MembraneTension_NByM*gBasisDel2Factor[j] : 0.0;
+   }
+
+   for (k=0;k<gFastStabilityNumElectrodes;k++)
+   {
+      theShape_MKS = MembraneShapeAtElectrode_MKS(inConfig,k);
+      theGapA_MKS = inConfig->DistA_um*1e-6 - theShape_MKS;
+      theGapT_MKS = inConfig->DistT_um*1e-6 + theShape_MKS;
+
+      if (theGapA_MKS <= 0 || theGapT_MKS <= 0) return -1;
+
+      theVoltage = (double) inConfig->ElectrodeVoltage_V[k];
+
+      thePressure = e_0*theVoltage*theVoltage/(2*theGapA_MKS*theGapA_MKS) - \
+                    e_0*theVoltageT_V*theVoltageT_V/(2*theGapT_MKS*theGapT_MKS);
+      thePressure *= gBasisElectrodeArea_MKS;
+
+      for (j=0;j<theDim;j++)
+         outResidual[j] -= thePressure*gBasisShape[j][k];
+
+      if (outJacobian != NULL)
+      {
+         // electrostatic weight function, see WeightFnForSum_MKS()
+         theFDS_MKS = e_0*theVoltage*theVoltage/ \
+                      (theGapA_MKS*theGapA_MKS*theGapA_MKS) + \
+                      e_0*theVoltageT_V*theVoltageT_V/ \
+                      (theGapT_MKS*theGapT_MKS*theGapT_MKS);
+         theFDS_MKS *= gBasisElectrodeArea_MKS;
+
+         for (j=0;j<theDim;j++)
+         {
+            if (gBasisShape[j][k] == 0.0) continue;
+            for (i=j;i<theDim;i++)
+               outJacobian[j][i] -= theFDS_MKS* \
+                                    gBasisShape[j][k]*gBasisShape[i][k];
+         }
+      }
+   }
+
+   if (outJacobian != NULL)
+      for (j=0;j<theDim;j++)
+         for (i=0;i<j;i++)
+            outJacobian[j][i] = outJacobian[i][j];
+
+   theNorm = 0.0;
+   for (j=0;j<theDim;j++)
+      theNorm += outResidual[j]*outResidual[j];
+
+   return theNorm;
+}
+
+
+//---------------------------------------------------------------------------
+// SolveLinearSystem
+//
+// Solves ioA x = ioB by gaussian elimination with partial pivoting.
+// ioA [0...N-1][0...N-1] is destroyed; the solution replaces ioB.
+// Returns 1 if the matrix is singular, otherwise 0.
+//---------------------------------------------------------------------------
+int SolveLinearSystem(double **ioA, double *ioB, int inDim)
+{
+   int     i,j,k;
+   int     thePivot;
+   double  theFactor;
+   double  theMax;
+   double  theScale;
+   double *theRow;
+
+   theScale = 0.0;
+   for (i=0;i<inDim;i++)
+      for (j=0;j<inDim;j++)
+         if (fabs(ioA[i][j]) > theScale) theScale = fabs(ioA[i][j]);
+
+   for (k=0;k<inDim;k++)
+   {
+      thePivot = k;
+      theMax = fabs(ioA[k][k]);
+      for (i=k+1;i<inDim;i++)
+      {
+         if (fabs(ioA[i][k]) > theMax)
+         {
+            theMax = fabs(ioA[i][k]);
+            thePivot = i;
+         }
+      }
+
+      if (theMax <= 1e-12*theScale) return 1;
+
+      if (thePivot != k)
+      {
+         theRow = ioA[k]; ioA[k] = ioA[thePivot]; ioA[thePivot] = theRow;
+         theFactor = ioB[k]; ioB[k] = ioB[thePivot]; ioB[thePivot] = theFactor;
+      }
+
+      for (i=k+1;i<inDim;i++)
+      {
+         theFactor = ioA[i][k]/ioA[k][k];
+         for (j=k;j<inDim;j++)
+            ioA[i][j] -= theFactor*ioA[k][j];
+         ioB[i] -= theFactor*ioB[k];
+      }
+   }
+
+   for (k=inDim-1;k>=0;k--)
+   {
+      for (j=k+1;j<inDim;j++)
+         ioB[k] -= ioA[k][j]*ioB[j];
+      ioB[k] /= ioA[k][k];
+   }
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// SolveDeviceEquilibrium
+//
+// Solves for the equilibrium expansion coefficients of the device, given
+// its electrode voltages and Vt.  ioConfig->ExpansionCoeff_MKS holds the
+// starting shape on entry, and the solution on return.  Iterations stop
+// when the full Newton step, the estimated distance to the solution,
+// changes no mode's peak deformation by more than inTolerance_um.  The
+// step along it that decreased the residual is then applied; if none
+// did, the residual is at roundoff level and the shape is kept.
+//
+//  return value:
+//          EQUILIBRIUM_CONVERGED      (0)
+//          EQUILIBRIUM_NOT_CONVERGED  inMaxIterations reached, or no step
+//                                     along the Newton direction decreases
+//                                     the residual
+//          EQUILIBRIUM_SINGULAR       singular Jacobian
+//          EQUILIBRIUM_PULL_IN        no step keeps the membrane clear of
+//                                     the electrodes
+//---------------------------------------------------------------------------
+int SolveDeviceEquilibrium(DeviceConfig *ioConfig, \
+                           int inMaxIterations, \
+                           double inTolerance_um)
+{
+   int      j;
+   int      theIter;
+   int      theBacktrack;
+   int      theDim;
+   int      theResult;
+   double   theNorm;
+   double   theTrialNorm;
+   double   theLambda;
+   double   theNewtonChange_um;
+   double  *theA;
+   double  *theResidual;
+   double  *theStep;
+   double **theJacobian;
+
+   theDim = gFastStabilityDim;
+
+   theA = dvector(0,theDim-1);
+   theResidual = dvector(0,theDim-1);
+   theStep = dvector(0,theDim-1);
+   theJacobian = dmatrix(0,theDim-1,0,theDim-1);
+
+   theNorm = EquilibriumResidual(ioConfig,theResidual,theJacobian);
+   if (theNorm < 0)
+   {
+      // warm start touches an electrode:  start from a flat membrane
+      for (j=0;j<theDim;j++)
+         ioConfig->ExpansionCoeff_MKS[j] = 0.0;
+      theNorm = EquilibriumResidual(ioConfig,theResidual,theJacobian);
+   }
+
+   theResult = EQUILIBRIUM_NOT_CONVERGED;
+   if (theNorm < 0) theResult = EQUILIBRIUM_PULL_IN;
+
+   for (theIter=0;theIter<inMaxIterations && theNorm >= 0;theIter++)
+   {
+      for (j=0;j<theDim;j++)
+         theStep[j] = -theResidual[j];
+
+      if (SolveLinearSystem(theJacobian,theStep,theDim))
+      {
+         theResult = EQUILIBRIUM_SINGULAR;
+         break;
+      }
+
+      for (j=0;j<theDim;j++)
+         theA[j] = ioConfig->ExpansionCoeff_MKS[j];
+
+      // peak deformation of the full Newton step
+      theNewtonChange_um = 0.0;
+      for (j=0;j<theDim;j++)
+         if (fabs(theStep[j])*ModalPeakAmplitude_MKS(j)*1e6 > \
+             theNewtonChange_um)
+            theNewtonChange_um = fabs(theStep[j])* \
+                                 ModalPeakAmplitude_MKS(j)*1e6;
+
+      // backtracking line search on the squared residual norm
+      theLambda = 1.0;
+      for (theBacktrack=0;theBacktrack<EQUILIBRIUM_MAX_BACKTRACK;theBacktrack++)
+      {
+         for (j=0;j<theDim;j++)
+            ioConfig->ExpansionCoeff_MKS[j] = theA[j] + theLambda*theStep[j];
+
+         theTrialNorm = EquilibriumResidual(ioConfig,theResidual,NULL);
+         if (theTrialNorm >= 0 && theTrialNorm < theNorm) break;
+
+         theLambda *= 0.5;
+      }
+
+      if (theBacktrack == EQUILIBRIUM_MAX_BACKTRACK)
+      {
+         // no step decreased the residual:  keep the last shape.  This
+         // occurs when the residual is already at roundoff level.
+         for (j=0;j<theDim;j++)
+            ioConfig->ExpansionCoeff_MKS[j] = theA[j];
+
+         if (theNewtonChange_um < inTolerance_um)
+            theResult = EQUILIBRIUM_CONVERGED;
+         else if (theTrialNorm < 0)
+            theResult = EQUILIBRIUM_PULL_IN;
+         else
+            theResult = EQUILIBRIUM_NOT_CONVERGED;
+         break;
+      }
+
+      if (theNewtonChange_um < inTolerance_um)
+      {
+         theResult = EQUILIBRIUM_CONVERGED;
+         break;
+      }
+
+      theNorm = EquilibriumResidual(ioConfig,theResidual,theJacobian);
+   }
+
+   free_dvector(theA,0,theDim-1);
+   free_dvector(theResidual,0,theDim-1);
+   free_dvector(theStep,0,theDim-1);
+   free_dmatrix(theJacobian,0,theDim-1,0,theDim-1);
+
+   return theResult;
+}
+
+
+//---------------------------------------------------------------------------
+// SolveMembraneEquilibrium
+//
+// Sets gExpansionCoeff_MKS to the equilibrium membrane shape for the
+// current electrode voltages (gElectrodeVoltage) and gVoltageT_V,
+// starting from the current shape.  The shape is left unchanged if the
+// solver fails.
+//
+// Returns one of the EQUILIBRIUM_ codes (see SolveDeviceEquilibrium).
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int SolveMembraneEquilibrium()
+{
+   int          j;
+   int          theResult;
+   double      *theStart;
+   DeviceConfig theConfig;
+   char         theMessage[100];
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   GetGlobalDeviceConfig(&theConfig);
+
+   theStart = dvector(0,gFastStabilityDim-1);
+   for (j=0;j<gFastStabilityDim;j++)
+      theStart[j] = theConfig.ExpansionCoeff_MKS[j];
+
+   theResult = SolveDeviceEquilibrium(&theConfig,50,1e-6);
+
+   if (theResult != EQUILIBRIUM_CONVERGED)
+      for (j=0;j<gFastStabilityDim;j++)
+         theConfig.ExpansionCoeff_MKS[j] = theStart[j];
+
+   free_dvector(theStart,0,gFastStabilityDim-1);
+   free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+
+   sprintf(theMessage,"--- SolveMembraneEquilibrium:  result %d ---",\
+           theResult);
+   LogMessage(theMessage);
+   LogDVector(gExpansionCoeff_MKS,0,gFastStabilityDim-1,\
+              "Membrane Shape Coeffs, MKS");
+
+   return theResult;
+}
@@ -0,0 +1,39 @@
+//---------------------------------------------------------------------------
+// Equilibrium.h
+//
+// Self consistent membrane shape for given electrode voltages.  The
+// membrane equation used by ComputeElectrodeVoltageForVt(),
+//
+//    T * del2(xi)  =  P_T - P_A,      P = e_0 * V^2 / (2 * gap^2)
+//
+// is projected onto the membrane eigenfunctions, giving the residual
+//
+//    R_j(a)  =  T X_j^2/R^2 a_j  -  Sum (P_A - P_T)_k zeta_jk DS
+//
+// which is solved for the expansion coefficients a_j by Newton's method.
+// Since d(P_A - P_T)/d xi is the electrostatic weight function F_k, the
+// Jacobian dR_j/da_i is the Omega matrix, assembled over the shape basis.
+//---------------------------------------------------------------------------
+#ifndef EQUILIBRIUM_H
+#define EQUILIBRIUM_H
+
+
+#include "FastStability.h"
+
+
+#define EQUILIBRIUM_CONVERGED      0
+#define EQUILIBRIUM_NOT_CONVERGED  1
+#define EQUILIBRIUM_SINGULAR       2    // Jacobian is singular
+#define EQUILIBRIUM_PULL_IN        3    // no step keeps the gaps open
+
+
+double EquilibriumResidual(DeviceConfig *inConfig, \
+                           double *outResidual, \
+                           double **outJacobian);
+int SolveDeviceEquilibrium(DeviceConfig *ioConfig, \
+                           int inMaxIterations, \
+                           double inTolerance_um);
+int SolveMembraneEquilibrium();
+
+
+#endif
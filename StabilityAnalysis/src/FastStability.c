@@ -0,0 +1,679 @@
+//---------------------------------------------------------------------------
+// FastStability.c
+//
+// Reentrant computation of the Omega matrix and its minimum eigenvalue.
+// See FastStability.h
+//
+// The membrane eigenfunctions are tabulated at the center of each
+// electrode pixel, in rectangular form:
+//
+//    gBasisCos[j][k]  =  |zeta_j(r_k)| * cos(v_j * phi_k)
+//    gBasisSin[j][k]  =  |zeta_j(r_k)| * sin(v_j * phi_k)
+//
+// so that the matrix element sum of RealMatrixASum() becomes
+//
+//               N-1
+//    A_jj'   =  Sum F_k * ( C_jk*C_j'k + S_jk*S_j'k ) * DS
+//               k=0
+//
+// The membrane shape and its laplacian at each electrode are computed
+// from the eigenfunction magnitudes, exactly as in
+// ExpansionInEFuncsDeformation_MKS() and Del2Expansion_MKS().
+//---------------------------------------------------------------------------
+#include "FastStability.h"
+#include "DiskCubature.h"
+#include "MatrixUtils.h"
+#include "BesselJZeros.h"
+#include "Eigenfunc.h"
+#include "ElectrodeArray.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <math.h>
+
+
+#define MAX_VT_INCREASES 100
+
+
+int       gFastStabilityDim = 0;          // eigenfunctions tabulated
+int       gFastStabilityNumElectrodes = 0;
+double    gFastStabilityRadius_mm = 0.0;
+float     gFastStabilityElectrodeWidth_um = 0.0;
+float     gFastStabilityElectrodeSpc_um = 0.0;
+int       gFastStabilityGeneration = 0;   // incremented by InitFastStability
+
+double  **gBasisCos;        // [0...N-1][0...Ne-1]
+double  **gBasisSin;        // [0...N-1][0...Ne-1]
+double  **gBasisShape;      // |zeta_j(r_k)| under the membrane, else 0
+double   *gBasisDel2Factor; // X_j^2 / R^2
+double   *gBasisPeak_MKS;   // normalization (peak value) of zeta_j
+double    gBasisElectrodeArea_MKS;
+int      *gElectrodeUnderMembrane;  // 1 if electrode center r < R
+
+
+extern int      gNumberOfEigenFunctions;
+extern int      gNumElectrodes;
+extern float  **gElectrodeVoltage;
+extern float    gElectrodeWidth_um;
+extern float    gElectrodeSpc_um;
+
+extern double   gMembraneTension_NByM;
+extern double   gMembraneRadius_mm;
+extern double   gVoltageT_V;
+extern double   gDistT_um;
+extern double   gDistA_um;
+extern double  *gExpansionCoeff_MKS;
+
+extern int      gMatrixACubature;
+extern int      gMatrixACubatureNumR;
+extern int      gMatrixACubatureNumPhi;
+
+
+
+//---------------------------------------------------------------------------
+// InitFastStability
+//
+// Tabulates membrane eigenfunctions at the electrode pixel centers for
+// the current number of eigenfunctions, membrane radius and electrode
+// array (pixel count, width and spacing), and the disk cubature rule
+// selected by SetMatrixACubature().  Previously tabulated data are
+// released.
+//
+// called by:  InitStabilityEngine(), and by the entry points of the
+//             stability units when FastStabilityIsCurrent() is 0
+//---------------------------------------------------------------------------
+void InitFastStability()
+{
+   int    j,k;
+   int    theIndex;
+   double theR_MKS;
+   double thePhi_Rad;
+   double theMagn_MKS;
+   double thePhase_Rad;
+   double theMembraneRadius_MKS;
+   double theElectrodePitch_MKS;
+   char   theMessage[100];
+
+
+   if (gFastStabilityDim > 0)
+   {
+      free_dmatrix(gBasisCos,0,gFastStabilityDim-1,\
+                             0,gFastStabilityNumElectrodes-1);
+      free_dmatrix(gBasisSin,0,gFastStabilityDim-1,\
+                             0,gFastStabilityNumElectrodes-1);
+      free_dmatrix(gBasisShape,0,gFastStabilityDim-1,\
+                               0,gFastStabilityNumElectrodes-1);
+      free_dvector(gBasisDel2Factor,0,gFastStabilityDim-1);
+      free_dvector(gBasisPeak_MKS,0,gFastStabilityDim-1);
+      free_ivector(gElectrodeUnderMembrane,0,gFastStabilityNumElectrodes-1);
+   }
+
+   gFastStabilityDim = gNumberOfEigenFunctions;
+   gFastStabilityNumElectrodes = gNumElectrodes;
+   gFastStabilityRadius_mm = gMembraneRadius_mm;
+   gFastStabilityElectrodeWidth_um = gElectrodeWidth_um;
+   gFastStabilityElectrodeSpc_um = gElectrodeSpc_um;
+   gFastStabilityGeneration++;
+
+   gBasisCos   = dmatrix(0,gFastStabilityDim-1,0,gNumElectrodes-1);
+   gBasisSin   = dmatrix(0,gFastStabilityDim-1,0,gNumElectrodes-1);
+   gBasisShape = dmatrix(0,gFastStabilityDim-1,0,gNumElectrodes-1);
+   gBasisDel2Factor = dvector(0,gFastStabilityDim-1);
+   gBasisPeak_MKS   = dvector(0,gFastStabilityDim-1);
+   gElectrodeUnderMembrane = ivector(0,gNumElectrodes-1);
+
+   theMembraneRadius_MKS = gMembraneRadius_mm * 1e-3;
+
+   theElectrodePitch_MKS = (double) gElectrodeWidth_um*1e-6 + \
+                           (double) gElectrodeSpc_um*1e-6;
+   gBasisElectrodeArea_MKS = theElectrodePitch_MKS*theElectrodePitch_MKS;
+
+   for (j=0;j<gFastStabilityDim;j++)
+   {
+      gBasisDel2Factor[j] = BesselJZero(j)*BesselJZero(j)/ \
+                            (theMembraneRadius_MKS*theMembraneRadius_MKS);
+
+      // eigenfunction normalization, see Eigenfunc().  This is the
+      // value of zeta_j at r=0 for v=0 modes.
+      gBasisPeak_MKS[j] = 1.0/(theMembraneRadius_MKS*sqrt(3.1415926535)* \
+                          fabs(BesselJn(BesselVIndex(j)+1,BesselJZero(j))));
+   }
+
+   for (k=0;k<gNumElectrodes;k++)
+   {
+       theIndex = (int) gElectrodeVoltage[k][0];
+       theR_MKS = (double) ERCenter_MKS(theIndex);
+       thePhi_Rad = (double) EPhiCenter_rad(theIndex);
+
+       gElectrodeUnderMembrane[k] = (theR_MKS < theMembraneRadius_MKS);
+
+       for (j=0;j<gFastStabilityDim;j++)
+       {
+          Eigenfunc(j,theR_MKS,thePhi_Rad,&theMagn_MKS,&thePhase_Rad);
+
+          gBasisCos[j][k] = theMagn_MKS*cos(thePhase_Rad);
+          gBasisSin[j][k] = theMagn_MKS*sin(thePhase_Rad);
+
+          if (theR_MKS < theMembraneRadius_MKS)
+             gBasisShape[j][k] = theMagn_MKS;
+          else
+             gBasisShape[j][k] = 0.0;
+       }
+   }
+
+   sprintf(theMessage,\
+           "InitFastStability:  tabulated %d eigenfunctions at %d electrodes",\
+           gFastStabilityDim, gFastStabilityNumElectrodes);
+   LogMessage(theMessage);
+
+   // the A matrix rule selected by SetMatrixACubature()
+   if (gMatrixACubature)
+      InitDiskCubature(gMatrixACubatureNumR,gMatrixACubatureNumPhi);
+
+   return;
+}
+
+
+//---------------------------------------------------------------------------
+// FastStabilityIsCurrent
+//
+// Returns 1 if the tabulated eigenfunctions correspond to the current
+// simulation parameters, 0 if InitFastStability() must be called.
+//---------------------------------------------------------------------------
+int FastStabilityIsCurrent()
+{
+   if (gFastStabilityDim != gNumberOfEigenFunctions) return 0;
+   if (gFastStabilityNumElectrodes != gNumElectrodes) return 0;
+   if (gFastStabilityRadius_mm != gMembraneRadius_mm) return 0;
+   if (gFastStabilityElectrodeWidth_um != gElectrodeWidth_um) return 0;
+   if (gFastStabilityElectrodeSpc_um != gElectrodeSpc_um) return 0;
+
+   return 1;
+}
+
+
+//---------------------------------------------------------------------------
+// GetGlobalDeviceConfig
+//
+// Fills a DeviceConfig with the current global simulation parameters.
+// ExpansionCoeff_MKS points to the global array (it is not copied).
+// ElectrodeVoltage_V is allocated here with vector(0,gNumElectrodes-1);
+// caller must free it with free_vector().
+//---------------------------------------------------------------------------
+void GetGlobalDeviceConfig(DeviceConfig *outConfig)
+{
+   int k;
+
+   outConfig->VoltageT_V           = gVoltageT_V;
+   outConfig->DistT_um             = gDistT_um;
+   outConfig->DistA_um             = gDistA_um;
+   outConfig->MembraneTension_NByM = gMembraneTension_NByM;
+   outConfig->ExpansionCoeff_MKS   = gExpansionCoeff_MKS;
+
+   // gElectrodeVoltage is an N x 2 array; voltages are in column 1,
+   // so they are gathered into a contiguous vector here.
+   outConfig->ElectrodeVoltage_V   = vector(0,gNumElectrodes-1);
+   for (k=0;k<gNumElectrodes;k++)
+      outConfig->ElectrodeVoltage_V[k] = gElectrodeVoltage[k][1];
+}
+
+
+//---------------------------------------------------------------------------
+// SetDeviceArrayVoltage
+//
+// Sets all electrodes underneath the membrane to inVoltage, and all others
+// to zero.  Same as SetElectrodeArrayVoltage().
+//---------------------------------------------------------------------------
+void SetDeviceArrayVoltage(DeviceConfig *ioConfig, double inVoltage)
+{
+   int k;
+
+   for (k=0;k<gFastStabilityNumElectrodes;k++)
+   {
+      if (gElectrodeUnderMembrane[k])
+         ioConfig->ElectrodeVoltage_V[k] = (float) inVoltage;
+      else
+         ioConfig->ElectrodeVoltage_V[k] = 0;
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// MembraneShapeAtElectrode_MKS
+//
+// Membrane deformation xi at the center of electrode k.  Same as
+// ExpansionInEFuncsDeformation_MKS(r_k, phi_k).
+//---------------------------------------------------------------------------
+double MembraneShapeAtElectrode_MKS(DeviceConfig *inConfig, int inK)
+{
+   int    j;
+   double theSum;
+
+   theSum = 0.0;
+   for (j=0;j<gFastStabilityDim;j++)
+      theSum += inConfig->ExpansionCoeff_MKS[j]*gBasisShape[j][inK];
+
+   return theSum;
+}
+
+
+//---------------------------------------------------------------------------
+// Del2ShapeAtElectrode_MKS
+//
+// Laplacian of the membrane deformation at the center of electrode k.
+// Same as Del2Expansion_MKS(r_k, phi_k).
+//---------------------------------------------------------------------------
+double Del2ShapeAtElectrode_MKS(DeviceConfig *inConfig, int inK)
+{
+   int    j;
+   double theSum;
+
+   theSum = 0.0;
+   for (j=0;j<gFastStabilityDim;j++)
+      theSum += inConfig->ExpansionCoeff_MKS[j]* \
+                gBasisDel2Factor[j]*gBasisShape[j][inK];
+
+   return -theSum;
+}
+
+
+//---------------------------------------------------------------------------
+// ModalPeakAmplitude_MKS
+//
+// Normalization of membrane eigenfunction j, i.e. the peak deformation
+// produced by a unit expansion coefficient for v=0 modes.  The empirical
+// factor 1.449 in SetMembraneShape_BesselJZero() is 1e-2 times this
+// value for j=0.
+//---------------------------------------------------------------------------
+double ModalPeakAmplitude_MKS(int inJ)
+{
+   return gBasisPeak_MKS[inJ];
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeDeviceElectrodeVoltageForVt
+//
+// Computes the voltage on each electrode required to produce the membrane
+// shape of the device, for the specified transparent electrode voltage.
+// Same equation as ComputeElectrodeVoltageForVt(); results are written
+// to ioConfig->ElectrodeVoltage_V.
+//
+//  return value:
+//          0    successful completion
+//          1    Vt is too low error.
+//
+// called by: ComputeDeviceElectrodeVoltage()
+//---------------------------------------------------------------------------
+int ComputeDeviceElectrodeVoltageForVt(DeviceConfig *ioConfig,
+                                       double inVoltageT_V)
+{
+   int    k;
+   double theShape_MKS;
+   double theSqrtTerm;
+   double theVtTerm;
+   double theD2Term;
+   double theNumer;
+   double theDenom;
+   double e_0 = 8.85E-12;
+
+   for (k=0;k<gFastStabilityNumElectrodes;k++)
+   {
+       theShape_MKS = MembraneShapeAtElectrode_MKS(ioConfig,k);
+
+       theNumer = ioConfig->DistA_um*1e-6 - theShape_MKS;
+       theNumer *= theNumer;
+       theNumer *= 2;
+       theNumer = theNumer/e_0;
+
+       theDenom = ioConfig->DistT_um*1e-6 + theShape_MKS;
+       theDenom *= theDenom;
+       theDenom *= 2;
+       theVtTerm = e_0*inVoltageT_V*inVoltageT_V/theDenom;
+
+       theD2Term = Del2ShapeAtElectrode_MKS(ioConfig,k);
+       theD2Term *= ioConfig->MembraneTension_NByM;
+
+       theSqrtTerm = theNumer*(theVtTerm - theD2Term);
+
+       if (theSqrtTerm < 0) return 1;
+
+       ioConfig->ElectrodeVoltage_V[k] = (float) sqrt(theSqrtTerm);
+   }
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeDeviceElectrodeVoltage
+//
+// Self-consistent electrode voltages for the membrane shape of the device.
+// As in ComputeElectrodeVoltage(), if Vt is too low to produce the shape
+// it is increased in 10% steps for the purpose of computing the array
+// voltages only; ioConfig->VoltageT_V is left unchanged.
+//
+//  return value:
+//          0    successful completion
+//          1    no physical solution was found
+//
+// called by: BuildStabilityEnvelope()
+//---------------------------------------------------------------------------
+int ComputeDeviceElectrodeVoltage(DeviceConfig *ioConfig)
+{
+   int    i;
+   double theVoltageT_V;
+
+   theVoltageT_V = ioConfig->VoltageT_V;
+
+   for (i=0;i<MAX_VT_INCREASES;i++)
+   {
+        if (!ComputeDeviceElectrodeVoltageForVt(ioConfig,theVoltageT_V))
+           return 0;
+
+        // Vt of zero cannot be increased in proportion
+        if (theVoltageT_V <= 0) return 1;
+
+        theVoltageT_V += theVoltageT_V*0.10;
+   }
+
+   return 1;
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeDeviceShapeForVoltages
+//
+// Estimates the membrane shape produced by the electrode voltages of the
+// device, as an expansion in the first inNumModes eigenfunctions.  The
+// remaining expansion coefficients are set to zero.  The membrane equation
+// used in ComputeDeviceElectrodeVoltageForVt(),
+//
+//    T * del2(xi)  =  P_T - P_A,      P = e_0 * V^2 / (2 * gap^2)
+//
+// is projected onto each eigenfunction.  The dependence of the pressure
+// on the gap is handled by inNumIterations fixed point iterations,
+// starting from a flat membrane.
+//
+// NOTE:  ioConfig->ExpansionCoeff_MKS is overwritten.
+//---------------------------------------------------------------------------
+void ComputeDeviceShapeForVoltages(DeviceConfig *ioConfig,
+                                   int inNumModes,
+                                   int inNumIterations)
+{
+   int    i,j,k;
+   double theShape_MKS;
+   double theGap_MKS;
+   double theVoltage;
+   double thePressure;
+   double theProjection[FAST_STABILITY_MAX_DIM];
+   double e_0 = 8.85E-12;
+
+   if (inNumModes > gFastStabilityDim) inNumModes = gFastStabilityDim;
+   if (inNumModes > FAST_STABILITY_MAX_DIM) inNumModes = FAST_STABILITY_MAX_DIM;
+
+   for (j=0;j<gFastStabilityDim;j++)
+      ioConfig->ExpansionCoeff_MKS[j] = 0.0;
+
+   for (i=0;i<inNumIterations;i++)
+   {
+      for (j=0;j<inNumModes;j++)
+         theProjection[j] = 0.0;
+
+      for (k=0;k<gFastStabilityNumElectrodes;k++)
+      {
+         theShape_MKS = MembraneShapeAtElectrode_MKS(ioConfig,k);
+         theVoltage = (double) ioConfig->ElectrodeVoltage_V[k];
+
+         theGap_MKS = ioConfig->DistA_um*1e-6 - theShape_MKS;
+         thePressure = e_0*theVoltage*theVoltage/(2*theGap_MKS*theGap_MKS);
+
+         theGap_MKS = ioConfig->DistT_um*1e-6 + theShape_MKS;
+         thePressure -= e_0*ioConfig->VoltageT_V*ioConfig->VoltageT_V/ \
+                        (2*theGap_MKS*theGap_MKS);
+
+         for (j=0;j<inNumModes;j++)
+            theProjection[j] += thePressure*gBasisShape[j][k];
+      }
+
+      for (j=0;j<inNumModes;j++)
+         ioConfig->ExpansionCoeff_MKS[j] = \
+                      theProjection[j]*gBasisElectrodeArea_MKS/ \
+                      (ioConfig->MembraneTension_NByM*gBasisDel2Factor[j]);
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeDeviceMatrixA
+//
+// Computes the A matrix [0...N-1][0...N-1] of the device:  the sum over
+// the electrodes, ComputeDeviceMatrixASum() (default), or the disk
+// cubature, ComputeDeviceMatrixACubature(), if selected with
+// SetMatrixACubature().
+//---------------------------------------------------------------------------
+void ComputeDeviceMatrixA(DeviceConfig *inConfig, double **outMatrixA)
+{
+   if (gMatrixACubature)
+      ComputeDeviceMatrixACubature(inConfig,outMatrixA,NULL);
+   else
+      ComputeDeviceMatrixASum(inConfig,outMatrixA);
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeDeviceMatrixASum
+//
+// Computes the A matrix [0...N-1][0...N-1] of the device as a sum over
+// the electrodes of the array.  Same as ComputeMatrixASum().
+//---------------------------------------------------------------------------
+void ComputeDeviceMatrixASum(DeviceConfig *inConfig, double **outMatrixA)
+{
+   int    i,j,k;
+   int    theDim;
+   double theShape_MKS;
+   double theDenom_MKS;
+   double theVoltage;
+   double theVoltageT_V;
+   double theDistA_MKS;
+   double theDistT_MKS;
+   double theFDS_MKS;
+   double e_0 = 8.85E-12;
+
+   theDim = gFastStabilityDim;
+   theVoltageT_V = inConfig->VoltageT_V;
+   theDistA_MKS = inConfig->DistA_um*1e-6;
+   theDistT_MKS = inConfig->DistT_um*1e-6;
+
+   for (i=0;i<theDim;i++)
+      for (j=0;j<theDim;j++)
+         outMatrixA[i][j] = 0.0;
+
+   for (k=0;k<gFastStabilityNumElectrodes;k++)
+   {
+       theShape_MKS = MembraneShapeAtElectrode_MKS(inConfig,k);
+       theVoltage = (double) inConfig->ElectrodeVoltage_V[k];
+
+       // electrostatic weight function, see WeightFnForSum_MKS()
+       theDenom_MKS = theDistA_MKS - theShape_MKS;
+       theFDS_MKS = e_0*theVoltage*theVoltage/ \
+                    (theDenom_MKS*theDenom_MKS*theDenom_MKS);
+
+       theDenom_MKS = theDistT_MKS + theShape_MKS;
+       theFDS_MKS += e_0*theVoltageT_V*theVoltageT_V/ \
+                     (theDenom_MKS*theDenom_MKS*theDenom_MKS);
+
+       theFDS_MKS *= gBasisElectrodeArea_MKS;
+
+       // A is symmetric:  accumulate the upper triangle only
+       for (i=0;i<theDim;i++)
+       {
+          for (j=i;j<theDim;j++)
+          {
+             outMatrixA[i][j] += theFDS_MKS* \
+                (gBasisCos[i][k]*gBasisCos[j][k] + \
+                 gBasisSin[i][k]*gBasisSin[j][k]);
+          }
+       }
+   }
+
+   for (i=0;i<theDim;i++)
+      for (j=0;j<i;j++)
+         outMatrixA[i][j] = outMatrixA[j][i];
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeDeviceOmega
+//
+// Computes the Omega matrix [1...N][1...N] of the device.  See
+// ComputeOmegaMatrix() for the definition.
+//---------------------------------------------------------------------------
+void ComputeDeviceOmega(DeviceConfig *inConfig, double **outOmega)
+{
+   int     i,j;
+   int     theDim;
+   double  theDiag_MKS;
+   double **theMatrixA;
+
+   theDim = gFastStabilityDim;
+   theMatrixA = dmatrix(0,theDim-1,0,theDim-1);
+
+   ComputeDeviceMatrixA(inConfig,theMatrixA);
+
+   // realMatrixA is indexed 0...N-1, but Omega must
+   // be indexed 1...N for later NR routines.
+   for (i=0;i<theDim;i++)
+   {
+      for (j=0;j<theDim;j++)
+      {
+         theDiag_MKS = 0.0;
+         if (i == j)
+            theDiag_MKS = inConfig->MembraneTension_NByM*gBasisDel2Factor[j];
+
+         outOmega[i+1][j+1] = theDiag_MKS - theMatrixA[i][j];
+      }
+   }
+
+   free_dmatrix(theMatrixA,0,theDim-1,0,theDim-1);
+}
+
+
+//---------------------------------------------------------------------------
+// DeviceMinEigenpair
+//
+// Returns the minimum eigenvalue of the Omega matrix of the device.  If
+// this eigenvalue is greater than zero, the device is stable.  If
+// outEigenVector is not NULL, the corresponding normalized eigenvector
+// is returned in outEigenVector[0...N-1].  The eigenvalue is returned at
+// the precision of OmegaScalar.
+//
+// NOTE:  the eigenvalues returned by DiagonalizeOmegaMatrix() are not sorted,
+// so the minimum is found explicitly here.
+//---------------------------------------------------------------------------
+OmegaScalar DeviceMinEigenpair(DeviceConfig *inConfig, double *outEigenVector)
+{
+   int      i,j;
+   int      theDim;
+   int      theMinIndex;
+   OmegaScalar    theMin;
+   double       **theOmega;
+   OmegaScalar  **theWorkOmega;
+   OmegaScalar  **theEigenVector;
+   OmegaScalar   *theEigenValue;
+
+   theDim = gFastStabilityDim;
+
+   theOmega = dmatrix(1,theDim,1,theDim);
+   theWorkOmega = omega_matrix(1,theDim,1,theDim);
+   theEigenVector = omega_matrix(1,theDim,1,theDim);
+   theEigenValue = omega_vector(1,theDim);
+
+   ComputeDeviceOmega(inConfig,theOmega);
+
+   for (i=1;i<=theDim;i++)
+      for (j=1;j<=theDim;j++)
+         theWorkOmega[i][j] = (OmegaScalar) theOmega[i][j];
+
+   DiagonalizeOmegaMatrix(theWorkOmega,theDim,theEigenValue,theEigenVector);
+
+   theMinIndex = 1;
+   for (i=2;i<=theDim;i++)
+      if (theEigenValue[i] < theEigenValue[theMinIndex]) theMinIndex = i;
+   theMin = theEigenValue[theMinIndex];
+
+   // eigenvectors are the columns of theEigenVector
+   if (outEigenVector != NULL)
+      for (i=1;i<=theDim;i++)
+         outEigenVector[i-1] = theEigenVector[i][theMinIndex];
+
+   free_dmatrix(theOmega,1,theDim,1,theDim);
+   free_omega_matrix(theWorkOmega,1,theDim,1,theDim);
+   free_omega_matrix(theEigenVector,1,theDim,1,theDim);
+   free_omega_vector(theEigenValue,1,theDim);
+
+   return theMin;
+}
+
+
+//---------------------------------------------------------------------------
+// DeviceSpectrum
+//
+// Computes all eigenvalues of the Omega matrix of the device, sorted in
+// ascending order, in outEigenValue[0...N-1], at the precision of
+// OmegaScalar.  Returns N.
+//---------------------------------------------------------------------------
+int DeviceSpectrum(DeviceConfig *inConfig, double *outEigenValue)
+{
+   int      i,j;
+   int      theDim;
+   double   theValue;
+   double       **theOmega;
+   OmegaScalar  **theWorkOmega;
+   OmegaScalar  **theEigenVector;
+   OmegaScalar   *theEigenValue;
+
+   theDim = gFastStabilityDim;
+
+   theOmega = dmatrix(1,theDim,1,theDim);
+   theWorkOmega = omega_matrix(1,theDim,1,theDim);
+   theEigenVector = omega_matrix(1,theDim,1,theDim);
+   theEigenValue = omega_vector(1,theDim);
+
+   ComputeDeviceOmega(inConfig,theOmega);
+
+   for (i=1;i<=theDim;i++)
+      for (j=1;j<=theDim;j++)
+         theWorkOmega[i][j] = (OmegaScalar) theOmega[i][j];
+
+   DiagonalizeOmegaMatrix(theWorkOmega,theDim,theEigenValue,theEigenVector);
+
+   // straight insertion sort
+   for (i=1;i<=theDim;i++)
+   {
+      theValue = (double) theEigenValue[i];
+      for (j=i-1;j>=1 && outEigenValue[j-1]>theValue;j--)
+         outEigenValue[j] = outEigenValue[j-1];
+      outEigenValue[j] = theValue;
+   }
+
+   free_dmatrix(theOmega,1,theDim,1,theDim);
+   free_omega_matrix(theWorkOmega,1,theDim,1,theDim);
+   free_omega_matrix(theEigenVector,1,theDim,1,theDim);
+   free_omega_vector(theEigenValue,1,theDim);
+
+   return theDim;
+}
+
+
+//---------------------------------------------------------------------------
+// DeviceMinEigenvalue
+//
+// Returns the minimum eigenvalue of the Omega matrix of the device.
+// See DeviceMinEigenpair().
+//---------------------------------------------------------------------------
+OmegaScalar DeviceMinEigenvalue(DeviceConfig *inConfig)
+{
+   return DeviceMinEigenpair(inConfig,NULL);
+}
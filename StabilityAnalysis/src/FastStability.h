@@ -0,0 +1,66 @@
+//---------------------------------------------------------------------------
+// FastStability.h
+//
+// Reentrant computation of the Omega matrix and its minimum eigenvalue
+// for a device described by a DeviceConfig record, rather than by the
+// global simulation parameters in Membrane.c.
+//
+// InitFastStability() tabulates the membrane eigenfunctions at the center
+// of every electrode pixel once.  Each evaluation then costs a single pass
+// over the electrode array plus the diagonalization, and may run
+// concurrently with other evaluations.  For the same device, results
+// agree with RealMatrixASum() / ComputeOmegaMatrix() / GetDeviceStability().
+//
+// InitFastStability() must be called after Membrane() and ElectrodeArray(),
+// and again whenever gNumberOfEigenFunctions, gMembraneRadius_mm or the
+// electrode geometry change.
+//---------------------------------------------------------------------------
+#ifndef FASTSTABILITY_H
+#define FASTSTABILITY_H
+
+
+#include "MatrixUtils.h"
+
+
+#define FAST_STABILITY_MAX_DIM  64       // max. gNumberOfEigenFunctions
+#define NO_EQUILIBRIUM_EIGENVALUE -1.0e30 // no self consistent voltages
+
+
+typedef struct
+{
+   double  VoltageT_V;            // Transp. electrode voltage
+   double  DistT_um;              // Transp. electr -- membr. dist.
+   double  DistA_um;              // Electr. array -- membr. dist.
+   double  MembraneTension_NByM;  // tension = stress * thickness
+   double *ExpansionCoeff_MKS;    // membrane shape coeffs [0...N-1]
+   float  *ElectrodeVoltage_V;    // electrode voltages [0...gNumElectrodes-1]
+                                  // same order as gElectrodeVoltage[][]
+} DeviceConfig;
+
+
+void   InitFastStability();
+int    FastStabilityIsCurrent();
+
+void   GetGlobalDeviceConfig(DeviceConfig *outConfig);
+void   SetDeviceArrayVoltage(DeviceConfig *ioConfig, double inVoltage);
+
+double MembraneShapeAtElectrode_MKS(DeviceConfig *inConfig, int inK);
+double Del2ShapeAtElectrode_MKS(DeviceConfig *inConfig, int inK);
+double ModalPeakAmplitude_MKS(int inJ);
+
+int    ComputeDeviceElectrodeVoltageForVt(DeviceConfig *ioConfig,
+                                          double inVoltageT_V);
+int    ComputeDeviceElectrodeVoltage(DeviceConfig *ioConfig);
+void   ComputeDeviceShapeForVoltages(DeviceConfig *ioConfig,
+                                     int inNumModes,
+                                     int inNumIterations);
+
+void   ComputeDeviceMatrixASum(DeviceConfig *inConfig, double **outMatrixA);
+void   ComputeDeviceMatrixA(DeviceConfig *inConfig, double **outMatrixA);
+void   ComputeDeviceOmega(DeviceConfig *inConfig, double **outOmega);
+OmegaScalar DeviceMinEigenpair(DeviceConfig *inConfig, double *outEigenVector);
+OmegaScalar DeviceMinEigenvalue(DeviceConfig *inConfig);
+int    DeviceSpectrum(DeviceConfig *inConfig, double *outEigenValue);
+
+
+#endif
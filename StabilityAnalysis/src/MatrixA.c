@@ -7,11 +7,12 @@
 // plk 03/08/2005
 //---------------------------------------------------------------------------
 #include "MatrixA.h"
+#include "MatrixUtils.h"
 #include "Membrane.h"
 #include "ElectrodeArray.h"
 #include "BesselJZeros.h"
 #include "Eigenfunc.h"
-#include "NR.h"
+#include "NR.H"
 #include "NRUTIL.H"
 #include <math.h>
 #include <stdio.h>
@@ -11,7 +11,9 @@
 #include "Eigenfunc.h"
 #include "BesselJZeros.h"
 #include "MatrixUtils.h"
-#include "NR.h"
+#include "ElectrodeArray.h"
+#include "NR.H"
+#include "NRUTIL.H"
 
 
 double gMembraneStress_MPa;
@@ -0,0 +1,572 @@
+//---------------------------------------------------------------------------
+// MembraneDynamics.c
+//
+// Modal membrane dynamics.  See MembraneDynamics.h
+//
+// The state vector y[0...2N-1] holds the expansion coefficients a_j in
+// y[0...N-1] and their time derivatives in y[N...2N-1].  Each evaluation
+// of the derivatives costs one pass over the electrode array, through
+// EquilibriumResidual().  Step responses in a sweep are independent, and
+// are distributed over processors when compiled with OpenMP support.
+//
+// Results of the last sweep are left in the gStepResponse globals below.
+//---------------------------------------------------------------------------
+#include "MembraneDynamics.h"
+#include "Equilibrium.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <math.h>
+
+
+#define DYNAMICS_MAX_STEPS     1000000
+#define DYNAMICS_MAX_TIME_MS   1000.0     // used by the Tcl entry points
+#define DYNAMICS_ACCURACY      0.01       // integration error / tolerance
+
+
+int      gStepResponseNumSteps = 0;
+float   *gStepResponseVa_V;           // [0...gStepResponseNumSteps-1]
+float   *gStepResponseSettleTime_ms;  // [0...gStepResponseNumSteps-1]
+int     *gStepResponseResult;         // [0...gStepResponseNumSteps-1]
+double   gStepResponseMaxSettleTime_ms;
+
+
+extern int      gFastStabilityDim;
+extern double  *gBasisDel2Factor;
+
+extern int      gNumElectrodes;
+extern double   gMembraneThickness_um;
+
+
+
+//---------------------------------------------------------------------------
+// ModalDerivatives
+//
+// Computes dy/dt for the state inY.  ioConfig supplies the device and
+// the electrode voltages; its expansion coefficients are overwritten with
+// inY[0...N-1].  inDamping[j] = 2 z w_j.  ioResidual [0...N-1] is work
+// space.  Returns 1 if the membrane touches an electrode, otherwise 0.
+//---------------------------------------------------------------------------
+int ModalDerivatives(DeviceConfig *ioConfig, \
+                     double inArealDensity_KgByM2, \
+                     double *inDamping, \
+                     double *inY, \
+                     double *outDYDt, \
+                     double *ioResidual)
+{
+   int j;
+   int theDim;
+
+   theDim = gFastStabilityDim;
+
+   for (j=0;j<theDim;j++)
+      ioConfig->ExpansionCoeff_MKS[j] = inY[j];
+
+   if (EquilibriumResidual(ioConfig,ioResidual,NULL) < 0) return 1;
+
+   for (j=0;j<theDim;j++)
+   {
+      outDYDt[j] = inY[theDim+j];
+      outDYDt[theDim+j] = -ioResidual[j]/inArealDensity_KgByM2 - \
+                          inDamping[j]*inY[theDim+j];
+   }
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// CashKarpStep
+//
+// Advances the state inY, with derivatives inDYDt, by one fifth order
+// Cash-Karp Runge-Kutta step of length inH (Numerical Recipes 16.2).  The
+// new state is returned in outY, the embedded error estimate in outYErr.
+// ioK [0...4][0...2N-1] and ioYTemp [0...2N-1] are work space.
+// Returns 1 if the membrane touches an electrode at an intermediate
+// stage, otherwise 0.
+//---------------------------------------------------------------------------
+int CashKarpStep(DeviceConfig *ioConfig, \
+                 double inArealDensity_KgByM2, \
+                 double *inDamping, \
+                 double *inY, \
+                 double *inDYDt, \
+                 double inH, \
+                 double *outY, \
+                 double *outYErr, \
+                 double **ioK, \
+                 double *ioYTemp, \
+                 double *ioResidual)
+{
+   int    i;
+   int    theN;
+   static double b21=0.2, \
+                 b31=3.0/40.0, b32=9.0/40.0, \
+                 b41=0.3, b42=-0.9, b43=1.2, \
+                 b51=-11.0/54.0, b52=2.5, b53=-70.0/27.0, b54=35.0/27.0, \
+                 b61=1631.0/55296.0, b62=175.0/512.0, b63=575.0/13824.0, \
+                 b64=44275.0/110592.0, b65=253.0/4096.0, \
+                 c1=37.0/378.0, c3=250.0/621.0, c4=125.0/594.0, \
+                 c6=512.0/1771.0, \
+                 dc5=-277.0/14336.0;
+   double dc1=c1-2825.0/27648.0, dc3=c3-18575.0/48384.0, \
+          dc4=c4-13525.0/55296.0, dc6=c6-0.25;
+
+   theN = 2*gFastStabilityDim;
+
+   for (i=0;i<theN;i++)
+      ioYTemp[i] = inY[i] + b21*inH*inDYDt[i];
+   if (ModalDerivatives(ioConfig,inArealDensity_KgByM2,inDamping, \
+                        ioYTemp,ioK[0],ioResidual)) return 1;
+
+   for (i=0;i<theN;i++)
+      ioYTemp[i] = inY[i] + inH*(b31*inDYDt[i] + b32*ioK[0][i]);
+   if (ModalDerivatives(ioConfig,inArealDensity_KgByM2,inDamping, \
+                        ioYTemp,ioK[1],ioResidual)) return 1;
+
+   for (i=0;i<theN;i++)
+      ioYTemp[i] = inY[i] + inH*(b41*inDYDt[i] + b42*ioK[0][i] + \
+                                 b43*ioK[1][i]);
+   if (ModalDerivatives(ioConfig,inArealDensity_KgByM2,inDamping, \
+                        ioYTemp,ioK[2],ioResidual)) return 1;
+
+   for (i=0;i<theN;i++)
+      ioYTemp[i] = inY[i] + inH*(b51*inDYDt[i] + b52*ioK[0][i] + \
+                                 b53*ioK[1][i] + b54*ioK[2][i]);
+   if (ModalDerivatives(ioConfig,inArealDensity_KgByM2,inDamping, \
+                        ioYTemp,ioK[3],ioResidual)) return 1;
+
+   for (i=0;i<theN;i++)
+      ioYTemp[i] = inY[i] + inH*(b61*inDYDt[i] + b62*ioK[0][i] + \
+                                 b63*ioK[1][i] + b64*ioK[2][i] + \
+                                 b65*ioK[3][i]);
+   if (ModalDerivatives(ioConfig,inArealDensity_KgByM2,inDamping, \
+                        ioYTemp,ioK[4],ioResidual)) return 1;
+
+   for (i=0;i<theN;i++)
+   {
+      outY[i] = inY[i] + inH*(c1*inDYDt[i] + c3*ioK[1][i] + \
+                              c4*ioK[2][i] + c6*ioK[4][i]);
+      outYErr[i] = inH*(dc1*inDYDt[i] + dc3*ioK[1][i] + dc4*ioK[2][i] + \
+                        dc5*ioK[3][i] + dc6*ioK[4][i]);
+   }
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// SimulateDeviceStepResponse
+//
+// Integrates the membrane motion after the electrode voltages of the
+// device step from ioConfig->ElectrodeVoltage_V to inFinalVoltage_V at
+// t = 0.  The membrane starts at rest, in the shape given by
+// ioConfig->ExpansionCoeff_MKS, which normally is the equilibrium shape
+// for the initial voltages (see SolveDeviceEquilibrium).  On return the
+// expansion coefficients hold the shape at the end of the simulation,
+// and outSettleTime_ms the time at which the membrane settled within
+// inTolerance_um of the equilibrium shape for the final voltages.  If the
+// membrane does not settle, outSettleTime_ms is the simulated time.
+//
+//  return value:
+//          DYNAMICS_SETTLED         (0)
+//          DYNAMICS_NOT_SETTLED     not settled within inMaxTime_ms
+//          DYNAMICS_PULL_IN         membrane touched an electrode
+//          DYNAMICS_NO_EQUILIBRIUM  no equilibrium for the final voltages,
+//                                   and no pull-in within inMaxTime_ms
+//
+// called by:  StepResponseSettleTime_ms(), RunStepResponseSweep()
+//---------------------------------------------------------------------------
+int SimulateDeviceStepResponse(DeviceConfig *ioConfig, \
+                               float *inFinalVoltage_V, \
+                               double inArealDensity_KgByM2, \
+                               double inDampingRatio, \
+                               double inMaxTime_ms, \
+                               double inTolerance_um, \
+                               double *outSettleTime_ms)
+{
+   int          j;
+   int          theDim;
+   int          theN;
+   int          theStep;
+   int          theResult;
+   int          theHasEquilibrium;
+   double       theT_s;
+   double       theMaxTime_s;
+   double       theH_s;
+   double       theMinH_s;
+   double       theMaxOmega;
+   double       theErr;
+   double       theModeErr;
+   double       theEnvelope;
+   double       theScale;
+   double      *theOmega;
+   double      *theDamping;
+   double      *theFinalA;
+   double      *theA;
+   double      *theY;
+   double      *theDYDt;
+   double      *theYNew;
+   double      *theYErr;
+   double      *theYTemp;
+   double      *theResidual;
+   double     **theK;
+   DeviceConfig theConfig;
+
+   theDim = gFastStabilityDim;
+   theN = 2*theDim;
+
+   theOmega    = dvector(0,theDim-1);
+   theDamping  = dvector(0,theDim-1);
+   theFinalA   = dvector(0,theDim-1);
+   theA        = dvector(0,theDim-1);
+   theResidual = dvector(0,theDim-1);
+   theY        = dvector(0,theN-1);
+   theDYDt     = dvector(0,theN-1);
+   theYNew     = dvector(0,theN-1);
+   theYErr     = dvector(0,theN-1);
+   theYTemp    = dvector(0,theN-1);
+   theK        = dmatrix(0,4,0,theN-1);
+
+   // equilibrium shape for the final voltages, warm started from the
+   // initial shape.
+   theConfig = *ioConfig;
+   theConfig.ExpansionCoeff_MKS = theFinalA;
+   theConfig.ElectrodeVoltage_V = inFinalVoltage_V;
+   for (j=0;j<theDim;j++)
+      theFinalA[j] = ioConfig->ExpansionCoeff_MKS[j];
+   theHasEquilibrium = (SolveDeviceEquilibrium(&theConfig,50,\
+                           DYNAMICS_ACCURACY*inTolerance_um) == \
+                        EQUILIBRIUM_CONVERGED);
+
+   // the state is carried in theY; theConfig is only used to evaluate
+   // the forcing, on a private copy of the coefficients.
+   theConfig.ExpansionCoeff_MKS = theA;
+
+   theMaxOmega = 0.0;
+   for (j=0;j<theDim;j++)
+   {
+      theOmega[j] = sqrt(ioConfig->MembraneTension_NByM*gBasisDel2Factor[j]/ \
+                         inArealDensity_KgByM2);
+      theDamping[j] = 2*inDampingRatio*theOmega[j];
+      if (theOmega[j] > theMaxOmega) theMaxOmega = theOmega[j];
+
+      theY[j] = ioConfig->ExpansionCoeff_MKS[j];
+      theY[theDim+j] = 0.0;
+   }
+
+   theMaxTime_s = inMaxTime_ms*1e-3;
+   theH_s = 0.05/theMaxOmega;
+   theMinH_s = 1e-6/theMaxOmega;
+   theT_s = 0.0;
+   theResult = theHasEquilibrium ? DYNAMICS_NOT_SETTLED : \
+                                   DYNAMICS_NO_EQUILIBRIUM;
+   *outSettleTime_ms = inMaxTime_ms;
+
+   for (theStep=0;theStep<DYNAMICS_MAX_STEPS;theStep++)
+   {
+      if (theHasEquilibrium)
+      {
+         theEnvelope = 0.0;
+         for (j=0;j<theDim;j++)
+         {
+            theModeErr = sqrt((theY[j]-theFinalA[j])*(theY[j]-theFinalA[j]) + \
+                              theY[theDim+j]*theY[theDim+j]/ \
+                              (theOmega[j]*theOmega[j]))* \
+                         ModalPeakAmplitude_MKS(j)*1e6;
+            if (theModeErr > theEnvelope) theEnvelope = theModeErr;
+         }
+
+         if (theEnvelope < inTolerance_um)
+         {
+            theResult = DYNAMICS_SETTLED;
+            *outSettleTime_ms = theT_s*1e3;
+            break;
+         }
+      }
+
+      if (theT_s >= theMaxTime_s) break;
+      if (theT_s + theH_s > theMaxTime_s) theH_s = theMaxTime_s - theT_s;
+
+      if (ModalDerivatives(&theConfig,inArealDensity_KgByM2,theDamping, \
+                           theY,theDYDt,theResidual))
+      {
+         theResult = DYNAMICS_PULL_IN;
+         *outSettleTime_ms = theT_s*1e3;
+         break;
+      }
+
+      if (CashKarpStep(&theConfig,inArealDensity_KgByM2,theDamping, \
+                       theY,theDYDt,theH_s,theYNew,theYErr, \
+                       theK,theYTemp,theResidual))
+      {
+         // an intermediate stage reached an electrode:  retry with a
+         // shorter step.  Pull-in if the step cannot be made shorter.
+         theH_s *= 0.25;
+         if (theH_s < theMinH_s)
+         {
+            theResult = DYNAMICS_PULL_IN;
+            *outSettleTime_ms = theT_s*1e3;
+            break;
+         }
+         continue;
+      }
+
+      // error relative to DYNAMICS_ACCURACY * tolerance, in peak
+      // deformation; velocity errors are scaled by the modal frequency.
+      theErr = 0.0;
+      for (j=0;j<theDim;j++)
+      {
+         theScale = ModalPeakAmplitude_MKS(j)*1e6/ \
+                    (DYNAMICS_ACCURACY*inTolerance_um);
+         theModeErr = fabs(theYErr[j])*theScale;
+         if (theModeErr > theErr) theErr = theModeErr;
+         theModeErr = fabs(theYErr[theDim+j])*theScale/theOmega[j];
+         if (theModeErr > theErr) theErr = theModeErr;
+      }
+
+      if (theErr > 1.0)
+      {
+         theH_s *= (0.9*pow(theErr,-0.25) > 0.1) ? \
+                    0.9*pow(theErr,-0.25) : 0.1;
+         // the step size underflows as the membrane snaps to an
+         // electrode, where the forcing diverges.
+         if (theH_s < theMinH_s)
+         {
+            theResult = DYNAMICS_PULL_IN;
+            *outSettleTime_ms = theT_s*1e3;
+            break;
+         }
+         continue;
+      }
+
+      theT_s += theH_s;
+      for (j=0;j<theN;j++)
+         theY[j] = theYNew[j];
+
+      if (theErr > 1.89e-4)
+         theH_s *= 0.9*pow(theErr,-0.2);
+      else
+         theH_s *= 5.0;
+   }
+
+   for (j=0;j<theDim;j++)
+      ioConfig->ExpansionCoeff_MKS[j] = theY[j];
+
+   free_dvector(theOmega,0,theDim-1);
+   free_dvector(theDamping,0,theDim-1);
+   free_dvector(theFinalA,0,theDim-1);
+   free_dvector(theA,0,theDim-1);
+   free_dvector(theResidual,0,theDim-1);
+   free_dvector(theY,0,theN-1);
+   free_dvector(theDYDt,0,theN-1);
+   free_dvector(theYNew,0,theN-1);
+   free_dvector(theYErr,0,theN-1);
+   free_dvector(theYTemp,0,theN-1);
+   free_dmatrix(theK,0,4,0,theN-1);
+
+   return theResult;
+}
+
+
+//---------------------------------------------------------------------------
+// InitialStepConfig
+//
+// Fills outConfig with the global device, with every electrode under the
+// membrane at inVaFrom_V and the membrane in the equilibrium shape for
+// these voltages.  The expansion coefficients are copied into
+// outConfig->ExpansionCoeff_MKS, which the caller allocates [0...N-1].
+// Returns the EQUILIBRIUM_ code of the equilibrium solution.
+//---------------------------------------------------------------------------
+int InitialStepConfig(DeviceConfig *outConfig, double inVaFrom_V)
+{
+   int     j;
+   double *theA;
+
+   theA = outConfig->ExpansionCoeff_MKS;
+
+   GetGlobalDeviceConfig(outConfig);
+   for (j=0;j<gFastStabilityDim;j++)
+      theA[j] = outConfig->ExpansionCoeff_MKS[j];
+   outConfig->ExpansionCoeff_MKS = theA;
+
+   SetDeviceArrayVoltage(outConfig,inVaFrom_V);
+
+   return SolveDeviceEquilibrium(outConfig,50,1e-6);
+}
+
+
+//---------------------------------------------------------------------------
+// StepResponseSettleTime_ms
+//
+// Settle time of the current device when the voltage of every electrode
+// under the membrane steps from inVaFrom_V to inVaTo_V.  The areal
+// density of the membrane is MEMBRANE_DENSITY_KGBYM3 times
+// gMembraneThickness_um.  Returns -1 if the membrane does not settle
+// within DYNAMICS_MAX_TIME_MS.
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+double StepResponseSettleTime_ms(double inVaFrom_V, double inVaTo_V, \
+                                 double inDampingRatio, \
+                                 double inTolerance_um)
+{
+   int          theResult;
+   double       theSettleTime_ms;
+   DeviceConfig theConfig;
+   DeviceConfig theFinal;
+   char         theMessage[150];
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   theConfig.ExpansionCoeff_MKS = dvector(0,gFastStabilityDim-1);
+   theResult = InitialStepConfig(&theConfig,inVaFrom_V);
+
+   if (theResult == EQUILIBRIUM_CONVERGED)
+   {
+      theFinal.ElectrodeVoltage_V = vector(0,gNumElectrodes-1);
+      SetDeviceArrayVoltage(&theFinal,inVaTo_V);
+
+      theResult = SimulateDeviceStepResponse(&theConfig, \
+                     theFinal.ElectrodeVoltage_V, \
+                     MEMBRANE_DENSITY_KGBYM3*gMembraneThickness_um*1e-6, \
+                     inDampingRatio,DYNAMICS_MAX_TIME_MS,inTolerance_um, \
+                     &theSettleTime_ms);
+
+      free_vector(theFinal.ElectrodeVoltage_V,0,gNumElectrodes-1);
+   }
+   else
+   {
+      theResult = DYNAMICS_NO_EQUILIBRIUM;
+   }
+
+   free_dvector(theConfig.ExpansionCoeff_MKS,0,gFastStabilityDim-1);
+   free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+
+   if (theResult != DYNAMICS_SETTLED) theSettleTime_ms = -1;
+
+   sprintf(theMessage,"--- StepResponseSettleTime:  Va %f -> %f V, "\
+                      "result %d, settle time %f ms ---", \
+                      inVaFrom_V,inVaTo_V,theResult,theSettleTime_ms);
+   LogMessage(theMessage);
+
+   return theSettleTime_ms;
+}
+
+
+//---------------------------------------------------------------------------
+// RunStepResponseSweep
+//
+// Simulates the step responses of the current device from a uniform
+// array voltage inVaFrom_V to inNumSteps uniform array voltages between
+// inVaToL_V and inVaToH_V.  Target voltages, settle times and result
+// codes are returned in the gStepResponse globals, and written to the
+// log file.  gStepResponseMaxSettleTime_ms is the longest settle time
+// of the steps that settled.
+//
+//  return value:
+//          0    successful completion
+//          1    invalid arguments, or no equilibrium at inVaFrom_V
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int RunStepResponseSweep(double inVaFrom_V, \
+                         double inVaToL_V, double inVaToH_V, \
+                         int inNumSteps, \
+                         double inDampingRatio, \
+                         double inTolerance_um)
+{
+   int          n;
+   double       theArealDensity_KgByM2;
+   DeviceConfig theInitial;
+   char         theMessage[150];
+
+   if (inNumSteps < 1 || inTolerance_um <= 0)
+   {
+      LogMessage("--- RunStepResponseSweep:  invalid arguments ---");
+      return 1;
+   }
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   theInitial.ExpansionCoeff_MKS = dvector(0,gFastStabilityDim-1);
+   if (InitialStepConfig(&theInitial,inVaFrom_V) != EQUILIBRIUM_CONVERGED)
+   {
+      LogMessage("--- RunStepResponseSweep:  no equilibrium at Va from ---");
+      free_dvector(theInitial.ExpansionCoeff_MKS,0,gFastStabilityDim-1);
+      free_vector(theInitial.ElectrodeVoltage_V,0,gNumElectrodes-1);
+      return 1;
+   }
+
+   if (gStepResponseNumSteps > 0)
+   {
+      free_vector(gStepResponseVa_V,0,gStepResponseNumSteps-1);
+      free_vector(gStepResponseSettleTime_ms,0,gStepResponseNumSteps-1);
+      free_ivector(gStepResponseResult,0,gStepResponseNumSteps-1);
+   }
+   gStepResponseNumSteps = inNumSteps;
+   gStepResponseVa_V = vector(0,inNumSteps-1);
+   gStepResponseSettleTime_ms = vector(0,inNumSteps-1);
+   gStepResponseResult = ivector(0,inNumSteps-1);
+
+   theArealDensity_KgByM2 = MEMBRANE_DENSITY_KGBYM3*gMembraneThickness_um*1e-6;
+
+#pragma omp parallel for schedule(dynamic)
+   for (n=0;n<inNumSteps;n++)
+   {
+      int           j;
+      double        theSettleTime_ms;
+      DeviceConfig  theConfig;
+      DeviceConfig  theFinal;
+
+      gStepResponseVa_V[n] = (float) ((inNumSteps > 1) ? \
+                  inVaToL_V + n*(inVaToH_V-inVaToL_V)/(inNumSteps-1) : \
+                  inVaToL_V);
+
+      theConfig = theInitial;
+      theConfig.ExpansionCoeff_MKS = dvector(0,gFastStabilityDim-1);
+      for (j=0;j<gFastStabilityDim;j++)
+         theConfig.ExpansionCoeff_MKS[j] = theInitial.ExpansionCoeff_MKS[j];
+
+      theFinal.ElectrodeVoltage_V = vector(0,gNumElectrodes-1);
+      SetDeviceArrayVoltage(&theFinal,gStepResponseVa_V[n]);
+
+      gStepResponseResult[n] = SimulateDeviceStepResponse(&theConfig, \
+                                  theFinal.ElectrodeVoltage_V, \
+                                  theArealDensity_KgByM2, \
+                                  inDampingRatio,DYNAMICS_MAX_TIME_MS, \
+                                  inTolerance_um,&theSettleTime_ms);
+      gStepResponseSettleTime_ms[n] = (float) theSettleTime_ms;
+
+      free_vector(theFinal.ElectrodeVoltage_V,0,gNumElectrodes-1);
+      free_dvector(theConfig.ExpansionCoeff_MKS,0,gFastStabilityDim-1);
+   }
+
+   free_dvector(theInitial.ExpansionCoeff_MKS,0,gFastStabilityDim-1);
+   free_vector(theInitial.ElectrodeVoltage_V,0,gNumElectrodes-1);
+
+   LogMessage("--- RunStepResponseSweep ---");
+   sprintf(theMessage,"Va from %f V, damping ratio %f, tolerance %f um", \
+           inVaFrom_V,inDampingRatio,inTolerance_um);
+   LogMessage(theMessage);
+   LogMessage("Va to (V)\tresult\tsettle time (ms)");
+
+   gStepResponseMaxSettleTime_ms = 0.0;
+   for (n=0;n<inNumSteps;n++)
+   {
+      sprintf(theMessage,"%f\t%d\t%f",gStepResponseVa_V[n], \
+              gStepResponseResult[n],gStepResponseSettleTime_ms[n]);
+      LogMessage(theMessage);
+
+      if (gStepResponseResult[n] == DYNAMICS_SETTLED && \
+          gStepResponseSettleTime_ms[n] > gStepResponseMaxSettleTime_ms)
+         gStepResponseMaxSettleTime_ms = gStepResponseSettleTime_ms[n];
+   }
+
+   sprintf(theMessage,"max. settle time %f ms",gStepResponseMaxSettleTime_ms);
+   LogMessage(theMessage);
+
+   return 0;
+}
@@ -0,0 +1,54 @@
+//---------------------------------------------------------------------------
+// MembraneDynamics.h
+//
+// Time domain simulation of the membrane after a step in the electrode
+// voltages.  The membrane is projected onto the eigenfunction basis of
+// the Omega matrix calculation; since the eigenfunctions are orthonormal,
+// the modal mass is the areal density of the membrane for every mode and
+// the modal stiffness is T X_j^2/R^2.  With a modal damping ratio z,
+//
+//    rho * a_j''  +  2 z w_j rho * a_j'  =  -R_j(a)
+//
+// where w_j^2 = T X_j^2/(R^2 rho) and R_j(a) is the equilibrium residual
+// of Equilibrium.c, which contains the nonlinear electrostatic forcing.
+// The equations are integrated with an adaptive step Runge-Kutta (Cash-
+// Karp) method.
+//
+// The membrane is settled when the envelope of the oscillation about the
+// final equilibrium shape, sqrt(da_j^2 + (da_j'/w_j)^2) converted to peak
+// deformation, is within the tolerance for every mode.
+//---------------------------------------------------------------------------
+#ifndef MEMBRANEDYNAMICS_H
+#define MEMBRANEDYNAMICS_H
+
+
+#include "FastStability.h"
+
+
+#define MEMBRANE_DENSITY_KGBYM3  3000.0   // nominal, adjust for material
+
+#define DYNAMICS_SETTLED          0
+#define DYNAMICS_NOT_SETTLED      1   // not settled within max. time
+#define DYNAMICS_PULL_IN          2   // membrane touched an electrode
+#define DYNAMICS_NO_EQUILIBRIUM   3   // no static solution for final V
+
+
+int SimulateDeviceStepResponse(DeviceConfig *ioConfig, \
+                               float *inFinalVoltage_V, \
+                               double inArealDensity_KgByM2, \
+                               double inDampingRatio, \
+                               double inMaxTime_ms, \
+                               double inTolerance_um, \
+                               double *outSettleTime_ms);
+
+double StepResponseSettleTime_ms(double inVaFrom_V, double inVaTo_V, \
+                                 double inDampingRatio, \
+                                 double inTolerance_um);
+int    RunStepResponseSweep(double inVaFrom_V, \
+                            double inVaToL_V, double inVaToH_V, \
+                            int inNumSteps, \
+                            double inDampingRatio, \
+                            double inTolerance_um);
+
+
+#endif
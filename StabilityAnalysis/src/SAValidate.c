@@ -9,8 +9,12 @@
 // plk 05/12/2005
 //---------------------------------------------------------------------------
 #include <stdio.h>
-#include <conio.h>
 #include <math.h>
+#include <string.h>
+
+#ifdef SA_CONSOLE_PAUSE
+#include <conio.h>
+#endif
 
 #pragma hdrstop
 
@@ -21,19 +25,20 @@
 #include "BesselJZeros.h"
 #include "Eigenfunc.h"
 #include "Membrane.h"
-#include "NR.h"
+#include "NR.H"
 #include "NRUTIL.H"
 #include "ElectrodeArray.h"
+#include "StabilitySweep.h"
 //---------------------------------------------------------------------------
 
 
 extern int       gNumberOfEigenFunctions;
 extern int       gNumElectrodes;
 extern double    gPeakDeformation_um;
-extern float   **gOmega;
+extern OmegaScalar **gOmega;
 extern double  **gMatrixA;
-extern float   **gEigenVector;
-extern float    *gEigenValue;
+extern OmegaScalar **gEigenVector;
+extern OmegaScalar  *gEigenValue;
 extern double  (*gMembraneShape)(double, double);
 extern float   **gElectrodeVoltage;
 extern float   **gElectrodeVoltageMap;
@@ -50,20 +55,80 @@ extern int   gNumElectrodes;
 
 
 
+#ifdef SA_TCL_MODULE
+//---------------------------------------------------------------------------
+// CreateDevice
+//
+// Initializes membrane and electrode array device parameters.  Also
+// opens log file and writes header information to it.  Tcl module build
+// only ("make tcl"); the DLL has its own copy in CompiledAsDll.
+//
+// Returns:
+//          7    device created
+//          0    ElectrodeArray() failed, see log file
+//
+// called by:  Ping(), (Tcl)
+//
+//---------------------------------------------------------------------------
+int Createdevice()
+{
+
+   OpenLogFile();
+   LogMessage("SAValidate Tcl module  Version 4");
+
+   Membrane();
+   if (ElectrodeArray() != ELECTRODE_ARRAY_OK)
+   {
+      LogMessage("--- Createdevice:  ElectrodeArray() failed ---");
+      return 0;
+   }
+
+   return 7;
+}
+
+
+
+int Ping()
+{
+   printf("Ping!\n");
+
+   return Createdevice();
+}
+#else
+
+
+
 #pragma argsused
 int main(int argc, char* argv[])
 {
    char theMessage[100];
    float theTest;
+   int theErr;
 
    OpenLogFile();
    LogMessage("SAValidate.exe  Version 4");
 
    Membrane();
-   ElectrodeArray();
+   theErr = ElectrodeArray();
+   if (theErr != ELECTRODE_ARRAY_OK)
+   {
+      if (theErr == ELECTRODE_ARRAY_VT_TOO_LOW)
+         LogMessage("--- SAValidate:  ElectrodeArray() failed, "\
+                    "Vt too low for the membrane shape ---");
+      else
+         LogMessage("--- SAValidate:  ElectrodeArray() failed, "\
+                    "electrode outside the voltage map ---");
+      return 1;
+   }
    //LogSimParams();
 
 
+   // sweep worker:  SAValidate -sweep <spec file> <result dir> [<tag>]
+   // see StabilitySweep.h
+   if (argc >= 4 && strcmp(argv[1],"-sweep") == 0)
+      return StabilitySweepWorker(argv[2],argv[3],(argc > 4) ? argv[4] : NULL);
+
+
 #if 0
    LogMessage("Index    X_um    Y_um   Electrode?");
    LogFMatrix(gElectrodePosition_MKS,\
@@ -207,10 +272,15 @@ int main(int argc, char* argv[])
 
 
    printf("\nDone!\n");
+
+   // keep the console window open (Borland console build only)
+#ifdef SA_CONSOLE_PAUSE
    while (!kbhit());
    getch();
+#endif
    return 0;
 }
+#endif
 //---------------------------------------------------------------------------
 
 
@@ -317,7 +387,7 @@ void TestSmallAmplitudeStability(float inVaLow_V, \
 //
 // plk 4/18/2005
 //---------------------------------------------------------------------------
-float GetDeviceStability()
+OmegaScalar GetDeviceStability()
 {
    RunFastStabilityComputation();
    return gEigenValue[1];
@@ -339,13 +409,13 @@ float GetDeviceStability()
 void RunStabilityComputation()
 {
         int      theDim;
-        float  **theOmega;
+        OmegaScalar **theOmega;
         double **theMatrixA;
         double **theMatrixASum;
 
 
 
-        theOmega = matrix(1,gNumberOfEigenFunctions, \
+        theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
         theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -381,7 +451,7 @@ void RunStabilityComputation()
         //---------------------------------------------
 
         ComputeOmegaMatrix();
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
         1,gNumberOfEigenFunctions,\
         1,gNumberOfEigenFunctions,\
         "Omega Matrix (Discrete Sum)");
@@ -391,21 +461,21 @@ void RunStabilityComputation()
         // OMEGA MATRIX DIAGONALIZATION, EIGENVALUES
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -430,13 +500,13 @@ void RunStabilityComputation()
 void RunFastStabilityComputation()
 {
         int      theDim;
-        float  **theOmega;
+        OmegaScalar **theOmega;
         double **theMatrixA;
         double **theMatrixASum;
 
 
 
-        theOmega = matrix(1,gNumberOfEigenFunctions, \
+        theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
         theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -472,7 +542,7 @@ void RunFastStabilityComputation()
         //---------------------------------------------
         //ComputegMatrixASum();
         ComputeOmegaMatrix();
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
         1,gNumberOfEigenFunctions,\
         1,gNumberOfEigenFunctions,\
         "Omega Matrix (Discrete Sum)");
@@ -482,23 +552,23 @@ void RunFastStabilityComputation()
         // OMEGA MATRIX DIAGONALIZATION, EIGENVALUES
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
 
 #if 0
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -525,25 +595,25 @@ void RunFastStabilityComputation()
 void TestStabilityMatrixEigenvectors()
 {
         int theDim;
-        float **theEigenVector_T;
-        float **theMatrixProduct;
+        OmegaScalar **theEigenVector_T;
+        OmegaScalar **theMatrixProduct;
 
         theDim = gNumberOfEigenFunctions;
-        theEigenVector_T = matrix(1,theDim, \
+        theEigenVector_T = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        theMatrixProduct = matrix(1,theDim, \
+        theMatrixProduct = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        TransposeFMatrix(gEigenVector,theEigenVector_T, \
+        TransposeOmegaMatrix(gEigenVector,theEigenVector_T, \
                          1, theDim, \
                          1, theDim);
 
-        MultiplyFMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
+        MultiplyOmegaMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
                          1, theDim, 1, theDim, \
                          1, theDim, 1, theDim);
 
-        LogFMatrix(theMatrixProduct,\
+        LogOmegaMatrix(theMatrixProduct,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Product Matrix (Omega Eigenvectors):  E*E^T");
@@ -678,15 +748,15 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
 {
    int theDim;
 
-   float **theOmega;
+   OmegaScalar **theOmega;
    double **theMatrixA;
    double **theMatrixASum;
-   float  **theOmegaResult;
-   float **theEigenVector_T;
-   float **theMatrixProduct;
-   float **theSimilarMatrix;
+   OmegaScalar **theOmegaResult;
+   OmegaScalar **theEigenVector_T;
+   OmegaScalar **theMatrixProduct;
+   OmegaScalar **theSimilarMatrix;
    double **theEPMatrix;
-   float   *thePeakDefResult;
+   OmegaScalar  *thePeakDefResult;
 
    double thePeakDef_um;
 
@@ -697,7 +767,7 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
 
 
 
-   theOmega = matrix(1,gNumberOfEigenFunctions, \
+   theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
    theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -706,9 +776,9 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
 
 
    theMaxNumberOfSimulations = 200;
-   theOmegaResult = matrix(0,theMaxNumberOfSimulations, \
+   theOmegaResult = omega_matrix(0,theMaxNumberOfSimulations, \
                     0,gNumberOfEigenFunctions);
-   thePeakDefResult = vector(0,theMaxNumberOfSimulations);
+   thePeakDefResult = omega_vector(0,theMaxNumberOfSimulations);
 
    LogMessage("--- Begin Vary-Peak-Deformation Simulation --- ");
 
@@ -762,13 +832,13 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
         // PRINT, LOG OMEGA MATRIX
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
 
 
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Omega Matrix");
@@ -779,19 +849,19 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
         //---------------------------------------------
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
         // copy current eigenvalues to the Result matrix for print out
         // at end of simulation
-        CopyFVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
+        CopyOmegaVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
 
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -800,22 +870,22 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
         //---------------------------------------------
         // TEST OMEGA EIGENVECTOR ORTHONORMALITY
         //---------------------------------------------
-        theEigenVector_T = matrix(1,theDim, \
+        theEigenVector_T = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        theMatrixProduct = matrix(1,theDim, \
+        theMatrixProduct = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        TransposeFMatrix(gEigenVector,theEigenVector_T, \
+        TransposeOmegaMatrix(gEigenVector,theEigenVector_T, \
                          1, theDim, \
                          1, theDim);
 
-        MultiplyFMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
+        MultiplyOmegaMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
                          1, theDim, 1, theDim, \
                          1, theDim, 1, theDim);
 
 
-        LogFMatrix(theMatrixProduct,\
+        LogOmegaMatrix(theMatrixProduct,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Product Matrix (Omega Eigenvectors):  E*E^T");
@@ -840,11 +910,11 @@ void DoPeakDefVariationExpt(double inL_um, double inH_um, double inStep_um)
    } // end for loop
 
    // copy peak defs. (indep. variable) to result matrix, column 0.
-   CopyFVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
+   CopyOmegaVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
 
 
 
-   LogFMatrix(theOmegaResult,\
+   LogOmegaMatrix(theOmegaResult,\
         1,theResultRow,\
         0,gNumberOfEigenFunctions,\
         "Omega Eigenvalues:  Summary");
@@ -881,15 +951,15 @@ void DoTEVoltageVariationExpt(double inL_V, double inH_V, double inStep_V)
 {
    int theDim;
 
-   float **theOmega;
+   OmegaScalar **theOmega;
    double **theMatrixA;
    double **theMatrixASum;
-   float  **theOmegaResult;
-   float **theEigenVector_T;
-   float **theMatrixProduct;
-   float **theSimilarMatrix;
+   OmegaScalar **theOmegaResult;
+   OmegaScalar **theEigenVector_T;
+   OmegaScalar **theMatrixProduct;
+   OmegaScalar **theSimilarMatrix;
    double **theEPMatrix;
-   float   *thePeakDefResult;
+   OmegaScalar  *thePeakDefResult;
 
    double theVt_V;
 
@@ -900,7 +970,7 @@ void DoTEVoltageVariationExpt(double inL_V, double inH_V, double inStep_V)
 
 
 
-   theOmega = matrix(1,gNumberOfEigenFunctions, \
+   theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
    theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -909,9 +979,9 @@ void DoTEVoltageVariationExpt(double inL_V, double inH_V, double inStep_V)
 
 
    theMaxNumberOfSimulations = 200;
-   theOmegaResult = matrix(0,theMaxNumberOfSimulations, \
+   theOmegaResult = omega_matrix(0,theMaxNumberOfSimulations, \
                     0,gNumberOfEigenFunctions);
-   thePeakDefResult = vector(0,theMaxNumberOfSimulations);
+   thePeakDefResult = omega_vector(0,theMaxNumberOfSimulations);
 
    sprintf(theMessage,"Peak Deformation:  %7.2f um\n",gPeakDeformation_um);
    LogMessage(theMessage);
@@ -977,13 +1047,13 @@ void DoTEVoltageVariationExpt(double inL_V, double inH_V, double inStep_V)
         // PRINT, LOG OMEGA MATRIX
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
 
 
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Omega Matrix");
@@ -994,19 +1064,19 @@ void DoTEVoltageVariationExpt(double inL_V, double inH_V, double inStep_V)
         //---------------------------------------------
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
         // copy current eigenvalues to the Result matrix for print out
         // at end of simulation
-        CopyFVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
+        CopyOmegaVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
 
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -1015,22 +1085,22 @@ void DoTEVoltageVariationExpt(double inL_V, double inH_V, double inStep_V)
         //---------------------------------------------
         // TEST OMEGA EIGENVECTOR ORTHONORMALITY
         //---------------------------------------------
-        theEigenVector_T = matrix(1,theDim, \
+        theEigenVector_T = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        theMatrixProduct = matrix(1,theDim, \
+        theMatrixProduct = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        TransposeFMatrix(gEigenVector,theEigenVector_T, \
+        TransposeOmegaMatrix(gEigenVector,theEigenVector_T, \
                          1, theDim, \
                          1, theDim);
 
-        MultiplyFMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
+        MultiplyOmegaMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
                          1, theDim, 1, theDim, \
                          1, theDim, 1, theDim);
 
 
-        LogFMatrix(theMatrixProduct,\
+        LogOmegaMatrix(theMatrixProduct,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Product Matrix (Omega Eigenvectors):  E*E^T");
@@ -1055,11 +1125,11 @@ void DoTEVoltageVariationExpt(double inL_V, double inH_V, double inStep_V)
    } // end for loop
 
    // copy peak defs. (indep. variable) to result matrix, column 0.
-   CopyFVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
+   CopyOmegaVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
 
 
 
-   LogFMatrix(theOmegaResult,\
+   LogOmegaMatrix(theOmegaResult,\
         1,theResultRow,\
         0,gNumberOfEigenFunctions,\
         "Omega Eigenvalues:  Summary");
@@ -1088,9 +1158,9 @@ void DoGapDistanceVariationExpt(double inL_um, double inH_um, double inStep_um)
 {
    int theDim;
 
-   float  **theOmegaResult;
-   float **theEigenVector_T;
-   float   *thePeakDefResult;
+   OmegaScalar **theOmegaResult;
+   OmegaScalar **theEigenVector_T;
+   OmegaScalar  *thePeakDefResult;
 
    double theGapDist_um;
 
@@ -1105,9 +1175,9 @@ void DoGapDistanceVariationExpt(double inL_um, double inH_um, double inStep_um)
    theDim = gNumberOfEigenFunctions;
    theMaxNumberOfSimulations = 200;
 
-   theOmegaResult = matrix(0,theMaxNumberOfSimulations, \
+   theOmegaResult = omega_matrix(0,theMaxNumberOfSimulations, \
                     0,gNumberOfEigenFunctions);
-   thePeakDefResult = vector(0,theMaxNumberOfSimulations);
+   thePeakDefResult = omega_vector(0,theMaxNumberOfSimulations);
 
    LogMessage("--- Begin Gap Distance Simulation --- ");
 
@@ -1134,7 +1204,7 @@ void DoGapDistanceVariationExpt(double inL_um, double inH_um, double inStep_um)
 
         // copy current eigenvalues to the Result
         // matrix for print out at end of simulation
-        CopyFVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
+        CopyOmegaVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
 
         // row index for eigenvalue result matrix
         theResultRow++;
@@ -1142,11 +1212,11 @@ void DoGapDistanceVariationExpt(double inL_um, double inH_um, double inStep_um)
    }
 
    // copy peak defs. (indep. variable) to result matrix, column 0.
-   CopyFVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
+   CopyOmegaVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
 
 
 
-   LogFMatrix(theOmegaResult,\
+   LogOmegaMatrix(theOmegaResult,\
         1,theResultRow,\
         0,gNumberOfEigenFunctions,\
         "Omega Eigenvalues:  Summary");
@@ -1177,15 +1247,15 @@ void DoEigenfuncAmplVariationExpt(int inJ, double inL_um, double inH_um, double
 {
    int theDim;
 
-   float **theOmega;
+   OmegaScalar **theOmega;
    double **theMatrixA;
    double **theMatrixASum;
-   float  **theOmegaResult;
-   float **theEigenVector_T;
-   float **theMatrixProduct;
-   float **theSimilarMatrix;
+   OmegaScalar **theOmegaResult;
+   OmegaScalar **theEigenVector_T;
+   OmegaScalar **theMatrixProduct;
+   OmegaScalar **theSimilarMatrix;
    double **theEPMatrix;
-   float   *thePeakDefResult;
+   OmegaScalar  *thePeakDefResult;
 
    double theCoeffValue_units;
 
@@ -1198,7 +1268,7 @@ void DoEigenfuncAmplVariationExpt(int inJ, double inL_um, double inH_um, double
    LogMessage("--- Begin EigenfuncAmplVariationExpt --- ");
 
 
-   theOmega = matrix(1,gNumberOfEigenFunctions, \
+   theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
    theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -1207,9 +1277,9 @@ void DoEigenfuncAmplVariationExpt(int inJ, double inL_um, double inH_um, double
 
 
    theMaxNumberOfSimulations = 200;
-   theOmegaResult = matrix(0,theMaxNumberOfSimulations, \
+   theOmegaResult = omega_matrix(0,theMaxNumberOfSimulations, \
                     0,gNumberOfEigenFunctions);
-   thePeakDefResult = vector(0,theMaxNumberOfSimulations);
+   thePeakDefResult = omega_vector(0,theMaxNumberOfSimulations);
 
 
    theResultRow = 1;
@@ -1265,13 +1335,13 @@ void DoEigenfuncAmplVariationExpt(int inJ, double inL_um, double inH_um, double
         // PRINT, LOG OMEGA MATRIX
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
 
 
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Omega Matrix");
@@ -1282,19 +1352,19 @@ void DoEigenfuncAmplVariationExpt(int inJ, double inL_um, double inH_um, double
         //---------------------------------------------
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
         // copy current eigenvalues to the Result matrix for print out
         // at end of simulation
-        CopyFVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
+        CopyOmegaVectorToMatrixRow(gEigenValue,1,theDim,theOmegaResult,theResultRow);
 
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -1303,22 +1373,22 @@ void DoEigenfuncAmplVariationExpt(int inJ, double inL_um, double inH_um, double
         //---------------------------------------------
         // TEST OMEGA EIGENVECTOR ORTHONORMALITY
         //---------------------------------------------
-        theEigenVector_T = matrix(1,theDim, \
+        theEigenVector_T = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        theMatrixProduct = matrix(1,theDim, \
+        theMatrixProduct = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        TransposeFMatrix(gEigenVector,theEigenVector_T, \
+        TransposeOmegaMatrix(gEigenVector,theEigenVector_T, \
                          1, theDim, \
                          1, theDim);
 
-        MultiplyFMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
+        MultiplyOmegaMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
                          1, theDim, 1, theDim, \
                          1, theDim, 1, theDim);
 
 
-        LogFMatrix(theMatrixProduct,\
+        LogOmegaMatrix(theMatrixProduct,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Product Matrix (Omega Eigenvectors):  E*E^T");
@@ -1343,11 +1413,11 @@ void DoEigenfuncAmplVariationExpt(int inJ, double inL_um, double inH_um, double
    } // end for loop
 
    // copy peak defs. (indep. variable) to result matrix, column 0.
-   CopyFVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
+   CopyOmegaVectorToMatrixCol(thePeakDefResult,1,theResultRow-1,theOmegaResult,0);
 
 
 
-   LogFMatrix(theOmegaResult,\
+   LogOmegaMatrix(theOmegaResult,\
         1,theResultRow,\
         0,gNumberOfEigenFunctions,\
         "Omega Eigenvalues:  Summary");
@@ -1381,19 +1451,19 @@ void DoDeviceStabilityAnalysis()
 {
    int theDim;
 
-   float **theOmega;
+   OmegaScalar **theOmega;
    double **theMatrixA;
    double **theMatrixASum;
-   float **theEigenVector_T;
-   float **theMatrixProduct;
-   float **theSimilarMatrix;
+   OmegaScalar **theEigenVector_T;
+   OmegaScalar **theMatrixProduct;
+   OmegaScalar **theSimilarMatrix;
    double **theEPMatrix;
 
    char theMessage[100];
 
 
 
-   theOmega = matrix(1,gNumberOfEigenFunctions, \
+   theOmega = omega_matrix(1,gNumberOfEigenFunctions, \
                     1,gNumberOfEigenFunctions);
    theMatrixA = dmatrix(0,gNumberOfEigenFunctions-1, \
                     0,gNumberOfEigenFunctions-1);
@@ -1440,13 +1510,13 @@ void DoDeviceStabilityAnalysis()
         // PRINT, LOG OMEGA MATRIX
         //---------------------------------------------
 
-        CopyFMatrix(gOmega,theOmega, \
+        CopyOmegaMatrix(gOmega,theOmega, \
                     1,gNumberOfEigenFunctions,\
                     1,gNumberOfEigenFunctions);
 
 
 
-        LogFMatrix(gOmega,\
+        LogOmegaMatrix(gOmega,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Omega Matrix");
@@ -1457,16 +1527,16 @@ void DoDeviceStabilityAnalysis()
         //---------------------------------------------
 
         theDim = gNumberOfEigenFunctions;
-        DiagonalizeFMatrix(theOmega,theDim,gEigenValue,gEigenVector);
+        DiagonalizeOmegaMatrix(theOmega,theDim,gEigenValue,gEigenVector);
 
         //---------------------------------------------
         // DISPLAY OMEGA EIGENVALUES, EIGENVECTORS
         //---------------------------------------------
 
-        LogFVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
+        LogOmegaVector(gEigenValue,1,theDim,"Omega Matrix -- Eigenvalues");
 
 
-        LogFMatrix(gEigenVector, \
+        LogOmegaMatrix(gEigenVector, \
                      1, theDim, \
                      1, theDim, \
                      "Omega Matrix -- Eigenvectors");
@@ -1475,22 +1545,22 @@ void DoDeviceStabilityAnalysis()
         //---------------------------------------------
         // TEST OMEGA EIGENVECTOR ORTHONORMALITY
         //---------------------------------------------
-        theEigenVector_T = matrix(1,theDim, \
+        theEigenVector_T = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        theMatrixProduct = matrix(1,theDim, \
+        theMatrixProduct = omega_matrix(1,theDim, \
                                    1,theDim);
 
-        TransposeFMatrix(gEigenVector,theEigenVector_T, \
+        TransposeOmegaMatrix(gEigenVector,theEigenVector_T, \
                          1, theDim, \
                          1, theDim);
 
-        MultiplyFMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
+        MultiplyOmegaMatrix(gEigenVector,theEigenVector_T, theMatrixProduct,\
                          1, theDim, 1, theDim, \
                          1, theDim, 1, theDim);
 
 
-        LogFMatrix(theMatrixProduct,\
+        LogOmegaMatrix(theMatrixProduct,\
                      1,gNumberOfEigenFunctions,\
                      1,gNumberOfEigenFunctions,\
                      "Product Matrix (Omega Eigenvectors):  E*E^T");
@@ -11,12 +11,15 @@
 #define SAVALIDATE_H
 
 
+#include "MatrixUtils.h"
+
+
 void TestSmallAmplitudeStability(float inVaLow_V, \
                                  float inVaHigh_V, \
                                  float inVtLow_V, \
                                  float inVtHigh_V, \
                                  int   inNumGridPoints);
-float GetDeviceStability();
+OmegaScalar GetDeviceStability();
 void RunStabilityComputation();
 void RunFastStabilityComputation();
 void TestStabilityMatrixEigenvectors();
@@ -33,6 +36,11 @@ void DoEigenfuncAmplVariationExpt(int inJ, \
 
 void DoDeviceStabilityAnalysis();
 
+#ifdef SA_TCL_MODULE
+int Ping();
+int Createdevice();
+#endif
+
 
 
 
@@ -0,0 +1,113 @@
+//---------------------------------------------------------------------------
+// StabilityBatch.c
+//
+// Batch evaluation of device stability.  See StabilityBatch.h
+//
+// Devices in a batch are independent, and are distributed over processors
+// when compiled with OpenMP support.
+//---------------------------------------------------------------------------
+#include "StabilityBatch.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+
+
+extern int      gNumberOfEigenFunctions;
+extern int      gNumElectrodes;
+extern double   gMembraneTension_NByM;
+
+
+
+//---------------------------------------------------------------------------
+// StabilityBatchStride
+//
+// Returns the number of doubles in one device parameter tuple.
+//---------------------------------------------------------------------------
+int StabilityBatchStride()
+{
+   return BATCH_NUM_DEVICE_PARAMS + gNumberOfEigenFunctions;
+}
+
+
+//---------------------------------------------------------------------------
+// GetDeviceStabilityBatch
+//
+// Computes the minimum eigenvalue of the Omega matrix for each of
+// inNumDevices device configurations packed in inParams (see
+// StabilityBatch.h).  Results are written to
+// outMinEigenvalue[0...inNumDevices-1]; NO_EQUILIBRIUM_EIGENVALUE marks
+// devices for which no self consistent electrode voltages were found.
+//
+// The globals describing the current device are not modified.
+//
+//  return value:
+//          0    successful completion
+//          1    invalid arguments
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int GetDeviceStabilityBatch(double *inParams, int inNumDevices, \
+                            float *outMinEigenvalue)
+{
+   int  n;
+   int  theStride;
+   char theMessage[100];
+
+   if (inParams == NULL || outMinEigenvalue == NULL || inNumDevices < 0)
+   {
+      LogMessage("--- GetDeviceStabilityBatch:  invalid arguments ---");
+      return 1;
+   }
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   theStride = StabilityBatchStride();
+
+#pragma omp parallel for schedule(dynamic)
+   for (n=0;n<inNumDevices;n++)
+   {
+      int          j;
+      double      *theTuple;
+      DeviceConfig theConfig;
+
+      theTuple = inParams + n*theStride;
+
+      theConfig.VoltageT_V = theTuple[0];
+      theConfig.DistA_um = theTuple[2];
+      theConfig.DistT_um = theTuple[3];
+      theConfig.MembraneTension_NByM = gMembraneTension_NByM;
+      theConfig.ExpansionCoeff_MKS = dvector(0,gNumberOfEigenFunctions-1);
+      theConfig.ElectrodeVoltage_V = vector(0,gNumElectrodes-1);
+
+      for (j=0;j<gNumberOfEigenFunctions;j++)
+         theConfig.ExpansionCoeff_MKS[j] = theTuple[BATCH_NUM_DEVICE_PARAMS+j];
+      theConfig.ExpansionCoeff_MKS[0] += theTuple[4]*1e-6/ \
+                                         ModalPeakAmplitude_MKS(0);
+
+      if (theTuple[1] == BATCH_SELF_CONSISTENT_VA)
+      {
+         if (ComputeDeviceElectrodeVoltage(&theConfig))
+            outMinEigenvalue[n] = NO_EQUILIBRIUM_EIGENVALUE;
+         else
+            outMinEigenvalue[n] = DeviceMinEigenvalue(&theConfig);
+      }
+      else
+      {
+         SetDeviceArrayVoltage(&theConfig,theTuple[1]);
+         outMinEigenvalue[n] = DeviceMinEigenvalue(&theConfig);
+      }
+
+      free_dvector(theConfig.ExpansionCoeff_MKS,0,gNumberOfEigenFunctions-1);
+      free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+   }
+
+   sprintf(theMessage,\
+           "--- GetDeviceStabilityBatch:  evaluated %d devices ---",\
+           inNumDevices);
+   LogMessage(theMessage);
+
+   return 0;
+}
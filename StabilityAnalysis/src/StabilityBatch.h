@@ -0,0 +1,32 @@
+//---------------------------------------------------------------------------
+// StabilityBatch.h
+//
+// Batch evaluation of device stability.  Each device configuration is
+// packed as a tuple of doubles:
+//
+//    [0]      Vt         transparent electrode voltage, V
+//    [1]      Va         array voltage, V.  BATCH_SELF_CONSISTENT_VA
+//                        selects the self consistent electrode voltages
+//                        for the membrane shape (ComputeElectrodeVoltage)
+//    [2]      dA         electrode array -- membrane distance, um
+//    [3]      dT         transparent electrode -- membrane distance, um
+//    [4]      peak deformation, um (BesselJ0 shape, added to a_0)
+//    [5...]   a_0 ... a_N-1   membrane shape expansion coeffs, MKS
+//
+// The tuple length is StabilityBatchStride() = 5 + gNumberOfEigenFunctions.
+// Membrane tension and the electrode array are taken from the globals.
+//---------------------------------------------------------------------------
+#ifndef STABILITYBATCH_H
+#define STABILITYBATCH_H
+
+
+#define BATCH_SELF_CONSISTENT_VA  9999
+#define BATCH_NUM_DEVICE_PARAMS   5
+
+
+int StabilityBatchStride();
+int GetDeviceStabilityBatch(double *inParams, int inNumDevices, \
+                            float *outMinEigenvalue);
+
+
+#endif
@@ -0,0 +1,480 @@
+//---------------------------------------------------------------------------
+// StabilityCache.c
+//
+// Persistent cache of stability computations.  See StabilityCache.h
+//
+// All records of the cache file are indexed in memory by an open
+// addressing hash table.  On a miss, records appended to the file by other
+// processes since the last read are indexed before the spectrum is
+// computed.  Each new record is written with a single fwrite() and
+// flushed, so appends from several processes do not interleave within a
+// record on file systems with atomic appends;  elsewhere the checksum
+// rejects damaged records and the reader resynchronizes on the next
+// valid one.
+//
+// Within a process, the cache may be called from parallel workers (e.g.
+// OpenMP threads).  Access to the index and the file is serialized; the
+// spectrum computation itself is not.
+//
+// The file is read with fread() rather than mapped (CreateFileMapping()/
+// mmap(), as VoltageExchange.c):  it grows while it is in use, by this
+// and by other processes, and a mapping covers a fixed length, so every
+// append would need a new mapping.  Each record is read only once, into
+// the index, so a mapping would not save any copies.
+//---------------------------------------------------------------------------
+#include "StabilityCache.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+
+#define STABILITY_CACHE_FILE_ID  0x53414332    // "SAC2", double eigenvalues
+
+
+FILE                  *gStabilityCacheFile = NULL;
+long                   gStabilityCacheFileOffset;   // bytes indexed so far
+
+StabilityCacheRecord  *gStabilityCacheRecord;
+int                    gStabilityCacheNumRecords = 0;
+int                    gStabilityCacheMaxRecords = 0;
+int                   *gStabilityCacheHash;          // record index, or -1
+int                    gStabilityCacheHashSize = 0;  // power of 2
+
+int                    gStabilityCacheGeneration = -1;
+unsigned int           gStabilityCacheBasisKeyA;
+unsigned int           gStabilityCacheBasisKeyB;
+
+int                    gStabilityCacheHits = 0;
+int                    gStabilityCacheMisses = 0;
+
+
+extern int      gFastStabilityDim;
+extern int      gFastStabilityNumElectrodes;
+extern int      gFastStabilityGeneration;
+extern double **gBasisCos;
+extern double **gBasisSin;
+extern double **gBasisShape;
+extern double  *gBasisDel2Factor;
+extern double   gBasisElectrodeArea_MKS;
+extern int      gMatrixACubature;
+extern int      gMatrixACubatureNumR;
+extern int      gMatrixACubatureNumPhi;
+
+extern int      gNumElectrodes;
+
+
+
+//---------------------------------------------------------------------------
+// StabilityCacheHashBytes
+//
+// Adds inNumBytes bytes to two independent 32 bit hashes:  FNV-1a (ioA)
+// and Jenkins one-at-a-time (ioB, without final mixing).
+//---------------------------------------------------------------------------
+void StabilityCacheHashBytes(void *inData, int inNumBytes, \
+                             unsigned int *ioA, unsigned int *ioB)
+{
+   int            i;
+   unsigned char *theByte;
+   unsigned int   theA;
+   unsigned int   theB;
+
+   theByte = (unsigned char *) inData;
+   theA = *ioA;
+   theB = *ioB;
+
+   for (i=0;i<inNumBytes;i++)
+   {
+      theA = (theA ^ theByte[i])*16777619U;
+
+      theB += theByte[i];
+      theB += theB << 10;
+      theB ^= theB >> 6;
+   }
+
+   *ioA = theA;
+   *ioB = theB;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityCacheChecksum
+//---------------------------------------------------------------------------
+unsigned int StabilityCacheChecksum(StabilityCacheRecord *inRecord)
+{
+   unsigned int theA = 2166136261U;
+   unsigned int theB = 0;
+
+   // all fields before Checksum;  the record may have tail padding
+   StabilityCacheHashBytes(inRecord, \
+                           offsetof(StabilityCacheRecord,Checksum),\
+                           &theA, &theB);
+   return theA;
+}
+
+
+//---------------------------------------------------------------------------
+// ComputeStabilityCacheBasisKey
+//
+// Hashes the tabulated eigenfunction basis of FastStability.c, which
+// depends on the number of eigenfunctions, the membrane radius and the
+// electrode table and geometry, the size of OmegaScalar, and the cubature
+// rule if the A matrix is computed by cubature (see SetMatrixACubature()).
+//---------------------------------------------------------------------------
+void ComputeStabilityCacheBasisKey()
+{
+   int j;
+   int theNumBytes;
+   int theScalarSize;
+   unsigned int theA = 2166136261U;
+   unsigned int theB = 0;
+
+   theNumBytes = gFastStabilityNumElectrodes*sizeof(double);
+   theScalarSize = (int) sizeof(OmegaScalar);
+
+   StabilityCacheHashBytes(&theScalarSize,sizeof(int),&theA,&theB);
+   if (gMatrixACubature)
+   {
+      StabilityCacheHashBytes(&gMatrixACubatureNumR,sizeof(int),&theA,&theB);
+      StabilityCacheHashBytes(&gMatrixACubatureNumPhi,sizeof(int),\
+                              &theA,&theB);
+   }
+   StabilityCacheHashBytes(&gFastStabilityDim,sizeof(int),&theA,&theB);
+   StabilityCacheHashBytes(&gFastStabilityNumElectrodes,sizeof(int),\
+                           &theA,&theB);
+   StabilityCacheHashBytes(&gBasisElectrodeArea_MKS,sizeof(double),\
+                           &theA,&theB);
+   StabilityCacheHashBytes(gBasisDel2Factor,gFastStabilityDim*sizeof(double),\
+                           &theA,&theB);
+
+   for (j=0;j<gFastStabilityDim;j++)
+   {
+      StabilityCacheHashBytes(gBasisCos[j],theNumBytes,&theA,&theB);
+      StabilityCacheHashBytes(gBasisSin[j],theNumBytes,&theA,&theB);
+      StabilityCacheHashBytes(gBasisShape[j],theNumBytes,&theA,&theB);
+   }
+
+   gStabilityCacheBasisKeyA = theA;
+   gStabilityCacheBasisKeyB = theB;
+   gStabilityCacheGeneration = gFastStabilityGeneration;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityCacheSlot
+//
+// Returns the hash table slot holding the record with key (inA,inB), or
+// the empty slot where it should be inserted.
+//---------------------------------------------------------------------------
+int StabilityCacheSlot(unsigned int inA, unsigned int inB)
+{
+   int theSlot;
+   int theRecord;
+
+   theSlot = (int) (inA & (gStabilityCacheHashSize-1));
+
+   while ((theRecord = gStabilityCacheHash[theSlot]) >= 0)
+   {
+      if (gStabilityCacheRecord[theRecord].KeyA == inA && \
+          gStabilityCacheRecord[theRecord].KeyB == inB)
+         break;
+
+      theSlot = (theSlot+1) & (gStabilityCacheHashSize-1);
+   }
+
+   return theSlot;
+}
+
+
+//---------------------------------------------------------------------------
+// AddStabilityCacheRecord
+//
+// Adds a record to the in-memory index (if its key is new).
+//---------------------------------------------------------------------------
+void AddStabilityCacheRecord(StabilityCacheRecord *inRecord)
+{
+   int i;
+   int theSlot;
+
+   if (gStabilityCacheHashSize == 0)
+   {
+      gStabilityCacheMaxRecords = 256;
+      gStabilityCacheHashSize = 512;
+      gStabilityCacheRecord = (StabilityCacheRecord *) \
+            malloc(gStabilityCacheMaxRecords*sizeof(StabilityCacheRecord));
+      gStabilityCacheHash = (int *) malloc(gStabilityCacheHashSize*sizeof(int));
+      if (!gStabilityCacheRecord || !gStabilityCacheHash)
+         nrerror("allocation failure in AddStabilityCacheRecord()");
+
+      for (i=0;i<gStabilityCacheHashSize;i++)
+         gStabilityCacheHash[i] = -1;
+   }
+
+   theSlot = StabilityCacheSlot(inRecord->KeyA,inRecord->KeyB);
+   if (gStabilityCacheHash[theSlot] >= 0) return;
+
+   if (gStabilityCacheNumRecords == gStabilityCacheMaxRecords)
+   {
+      gStabilityCacheMaxRecords *= 2;
+      gStabilityCacheRecord = (StabilityCacheRecord *) \
+            realloc(gStabilityCacheRecord,\
+                    gStabilityCacheMaxRecords*sizeof(StabilityCacheRecord));
+      if (!gStabilityCacheRecord)
+         nrerror("allocation failure in AddStabilityCacheRecord()");
+   }
+
+   gStabilityCacheRecord[gStabilityCacheNumRecords] = *inRecord;
+   gStabilityCacheHash[theSlot] = gStabilityCacheNumRecords;
+   gStabilityCacheNumRecords++;
+
+   // keep the hash table at most half full
+   if (2*gStabilityCacheNumRecords > gStabilityCacheHashSize)
+   {
+      free(gStabilityCacheHash);
+      gStabilityCacheHashSize *= 2;
+      gStabilityCacheHash = (int *) malloc(gStabilityCacheHashSize*sizeof(int));
+      if (!gStabilityCacheHash)
+         nrerror("allocation failure in AddStabilityCacheRecord()");
+
+      for (i=0;i<gStabilityCacheHashSize;i++)
+         gStabilityCacheHash[i] = -1;
+      for (i=0;i<gStabilityCacheNumRecords;i++)
+         gStabilityCacheHash[StabilityCacheSlot(gStabilityCacheRecord[i].KeyA,\
+                                          gStabilityCacheRecord[i].KeyB)] = i;
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// ReadStabilityCacheFile
+//
+// Indexes the records appended to the cache file since the last read.
+// A record that fails its checksum is skipped one byte at a time until
+// the next valid record is found.  An incomplete record at the end of
+// the file is left to a later read.
+//---------------------------------------------------------------------------
+void ReadStabilityCacheFile()
+{
+   StabilityCacheRecord theRecord;
+
+   if (gStabilityCacheFile == NULL) return;
+
+   fflush(gStabilityCacheFile);
+
+   while (fseek(gStabilityCacheFile,gStabilityCacheFileOffset,SEEK_SET) == 0&&\
+          fread(&theRecord,sizeof(theRecord),1,gStabilityCacheFile) == 1)
+   {
+      if (theRecord.FileID == STABILITY_CACHE_FILE_ID && \
+          theRecord.Dim > 0 && theRecord.Dim <= STABILITY_CACHE_MAX_DIM && \
+          theRecord.Checksum == StabilityCacheChecksum(&theRecord))
+      {
+         AddStabilityCacheRecord(&theRecord);
+         gStabilityCacheFileOffset += sizeof(theRecord);
+      }
+      else
+      {
+         gStabilityCacheFileOffset++;
+      }
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// OpenStabilityCache
+//
+// Opens (or creates) the cache file and indexes its records.  Records
+// computed while no cache file is open are kept in memory only.
+//
+//  return value:
+//          0    successful completion
+//          1    file error
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int OpenStabilityCache(char *inFileName)
+{
+   char theMessage[100];
+
+   CloseStabilityCache();
+
+   if ((gStabilityCacheFile = fopen(inFileName,"a+b")) == NULL)
+   {
+      LogMessage("--- OpenStabilityCache:  cannot open file ---");
+      return 1;
+   }
+
+   gStabilityCacheFileOffset = 0;
+   ReadStabilityCacheFile();
+
+   sprintf(theMessage,"--- OpenStabilityCache:  %d records ---",\
+           gStabilityCacheNumRecords);
+   LogMessage(theMessage);
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// CloseStabilityCache
+//
+// Closes the cache file and releases the in-memory index.
+//---------------------------------------------------------------------------
+void CloseStabilityCache()
+{
+   char theMessage[100];
+
+   if (gStabilityCacheFile != NULL)
+   {
+      sprintf(theMessage,"--- CloseStabilityCache:  %d hits, %d misses ---",\
+              gStabilityCacheHits, gStabilityCacheMisses);
+      LogMessage(theMessage);
+
+      fclose(gStabilityCacheFile);
+      gStabilityCacheFile = NULL;
+   }
+
+   if (gStabilityCacheHashSize > 0)
+   {
+      free(gStabilityCacheRecord);
+      free(gStabilityCacheHash);
+   }
+
+   gStabilityCacheNumRecords = 0;
+   gStabilityCacheMaxRecords = 0;
+   gStabilityCacheHashSize = 0;
+   gStabilityCacheHits = 0;
+   gStabilityCacheMisses = 0;
+}
+
+
+//---------------------------------------------------------------------------
+// CachedDeviceSpectrum
+//
+// Same as DeviceSpectrum(), but returns the cached spectrum if this
+// device configuration has been computed before, in this or any earlier
+// run sharing the cache file.
+//---------------------------------------------------------------------------
+int CachedDeviceSpectrum(DeviceConfig *inConfig, double *outEigenValue)
+{
+   int          i;
+   int          theRecord;
+   unsigned int theA;
+   unsigned int theB;
+   StabilityCacheRecord theNew;
+
+   if (gFastStabilityDim > STABILITY_CACHE_MAX_DIM)
+      return DeviceSpectrum(inConfig,outEigenValue);
+
+   theRecord = -1;
+
+#pragma omp critical (StabilityCache)
+   {
+      if (gStabilityCacheGeneration != gFastStabilityGeneration)
+         ComputeStabilityCacheBasisKey();
+
+      theA = gStabilityCacheBasisKeyA;
+      theB = gStabilityCacheBasisKeyB;
+   }
+
+   StabilityCacheHashBytes(&inConfig->VoltageT_V,sizeof(double),&theA,&theB);
+   StabilityCacheHashBytes(&inConfig->DistT_um,sizeof(double),&theA,&theB);
+   StabilityCacheHashBytes(&inConfig->DistA_um,sizeof(double),&theA,&theB);
+   StabilityCacheHashBytes(&inConfig->MembraneTension_NByM,sizeof(double),\
+                           &theA,&theB);
+   StabilityCacheHashBytes(inConfig->ExpansionCoeff_MKS,\
+                           gFastStabilityDim*sizeof(double),&theA,&theB);
+   StabilityCacheHashBytes(inConfig->ElectrodeVoltage_V,\
+                           gFastStabilityNumElectrodes*sizeof(float),\
+                           &theA,&theB);
+
+#pragma omp critical (StabilityCache)
+   {
+      if (gStabilityCacheHashSize > 0)
+         theRecord = gStabilityCacheHash[StabilityCacheSlot(theA,theB)];
+
+      if (theRecord < 0)
+      {
+         ReadStabilityCacheFile();
+         if (gStabilityCacheHashSize > 0)
+            theRecord = gStabilityCacheHash[StabilityCacheSlot(theA,theB)];
+      }
+
+      if (theRecord >= 0)
+      {
+         for (i=0;i<gStabilityCacheRecord[theRecord].Dim;i++)
+            outEigenValue[i] = gStabilityCacheRecord[theRecord].EigenValue[i];
+         gStabilityCacheHits++;
+      }
+   }
+
+   if (theRecord >= 0) return gFastStabilityDim;
+
+   memset(&theNew,0,sizeof(theNew));
+   theNew.FileID = STABILITY_CACHE_FILE_ID;
+   theNew.KeyA = theA;
+   theNew.KeyB = theB;
+   theNew.Dim = DeviceSpectrum(inConfig,theNew.EigenValue);
+   theNew.Checksum = StabilityCacheChecksum(&theNew);
+
+   for (i=0;i<theNew.Dim;i++)
+      outEigenValue[i] = theNew.EigenValue[i];
+
+#pragma omp critical (StabilityCache)
+   {
+      AddStabilityCacheRecord(&theNew);
+      gStabilityCacheMisses++;
+
+      if (gStabilityCacheFile != NULL)
+      {
+         fseek(gStabilityCacheFile,0,SEEK_END);
+         fwrite(&theNew,sizeof(theNew),1,gStabilityCacheFile);
+         fflush(gStabilityCacheFile);
+      }
+   }
+
+   return theNew.Dim;
+}
+
+
+//---------------------------------------------------------------------------
+// CachedDeviceMinEigenvalue
+//
+// Same as DeviceMinEigenvalue(), through the cache.
+//---------------------------------------------------------------------------
+OmegaScalar CachedDeviceMinEigenvalue(DeviceConfig *inConfig)
+{
+   double theEigenValue[FAST_STABILITY_MAX_DIM];
+
+   CachedDeviceSpectrum(inConfig,theEigenValue);
+
+   return (OmegaScalar) theEigenValue[0];
+}
+
+
+//---------------------------------------------------------------------------
+// GetCachedDeviceStability
+//
+// Minimum eigenvalue of the Omega matrix for the current device (global
+// simulation parameters), through the cache.  Same value as the minimum
+// of gEigenValue[] after RunFastStabilityComputation().
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+OmegaScalar GetCachedDeviceStability()
+{
+   OmegaScalar  theMin;
+   DeviceConfig theConfig;
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   GetGlobalDeviceConfig(&theConfig);
+   theMin = CachedDeviceMinEigenvalue(&theConfig);
+   free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+
+   return theMin;
+}
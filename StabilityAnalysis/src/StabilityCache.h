@@ -0,0 +1,48 @@
+//---------------------------------------------------------------------------
+// StabilityCache.h
+//
+// Persistent cache of stability computations.  Each record holds the
+// sorted Omega spectrum of one device configuration, keyed by a 64 bit
+// hash (two independent 32 bit hashes) of every input to the
+// computation:  the tabulated eigenfunction basis (eigenfunction count,
+// membrane radius, electrode table and geometry), the precision of the
+// eigenvalue solver (OmegaScalar), the A matrix rule (pixel sum, or
+// cubature after SetMatrixACubature()), Vt, the gaps, the tension, the
+// membrane shape coefficients and the electrode voltages.  Eigenvalues are stored
+// in double precision, so records of an OMEGA_DOUBLE build keep their full
+// precision;  records of float and double builds have different keys.
+//
+// Records are appended to a binary file shared by all runs.  Every record
+// carries a checksum, so a record that is only partially written (e.g. by
+// a process that was interrupted) is ignored when the file is read.
+//---------------------------------------------------------------------------
+#ifndef STABILITYCACHE_H
+#define STABILITYCACHE_H
+
+
+#include "FastStability.h"
+
+
+#define STABILITY_CACHE_MAX_DIM  32       // eigenvalues stored per record
+
+
+typedef struct
+{
+   unsigned int  FileID;
+   unsigned int  KeyA;
+   unsigned int  KeyB;
+   int           Dim;
+   double        EigenValue[STABILITY_CACHE_MAX_DIM];   // ascending
+   unsigned int  Checksum;
+} StabilityCacheRecord;
+
+
+int   OpenStabilityCache(char *inFileName);
+void  CloseStabilityCache();
+
+int   CachedDeviceSpectrum(DeviceConfig *inConfig, double *outEigenValue);
+OmegaScalar CachedDeviceMinEigenvalue(DeviceConfig *inConfig);
+OmegaScalar GetCachedDeviceStability();
+
+
+#endif
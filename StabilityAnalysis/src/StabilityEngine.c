@@ -0,0 +1,43 @@
+//---------------------------------------------------------------------------
+// StabilityEngine.c
+//
+// Initialization of the stability engine library.  See StabilityEngine.h
+//---------------------------------------------------------------------------
+#include "StabilityEngine.h"
+
+#include <stdio.h>
+
+
+
+//---------------------------------------------------------------------------
+// InitStabilityEngine
+//
+// Opens the log file, sets the default membrane and electrode array
+// parameters (Membrane(), ElectrodeArray()) and tabulates the basis of
+// FastStability.c.  Same initialization as SAValidate main().
+//
+//  return value:
+//          ELECTRODE_ARRAY_OK          (0)
+//          ELECTRODE_ARRAY_MAP_BOUNDS  electrode outside the voltage map
+//
+// called by:  programs linked with libsaengine
+//---------------------------------------------------------------------------
+int InitStabilityEngine()
+{
+   int theResult;
+
+   OpenLogFile();
+   LogMessage("StabilityEngine  (SAValidate Version 4)");
+
+   Membrane();
+   theResult = ElectrodeArray();
+   if (theResult != ELECTRODE_ARRAY_OK)
+   {
+      LogMessage("--- InitStabilityEngine:  electrode array error ---");
+      return theResult;
+   }
+
+   InitFastStability();
+
+   return ELECTRODE_ARRAY_OK;
+}
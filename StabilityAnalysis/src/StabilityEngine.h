@@ -0,0 +1,67 @@
+//---------------------------------------------------------------------------
+// StabilityEngine.h
+//
+// Public interface of the stability engine library (libsaengine, see
+// Makefile):  the numerical core of SAValidate without main() and without
+// console input, for C and C++ programs on any platform.
+//
+// Call InitStabilityEngine() once, set the device parameters below, then
+// use the entry points of the included headers.  Functions that can fail
+// return 0 on success and a nonzero error code otherwise; the codes are
+// listed with each function and #defined in its header (e.g.
+// ELECTRODE_ARRAY_, EQUILIBRIUM_, DYNAMICS_).  Messages go to the log
+// file.  The library exits through the Numerical Recipes error handler
+// nrerror() when memory cannot be allocated, when tqli()/dtqli() do not
+// converge in DiagonalizeOmegaMatrix(), and when qtrap() exceeds its
+// step limit in the radial integrals of MatrixA.c and Eigenfunc.c.
+//---------------------------------------------------------------------------
+#ifndef STABILITYENGINE_H
+#define STABILITYENGINE_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#include "MatrixUtils.h"
+#include "Membrane.h"
+#include "ElectrodeArray.h"
+#include "ComputeOmegaMatrix.h"
+#include "FastStability.h"
+#include "StabilityEnvelope.h"
+#include "StabilityBatch.h"
+#include "StabilityGradient.h"
+#include "StabilityMonteCarlo.h"
+#include "StabilityMap.h"
+#include "StabilityCache.h"
+#include "Equilibrium.h"
+#include "MembraneDynamics.h"
+#include "DiskCubature.h"
+#include "VoltageExchange.h"
+#include "StabilitySweep.h"
+
+
+// device parameters (Membrane.c, ElectrodeArray.c)
+extern double    gMembraneTension_NByM;
+extern double    gMembraneRadius_mm;
+extern double    gVoltageT_V;
+extern double    gVoltageA_V;
+extern double    gDistT_um;
+extern double    gDistA_um;
+extern double    gPeakDeformation_um;
+extern double   *gExpansionCoeff_MKS;
+extern int       gNumberOfEigenFunctions;
+extern int       gNumElectrodes;
+extern float   **gElectrodeVoltage;
+
+
+int InitStabilityEngine();
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
@@ -0,0 +1,565 @@
+//---------------------------------------------------------------------------
+// StabilityEnvelope.c
+//
+// Stability envelope lookup table.  See StabilityEnvelope.h
+//
+// BuildStabilityEnvelope() evaluates the minimum Omega eigenvalue at every
+// grid point with the reentrant routines in FastStability.c.  Grid points
+// are independent, and are distributed over processors when compiled
+// with OpenMP support.
+//---------------------------------------------------------------------------
+#include "StabilityEnvelope.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <string.h>
+
+
+#define ENVELOPE_FILE_ID                "SAENV01"
+#define ENVELOPE_PROJECTION_ITERATIONS  5
+
+
+StabilityEnvelope gStabilityEnvelope;
+
+
+extern int      gNumberOfEigenFunctions;
+extern int      gNumElectrodes;
+
+extern double   gMembraneTension_NByM;
+extern double   gMembraneRadius_mm;
+extern double   gDistT_um;
+extern double   gDistA_um;
+
+
+
+//---------------------------------------------------------------------------
+// EnvelopeGridValue
+//
+// Value of grid point inI of inNum points spanning [inL, inH]
+//---------------------------------------------------------------------------
+double EnvelopeGridValue(double inL, double inH, int inNum, int inI)
+{
+   if (inNum < 2) return inL;
+
+   return inL + inI*(inH-inL)/(inNum-1);
+}
+
+
+//---------------------------------------------------------------------------
+// EnvelopeGridPosition
+//
+// Locates inX on the grid of inNum points spanning [inL, inH].  Returns
+// the index of the grid point at or below inX, and the fractional
+// distance to the next grid point in outFrac.  inX is clamped to the
+// grid.
+//---------------------------------------------------------------------------
+int EnvelopeGridPosition(double inX, double inL, double inH, int inNum, \
+                         double *outFrac)
+{
+   int    theI;
+   double thePos;
+
+   *outFrac = 0.0;
+   if (inNum < 2 || inH == inL) return 0;
+
+   thePos = (inX-inL)*(inNum-1)/(inH-inL);
+
+   if (thePos <= 0) return 0;
+   if (thePos >= inNum-1) return inNum-1;
+
+   theI = (int) thePos;
+   *outFrac = thePos - theI;
+
+   return theI;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityEnvelopeSize
+//
+// Returns the number of entries in the current stability envelope table,
+// or 0 if no table has been built or loaded.
+//---------------------------------------------------------------------------
+int StabilityEnvelopeSize()
+{
+   int i;
+   int theSize;
+
+   if (gStabilityEnvelope.MinEigenvalue == NULL) return 0;
+
+   theSize = gStabilityEnvelope.NumVt;
+   for (i=0;i<gStabilityEnvelope.NumModes;i++)
+      theSize *= gStabilityEnvelope.NumAmpl;
+
+   return theSize;
+}
+
+
+//---------------------------------------------------------------------------
+// FreeStabilityEnvelope
+//---------------------------------------------------------------------------
+void FreeStabilityEnvelope()
+{
+   int theSize;
+
+   theSize = StabilityEnvelopeSize();
+   if (theSize > 0)
+      free_vector(gStabilityEnvelope.MinEigenvalue,0,theSize-1);
+
+   gStabilityEnvelope.MinEigenvalue = NULL;
+   gStabilityEnvelope.NumModes = 0;
+}
+
+
+//---------------------------------------------------------------------------
+// BuildStabilityEnvelope
+//
+// Tabulates the minimum eigenvalue of the Omega matrix over inNumVt
+// transparent electrode voltages in [inVtL_V, inVtH_V], and inNumAmpl
+// amplitudes in [inAmplL_um, inAmplH_um] for each of the first inNumModes
+// membrane shape modes.  The electrode voltages at each grid point are
+// computed self consistently from the membrane shape, as in
+// ComputeElectrodeVoltage().  The remaining device parameters (gaps,
+// tension, electrode array) are taken from the current globals.
+//
+// The table has inNumVt * inNumAmpl^inNumModes entries.
+//
+//  return value:
+//          0    successful completion
+//          1    invalid arguments
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int BuildStabilityEnvelope(double inVtL_V, double inVtH_V, int inNumVt, \
+                           double inAmplL_um, double inAmplH_um, \
+                           int inNumAmpl, int inNumModes)
+{
+   int    n;
+   int    theSize;
+   int    theNumNoEquilibrium;
+   char   theMessage[100];
+
+   if (inNumModes < 1 || inNumModes > ENVELOPE_MAX_MODES || \
+       inNumModes > gNumberOfEigenFunctions || \
+       inNumVt < 1 || inNumAmpl < 1)
+   {
+      LogMessage("--- BuildStabilityEnvelope:  invalid table size ---");
+      return 1;
+   }
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   FreeStabilityEnvelope();
+
+   gStabilityEnvelope.NumModes  = inNumModes;
+   gStabilityEnvelope.NumVt     = inNumVt;
+   gStabilityEnvelope.NumAmpl   = inNumAmpl;
+   gStabilityEnvelope.VtL_V     = inVtL_V;
+   gStabilityEnvelope.VtH_V     = inVtH_V;
+   gStabilityEnvelope.AmplL_um  = inAmplL_um;
+   gStabilityEnvelope.AmplH_um  = inAmplH_um;
+
+   gStabilityEnvelope.DistT_um               = gDistT_um;
+   gStabilityEnvelope.DistA_um               = gDistA_um;
+   gStabilityEnvelope.MembraneTension_NByM   = gMembraneTension_NByM;
+   gStabilityEnvelope.MembraneRadius_mm      = gMembraneRadius_mm;
+   gStabilityEnvelope.NumberOfEigenFunctions = gNumberOfEigenFunctions;
+
+   theSize = inNumVt;
+   for (n=0;n<inNumModes;n++)
+      theSize *= inNumAmpl;
+   gStabilityEnvelope.MinEigenvalue = vector(0,theSize-1);
+
+   sprintf(theMessage,\
+           "--- BuildStabilityEnvelope:  %d modes, %d grid points ---",\
+           inNumModes, theSize);
+   LogMessage(theMessage);
+
+   theNumNoEquilibrium = 0;
+
+#pragma omp parallel for schedule(dynamic) reduction(+:theNumNoEquilibrium)
+   for (n=0;n<theSize;n++)
+   {
+      int          j;
+      int          theRemainder;
+      double       theAmpl_um;
+      DeviceConfig theConfig;
+
+      theConfig.DistT_um = gStabilityEnvelope.DistT_um;
+      theConfig.DistA_um = gStabilityEnvelope.DistA_um;
+      theConfig.MembraneTension_NByM = gStabilityEnvelope.MembraneTension_NByM;
+      theConfig.ExpansionCoeff_MKS = dvector(0,gNumberOfEigenFunctions-1);
+      theConfig.ElectrodeVoltage_V = vector(0,gNumElectrodes-1);
+
+      // decode the grid point:  Vt varies fastest
+      theRemainder = n;
+      theConfig.VoltageT_V = EnvelopeGridValue(inVtL_V,inVtH_V,inNumVt, \
+                                               theRemainder % inNumVt);
+      theRemainder /= inNumVt;
+
+      for (j=0;j<gNumberOfEigenFunctions;j++)
+      {
+         theConfig.ExpansionCoeff_MKS[j] = 0.0;
+         if (j < inNumModes)
+         {
+            theAmpl_um = EnvelopeGridValue(inAmplL_um,inAmplH_um,inNumAmpl,\
+                                           theRemainder % inNumAmpl);
+            theRemainder /= inNumAmpl;
+            theConfig.ExpansionCoeff_MKS[j] = \
+                               theAmpl_um*1e-6/ModalPeakAmplitude_MKS(j);
+         }
+      }
+
+      if (ComputeDeviceElectrodeVoltage(&theConfig))
+      {
+         gStabilityEnvelope.MinEigenvalue[n] = ENVELOPE_NO_EQUILIBRIUM;
+         theNumNoEquilibrium++;
+      }
+      else
+      {
+         gStabilityEnvelope.MinEigenvalue[n] = DeviceMinEigenvalue(&theConfig);
+      }
+
+      free_dvector(theConfig.ExpansionCoeff_MKS,0,gNumberOfEigenFunctions-1);
+      free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+   }
+
+   sprintf(theMessage,\
+           "--- BuildStabilityEnvelope:  done, %d points without equilibrium ---",\
+           theNumNoEquilibrium);
+   LogMessage(theMessage);
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// SaveStabilityEnvelope
+//
+// Writes the current stability envelope table to a binary file.
+//
+//  return value:
+//          0    successful completion
+//          1    no table, or file error
+//---------------------------------------------------------------------------
+int SaveStabilityEnvelope(char *inFileName)
+{
+   FILE *theFile;
+   int   theSize;
+   int   theErr;
+   char  theFileID[8];
+
+   theSize = StabilityEnvelopeSize();
+   if (theSize == 0)
+   {
+      LogMessage("--- SaveStabilityEnvelope:  no table to save ---");
+      return 1;
+   }
+
+   if ((theFile = fopen(inFileName,"wb")) == NULL)
+   {
+      LogMessage("--- SaveStabilityEnvelope:  cannot open file ---");
+      return 1;
+   }
+
+   memset(theFileID,0,sizeof(theFileID));
+   strcpy(theFileID,ENVELOPE_FILE_ID);
+
+   theErr = 0;
+   theErr |= fwrite(theFileID,sizeof(theFileID),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.NumModes,sizeof(int),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.NumVt,sizeof(int),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.NumAmpl,sizeof(int),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.NumberOfEigenFunctions,\
+                    sizeof(int),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.VtL_V,sizeof(double),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.VtH_V,sizeof(double),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.AmplL_um,sizeof(double),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.AmplH_um,sizeof(double),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.DistT_um,sizeof(double),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.DistA_um,sizeof(double),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.MembraneTension_NByM,\
+                    sizeof(double),1,theFile) != 1;
+   theErr |= fwrite(&gStabilityEnvelope.MembraneRadius_mm,\
+                    sizeof(double),1,theFile) != 1;
+   theErr |= fwrite(gStabilityEnvelope.MinEigenvalue,\
+                    sizeof(float),theSize,theFile) != (size_t) theSize;
+
+   fclose(theFile);
+
+   if (theErr)
+   {
+      LogMessage("--- SaveStabilityEnvelope:  write error ---");
+      return 1;
+   }
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityEnvelopeMatchesDevice
+//
+// Returns 1 if the envelope table inEnvelope was built for the current
+// device:  the same number of eigenfunctions, membrane radius, gaps and
+// membrane tension, and no more shape modes than eigenfunctions.
+// Returns 0 otherwise.
+//
+// called by:  LoadStabilityEnvelope(), StabilityMarginForVoltages()
+//---------------------------------------------------------------------------
+int StabilityEnvelopeMatchesDevice(StabilityEnvelope *inEnvelope)
+{
+   if (inEnvelope->NumModes > gNumberOfEigenFunctions) return 0;
+   if (inEnvelope->NumberOfEigenFunctions != gNumberOfEigenFunctions) return 0;
+   if (inEnvelope->MembraneRadius_mm != gMembraneRadius_mm) return 0;
+   if (inEnvelope->DistT_um != gDistT_um) return 0;
+   if (inEnvelope->DistA_um != gDistA_um) return 0;
+   if (inEnvelope->MembraneTension_NByM != gMembraneTension_NByM) return 0;
+
+   return 1;
+}
+
+
+//---------------------------------------------------------------------------
+// LoadStabilityEnvelope
+//
+// Reads a stability envelope table written by SaveStabilityEnvelope(),
+// replacing the current table.  A table built for a different device
+// (see StabilityEnvelopeMatchesDevice()) is rejected, and the current
+// table is kept.
+//
+//  return value:
+//          0    successful completion
+//          1    file error, or not a stability envelope file
+//          2    table was built for a different device
+//---------------------------------------------------------------------------
+int LoadStabilityEnvelope(char *inFileName)
+{
+   int   i;
+   FILE *theFile;
+   int   theSize;
+   int   theErr;
+   char  theFileID[8];
+   StabilityEnvelope theEnvelope;
+
+   if ((theFile = fopen(inFileName,"rb")) == NULL)
+   {
+      LogMessage("--- LoadStabilityEnvelope:  cannot open file ---");
+      return 1;
+   }
+
+   theErr = 0;
+   theErr |= fread(theFileID,sizeof(theFileID),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.NumModes,sizeof(int),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.NumVt,sizeof(int),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.NumAmpl,sizeof(int),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.NumberOfEigenFunctions,\
+                   sizeof(int),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.VtL_V,sizeof(double),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.VtH_V,sizeof(double),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.AmplL_um,sizeof(double),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.AmplH_um,sizeof(double),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.DistT_um,sizeof(double),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.DistA_um,sizeof(double),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.MembraneTension_NByM,\
+                   sizeof(double),1,theFile) != 1;
+   theErr |= fread(&theEnvelope.MembraneRadius_mm,\
+                   sizeof(double),1,theFile) != 1;
+
+   if (theErr || strncmp(theFileID,ENVELOPE_FILE_ID,sizeof(theFileID)) || \
+       theEnvelope.NumModes < 1 || theEnvelope.NumModes > ENVELOPE_MAX_MODES ||\
+       theEnvelope.NumVt < 1 || theEnvelope.NumAmpl < 1)
+   {
+      fclose(theFile);
+      LogMessage("--- LoadStabilityEnvelope:  not a stability envelope file ---");
+      return 1;
+   }
+
+   if (!StabilityEnvelopeMatchesDevice(&theEnvelope))
+   {
+      fclose(theFile);
+      LogMessage("--- LoadStabilityEnvelope:  table was built for a different device ---");
+      return 2;
+   }
+
+   theSize = theEnvelope.NumVt;
+   for (i=0;i<theEnvelope.NumModes;i++)
+      theSize *= theEnvelope.NumAmpl;
+
+   FreeStabilityEnvelope();
+   gStabilityEnvelope = theEnvelope;
+   gStabilityEnvelope.MinEigenvalue = vector(0,theSize-1);
+
+   theErr = fread(gStabilityEnvelope.MinEigenvalue,\
+                  sizeof(float),theSize,theFile) != (size_t) theSize;
+   fclose(theFile);
+
+   if (theErr)
+   {
+      FreeStabilityEnvelope();
+      LogMessage("--- LoadStabilityEnvelope:  table is truncated ---");
+      return 1;
+   }
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityMarginForModes
+//
+// Returns the minimum Omega eigenvalue, interpolated from the stability
+// envelope table, for transparent electrode voltage inVoltageT_V and mode
+// amplitudes inAmpl_um[0...NumModes-1] (peak deformation, um).  Values
+// outside of the table are clamped to the table edges.  The device is
+// stable if the returned margin is greater than zero.
+//
+// Returns ENVELOPE_NO_EQUILIBRIUM if any of the neighboring grid points
+// has no self consistent solution, ENVELOPE_NO_TABLE if no table has been
+// built or loaded.
+//---------------------------------------------------------------------------
+float StabilityMarginForModes(double inVoltageT_V, double *inAmpl_um)
+{
+   int    c,d;
+   int    theNumDim;
+   int    theOffset;
+   int    theStride;
+   int    theIndex[ENVELOPE_MAX_MODES+1];
+   int    theSize[ENVELOPE_MAX_MODES+1];
+   double theFrac[ENVELOPE_MAX_MODES+1];
+   double theWeight;
+   double theValue;
+   double theSum;
+
+   if (gStabilityEnvelope.MinEigenvalue == NULL) return ENVELOPE_NO_TABLE;
+
+   theNumDim = gStabilityEnvelope.NumModes + 1;
+
+   theSize[0] = gStabilityEnvelope.NumVt;
+   theIndex[0] = EnvelopeGridPosition(inVoltageT_V,\
+                                      gStabilityEnvelope.VtL_V,\
+                                      gStabilityEnvelope.VtH_V,\
+                                      gStabilityEnvelope.NumVt,\
+                                      &theFrac[0]);
+   for (d=1;d<theNumDim;d++)
+   {
+      theSize[d] = gStabilityEnvelope.NumAmpl;
+      theIndex[d] = EnvelopeGridPosition(inAmpl_um[d-1],\
+                                         gStabilityEnvelope.AmplL_um,\
+                                         gStabilityEnvelope.AmplH_um,\
+                                         gStabilityEnvelope.NumAmpl,\
+                                         &theFrac[d]);
+   }
+
+   // sum over the 2^theNumDim corners of the enclosing grid cell;
+   // bit d of c selects the upper grid point in dimension d.
+   theSum = 0.0;
+   for (c=0;c<(1<<theNumDim);c++)
+   {
+      theWeight = 1.0;
+      theOffset = 0;
+      theStride = 1;
+      for (d=0;d<theNumDim;d++)
+      {
+         if (c & (1<<d))
+         {
+            if (theFrac[d] == 0.0) break;
+            theWeight *= theFrac[d];
+            theOffset += (theIndex[d]+1)*theStride;
+         }
+         else
+         {
+            theWeight *= 1.0 - theFrac[d];
+            theOffset += theIndex[d]*theStride;
+         }
+         theStride *= theSize[d];
+      }
+
+      // corners with zero weight are skipped
+      if (d < theNumDim || theWeight == 0.0) continue;
+
+      theValue = gStabilityEnvelope.MinEigenvalue[theOffset];
+      if (theValue <= ENVELOPE_NO_EQUILIBRIUM) return ENVELOPE_NO_EQUILIBRIUM;
+
+      theSum += theWeight*theValue;
+   }
+
+   return (float) theSum;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityMargin
+//
+// Stability margin for a BesselJ0 membrane shape of peak deformation
+// inPeakDeformation_um (see SetMembraneShape_BesselJZero()).  All other
+// mode amplitudes are zero.
+//---------------------------------------------------------------------------
+float StabilityMargin(double inVoltageT_V, double inPeakDeformation_um)
+{
+   int    j;
+   double theAmpl_um[ENVELOPE_MAX_MODES];
+
+   for (j=0;j<ENVELOPE_MAX_MODES;j++)
+      theAmpl_um[j] = 0.0;
+   theAmpl_um[0] = inPeakDeformation_um;
+
+   return StabilityMarginForModes(inVoltageT_V,theAmpl_um);
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityMarginForVoltages
+//
+// Stability margin for a set of electrode voltages,
+// inElectrodeVoltage_V[0...gNumElectrodes-1], in the same order as
+// gElectrodeVoltage[][].  The membrane shape produced by the voltages is
+// projected onto the shape modes of the table (see
+// ComputeDeviceShapeForVoltages()), and the margin is interpolated from
+// the table.
+//
+// Returns ENVELOPE_WRONG_DEVICE if the device has changed since the table
+// was built or loaded (see StabilityEnvelopeMatchesDevice()).
+//
+// The first call after Membrane() and ElectrodeArray() initializes the
+// eigenfunction tables in FastStability.c, and must not be made
+// concurrently with other calls.
+//---------------------------------------------------------------------------
+float StabilityMarginForVoltages(double inVoltageT_V, \
+                                 float *inElectrodeVoltage_V)
+{
+   int          j;
+   float        theMargin;
+   double       theAmpl_um[ENVELOPE_MAX_MODES];
+   DeviceConfig theConfig;
+
+   if (gStabilityEnvelope.MinEigenvalue == NULL) return ENVELOPE_NO_TABLE;
+   if (!StabilityEnvelopeMatchesDevice(&gStabilityEnvelope))
+      return ENVELOPE_WRONG_DEVICE;
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   theConfig.VoltageT_V = inVoltageT_V;
+   theConfig.DistT_um = gStabilityEnvelope.DistT_um;
+   theConfig.DistA_um = gStabilityEnvelope.DistA_um;
+   theConfig.MembraneTension_NByM = gStabilityEnvelope.MembraneTension_NByM;
+   theConfig.ExpansionCoeff_MKS = dvector(0,gNumberOfEigenFunctions-1);
+   theConfig.ElectrodeVoltage_V = inElectrodeVoltage_V;
+
+   ComputeDeviceShapeForVoltages(&theConfig,\
+                                 gStabilityEnvelope.NumModes,\
+                                 ENVELOPE_PROJECTION_ITERATIONS);
+
+   for (j=0;j<gStabilityEnvelope.NumModes;j++)
+      theAmpl_um[j] = theConfig.ExpansionCoeff_MKS[j]* \
+                      ModalPeakAmplitude_MKS(j)*1e6;
+
+   free_dvector(theConfig.ExpansionCoeff_MKS,0,gNumberOfEigenFunctions-1);
+
+   theMargin = StabilityMarginForModes(inVoltageT_V,theAmpl_um);
+
+   return theMargin;
+}
@@ -0,0 +1,69 @@
+//---------------------------------------------------------------------------
+// StabilityEnvelope.h
+//
+// Stability envelope lookup table.  The minimum eigenvalue of the Omega
+// matrix is tabulated offline over the operating space of the device:
+// transparent electrode voltage, and the amplitudes of the leading
+// membrane shape modes.  At run time, the stability margin of a device
+// configuration (peak deformation, or a set of array voltages projected
+// onto the shape modes) is found by multilinear interpolation in the
+// table, without computing the Omega matrix.
+//
+// Mode amplitudes are peak deformations in um:  mode j with amplitude A_j
+// has expansion coefficient a_j = A_j / ModalPeakAmplitude_MKS(j).  For
+// mode 0 the amplitude is the same as gPeakDeformation_um.
+//
+// Table layout (Vt varies fastest):
+//
+//    MinEigenvalue[ iVt + NumVt*(iA_0 + NumAmpl*(iA_1 + NumAmpl*(...))) ]
+//---------------------------------------------------------------------------
+#ifndef STABILITYENVELOPE_H
+#define STABILITYENVELOPE_H
+
+
+#include "FastStability.h"
+
+
+#define ENVELOPE_MAX_MODES       4
+#define ENVELOPE_NO_EQUILIBRIUM  NO_EQUILIBRIUM_EIGENVALUE
+#define ENVELOPE_NO_TABLE         1.0e30   // returned if no table loaded
+#define ENVELOPE_WRONG_DEVICE     2.0e30   // table built for another device
+
+
+typedef struct
+{
+   int     NumModes;                // shape modes tabulated, j=0...NumModes-1
+   int     NumVt;                   // grid points in Vt
+   int     NumAmpl;                 // grid points in each mode amplitude
+   double  VtL_V;
+   double  VtH_V;
+   double  AmplL_um;
+   double  AmplH_um;
+
+   // device parameters for which the table was built
+   double  DistT_um;
+   double  DistA_um;
+   double  MembraneTension_NByM;
+   double  MembraneRadius_mm;
+   int     NumberOfEigenFunctions;
+
+   float  *MinEigenvalue;           // [0...NumVt*NumAmpl^NumModes-1]
+} StabilityEnvelope;
+
+
+int   BuildStabilityEnvelope(double inVtL_V, double inVtH_V, int inNumVt, \
+                             double inAmplL_um, double inAmplH_um, \
+                             int inNumAmpl, int inNumModes);
+int   SaveStabilityEnvelope(char *inFileName);
+int   LoadStabilityEnvelope(char *inFileName);
+void  FreeStabilityEnvelope();
+int   StabilityEnvelopeSize();
+int   StabilityEnvelopeMatchesDevice(StabilityEnvelope *inEnvelope);
+
+float StabilityMargin(double inVoltageT_V, double inPeakDeformation_um);
+float StabilityMarginForModes(double inVoltageT_V, double *inAmpl_um);
+float StabilityMarginForVoltages(double inVoltageT_V, \
+                                 float *inElectrodeVoltage_V);
+
+
+#endif
@@ -0,0 +1,141 @@
+//---------------------------------------------------------------------------
+// StabilityGradient.c
+//
+// Gradient of the minimum Omega eigenvalue with respect to the device
+// design parameters.  See StabilityGradient.h
+//
+// With F_k the electrostatic weight function at electrode k,
+//
+//    F_k  =  e_0 V_k^2 / (dA - xi_k)^3  +  e_0 Vt^2 / (dT + xi_k)^3
+//
+//    Omega_jj'  =  T X_j^2/R^2 delta_jj'  -  Sum F_k DS (C_jk C_j'k + S_jk S_j'k)
+//
+// the derivative of the minimum eigenvalue with respect to a parameter p
+// that enters only through F_k is
+//
+//    d lambda / dp  =  - Sum (dF_k/dp) DS ( (C_k . v)^2 + (S_k . v)^2 )
+//
+// and with respect to the tension,  Sum v_j^2 X_j^2/R^2.
+//---------------------------------------------------------------------------
+#include "StabilityGradient.h"
+#include "FastStability.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+
+extern int      gFastStabilityDim;
+extern int      gFastStabilityNumElectrodes;
+extern double **gBasisCos;
+extern double **gBasisSin;
+extern double  *gBasisDel2Factor;
+extern double   gBasisElectrodeArea_MKS;
+extern int     *gElectrodeUnderMembrane;
+
+extern int      gNumElectrodes;
+
+
+
+//---------------------------------------------------------------------------
+// DeviceMinEigenvalueGradient
+//
+// Returns the minimum eigenvalue of the Omega matrix of the device, and
+// its gradient with respect to the design parameters in
+// outGradient[0...NUM_STABILITY_GRADIENT-1] (see StabilityGradient.h).
+// Membrane shape and electrode voltages are held fixed; the Va component
+// is the derivative for a uniform change of the voltage of all electrodes
+// underneath the membrane, as set by SetElectrodeArrayVoltage().
+//
+// The gradient is not defined at a degenerate minimum eigenvalue.
+//---------------------------------------------------------------------------
+OmegaScalar DeviceMinEigenvalueGradient(DeviceConfig *inConfig, \
+                                        double *outGradient)
+{
+   int    i,j,k;
+   int    theDim;
+   OmegaScalar theMin;
+   double theShape_MKS;
+   double theGapA_MKS;
+   double theGapT_MKS;
+   double theVoltage;
+   double theVoltageT_V;
+   double theCV;
+   double theSV;
+   double theProjection;
+   double *theEigenVector;
+   double e_0 = 8.85E-12;
+
+   theDim = gFastStabilityDim;
+   theEigenVector = dvector(0,theDim-1);
+
+   theMin = DeviceMinEigenpair(inConfig,theEigenVector);
+
+   for (i=0;i<NUM_STABILITY_GRADIENT;i++)
+      outGradient[i] = 0.0;
+
+   theVoltageT_V = inConfig->VoltageT_V;
+
+   for (k=0;k<gFastStabilityNumElectrodes;k++)
+   {
+      theShape_MKS = MembraneShapeAtElectrode_MKS(inConfig,k);
+      theVoltage = (double) inConfig->ElectrodeVoltage_V[k];
+      theGapA_MKS = inConfig->DistA_um*1e-6 - theShape_MKS;
+      theGapT_MKS = inConfig->DistT_um*1e-6 + theShape_MKS;
+
+      // (C_k . v)^2 + (S_k . v)^2
+      theCV = 0.0;
+      theSV = 0.0;
+      for (j=0;j<theDim;j++)
+      {
+         theCV += gBasisCos[j][k]*theEigenVector[j];
+         theSV += gBasisSin[j][k]*theEigenVector[j];
+      }
+      theProjection = (theCV*theCV + theSV*theSV)*gBasisElectrodeArea_MKS;
+
+      outGradient[GRAD_VOLTAGE_T] -= theProjection* \
+                  2*e_0*theVoltageT_V/(theGapT_MKS*theGapT_MKS*theGapT_MKS);
+
+      if (gElectrodeUnderMembrane[k])
+         outGradient[GRAD_VOLTAGE_A] -= theProjection* \
+                  2*e_0*theVoltage/(theGapA_MKS*theGapA_MKS*theGapA_MKS);
+
+      // -3 e_0 V^2 / gap^4, converted to per um
+      outGradient[GRAD_DIST_A] += theProjection*1e-6* \
+                  3*e_0*theVoltage*theVoltage/ \
+                  (theGapA_MKS*theGapA_MKS*theGapA_MKS*theGapA_MKS);
+
+      outGradient[GRAD_DIST_T] += theProjection*1e-6* \
+                  3*e_0*theVoltageT_V*theVoltageT_V/ \
+                  (theGapT_MKS*theGapT_MKS*theGapT_MKS*theGapT_MKS);
+   }
+
+   for (j=0;j<theDim;j++)
+      outGradient[GRAD_TENSION] += theEigenVector[j]*theEigenVector[j]* \
+                                   gBasisDel2Factor[j];
+
+   free_dvector(theEigenVector,0,theDim-1);
+
+   return theMin;
+}
+
+
+//---------------------------------------------------------------------------
+// GetDeviceStabilityGradient
+//
+// Minimum eigenvalue and its gradient for the current device (global
+// simulation parameters).  See DeviceMinEigenvalueGradient().
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+OmegaScalar GetDeviceStabilityGradient(double *outGradient)
+{
+   OmegaScalar  theMin;
+   DeviceConfig theConfig;
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   GetGlobalDeviceConfig(&theConfig);
+   theMin = DeviceMinEigenvalueGradient(&theConfig,outGradient);
+   free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+
+   return theMin;
+}
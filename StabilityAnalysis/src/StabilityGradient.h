@@ -0,0 +1,36 @@
+//---------------------------------------------------------------------------
+// StabilityGradient.h
+//
+// Gradient of the minimum eigenvalue of the Omega matrix with respect to
+// the device design parameters.  For a simple eigenvalue lambda with
+// normalized eigenvector v,
+//
+//    d lambda / dp  =  v^T (d Omega / dp) v
+//
+// and d Omega / dp follows analytically from the electrostatic weight
+// function (WeightFnForSum_MKS) and the tension term of Omega.  The
+// gradient is taken at fixed membrane shape.
+//
+// Gradient components are indexed by the GRAD_ constants below.
+//---------------------------------------------------------------------------
+#ifndef STABILITYGRADIENT_H
+#define STABILITYGRADIENT_H
+
+
+#include "FastStability.h"
+
+
+#define GRAD_VOLTAGE_T          0     // per V
+#define GRAD_VOLTAGE_A          1     // per V, all electrodes under membrane
+#define GRAD_DIST_A             2     // per um
+#define GRAD_DIST_T             3     // per um
+#define GRAD_TENSION            4     // per N/m
+#define NUM_STABILITY_GRADIENT  5
+
+
+OmegaScalar DeviceMinEigenvalueGradient(DeviceConfig *inConfig, \
+                                        double *outGradient);
+OmegaScalar GetDeviceStabilityGradient(double *outGradient);
+
+
+#endif
@@ -0,0 +1,453 @@
+//---------------------------------------------------------------------------
+// StabilityMap.c
+//
+// Adaptive quadtree stability map.  See StabilityMap.h
+//
+// The map is refined one level at a time.  At each level, the cells that
+// need subdivision are split, the new corner points of their children are
+// collected, and the minimum eigenvalue is computed at all of the new
+// points.  These evaluations are independent, and are distributed over
+// processors when compiled with OpenMP support.
+//
+// Points are located through a hash table keyed by lattice index, so that
+// corners shared by neighboring cells are evaluated only once.
+//---------------------------------------------------------------------------
+#include "StabilityMap.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+double              gStabilityMapVaL_V;
+double              gStabilityMapVaH_V;
+double              gStabilityMapVtL_V;
+double              gStabilityMapVtH_V;
+int                 gStabilityMapLatticeSize = 0;   // 2^MaxDepth
+
+StabilityMapCell   *gStabilityMapCell;              // [0] is the root
+int                 gStabilityMapNumCells = 0;
+int                 gStabilityMapMaxCells = 0;
+
+int                *gStabilityMapPointI;            // evaluated points
+int                *gStabilityMapPointJ;
+float              *gStabilityMapPointValue;
+int                 gStabilityMapNumPoints = 0;
+int                 gStabilityMapMaxPoints = 0;
+
+int                *gStabilityMapHash;              // point index, or -1
+int                 gStabilityMapHashSize = 0;      // power of 2
+
+
+extern int      gNumElectrodes;
+
+
+
+//---------------------------------------------------------------------------
+// FreeStabilityMap
+//---------------------------------------------------------------------------
+void FreeStabilityMap()
+{
+   if (gStabilityMapMaxCells > 0)
+   {
+      free(gStabilityMapCell);
+      free(gStabilityMapPointI);
+      free(gStabilityMapPointJ);
+      free(gStabilityMapPointValue);
+      free(gStabilityMapHash);
+   }
+
+   gStabilityMapNumCells = 0;
+   gStabilityMapMaxCells = 0;
+   gStabilityMapNumPoints = 0;
+   gStabilityMapMaxPoints = 0;
+   gStabilityMapHashSize = 0;
+   gStabilityMapLatticeSize = 0;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityMapHashSlot
+//
+// Returns the hash table slot holding lattice point (inI,inJ), or the
+// empty slot where it should be inserted.
+//---------------------------------------------------------------------------
+int StabilityMapHashSlot(int inI, int inJ)
+{
+   unsigned long theKey;
+   int           theSlot;
+   int           thePoint;
+
+   theKey = (unsigned long) inI*(gStabilityMapLatticeSize+1) + inJ;
+   theSlot = (int) ((theKey*2654435761UL) & (gStabilityMapHashSize-1));
+
+   while ((thePoint = gStabilityMapHash[theSlot]) >= 0)
+   {
+      if (gStabilityMapPointI[thePoint] == inI && \
+          gStabilityMapPointJ[thePoint] == inJ)
+         break;
+
+      theSlot = (theSlot+1) & (gStabilityMapHashSize-1);
+   }
+
+   return theSlot;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityMapPoint
+//
+// Returns the index of lattice point (inI,inJ), adding it to the list of
+// points (not yet evaluated) if it is new.
+//---------------------------------------------------------------------------
+int StabilityMapPoint(int inI, int inJ)
+{
+   int i;
+   int theSlot;
+
+   theSlot = StabilityMapHashSlot(inI,inJ);
+   if (gStabilityMapHash[theSlot] >= 0) return gStabilityMapHash[theSlot];
+
+   if (gStabilityMapNumPoints == gStabilityMapMaxPoints)
+   {
+      gStabilityMapMaxPoints *= 2;
+      gStabilityMapPointI = (int *) realloc(gStabilityMapPointI,\
+                                  gStabilityMapMaxPoints*sizeof(int));
+      gStabilityMapPointJ = (int *) realloc(gStabilityMapPointJ,\
+                                  gStabilityMapMaxPoints*sizeof(int));
+      gStabilityMapPointValue = (float *) realloc(gStabilityMapPointValue,\
+                                  gStabilityMapMaxPoints*sizeof(float));
+      if (!gStabilityMapPointI || !gStabilityMapPointJ || \
+          !gStabilityMapPointValue)
+         nrerror("allocation failure in StabilityMapPoint()");
+   }
+
+   gStabilityMapPointI[gStabilityMapNumPoints] = inI;
+   gStabilityMapPointJ[gStabilityMapNumPoints] = inJ;
+   gStabilityMapHash[theSlot] = gStabilityMapNumPoints;
+   gStabilityMapNumPoints++;
+
+   // keep the hash table at most half full
+   if (2*gStabilityMapNumPoints > gStabilityMapHashSize)
+   {
+      free(gStabilityMapHash);
+      gStabilityMapHashSize *= 2;
+      gStabilityMapHash = (int *) malloc(gStabilityMapHashSize*sizeof(int));
+      if (!gStabilityMapHash)
+         nrerror("allocation failure in StabilityMapPoint()");
+
+      for (i=0;i<gStabilityMapHashSize;i++)
+         gStabilityMapHash[i] = -1;
+      for (i=0;i<gStabilityMapNumPoints;i++)
+         gStabilityMapHash[StabilityMapHashSlot(gStabilityMapPointI[i],\
+                                                gStabilityMapPointJ[i])] = i;
+   }
+
+   return gStabilityMapNumPoints-1;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityMapCorner
+//
+// Returns the minimum eigenvalue at corner inCorner (0..3, bit 0 = +Va,
+// bit 1 = +Vt) of cell inCell.  The corner must have been evaluated.
+//---------------------------------------------------------------------------
+float StabilityMapCorner(int inCell, int inCorner)
+{
+   int theI;
+   int theJ;
+   StabilityMapCell *theCell;
+
+   theCell = &gStabilityMapCell[inCell];
+   theI = theCell->I + ((inCorner & 1) ? theCell->Size : 0);
+   theJ = theCell->J + ((inCorner & 2) ? theCell->Size : 0);
+
+   return gStabilityMapPointValue[gStabilityMapHash[\
+                                  StabilityMapHashSlot(theI,theJ)]];
+}
+
+
+//---------------------------------------------------------------------------
+// AddStabilityMapCell
+//
+// Appends a cell and its corner points to the map, and returns its index.
+//---------------------------------------------------------------------------
+int AddStabilityMapCell(int inI, int inJ, int inSize)
+{
+   if (gStabilityMapNumCells == gStabilityMapMaxCells)
+   {
+      gStabilityMapMaxCells *= 2;
+      gStabilityMapCell = (StabilityMapCell *) realloc(gStabilityMapCell,\
+                          gStabilityMapMaxCells*sizeof(StabilityMapCell));
+      if (!gStabilityMapCell)
+         nrerror("allocation failure in AddStabilityMapCell()");
+   }
+
+   gStabilityMapCell[gStabilityMapNumCells].I = inI;
+   gStabilityMapCell[gStabilityMapNumCells].J = inJ;
+   gStabilityMapCell[gStabilityMapNumCells].Size = inSize;
+   gStabilityMapCell[gStabilityMapNumCells].Child = -1;
+
+   StabilityMapPoint(inI,       inJ);
+   StabilityMapPoint(inI+inSize,inJ);
+   StabilityMapPoint(inI,       inJ+inSize);
+   StabilityMapPoint(inI+inSize,inJ+inSize);
+
+   gStabilityMapNumCells++;
+
+   return gStabilityMapNumCells-1;
+}
+
+
+//---------------------------------------------------------------------------
+// EvaluateStabilityMapPoints
+//
+// Computes the minimum eigenvalue at points [inFirst...gStabilityMapNumPoints-1]
+//---------------------------------------------------------------------------
+void EvaluateStabilityMapPoints(int inFirst)
+{
+   int          n;
+   DeviceConfig theNominal;
+
+   GetGlobalDeviceConfig(&theNominal);
+
+#pragma omp parallel for schedule(dynamic)
+   for (n=inFirst;n<gStabilityMapNumPoints;n++)
+   {
+      double       theVa_V;
+      DeviceConfig theConfig;
+
+      theConfig = theNominal;
+      theConfig.ElectrodeVoltage_V = vector(0,gNumElectrodes-1);
+
+      theVa_V = gStabilityMapVaL_V + gStabilityMapPointI[n]* \
+                (gStabilityMapVaH_V-gStabilityMapVaL_V)/gStabilityMapLatticeSize;
+      theConfig.VoltageT_V = gStabilityMapVtL_V + gStabilityMapPointJ[n]* \
+                (gStabilityMapVtH_V-gStabilityMapVtL_V)/gStabilityMapLatticeSize;
+
+      SetDeviceArrayVoltage(&theConfig,theVa_V);
+      gStabilityMapPointValue[n] = DeviceMinEigenvalue(&theConfig);
+
+      free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+   }
+
+   free_vector(theNominal.ElectrodeVoltage_V,0,gNumElectrodes-1);
+}
+
+
+//---------------------------------------------------------------------------
+// BuildStabilityMap
+//
+// Builds an adaptive stability map over Va in [inVaL_V, inVaH_V] and Vt in
+// [inVtL_V, inVtH_V].  All cells are subdivided down to inMinDepth levels.
+// Below that, a cell is subdivided (to at most inMaxDepth levels) if its
+// corner eigenvalues differ in sign, or if the range of its corner
+// eigenvalues exceeds inMaxCellRange (inMaxCellRange <= 0 disables this
+// criterion).
+//
+//  return value:
+//          0    successful completion
+//          1    invalid arguments
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int BuildStabilityMap(double inVaL_V, double inVaH_V, \
+                      double inVtL_V, double inVtH_V, \
+                      int inMinDepth, int inMaxDepth, \
+                      double inMaxCellRange)
+{
+   int    c,k;
+   int    theLevel;
+   int    theFirstCell;
+   int    theLastCell;
+   int    theFirstPoint;
+   int    theSize;
+   int    theRefine;
+   int    theNumPositive;
+   float  theValue;
+   float  theMin;
+   float  theMax;
+   long   theFullGrid;
+   char   theMessage[100];
+   StabilityMapCell theCell;
+
+   if (inMaxDepth < 0 || inMaxDepth > STABILITY_MAP_MAX_DEPTH || \
+       inMinDepth < 0 || inMinDepth > inMaxDepth)
+   {
+      LogMessage("--- BuildStabilityMap:  invalid depth ---");
+      return 1;
+   }
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   FreeStabilityMap();
+
+   gStabilityMapVaL_V = inVaL_V;
+   gStabilityMapVaH_V = inVaH_V;
+   gStabilityMapVtL_V = inVtL_V;
+   gStabilityMapVtH_V = inVtH_V;
+   gStabilityMapLatticeSize = 1 << inMaxDepth;
+
+   gStabilityMapMaxCells = 64;
+   gStabilityMapMaxPoints = 64;
+   gStabilityMapHashSize = 256;
+   gStabilityMapCell = (StabilityMapCell *) \
+                       malloc(gStabilityMapMaxCells*sizeof(StabilityMapCell));
+   gStabilityMapPointI = (int *) malloc(gStabilityMapMaxPoints*sizeof(int));
+   gStabilityMapPointJ = (int *) malloc(gStabilityMapMaxPoints*sizeof(int));
+   gStabilityMapPointValue = (float *) \
+                       malloc(gStabilityMapMaxPoints*sizeof(float));
+   gStabilityMapHash = (int *) malloc(gStabilityMapHashSize*sizeof(int));
+   if (!gStabilityMapCell || !gStabilityMapPointI || !gStabilityMapPointJ || \
+       !gStabilityMapPointValue || !gStabilityMapHash)
+      nrerror("allocation failure in BuildStabilityMap()");
+
+   for (k=0;k<gStabilityMapHashSize;k++)
+      gStabilityMapHash[k] = -1;
+
+   AddStabilityMapCell(0,0,gStabilityMapLatticeSize);
+   EvaluateStabilityMapPoints(0);
+
+   theFirstCell = 0;
+   theLastCell = 1;
+
+   for (theLevel=0;theLevel<inMaxDepth;theLevel++)
+   {
+      theFirstPoint = gStabilityMapNumPoints;
+
+      for (c=theFirstCell;c<theLastCell;c++)
+      {
+         theRefine = (theLevel < inMinDepth);
+
+         if (!theRefine)
+         {
+            theNumPositive = 0;
+            theMin = theMax = StabilityMapCorner(c,0);
+            for (k=0;k<4;k++)
+            {
+               theValue = StabilityMapCorner(c,k);
+               if (theValue > 0) theNumPositive++;
+               if (theValue < theMin) theMin = theValue;
+               if (theValue > theMax) theMax = theValue;
+            }
+
+            theRefine = (theNumPositive != 0 && theNumPositive != 4) || \
+                        (inMaxCellRange > 0 && theMax-theMin > inMaxCellRange);
+         }
+
+         if (theRefine)
+         {
+            // gStabilityMapCell may move when cells are added
+            theCell = gStabilityMapCell[c];
+            theSize = theCell.Size/2;
+
+            gStabilityMapCell[c].Child = \
+                  AddStabilityMapCell(theCell.I,        theCell.J,        theSize);
+            AddStabilityMapCell(theCell.I+theSize,theCell.J,        theSize);
+            AddStabilityMapCell(theCell.I,        theCell.J+theSize,theSize);
+            AddStabilityMapCell(theCell.I+theSize,theCell.J+theSize,theSize);
+         }
+      }
+
+      if (gStabilityMapNumCells == theLastCell) break;
+
+      EvaluateStabilityMapPoints(theFirstPoint);
+
+      theFirstCell = theLastCell;
+      theLastCell = gStabilityMapNumCells;
+   }
+
+   theFullGrid = (long) (gStabilityMapLatticeSize+1)* \
+                        (gStabilityMapLatticeSize+1);
+   sprintf(theMessage,\
+           "--- BuildStabilityMap:  %d cells, %d points (full grid %ld) ---",\
+           gStabilityMapNumCells, gStabilityMapNumPoints, theFullGrid);
+   LogMessage(theMessage);
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilityMapValue
+//
+// Returns the minimum eigenvalue at (inVa_V, inVt_V), interpolated
+// bilinearly within the leaf cell of the map containing this point.
+// Points outside of the map are clamped to its edges.
+//---------------------------------------------------------------------------
+float StabilityMapValue(double inVa_V, double inVt_V)
+{
+   int    c;
+   int    theHalf;
+   double theX;
+   double theY;
+   double theFX;
+   double theFY;
+   StabilityMapCell *theCell;
+
+   if (gStabilityMapNumCells == 0) return 0.0;
+
+   // position in lattice units
+   theX = 0.0;
+   theY = 0.0;
+   if (gStabilityMapVaH_V != gStabilityMapVaL_V)
+      theX = (inVa_V-gStabilityMapVaL_V)*gStabilityMapLatticeSize/ \
+             (gStabilityMapVaH_V-gStabilityMapVaL_V);
+   if (gStabilityMapVtH_V != gStabilityMapVtL_V)
+      theY = (inVt_V-gStabilityMapVtL_V)*gStabilityMapLatticeSize/ \
+             (gStabilityMapVtH_V-gStabilityMapVtL_V);
+
+   if (theX < 0) theX = 0;
+   if (theY < 0) theY = 0;
+   if (theX > gStabilityMapLatticeSize) theX = gStabilityMapLatticeSize;
+   if (theY > gStabilityMapLatticeSize) theY = gStabilityMapLatticeSize;
+
+   c = 0;
+   while (gStabilityMapCell[c].Child >= 0)
+   {
+      theCell = &gStabilityMapCell[c];
+      theHalf = theCell->Size/2;
+
+      c = theCell->Child;
+      if (theX >= theCell->I+theHalf) c += 1;
+      if (theY >= theCell->J+theHalf) c += 2;
+   }
+
+   theCell = &gStabilityMapCell[c];
+   theFX = (theX-theCell->I)/theCell->Size;
+   theFY = (theY-theCell->J)/theCell->Size;
+
+   return (float) ((1-theFX)*(1-theFY)*StabilityMapCorner(c,0) + \
+                   theFX    *(1-theFY)*StabilityMapCorner(c,1) + \
+                   (1-theFX)*theFY    *StabilityMapCorner(c,2) + \
+                   theFX    *theFY    *StabilityMapCorner(c,3));
+}
+
+
+//---------------------------------------------------------------------------
+// LogStabilityMap
+//
+// Writes all evaluated points of the map (Va, Vt, minimum eigenvalue) to
+// the log file.
+//---------------------------------------------------------------------------
+void LogStabilityMap()
+{
+   int  n;
+   char theMessage[100];
+
+   LogMessage("Stability Map:  Va_V    Vt_V    MinEigenvalue");
+   for (n=0;n<gStabilityMapNumPoints;n++)
+   {
+      sprintf(theMessage,"%f\t%f\t%e",\
+         gStabilityMapVaL_V + gStabilityMapPointI[n]* \
+           (gStabilityMapVaH_V-gStabilityMapVaL_V)/gStabilityMapLatticeSize,\
+         gStabilityMapVtL_V + gStabilityMapPointJ[n]* \
+           (gStabilityMapVtH_V-gStabilityMapVtL_V)/gStabilityMapLatticeSize,\
+         gStabilityMapPointValue[n]);
+      LogMessage(theMessage);
+   }
+}
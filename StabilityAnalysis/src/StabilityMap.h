@@ -0,0 +1,44 @@
+//---------------------------------------------------------------------------
+// StabilityMap.h
+//
+// Adaptive stability map over (array voltage Va, transparent electrode
+// voltage Vt).  Like TestSmallAmplitudeStability(), all electrodes under
+// the membrane are set to Va; the membrane shape and the remaining device
+// parameters are taken from the current globals.
+//
+// The map is a quadtree.  Starting from a single cell covering the
+// voltage range, cells are subdivided if their corner eigenvalues differ
+// in sign (the cell contains the stability boundary), or if the corner
+// eigenvalues differ by more than a specified range (large gradient).
+// Corner points are shared between cells and evaluated once.  The map is
+// interpolated bilinearly within the leaf cell containing a point.
+//
+// Corner points lie on a lattice of 2^inMaxDepth+1 points per side;
+// I indexes Va and J indexes Vt.
+//---------------------------------------------------------------------------
+#ifndef STABILITYMAP_H
+#define STABILITYMAP_H
+
+
+#define STABILITY_MAP_MAX_DEPTH  15
+
+
+typedef struct
+{
+   int   I;          // lattice index of lower left corner (Va)
+   int   J;          // lattice index of lower left corner (Vt)
+   int   Size;       // cell size, lattice units
+   int   Child;      // index of first of 4 children, -1 for a leaf
+} StabilityMapCell;
+
+
+int   BuildStabilityMap(double inVaL_V, double inVaH_V, \
+                        double inVtL_V, double inVtH_V, \
+                        int inMinDepth, int inMaxDepth, \
+                        double inMaxCellRange);
+void  FreeStabilityMap();
+float StabilityMapValue(double inVa_V, double inVt_V);
+void  LogStabilityMap();
+
+
+#endif
@@ -0,0 +1,272 @@
+//---------------------------------------------------------------------------
+// StabilityMonteCarlo.c
+//
+// Monte Carlo fabrication tolerance analysis.  See StabilityMonteCarlo.h
+//
+// Samples are independent, and are distributed over processors when
+// compiled with OpenMP support.  Each sample reuses the eigenfunction
+// tables of FastStability.c, so it costs one A matrix evaluation and one
+// diagonalization.
+//
+// Results of the last run are left in the gMonteCarlo globals below.
+//---------------------------------------------------------------------------
+#include "StabilityMonteCarlo.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+
+int      gMonteCarloNumSamples = 0;
+float   *gMonteCarloMargin;         // [0...gMonteCarloNumSamples-1]
+double   gMonteCarloYield;          // fraction of stable samples
+double   gMonteCarloMarginMean;
+double   gMonteCarloMarginSigma;
+double   gMonteCarloMarginMin;
+double   gMonteCarloMarginMax;
+
+
+extern int      gNumberOfEigenFunctions;
+extern int      gNumElectrodes;
+
+
+
+//---------------------------------------------------------------------------
+// MonteCarloHash
+//
+// Integer hash used to derive independent random streams from the run
+// seed and the sample index (32 bit arithmetic).
+//---------------------------------------------------------------------------
+unsigned long MonteCarloHash(unsigned long inX)
+{
+   inX &= 0xffffffffUL;
+   inX = ((inX >> 16) ^ inX) * 0x45d9f3bUL & 0xffffffffUL;
+   inX = ((inX >> 16) ^ inX) * 0x45d9f3bUL & 0xffffffffUL;
+   inX = (inX >> 16) ^ inX;
+
+   return inX;
+}
+
+
+//---------------------------------------------------------------------------
+// MonteCarloUniform
+//
+// Returns a uniform deviate in (0,1) and advances the stream state
+// (xorshift generator, 32 bit).
+//---------------------------------------------------------------------------
+double MonteCarloUniform(unsigned long *ioState)
+{
+   unsigned long x;
+
+   x = *ioState;
+   x ^= (x << 13) & 0xffffffffUL;
+   x ^= x >> 17;
+   x ^= (x << 5) & 0xffffffffUL;
+   *ioState = x;
+
+   return ((double) (x >> 8) + 0.5)/16777216.0;
+}
+
+
+//---------------------------------------------------------------------------
+// MonteCarloGauss
+//
+// Returns a normally distributed deviate with zero mean and unit
+// variance (Box-Muller).
+//---------------------------------------------------------------------------
+double MonteCarloGauss(unsigned long *ioState)
+{
+   double theU1;
+   double theU2;
+
+   theU1 = MonteCarloUniform(ioState);
+   theU2 = MonteCarloUniform(ioState);
+
+   return sqrt(-2.0*log(theU1))*cos(2.0*3.1415926535*theU2);
+}
+
+
+int CompareFloat(const void *inA, const void *inB)
+{
+   float theA = *(const float *) inA;
+   float theB = *(const float *) inB;
+
+   if (theA < theB) return -1;
+   if (theA > theB) return  1;
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// LogMonteCarloResults
+//
+// Writes yield, margin statistics, percentiles and a histogram of the
+// margin distribution of the last run to the log file.
+//---------------------------------------------------------------------------
+void LogMonteCarloResults()
+{
+   int    i;
+   int    theBin;
+   int    theN;
+   int    theCount[MONTECARLO_HISTOGRAM_BINS];
+   double theBinWidth;
+   float *theSorted;
+   char   theMessage[100];
+
+   theN = gMonteCarloNumSamples;
+   if (theN == 0) return;
+
+   sprintf(theMessage,"Monte Carlo:  %d samples, yield %f",\
+           theN, gMonteCarloYield);
+   LogMessage(theMessage);
+   sprintf(theMessage,"Min. eigenvalue mean %e  sigma %e",\
+           gMonteCarloMarginMean, gMonteCarloMarginSigma);
+   LogMessage(theMessage);
+   sprintf(theMessage,"Min. eigenvalue min  %e  max   %e",\
+           gMonteCarloMarginMin, gMonteCarloMarginMax);
+   LogMessage(theMessage);
+
+   theSorted = vector(0,theN-1);
+   for (i=0;i<theN;i++)
+      theSorted[i] = gMonteCarloMargin[i];
+   qsort(theSorted,theN,sizeof(float),CompareFloat);
+
+   sprintf(theMessage,"Percentiles  1%%: %e  5%%: %e  50%%: %e",\
+           theSorted[(theN-1)/100], theSorted[(theN-1)*5/100], \
+           theSorted[(theN-1)/2]);
+   LogMessage(theMessage);
+   free_vector(theSorted,0,theN-1);
+
+   for (i=0;i<MONTECARLO_HISTOGRAM_BINS;i++)
+      theCount[i] = 0;
+
+   theBinWidth = (gMonteCarloMarginMax - gMonteCarloMarginMin)/ \
+                 MONTECARLO_HISTOGRAM_BINS;
+   for (i=0;i<theN;i++)
+   {
+      theBin = 0;
+      if (theBinWidth > 0)
+         theBin = (int) ((gMonteCarloMargin[i]-gMonteCarloMarginMin)/theBinWidth);
+      if (theBin >= MONTECARLO_HISTOGRAM_BINS)
+         theBin = MONTECARLO_HISTOGRAM_BINS-1;
+      theCount[theBin]++;
+   }
+
+   LogMessage("Margin histogram:  bin lower edge    count");
+   for (i=0;i<MONTECARLO_HISTOGRAM_BINS;i++)
+   {
+      sprintf(theMessage,"%e\t%d",gMonteCarloMarginMin+i*theBinWidth,\
+                                  theCount[i]);
+      LogMessage(theMessage);
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// RunStabilityMonteCarlo
+//
+// Evaluates inNumSamples perturbed copies of the current device.  The
+// standard deviations of the gap, tension and electrode voltage errors
+// are given in the arguments; a sigma of zero leaves that parameter at
+// its nominal value.  Membrane shape is held at its nominal value.
+//
+// Sample margins are returned in gMonteCarloMargin[], summary statistics
+// in the other gMonteCarlo globals, and written to the log file.
+//
+//  return value:
+//          0    successful completion
+//          1    invalid arguments
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int RunStabilityMonteCarlo(int    inNumSamples,
+                           double inSigmaDistA_um,
+                           double inSigmaDistT_um,
+                           double inSigmaTension_NByM,
+                           double inSigmaVoltage_V,
+                           long   inSeed)
+{
+   int          n;
+   int          theNumStable;
+   double       theSum;
+   double       theSumSq;
+   DeviceConfig theNominal;
+
+   if (inNumSamples < 1)
+   {
+      LogMessage("--- RunStabilityMonteCarlo:  invalid number of samples ---");
+      return 1;
+   }
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   if (gMonteCarloNumSamples > 0)
+      free_vector(gMonteCarloMargin,0,gMonteCarloNumSamples-1);
+   gMonteCarloNumSamples = inNumSamples;
+   gMonteCarloMargin = vector(0,inNumSamples-1);
+
+   GetGlobalDeviceConfig(&theNominal);
+
+#pragma omp parallel for schedule(dynamic)
+   for (n=0;n<inNumSamples;n++)
+   {
+      int           k;
+      unsigned long theState;
+      DeviceConfig  theConfig;
+
+      theState = MonteCarloHash((unsigned long) inSeed ^ \
+                                MonteCarloHash((unsigned long) n));
+      if (theState == 0) theState = 1;
+
+      theConfig = theNominal;
+      theConfig.DistA_um += inSigmaDistA_um*MonteCarloGauss(&theState);
+      theConfig.DistT_um += inSigmaDistT_um*MonteCarloGauss(&theState);
+      theConfig.MembraneTension_NByM += \
+                            inSigmaTension_NByM*MonteCarloGauss(&theState);
+
+      theConfig.ElectrodeVoltage_V = vector(0,gNumElectrodes-1);
+      for (k=0;k<gNumElectrodes;k++)
+         theConfig.ElectrodeVoltage_V[k] = (float) \
+                            (theNominal.ElectrodeVoltage_V[k] + \
+                             inSigmaVoltage_V*MonteCarloGauss(&theState));
+
+      gMonteCarloMargin[n] = DeviceMinEigenvalue(&theConfig);
+
+      free_vector(theConfig.ElectrodeVoltage_V,0,gNumElectrodes-1);
+   }
+
+   free_vector(theNominal.ElectrodeVoltage_V,0,gNumElectrodes-1);
+
+   // statistics are accumulated serially, in sample order, so that
+   // they do not depend on the number of threads.
+   theNumStable = 0;
+   theSum = 0.0;
+   theSumSq = 0.0;
+   gMonteCarloMarginMin = gMonteCarloMargin[0];
+   gMonteCarloMarginMax = gMonteCarloMargin[0];
+   for (n=0;n<inNumSamples;n++)
+   {
+      if (gMonteCarloMargin[n] > 0) theNumStable++;
+      theSum += gMonteCarloMargin[n];
+      theSumSq += (double) gMonteCarloMargin[n]*gMonteCarloMargin[n];
+      if (gMonteCarloMargin[n] < gMonteCarloMarginMin)
+         gMonteCarloMarginMin = gMonteCarloMargin[n];
+      if (gMonteCarloMargin[n] > gMonteCarloMarginMax)
+         gMonteCarloMarginMax = gMonteCarloMargin[n];
+   }
+
+   gMonteCarloYield = (double) theNumStable/inNumSamples;
+   gMonteCarloMarginMean = theSum/inNumSamples;
+   gMonteCarloMarginSigma = theSumSq/inNumSamples - \
+                            gMonteCarloMarginMean*gMonteCarloMarginMean;
+   gMonteCarloMarginSigma = (gMonteCarloMarginSigma > 0) ? \
+                            sqrt(gMonteCarloMarginSigma) : 0.0;
+
+   LogMonteCarloResults();
+
+   return 0;
+}
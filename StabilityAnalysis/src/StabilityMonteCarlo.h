@@ -0,0 +1,30 @@
+//---------------------------------------------------------------------------
+// StabilityMonteCarlo.h
+//
+// Monte Carlo fabrication tolerance analysis.  The current device (global
+// simulation parameters, membrane shape and electrode voltages) is taken
+// as nominal.  Each sample perturbs the gaps, the membrane tension and
+// every entry of the electrode voltage array with independent gaussian
+// errors, and the minimum Omega eigenvalue of the perturbed device is
+// computed.  The sample is stable if this eigenvalue is greater than zero.
+//
+// Every sample draws from its own random stream, seeded from the run seed
+// and the sample index, so results are reproducible regardless of the
+// number of threads or the order in which samples are evaluated.
+//---------------------------------------------------------------------------
+#ifndef STABILITYMONTECARLO_H
+#define STABILITYMONTECARLO_H
+
+
+#define MONTECARLO_HISTOGRAM_BINS  20
+
+
+int RunStabilityMonteCarlo(int    inNumSamples,
+                           double inSigmaDistA_um,
+                           double inSigmaDistT_um,
+                           double inSigmaTension_NByM,
+                           double inSigmaVoltage_V,
+                           long   inSeed);
+
+
+#endif
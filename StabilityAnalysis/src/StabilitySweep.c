@@ -0,0 +1,1128 @@
+//---------------------------------------------------------------------------
+// StabilitySweep.c
+//
+// Sharded stability sweeps.  See StabilitySweep.h
+//
+// Files in the result directory, for shard NNNN:
+//
+//    shard_NNNN.claim         "<attempt> <worker tag>", while being evaluated
+//    shard_NNNN.claim.<tag>   claim taken by worker <tag> to release it
+//    shard_NNNN.tmp.<tag>     result being written
+//    shard_NNNN.dat           completed result
+//    shard_NNNN.failK         claim of failed attempt K
+//
+// Claims rely on exclusive file creation and releases on rename, both of
+// which are atomic on local file systems and on NFS v3 and later.  A
+// worker releases or removes a claim only after moving it to a name of
+// its own (TakeShardClaim()) and checking its owner and age there, so two
+// workers never release the same claim, and a claim that was replaced in
+// the meantime is not removed.  The owner of a claim refreshes its time
+// stamp every STABILITY_SWEEP_REFRESH_DEVICES devices.  Claim ages are
+// measured against the local clock, so the hosts' clocks must agree to
+// well within timeout_s.
+//
+// A result file starts with the fixed parameters of the device,
+//
+//    DEVICE  tension  radius  modes  width  spacing
+//
+// has one line per device,
+//
+//    <grid index>  Vt  Va  dA  dT  peak  <min. eigenvalue>
+//
+// and ends with "END <number of devices>".
+//---------------------------------------------------------------------------
+#include "StabilitySweep.h"
+#include "StabilityBatch.h"
+#include "FastStability.h"
+#include "MatrixUtils.h"
+#include "Membrane.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <process.h>
+#include <io.h>
+#include <sys/utime.h>
+#else
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+
+#define STABILITY_SWEEP_MAX_WORKERS      256
+#define STABILITY_SWEEP_REFRESH_DEVICES  256  // devices between claim refreshes
+
+
+#if defined(_WIN32)
+char gStabilitySweepProgram[200] = "SAValidate.exe";
+#else
+char gStabilitySweepProgram[200] = "./SAValidate";
+#endif
+
+char *gStabilitySweepParamName[BATCH_NUM_DEVICE_PARAMS] = \
+           {"Vt", "Va", "dA", "dT", "peak"};
+
+char *gStabilitySweepFixedName[STABILITY_SWEEP_NUM_FIXED] = \
+           {"tension", "radius", "modes", "width", "spacing"};
+
+
+extern int     gNumberOfEigenFunctions;
+extern double  gMembraneTension_NByM;
+extern double  gMembraneRadius_mm;
+extern float   gElectrodeWidth_um;
+extern float   gElectrodeSpc_um;
+extern double *gExpansionCoeff_MKS;
+
+
+
+//---------------------------------------------------------------------------
+// ReadStabilitySweepSpec
+//
+// Reads a sweep spec file (see StabilitySweep.h).  Parameters that are
+// not in the file are held at 0 (Vt, Va, peak) or 75 um (dA, dT);  fixed
+// parameters that are not in the file are marked in HasFixed[].
+//
+//  return value:
+//          0    successful completion
+//          1    the file could not be opened
+//          2    invalid spec
+//---------------------------------------------------------------------------
+int ReadStabilitySweepSpec(char *inFileName, StabilitySweepSpec *outSpec)
+{
+   int    i;
+   int    theNumValues;
+   double theLow;
+   double theHigh;
+   char   theKey[50];
+   char   theLine[200];
+   char   theMessage[150];
+   FILE  *theFile;
+
+   if ((theFile = fopen(inFileName,"rt")) == NULL)
+   {
+      sprintf(theMessage,\
+              "--- ReadStabilitySweepSpec:  cannot open %.100s ---",\
+              inFileName);
+      LogMessage(theMessage);
+      return 1;
+   }
+
+   outSpec->NumShards = 1;
+   outSpec->Timeout_s = 0;
+   for (i=0;i<BATCH_NUM_DEVICE_PARAMS;i++)
+   {
+      outSpec->Low[i] = (i == 2 || i == 3) ? 75.0 : 0.0;
+      outSpec->High[i] = outSpec->Low[i];
+      outSpec->NumValues[i] = 1;
+   }
+   for (i=0;i<STABILITY_SWEEP_NUM_FIXED;i++)
+   {
+      outSpec->HasFixed[i] = 0;
+      outSpec->Fixed[i] = 0.0;
+   }
+
+   while (fgets(theLine,sizeof(theLine),theFile) != NULL)
+   {
+      if (sscanf(theLine,"%49s",theKey) != 1 || theKey[0] == '#') continue;
+
+      if (strcmp(theKey,"shards") == 0)
+      {
+         sscanf(theLine,"%*s %d",&outSpec->NumShards);
+         continue;
+      }
+
+      if (strcmp(theKey,"timeout_s") == 0)
+      {
+         sscanf(theLine,"%*s %lf",&outSpec->Timeout_s);
+         continue;
+      }
+
+      for (i=0;i<STABILITY_SWEEP_NUM_FIXED;i++)
+         if (strcmp(theKey,gStabilitySweepFixedName[i]) == 0) break;
+
+      if (i < STABILITY_SWEEP_NUM_FIXED)
+      {
+         if (sscanf(theLine,"%*s %lf",&theLow) != 1 || theLow <= 0)
+         {
+            sprintf(theMessage,"--- ReadStabilitySweepSpec:  invalid line %.100s",\
+                    theLine);
+            LogMessage(theMessage);
+            fclose(theFile);
+            return 2;
+         }
+         outSpec->HasFixed[i] = 1;
+         outSpec->Fixed[i] = theLow;
+         continue;
+      }
+
+      for (i=0;i<BATCH_NUM_DEVICE_PARAMS;i++)
+         if (strcmp(theKey,gStabilitySweepParamName[i]) == 0) break;
+
+      if (i == BATCH_NUM_DEVICE_PARAMS || \
+          sscanf(theLine,"%*s %lf %lf %d",&theLow,&theHigh,&theNumValues) != 3 || \
+          theNumValues < 1)
+      {
+         sprintf(theMessage,"--- ReadStabilitySweepSpec:  invalid line %.100s",\
+                 theLine);
+         LogMessage(theMessage);
+         fclose(theFile);
+         return 2;
+      }
+
+      outSpec->Low[i] = theLow;
+      outSpec->High[i] = theHigh;
+      outSpec->NumValues[i] = theNumValues;
+   }
+
+   fclose(theFile);
+
+   if (outSpec->NumShards < 1 || \
+       outSpec->NumShards > STABILITY_SWEEP_MAX_SHARDS)
+   {
+      LogMessage("--- ReadStabilitySweepSpec:  invalid number of shards ---");
+      return 2;
+   }
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// GetStabilitySweepFixed
+//
+// Fixed parameters [0...STABILITY_SWEEP_NUM_FIXED-1] of the current
+// device:  tension (N/m), radius (mm), modes, width (um), spacing (um).
+//---------------------------------------------------------------------------
+void GetStabilitySweepFixed(double *outFixed)
+{
+   outFixed[0] = gMembraneTension_NByM;
+   outFixed[1] = gMembraneRadius_mm;
+   outFixed[2] = (double) gNumberOfEigenFunctions;
+   outFixed[3] = (double) gElectrodeWidth_um;
+   outFixed[4] = (double) gElectrodeSpc_um;
+}
+
+
+//---------------------------------------------------------------------------
+// SetStabilitySweepFixed
+//
+// Sets the fixed parameters of the current device that are given in the
+// spec.  The membrane shape coefficients are reallocated if the number
+// of eigenfunctions changes;  the eigenfunction tables are rebuilt on
+// the next call of GetDeviceStabilityBatch().
+//
+// called by:  StabilitySweepWorker()
+//---------------------------------------------------------------------------
+void SetStabilitySweepFixed(StabilitySweepSpec *inSpec)
+{
+   int theNumModes;
+
+   if (inSpec->HasFixed[0]) gMembraneTension_NByM = inSpec->Fixed[0];
+   if (inSpec->HasFixed[1]) gMembraneRadius_mm = inSpec->Fixed[1];
+   if (inSpec->HasFixed[3]) gElectrodeWidth_um = (float) inSpec->Fixed[3];
+   if (inSpec->HasFixed[4]) gElectrodeSpc_um = (float) inSpec->Fixed[4];
+
+   if (inSpec->HasFixed[2])
+   {
+      theNumModes = (int) (inSpec->Fixed[2] + 0.5);
+      if (theNumModes != gNumberOfEigenFunctions)
+      {
+         free_dvector(gExpansionCoeff_MKS,0,gNumberOfEigenFunctions-1);
+         gNumberOfEigenFunctions = theNumModes;
+         InitMembraneShapeCoeffs();
+      }
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// StabilitySweepFixedDiffers
+//
+// Compares the fixed parameters inFixed with those given in the spec.
+// Returns 1 + the index of the first parameter that differs, or 0.
+// Parameters that are not in the spec are not compared.
+//---------------------------------------------------------------------------
+int StabilitySweepFixedDiffers(StabilitySweepSpec *inSpec, double *inFixed)
+{
+   int i;
+
+   for (i=0;i<STABILITY_SWEEP_NUM_FIXED;i++)
+   {
+      if (!inSpec->HasFixed[i]) continue;
+      if (fabs(inFixed[i]-inSpec->Fixed[i]) > 1e-6*fabs(inSpec->Fixed[i]))
+         return i+1;
+   }
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilitySweepNumDevices
+//
+// Number of grid points of the sweep.
+//---------------------------------------------------------------------------
+int StabilitySweepNumDevices(StabilitySweepSpec *inSpec)
+{
+   int i;
+   int theNumDevices = 1;
+
+   for (i=0;i<BATCH_NUM_DEVICE_PARAMS;i++)
+      theNumDevices *= inSpec->NumValues[i];
+
+   return theNumDevices;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilitySweepShardRange
+//
+// Grid indices outFirst ... outFirst+outNumDevices-1 of shard inShard.
+//---------------------------------------------------------------------------
+void StabilitySweepShardRange(StabilitySweepSpec *inSpec, int inShard, \
+                              int *outFirst, int *outNumDevices)
+{
+   int    theNumDevices;
+   double theShardSize;
+
+   theNumDevices = StabilitySweepNumDevices(inSpec);
+   theShardSize = (double) theNumDevices/inSpec->NumShards;
+
+   *outFirst = (int) (inShard*theShardSize + 0.5);
+   *outNumDevices = (int) ((inShard+1)*theShardSize + 0.5) - *outFirst;
+}
+
+
+//---------------------------------------------------------------------------
+// StabilitySweepDeviceParams
+//
+// Device parameters [0...BATCH_NUM_DEVICE_PARAMS-1] of grid point inIndex.
+//---------------------------------------------------------------------------
+void StabilitySweepDeviceParams(StabilitySweepSpec *inSpec, int inIndex, \
+                                double *outParams)
+{
+   int i;
+   int theValue;
+
+   for (i=BATCH_NUM_DEVICE_PARAMS-1;i>=0;i--)
+   {
+      theValue = inIndex % inSpec->NumValues[i];
+      inIndex /= inSpec->NumValues[i];
+
+      if (inSpec->NumValues[i] > 1)
+         outParams[i] = inSpec->Low[i] + theValue* \
+                        (inSpec->High[i]-inSpec->Low[i])/ \
+                        (inSpec->NumValues[i]-1);
+      else
+         outParams[i] = inSpec->Low[i];
+   }
+}
+
+
+//---------------------------------------------------------------------------
+// ShardFileName
+//---------------------------------------------------------------------------
+void ShardFileName(char *inDir, int inShard, char *inExt, char *outName)
+{
+   sprintf(outName,"%.150s/shard_%04d.%.120s",inDir,inShard,inExt);
+}
+
+
+//---------------------------------------------------------------------------
+// ShardFileExists
+//---------------------------------------------------------------------------
+int ShardFileExists(char *inDir, int inShard, char *inExt)
+{
+   char        theName[300];
+   struct stat theStat;
+
+   ShardFileName(inDir,inShard,inExt,theName);
+
+   return (stat(theName,&theStat) == 0);
+}
+
+
+//---------------------------------------------------------------------------
+// ShardFailedAttempts
+//
+// Number of failed attempts recorded for the shard (failK files).
+//---------------------------------------------------------------------------
+int ShardFailedAttempts(char *inDir, int inShard)
+{
+   int  k;
+   char theExt[10];
+
+   for (k=1;k<=STABILITY_SWEEP_MAX_ATTEMPTS;k++)
+   {
+      sprintf(theExt,"fail%d",k);
+      if (!ShardFileExists(inDir,inShard,theExt)) break;
+   }
+
+   return k-1;
+}
+
+
+//---------------------------------------------------------------------------
+// ReadClaimFile
+//
+// Reads the attempt number and worker tag of the claim file inName.
+// Returns 0 if there is no such file.  outAge_s (may be NULL) is the age
+// of the claim.
+//---------------------------------------------------------------------------
+int ReadClaimFile(char *inName, int *outAttempt, char *outTag, \
+                  double *outAge_s)
+{
+   struct stat  theStat;
+   FILE        *theFile;
+
+   if ((theFile = fopen(inName,"rt")) == NULL) return 0;
+
+   // a claim that is still being written reads as attempt 0
+   if (fscanf(theFile,"%d %99s",outAttempt,outTag) != 2)
+   {
+      *outAttempt = 0;
+      outTag[0] = 0;
+   }
+   fclose(theFile);
+
+   if (outAge_s != NULL)
+   {
+      *outAge_s = 0;
+      if (stat(inName,&theStat) == 0)
+         *outAge_s = difftime(time(NULL),theStat.st_mtime);
+   }
+
+   return 1;
+}
+
+
+//---------------------------------------------------------------------------
+// ReadShardClaim
+//
+// Reads the attempt number and worker tag of the claim of a shard.
+// Returns 0 if the shard is not claimed.  outAge_s (may be NULL) is the
+// time since the claim was made or last refreshed.
+//---------------------------------------------------------------------------
+int ReadShardClaim(char *inDir, int inShard, int *outAttempt, char *outTag, \
+                   double *outAge_s)
+{
+   char theName[300];
+
+   ShardFileName(inDir,inShard,"claim",theName);
+
+   return ReadClaimFile(theName,outAttempt,outTag,outAge_s);
+}
+
+
+//---------------------------------------------------------------------------
+// MoveShardFileExcl
+//
+// Renames inFrom to inTo unless inTo exists.  Returns 0 on success.
+//---------------------------------------------------------------------------
+int MoveShardFileExcl(char *inFrom, char *inTo)
+{
+#if defined(_WIN32)
+   // rename() does not replace an existing file on Windows
+   return (rename(inFrom,inTo) != 0);
+#else
+   if (link(inFrom,inTo) != 0) return 1;
+   unlink(inFrom);
+   return 0;
+#endif
+}
+
+
+//---------------------------------------------------------------------------
+// TakeShardClaim
+//
+// Moves the claim of a shard to shard_NNNN.claim.<inTag>, a name used
+// only by the worker (or RunStabilitySweep() process) inTag, and reads
+// it.  While it is taken, no other worker can release or remove the
+// claim, and the worker that took it decides from its contents whether
+// to release it, remove it or put it back with RestoreShardClaim().
+// Returns 0 if the shard was not claimed.
+//---------------------------------------------------------------------------
+int TakeShardClaim(char *inDir, int inShard, char *inTag, int *outAttempt, \
+                   char *outOwner, double *outAge_s)
+{
+   char theClaimName[300];
+   char theTakenName[300];
+   char theExt[150];
+
+   sprintf(theExt,"claim.%.100s",inTag);
+   ShardFileName(inDir,inShard,"claim",theClaimName);
+   ShardFileName(inDir,inShard,theExt,theTakenName);
+
+   if (rename(theClaimName,theTakenName) != 0) return 0;
+
+   if (!ReadClaimFile(theTakenName,outAttempt,outOwner,outAge_s))
+      return 0;
+
+   return 1;
+}
+
+
+//---------------------------------------------------------------------------
+// RestoreShardClaim
+//
+// Puts back a claim taken with TakeShardClaim().  If the shard has been
+// claimed again in the meantime, the taken claim is discarded;  its owner
+// finds the claim lost when it next refreshes it (RefreshShardClaim()).
+//---------------------------------------------------------------------------
+void RestoreShardClaim(char *inDir, int inShard, char *inTag)
+{
+   char theClaimName[300];
+   char theTakenName[300];
+   char theExt[150];
+
+   sprintf(theExt,"claim.%.100s",inTag);
+   ShardFileName(inDir,inShard,"claim",theClaimName);
+   ShardFileName(inDir,inShard,theExt,theTakenName);
+
+   if (MoveShardFileExcl(theTakenName,theClaimName) != 0)
+      remove(theTakenName);
+}
+
+
+//---------------------------------------------------------------------------
+// ReleaseShardClaim
+//
+// Records the claim of a shard as failed (renames it to shard_NNNN.failK,
+// K = attempt), so the shard is claimed again by the next worker.  Only
+// a claim of the worker inOwner (any worker if NULL) that has not been
+// refreshed for inMinAge_s is released;  inTag is the tag of the calling
+// worker or process, see TakeShardClaim().  Returns 0 if the claim was
+// released by this call.
+//---------------------------------------------------------------------------
+int ReleaseShardClaim(char *inDir, int inShard, char *inTag, char *inOwner, \
+                      double inMinAge_s)
+{
+   int    theAttempt;
+   double theAge_s;
+   char   theOwner[100];
+   char   theTakenName[300];
+   char   theFailName[300];
+   char   theExt[150];
+
+   if (!TakeShardClaim(inDir,inShard,inTag,&theAttempt,theOwner,&theAge_s))
+      return 1;
+
+   // a claim of another worker, or one refreshed since it was last read
+   if ((inOwner != NULL && strcmp(theOwner,inOwner) != 0) || \
+       theAge_s < inMinAge_s)
+   {
+      RestoreShardClaim(inDir,inShard,inTag);
+      return 1;
+   }
+
+   if (theAttempt < 1) theAttempt = 1;
+   if (theAttempt > STABILITY_SWEEP_MAX_ATTEMPTS)
+      theAttempt = STABILITY_SWEEP_MAX_ATTEMPTS;
+
+   sprintf(theExt,"claim.%.100s",inTag);
+   ShardFileName(inDir,inShard,theExt,theTakenName);
+   sprintf(theExt,"fail%d",theAttempt);
+   ShardFileName(inDir,inShard,theExt,theFailName);
+
+   return (rename(theTakenName,theFailName) != 0);
+}
+
+
+//---------------------------------------------------------------------------
+// RemoveShardClaim
+//
+// Removes the claim of the worker inTag on a completed shard.  A claim
+// of another worker is left in place.
+//---------------------------------------------------------------------------
+void RemoveShardClaim(char *inDir, int inShard, char *inTag)
+{
+   int    theAttempt;
+   char   theOwner[100];
+   char   theTakenName[300];
+   char   theExt[150];
+
+   if (!TakeShardClaim(inDir,inShard,inTag,&theAttempt,theOwner,NULL))
+      return;
+
+   if (strcmp(theOwner,inTag) != 0)
+   {
+      RestoreShardClaim(inDir,inShard,inTag);
+      return;
+   }
+
+   sprintf(theExt,"claim.%.100s",inTag);
+   ShardFileName(inDir,inShard,theExt,theTakenName);
+   remove(theTakenName);
+}
+
+
+//---------------------------------------------------------------------------
+// RefreshShardClaim
+//
+// Sets the time stamp of the claim of the worker inTag to the current
+// time, so that it does not time out while the shard is evaluated.
+// Returns 0 if the shard is still claimed by inTag, 1 if the claim has
+// been released by another worker.
+//---------------------------------------------------------------------------
+int RefreshShardClaim(char *inDir, int inShard, char *inTag)
+{
+   int  theAttempt;
+   char theName[300];
+   char theOwner[100];
+
+   if (!ReadShardClaim(inDir,inShard,&theAttempt,theOwner,NULL)) return 1;
+   if (strcmp(theOwner,inTag) != 0) return 1;
+
+   ShardFileName(inDir,inShard,"claim",theName);
+
+   return (utime(theName,NULL) != 0);
+}
+
+
+//---------------------------------------------------------------------------
+// ClaimShard
+//
+// Claims a shard for the worker inTag.  A claim that has not been
+// refreshed for inTimeout_s (if > 0) is released first.  Returns 1 if the
+// shard was claimed; 0 if it is complete, claimed by another worker or
+// has failed STABILITY_SWEEP_MAX_ATTEMPTS times.
+//---------------------------------------------------------------------------
+int ClaimShard(char *inDir, int inShard, char *inTag, double inTimeout_s)
+{
+   int    theFile;
+   int    theAttempt;
+   int    theLength;
+   double theAge_s;
+   char   theName[300];
+   char   theOwner[100];
+   char   theClaim[150];
+   char   theMessage[300];
+
+   if (ShardFileExists(inDir,inShard,"dat")) return 0;
+
+   if (ReadShardClaim(inDir,inShard,&theAttempt,theOwner,&theAge_s))
+   {
+      if (inTimeout_s <= 0 || theAge_s < inTimeout_s) return 0;
+
+      // released only if it is still stale once this worker holds it
+      if (ReleaseShardClaim(inDir,inShard,inTag,NULL,inTimeout_s)) return 0;
+
+      sprintf(theMessage,\
+              "--- ClaimShard:  shard %d of %.100s timed out, released ---",\
+              inShard,theOwner);
+      LogMessage(theMessage);
+   }
+
+   theAttempt = ShardFailedAttempts(inDir,inShard)+1;
+   if (theAttempt > STABILITY_SWEEP_MAX_ATTEMPTS) return 0;
+
+   ShardFileName(inDir,inShard,"claim",theName);
+   theFile = open(theName,O_CREAT | O_EXCL | O_WRONLY,0666);
+   if (theFile < 0) return 0;
+
+   sprintf(theClaim,"%d %.100s\n",theAttempt,inTag);
+   theLength = (int) strlen(theClaim);
+   if (write(theFile,theClaim,theLength) != theLength)
+   {
+      close(theFile);
+      remove(theName);
+      return 0;
+   }
+   close(theFile);
+
+   // the shard may have been completed between the checks above
+   if (ShardFileExists(inDir,inShard,"dat"))
+   {
+      RemoveShardClaim(inDir,inShard,inTag);
+      return 0;
+   }
+
+   return 1;
+}
+
+
+//---------------------------------------------------------------------------
+// RunStabilitySweepShard
+//
+// Evaluates all devices of shard inShard and writes the result file.
+//
+//  return value:
+//          0    successful completion
+//          1    the result file could not be written, or the claim was
+//               released by another worker (see RefreshShardClaim())
+//---------------------------------------------------------------------------
+int RunStabilitySweepShard(StabilitySweepSpec *inSpec, char *inDir, \
+                           int inShard, char *inTag)
+{
+   int     i,j,n;
+   int     theFirst;
+   int     theChunk;
+   int     theNumDevices;
+   int     theStride;
+   int     theResult;
+   double *theParams;
+   double *theTuple;
+   double  theFixed[STABILITY_SWEEP_NUM_FIXED];
+   float  *theMinEigenvalue;
+   char    theExt[150];
+   char    theTmpName[300];
+   char    theDatName[300];
+   FILE   *theFile;
+
+   StabilitySweepShardRange(inSpec,inShard,&theFirst,&theNumDevices);
+   if (theNumDevices < 1) theNumDevices = 0;
+
+   theStride = StabilityBatchStride();
+   theParams = dvector(0,theNumDevices*theStride);
+   theMinEigenvalue = vector(0,theNumDevices);
+
+   for (n=0;n<theNumDevices;n++)
+   {
+      theTuple = theParams + n*theStride;
+      StabilitySweepDeviceParams(inSpec,theFirst+n,theTuple);
+      for (j=0;j<gNumberOfEigenFunctions;j++)
+         theTuple[BATCH_NUM_DEVICE_PARAMS+j] = 0.0;
+   }
+
+   // the claim is refreshed between chunks of devices
+   for (n=0;n<theNumDevices;n+=STABILITY_SWEEP_REFRESH_DEVICES)
+   {
+      if (RefreshShardClaim(inDir,inShard,inTag))
+      {
+         sprintf(theTmpName,\
+                 "--- RunStabilitySweepShard:  claim of shard %d lost ---",\
+                 inShard);
+         LogMessage(theTmpName);
+         free_dvector(theParams,0,theNumDevices*theStride);
+         free_vector(theMinEigenvalue,0,theNumDevices);
+         return 1;
+      }
+
+      theChunk = theNumDevices-n;
+      if (theChunk > STABILITY_SWEEP_REFRESH_DEVICES)
+         theChunk = STABILITY_SWEEP_REFRESH_DEVICES;
+      GetDeviceStabilityBatch(theParams+n*theStride,theChunk,\
+                              theMinEigenvalue+n);
+   }
+
+   sprintf(theExt,"tmp.%.100s",inTag);
+   ShardFileName(inDir,inShard,theExt,theTmpName);
+   ShardFileName(inDir,inShard,"dat",theDatName);
+
+   theResult = 1;
+   if ((theFile = fopen(theTmpName,"wt")) != NULL)
+   {
+      GetStabilitySweepFixed(theFixed);
+      fprintf(theFile,"DEVICE");
+      for (i=0;i<STABILITY_SWEEP_NUM_FIXED;i++)
+         fprintf(theFile,"\t%.10g",theFixed[i]);
+      fprintf(theFile,"\n");
+
+      for (n=0;n<theNumDevices;n++)
+      {
+         theTuple = theParams + n*theStride;
+         fprintf(theFile,"%d",theFirst+n);
+         for (i=0;i<BATCH_NUM_DEVICE_PARAMS;i++)
+            fprintf(theFile,"\t%g",theTuple[i]);
+         fprintf(theFile,"\t%e\n",theMinEigenvalue[n]);
+      }
+      fprintf(theFile,"END %d\n",theNumDevices);
+
+      if (fclose(theFile) == 0)
+      {
+         // an existing result of a worker that timed out is kept
+         if (rename(theTmpName,theDatName) == 0 || \
+             ShardFileExists(inDir,inShard,"dat"))
+            theResult = 0;
+      }
+      remove(theTmpName);
+   }
+
+   free_dvector(theParams,0,theNumDevices*theStride);
+   free_vector(theMinEigenvalue,0,theNumDevices);
+
+   return theResult;
+}
+
+
+//---------------------------------------------------------------------------
+// DefaultWorkerTag
+//
+// <host name>.<process id>
+//---------------------------------------------------------------------------
+void DefaultWorkerTag(char *outTag)
+{
+   char theHost[64];
+
+#if defined(_WIN32)
+   DWORD theSize = sizeof(theHost);
+
+   if (!GetComputerName(theHost,&theSize)) strcpy(theHost,"localhost");
+   sprintf(outTag,"%.63s.%d",theHost,(int) GetCurrentProcessId());
+#else
+   if (gethostname(theHost,sizeof(theHost)) != 0) strcpy(theHost,"localhost");
+   theHost[sizeof(theHost)-1] = 0;
+   sprintf(outTag,"%.63s.%d",theHost,(int) getpid());
+#endif
+}
+
+
+//---------------------------------------------------------------------------
+// StabilitySweepWorker
+//
+// Claims and evaluates shards of the sweep until no shard is left to
+// claim.  inTag identifies the worker in claim files; if NULL, the host
+// name and process id are used.  Must be called after Membrane() and
+// ElectrodeArray();  the fixed parameters of the spec are then set.
+//
+//  return value:
+//          0    every shard claimed by this worker was completed
+//          1    at least one shard failed
+//          2    invalid spec file
+//
+// called by:  main() (SAValidate -sweep)
+//---------------------------------------------------------------------------
+int StabilitySweepWorker(char *inSpecFileName, char *inDir, char *inTag)
+{
+   int                theShard;
+   int                theNumDone;
+   int                theNumFailed;
+   char               theTag[100];
+   char               theMessage[300];
+   StabilitySweepSpec theSpec;
+
+   if (ReadStabilitySweepSpec(inSpecFileName,&theSpec)) return 2;
+
+   SetStabilitySweepFixed(&theSpec);
+
+   if (inTag != NULL)
+      sprintf(theTag,"%.99s",inTag);
+   else
+      DefaultWorkerTag(theTag);
+
+   theNumDone = 0;
+   theNumFailed = 0;
+   for (theShard=0;theShard<theSpec.NumShards;theShard++)
+   {
+      if (!ClaimShard(inDir,theShard,theTag,theSpec.Timeout_s)) continue;
+
+      if (RunStabilitySweepShard(&theSpec,inDir,theShard,theTag) == 0)
+      {
+         theNumDone++;
+         RemoveShardClaim(inDir,theShard,theTag);
+      }
+      else
+      {
+         theNumFailed++;
+         ReleaseShardClaim(inDir,theShard,theTag,theTag,0.0);
+      }
+   }
+
+   sprintf(theMessage,\
+           "StabilitySweepWorker:  %.99s completed %d shards, %d failed",\
+           theTag,theNumDone,theNumFailed);
+   LogMessage(theMessage);
+
+   return (theNumFailed > 0);
+}
+
+
+//---------------------------------------------------------------------------
+// SetStabilitySweepProgram
+//
+// Sets the path of the SAValidate executable started by
+// RunStabilitySweep() for each worker.
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+void SetStabilitySweepProgram(char *inPath)
+{
+   sprintf(gStabilitySweepProgram,"%.199s",inPath);
+}
+
+
+//---------------------------------------------------------------------------
+// RunStabilitySweep
+//
+// Runs the sweep with inNumWorkers worker processes on the local host.
+// After all workers exit, the claims they left behind (workers that
+// crashed or failed) are released and a new set of workers is started,
+// up to STABILITY_SWEEP_MAX_ATTEMPTS rounds.  Workers on other hosts may
+// share the result directory, which must exist.
+//
+// The spec file must give all fixed parameters, equal to those of the
+// current device:  the workers start from the compiled-in device, not
+// from the state of the calling session.
+//
+// Returns the number of shards without a result, or -1 if the spec file
+// is invalid or does not describe the current device.
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int RunStabilitySweep(char *inSpecFileName, char *inDir, int inNumWorkers)
+{
+   int                w;
+   int                theRound;
+   int                theShard;
+   int                theAttempt;
+   int                theNumLeft;
+   int                theNumCrashed;
+   int                theStatus;
+   int                i;
+   double             theFixed[STABILITY_SWEEP_NUM_FIXED];
+   char               theBaseTag[100];
+   char               theOwner[100];
+   char               theTag[STABILITY_SWEEP_MAX_WORKERS][120];
+   char               theMessage[300];
+   StabilitySweepSpec theSpec;
+#if defined(_WIN32)
+   int                theProcess[STABILITY_SWEEP_MAX_WORKERS];
+#else
+   pid_t              theProcess[STABILITY_SWEEP_MAX_WORKERS];
+#endif
+
+   if (ReadStabilitySweepSpec(inSpecFileName,&theSpec)) return -1;
+
+   GetStabilitySweepFixed(theFixed);
+   for (i=0;i<STABILITY_SWEEP_NUM_FIXED;i++)
+   {
+      if (!theSpec.HasFixed[i] || StabilitySweepFixedDiffers(&theSpec,theFixed) == i+1)
+      {
+         sprintf(theMessage,"--- RunStabilitySweep:  spec file must give "\
+                            "\"%s %.10g\" for the current device ---",\
+                 gStabilitySweepFixedName[i],theFixed[i]);
+         LogMessage(theMessage);
+         return -1;
+      }
+   }
+
+   if (inNumWorkers < 1) inNumWorkers = 1;
+   if (inNumWorkers > STABILITY_SWEEP_MAX_WORKERS)
+      inNumWorkers = STABILITY_SWEEP_MAX_WORKERS;
+
+   DefaultWorkerTag(theBaseTag);
+
+   theNumLeft = theSpec.NumShards;
+   for (theRound=0;theRound<STABILITY_SWEEP_MAX_ATTEMPTS;theRound++)
+   {
+      for (w=0;w<inNumWorkers;w++)
+      {
+         sprintf(theTag[w],"%s.%d.%d",theBaseTag,theRound,w);
+#if defined(_WIN32)
+         theProcess[w] = spawnl(P_NOWAIT,gStabilitySweepProgram,\
+                                gStabilitySweepProgram,"-sweep",\
+                                inSpecFileName,inDir,theTag[w],NULL);
+#else
+         theProcess[w] = fork();
+         if (theProcess[w] == 0)
+         {
+            execl(gStabilitySweepProgram,gStabilitySweepProgram,"-sweep",\
+                  inSpecFileName,inDir,theTag[w],(char *) NULL);
+            _exit(127);
+         }
+#endif
+         if (theProcess[w] < 0)
+         {
+            sprintf(theMessage,\
+                    "--- RunStabilitySweep:  cannot start %.150s ---",\
+                    gStabilitySweepProgram);
+            LogMessage(theMessage);
+         }
+      }
+
+      theNumCrashed = 0;
+      for (w=0;w<inNumWorkers;w++)
+      {
+         if (theProcess[w] < 0) continue;
+#if defined(_WIN32)
+         cwait(&theStatus,theProcess[w],WAIT_CHILD);
+         if (theStatus != 0) theNumCrashed++;
+#else
+         waitpid(theProcess[w],&theStatus,0);
+         if (!WIFEXITED(theStatus) || WEXITSTATUS(theStatus) != 0)
+            theNumCrashed++;
+#endif
+      }
+
+      // release shards left claimed by the workers of this round
+      theNumLeft = 0;
+      for (theShard=0;theShard<theSpec.NumShards;theShard++)
+      {
+         if (ShardFileExists(inDir,theShard,"dat")) continue;
+
+         theNumLeft++;
+         if (!ReadShardClaim(inDir,theShard,&theAttempt,theOwner,NULL))
+            continue;
+
+         for (w=0;w<inNumWorkers;w++)
+         {
+            if (strcmp(theOwner,theTag[w]) == 0)
+            {
+               ReleaseShardClaim(inDir,theShard,theBaseTag,theTag[w],0.0);
+               break;
+            }
+         }
+      }
+
+      sprintf(theMessage,"RunStabilitySweep:  round %d, %d workers failed, "\
+                         "%d of %d shards left",\
+              theRound, theNumCrashed, theNumLeft, theSpec.NumShards);
+      LogMessage(theMessage);
+
+      if (theNumLeft == 0) break;
+   }
+
+   return theNumLeft;
+}
+
+
+//---------------------------------------------------------------------------
+// MergeStabilitySweep
+//
+// Writes the results of all shards to inOutFileName, in grid order, with
+// a header line.  Shards without a complete result file, and shards
+// computed for a device whose fixed parameters differ from the spec file
+// (or, for parameters the spec file does not give, from the first shard)
+// are listed in the log file and left out.
+//
+// Returns the number of missing, incomplete or mismatched shards, or -1
+// if the spec file is invalid or the output file cannot be written.
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int MergeStabilitySweep(char *inSpecFileName, char *inDir, \
+                        char *inOutFileName)
+{
+   int                i;
+   int                theShard;
+   int                theFirst;
+   int                theNumDevices;
+   int                theNumLines;
+   int                theCount;
+   int                theNumMissing;
+   int                theDiffers;
+   double             theFixed[STABILITY_SWEEP_NUM_FIXED];
+   char               theName[300];
+   char               theLine[300];
+   char               theMessage[300];
+   FILE              *theIn;
+   FILE              *theOut;
+   StabilitySweepSpec theSpec;
+
+   if (ReadStabilitySweepSpec(inSpecFileName,&theSpec)) return -1;
+
+   if ((theOut = fopen(inOutFileName,"wt")) == NULL)
+   {
+      sprintf(theMessage,"--- MergeStabilitySweep:  cannot open %.150s ---",\
+              inOutFileName);
+      LogMessage(theMessage);
+      return -1;
+   }
+
+   fprintf(theOut,"Index");
+   for (i=0;i<BATCH_NUM_DEVICE_PARAMS;i++)
+      fprintf(theOut,"\t%s",gStabilitySweepParamName[i]);
+   fprintf(theOut,"\tMinEigenvalue\n");
+
+   theNumMissing = 0;
+   for (theShard=0;theShard<theSpec.NumShards;theShard++)
+   {
+      StabilitySweepShardRange(&theSpec,theShard,&theFirst,&theNumDevices);
+      ShardFileName(inDir,theShard,"dat",theName);
+
+      // verify the shard before copying it
+      theCount = -1;
+      theNumLines = 0;
+      theDiffers = 0;
+      if ((theIn = fopen(theName,"rt")) != NULL)
+      {
+         // the device the shard was computed for
+         if (fgets(theLine,sizeof(theLine),theIn) == NULL || \
+             sscanf(theLine,"DEVICE %lf %lf %lf %lf %lf",&theFixed[0],\
+                    &theFixed[1],&theFixed[2],&theFixed[3],&theFixed[4]) != 5)
+         {
+            theDiffers = -1;
+         }
+         else
+         {
+            for (i=0;i<STABILITY_SWEEP_NUM_FIXED;i++)
+            {
+               if (!theSpec.HasFixed[i])
+               {
+                  theSpec.HasFixed[i] = 1;
+                  theSpec.Fixed[i] = theFixed[i];
+               }
+            }
+            theDiffers = StabilitySweepFixedDiffers(&theSpec,theFixed);
+         }
+
+         while (theDiffers == 0 && \
+                fgets(theLine,sizeof(theLine),theIn) != NULL)
+         {
+            if (strncmp(theLine,"END",3) == 0)
+            {
+               sscanf(theLine,"END %d",&theCount);
+               break;
+            }
+            theNumLines++;
+         }
+
+         if (theCount == theNumDevices && theNumLines == theNumDevices)
+         {
+            rewind(theIn);
+            fgets(theLine,sizeof(theLine),theIn);
+            for (i=0;i<theNumLines;i++)
+            {
+               fgets(theLine,sizeof(theLine),theIn);
+               fputs(theLine,theOut);
+            }
+         }
+         fclose(theIn);
+      }
+
+      if (theDiffers > 0)
+      {
+         theNumMissing++;
+         sprintf(theMessage,"--- MergeStabilitySweep:  shard %d computed "\
+                            "with %s %g, expected %g ---",\
+                 theShard,gStabilitySweepFixedName[theDiffers-1],\
+                 theFixed[theDiffers-1],theSpec.Fixed[theDiffers-1]);
+         LogMessage(theMessage);
+      }
+      else if (theDiffers < 0)
+      {
+         theNumMissing++;
+         sprintf(theMessage,"--- MergeStabilitySweep:  shard %d has no "\
+                            "DEVICE line ---",theShard);
+         LogMessage(theMessage);
+      }
+      else if (theCount != theNumDevices || theNumLines != theNumDevices)
+      {
+         theNumMissing++;
+         sprintf(theMessage,"--- MergeStabilitySweep:  shard %d (indices "\
+                            "%d...%d) missing or incomplete ---",\
+                 theShard,theFirst,theFirst+theNumDevices-1);
+         LogMessage(theMessage);
+      }
+   }
+
+   fclose(theOut);
+
+   sprintf(theMessage,"MergeStabilitySweep:  %d devices, %d shards missing "\
+                      "or mismatched",\
+           StabilitySweepNumDevices(&theSpec),theNumMissing);
+   LogMessage(theMessage);
+
+   return theNumMissing;
+}
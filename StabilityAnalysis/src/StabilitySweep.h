@@ -0,0 +1,97 @@
+//---------------------------------------------------------------------------
+// StabilitySweep.h
+//
+// Sharded stability sweeps over several processes and hosts.
+//
+// A sweep is a regular grid over the five device parameters of
+// StabilityBatch.h (Vt, Va, dA, dT, peak deformation), described by a
+// text spec file:
+//
+//    shards     64          number of shards
+//    timeout_s  3600        claims not refreshed for this long are retried
+//    Vt         10  100 10  low high number of values
+//    Va         9999 9999 1
+//    dA         75  75  1
+//    dT         75  75  1
+//    peak       -8  8  17
+//    tension    3.0         membrane tension, N/m
+//    radius     7.5         membrane radius, mm
+//    modes      6           number of eigenfunctions
+//    width      275         electrode width, um
+//    spacing    5           electrode spacing, um
+//
+// The last five lines fix the device that is not swept.  A worker starts
+// from the compiled-in device of Membrane() and ElectrodeArray() and sets
+// the fixed parameters that the spec file gives;  every shard records the
+// fixed parameters it was computed with, and MergeStabilitySweep() rejects
+// shards that disagree with the spec file or with each other.
+// RunStabilitySweep() refuses a spec file that does not give all five or
+// that differs from the device of the calling session, so a sweep started
+// from a Tcl session with another tension, radius or basis size does not
+// silently compute the default device.
+//
+// Grid points are numbered with the last parameter (peak) varying
+// fastest, and split into contiguous shards.  Worker processes
+//
+//    SAValidate -sweep <spec file> <result dir> [<worker tag>]
+//
+// share a result directory, on the local disk or on a file system
+// mounted by every host.  A worker claims a shard by exclusively creating
+// shard_NNNN.claim, evaluates it with GetDeviceStabilityBatch() and
+// publishes shard_NNNN.dat by renaming a completed temporary file, so a
+// result file is always complete.  A shard whose worker fails is released
+// (its claim is renamed to shard_NNNN.failK, K = attempt) and is claimed
+// again by the next worker, up to STABILITY_SWEEP_MAX_ATTEMPTS attempts.
+// A worker refreshes the time stamp of its claim while it evaluates the
+// shard;  claims not refreshed for timeout_s are presumed to belong to a
+// dead worker on another host and are released by any worker.
+//
+// RunStabilitySweep() starts workers on the local host and retries failed
+// shards; workers on other hosts are started with the command line above.
+// MergeStabilitySweep() writes the results of all shards to one file, in
+// grid order.
+//---------------------------------------------------------------------------
+#ifndef STABILITYSWEEP_H
+#define STABILITYSWEEP_H
+
+
+#include "StabilityBatch.h"
+
+
+#define STABILITY_SWEEP_MAX_ATTEMPTS  3
+#define STABILITY_SWEEP_MAX_SHARDS    9999
+
+#define STABILITY_SWEEP_NUM_FIXED     5   // tension radius modes width spacing
+
+
+typedef struct
+{
+   int    NumShards;
+   double Timeout_s;
+   double Low[BATCH_NUM_DEVICE_PARAMS];
+   double High[BATCH_NUM_DEVICE_PARAMS];
+   int    NumValues[BATCH_NUM_DEVICE_PARAMS];
+   int    HasFixed[STABILITY_SWEEP_NUM_FIXED];   // 1 if given in the file
+   double Fixed[STABILITY_SWEEP_NUM_FIXED];
+} StabilitySweepSpec;
+
+
+int  ReadStabilitySweepSpec(char *inFileName, StabilitySweepSpec *outSpec);
+void GetStabilitySweepFixed(double *outFixed);
+void SetStabilitySweepFixed(StabilitySweepSpec *inSpec);
+int  StabilitySweepFixedDiffers(StabilitySweepSpec *inSpec, double *inFixed);
+int  StabilitySweepNumDevices(StabilitySweepSpec *inSpec);
+void StabilitySweepShardRange(StabilitySweepSpec *inSpec, int inShard, \
+                              int *outFirst, int *outNumDevices);
+
+int  RunStabilitySweepShard(StabilitySweepSpec *inSpec, char *inDir, \
+                            int inShard, char *inTag);
+int  StabilitySweepWorker(char *inSpecFileName, char *inDir, char *inTag);
+
+void SetStabilitySweepProgram(char *inPath);
+int  RunStabilitySweep(char *inSpecFileName, char *inDir, int inNumWorkers);
+int  MergeStabilitySweep(char *inSpecFileName, char *inDir, \
+                         char *inOutFileName);
+
+
+#endif
@@ -0,0 +1,636 @@
+//---------------------------------------------------------------------------
+// VoltageExchange.c
+//
+// Shared memory exchange of the electrode voltages.  See VoltageExchange.h
+//
+// The segment is a named file mapping (Win32) or a POSIX shared memory
+// object.  Its size is fixed by gNumElectrodes, so writer and monitor
+// must be built with the same electrode table.  The memory barriers
+// around the sequence counter updates order the voltage stores and loads
+// with respect to the counter on multiprocessors.
+//
+// For each frame, the monitor solves for the equilibrium membrane shape
+// (warm started from the shape of the previous frame) and computes the
+// minimum eigenvalue of Omega for that shape.  A frame whose evaluation
+// is overrun by the writer is retried; after VOLTAGE_EXCHANGE_MAX_RETRIES
+// attempts the voltages are copied and the copy is evaluated instead.
+//---------------------------------------------------------------------------
+#include "VoltageExchange.h"
+#include "FastStability.h"
+#include "Equilibrium.h"
+#include "MatrixUtils.h"
+#include "NR.H"
+#include "NRUTIL.H"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+VoltageExchangeHeader *gVoltageExchange = NULL;
+float                 *gVoltageExchangeVoltage_V;  // follows the header
+int                    gVoltageExchangeIsWriter = 0;
+long                   gVoltageExchangeSize;       // bytes
+char                   gVoltageExchangeName[100];
+
+#if defined(_WIN32)
+HANDLE                 gVoltageExchangeHandle;
+#endif
+
+double                *gVoltageExchangeShape;      // monitor warm start
+double                *gVoltageExchangeTrialShape;
+float                 *gVoltageExchangeCopy_V;     // monitor fallback copy
+int                    gVoltageExchangeDim = 0;    // 0 if not monitoring
+
+
+extern int      gFastStabilityDim;
+extern int      gNumElectrodes;
+extern float  **gElectrodeVoltage;
+extern double  *gExpansionCoeff_MKS;
+
+extern double   gMembraneTension_NByM;
+extern double   gVoltageT_V;
+extern double   gDistT_um;
+extern double   gDistA_um;
+
+
+
+//---------------------------------------------------------------------------
+// VoltageExchangeBarrier
+//
+// Full memory barrier.
+//---------------------------------------------------------------------------
+void VoltageExchangeBarrier()
+{
+#if defined(__GNUC__)
+   __sync_synchronize();
+#else
+   long theFence;
+
+   InterlockedExchange(&theFence,0);
+#endif
+}
+
+
+//---------------------------------------------------------------------------
+// VoltageExchangeSleep
+//
+// Yields the processor for about a millisecond while the monitor waits
+// for a new frame.
+//---------------------------------------------------------------------------
+void VoltageExchangeSleep()
+{
+#if defined(_WIN32)
+   Sleep(1);
+#else
+   usleep(1000);
+#endif
+}
+
+
+//---------------------------------------------------------------------------
+// MapVoltageExchange
+//
+// Creates (inCreate = 1) or opens the named segment and maps it into
+// memory.  Returns 0 on success, 1 on failure.
+//---------------------------------------------------------------------------
+int MapVoltageExchange(char *inName, int inCreate)
+{
+   void *theView;
+#if !defined(_WIN32)
+   int   theFile;
+#endif
+
+   gVoltageExchangeSize = sizeof(VoltageExchangeHeader) + \
+                          gNumElectrodes*sizeof(float);
+
+#if defined(_WIN32)
+   sprintf(gVoltageExchangeName,"%.90s",inName);
+
+   if (inCreate)
+      gVoltageExchangeHandle = CreateFileMapping(INVALID_HANDLE_VALUE,NULL, \
+                                  PAGE_READWRITE,0,gVoltageExchangeSize, \
+                                  gVoltageExchangeName);
+   else
+      gVoltageExchangeHandle = OpenFileMapping(FILE_MAP_ALL_ACCESS,FALSE, \
+                                               gVoltageExchangeName);
+   if (gVoltageExchangeHandle == NULL) return 1;
+
+   theView = MapViewOfFile(gVoltageExchangeHandle,FILE_MAP_ALL_ACCESS, \
+                           0,0,gVoltageExchangeSize);
+   if (theView == NULL)
+   {
+      CloseHandle(gVoltageExchangeHandle);
+      return 1;
+   }
+#else
+   // POSIX shared memory object names start with a single slash
+   sprintf(gVoltageExchangeName,"/%.90s",inName);
+
+   if (inCreate)
+      theFile = shm_open(gVoltageExchangeName,O_CREAT | O_RDWR,0666);
+   else
+      theFile = shm_open(gVoltageExchangeName,O_RDWR,0666);
+   if (theFile < 0) return 1;
+
+   if (inCreate && ftruncate(theFile,gVoltageExchangeSize) != 0)
+   {
+      close(theFile);
+      return 1;
+   }
+
+   theView = mmap(NULL,gVoltageExchangeSize,PROT_READ | PROT_WRITE, \
+                  MAP_SHARED,theFile,0);
+   close(theFile);
+   if (theView == MAP_FAILED) return 1;
+#endif
+
+   gVoltageExchange = (VoltageExchangeHeader *) theView;
+   gVoltageExchangeVoltage_V = (float *) (gVoltageExchange+1);
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// CreateVoltageExchange
+//
+// Creates the named segment for writing and initializes it with the
+// current electrode voltages (frame 1).  Must be called after
+// ElectrodeArray().  An existing segment of the same name is reused.
+//
+//  return value:
+//          0    successful completion
+//          1    the segment could not be created
+//
+// called by:  Tcl (Savalidate.i), closed loop controller
+//---------------------------------------------------------------------------
+int CreateVoltageExchange(char *inName)
+{
+   char theMessage[150];
+
+   CloseVoltageExchange();
+
+   if (MapVoltageExchange(inName,1))
+   {
+      sprintf(theMessage,\
+              "--- CreateVoltageExchange:  cannot create %.90s ---",inName);
+      LogMessage(theMessage);
+      return 1;
+   }
+
+   gVoltageExchangeIsWriter = 1;
+
+   // a reader checks ExchangeID first, so it is set last
+   gVoltageExchange->ExchangeID = 0;
+   VoltageExchangeBarrier();
+   gVoltageExchange->NumElectrodes = gNumElectrodes;
+   gVoltageExchange->Sequence = 0;
+   gVoltageExchange->Frame = 0;
+   gVoltageExchange->VoltageT_V = 0.0;
+   gVoltageExchange->MonitorSequence = 0;
+   gVoltageExchange->MonitorFrame = 0;
+   gVoltageExchange->MonitorMinEigenvalue = 0.0;
+   VoltageExchangeBarrier();
+   gVoltageExchange->ExchangeID = VOLTAGE_EXCHANGE_ID;
+
+   PublishElectrodeVoltages();
+
+   sprintf(theMessage,"CreateVoltageExchange:  %.90s, %d electrodes",\
+           inName, gNumElectrodes);
+   LogMessage(theMessage);
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// OpenVoltageExchange
+//
+// Opens an existing segment for monitoring.  Must be called after
+// Membrane() and ElectrodeArray(); the current membrane shape
+// (gExpansionCoeff_MKS) is the starting shape of the monitor.
+//
+//  return value:
+//          0    successful completion
+//          1    the segment could not be opened
+//          2    the segment was not initialized, or was created for a
+//               different number of electrodes
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int OpenVoltageExchange(char *inName)
+{
+   int  j;
+   char theMessage[150];
+
+   CloseVoltageExchange();
+
+   if (MapVoltageExchange(inName,0))
+   {
+      sprintf(theMessage,\
+              "--- OpenVoltageExchange:  cannot open %.90s ---",inName);
+      LogMessage(theMessage);
+      return 1;
+   }
+
+   if (gVoltageExchange->ExchangeID != VOLTAGE_EXCHANGE_ID || \
+       gVoltageExchange->NumElectrodes != gNumElectrodes)
+   {
+      LogMessage("--- OpenVoltageExchange:  segment does not match ---");
+      CloseVoltageExchange();
+      return 2;
+   }
+
+   gVoltageExchangeIsWriter = 0;
+
+   if (!FastStabilityIsCurrent()) InitFastStability();
+
+   gVoltageExchangeDim = gFastStabilityDim;
+   gVoltageExchangeShape = dvector(0,gVoltageExchangeDim-1);
+   gVoltageExchangeTrialShape = dvector(0,gVoltageExchangeDim-1);
+   gVoltageExchangeCopy_V = vector(0,gNumElectrodes-1);
+   for (j=0;j<gVoltageExchangeDim;j++)
+      gVoltageExchangeShape[j] = gExpansionCoeff_MKS[j];
+
+   sprintf(theMessage,"OpenVoltageExchange:  %.90s, frame %u",\
+           inName, gVoltageExchange->Frame);
+   LogMessage(theMessage);
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// CloseVoltageExchange
+//
+// Unmaps the segment.  When the writer closes it, the segment name is
+// removed; a monitor that still has it open keeps its mapping.
+//---------------------------------------------------------------------------
+void CloseVoltageExchange()
+{
+   if (gVoltageExchange == NULL) return;
+
+#if defined(_WIN32)
+   UnmapViewOfFile((void *) gVoltageExchange);
+   CloseHandle(gVoltageExchangeHandle);
+#else
+   munmap((void *) gVoltageExchange,gVoltageExchangeSize);
+   if (gVoltageExchangeIsWriter) shm_unlink(gVoltageExchangeName);
+#endif
+
+   if (gVoltageExchangeDim > 0)
+   {
+      free_dvector(gVoltageExchangeShape,0,gVoltageExchangeDim-1);
+      free_dvector(gVoltageExchangeTrialShape,0,gVoltageExchangeDim-1);
+      free_vector(gVoltageExchangeCopy_V,0,gNumElectrodes-1);
+      gVoltageExchangeDim = 0;
+   }
+
+   gVoltageExchange = NULL;
+   gVoltageExchangeIsWriter = 0;
+}
+
+
+//---------------------------------------------------------------------------
+// PublishDeviceVoltages
+//
+// Writes a new frame:  the electrode voltages inVoltage_V
+// [0...gNumElectrodes-1] (same order as gElectrodeVoltage) and Vt.
+// Never waits for the monitor.
+//
+// called by:  closed loop controller
+//---------------------------------------------------------------------------
+void PublishDeviceVoltages(float *inVoltage_V, double inVoltageT_V)
+{
+   unsigned int theSequence;
+
+   if (gVoltageExchange == NULL || !gVoltageExchangeIsWriter) return;
+
+   theSequence = gVoltageExchange->Sequence;
+   gVoltageExchange->Sequence = theSequence+1;
+   VoltageExchangeBarrier();
+
+   memcpy(gVoltageExchangeVoltage_V,inVoltage_V,gNumElectrodes*sizeof(float));
+   gVoltageExchange->VoltageT_V = inVoltageT_V;
+   gVoltageExchange->Frame++;
+
+   VoltageExchangeBarrier();
+   gVoltageExchange->Sequence = theSequence+2;
+}
+
+
+//---------------------------------------------------------------------------
+// PublishElectrodeVoltages
+//
+// Writes a new frame from the current electrode voltages
+// (gElectrodeVoltage) and gVoltageT_V.
+//
+//  return value:
+//          0    successful completion
+//          1    no segment is open for writing
+//
+// called by:  Tcl (Savalidate.i), CreateVoltageExchange()
+//---------------------------------------------------------------------------
+int PublishElectrodeVoltages()
+{
+   int          k;
+   unsigned int theSequence;
+
+   if (gVoltageExchange == NULL || !gVoltageExchangeIsWriter) return 1;
+
+   theSequence = gVoltageExchange->Sequence;
+   gVoltageExchange->Sequence = theSequence+1;
+   VoltageExchangeBarrier();
+
+   // gElectrodeVoltage is an N x 2 array; voltages are in column 1
+   for (k=0;k<gNumElectrodes;k++)
+      gVoltageExchangeVoltage_V[k] = gElectrodeVoltage[k][1];
+   gVoltageExchange->VoltageT_V = gVoltageT_V;
+   gVoltageExchange->Frame++;
+
+   VoltageExchangeBarrier();
+   gVoltageExchange->Sequence = theSequence+2;
+
+   return 0;
+}
+
+
+//---------------------------------------------------------------------------
+// BeginVoltageExchangeRead
+//
+// Starts a read of the segment:  waits (spins) while a frame is being
+// written and returns the sequence number to pass to
+// EndVoltageExchangeRead().  The voltages may then be read in place
+// through gVoltageExchangeVoltage_V.
+//---------------------------------------------------------------------------
+unsigned int BeginVoltageExchangeRead()
+{
+   unsigned int theSequence;
+
+   do
+   {
+      theSequence = gVoltageExchange->Sequence;
+   } while (theSequence & 1);
+
+   VoltageExchangeBarrier();
+
+   return theSequence;
+}
+
+
+//---------------------------------------------------------------------------
+// EndVoltageExchangeRead
+//
+// Returns 1 if the data read since BeginVoltageExchangeRead() are a
+// consistent frame, 0 if the writer changed them in the meantime and the
+// read must be repeated.
+//---------------------------------------------------------------------------
+int EndVoltageExchangeRead(unsigned int inSequence)
+{
+   VoltageExchangeBarrier();
+
+   return (gVoltageExchange->Sequence == inSequence);
+}
+
+
+//---------------------------------------------------------------------------
+// ReadVoltageExchange
+//
+// Copies the current frame to outVoltage_V [0...gNumElectrodes-1] and
+// outVoltageT_V.  Returns the frame number.
+//---------------------------------------------------------------------------
+unsigned int ReadVoltageExchange(float *outVoltage_V, double *outVoltageT_V)
+{
+   unsigned int theSequence;
+   unsigned int theFrame;
+
+   do
+   {
+      theSequence = BeginVoltageExchangeRead();
+      memcpy(outVoltage_V,gVoltageExchangeVoltage_V, \
+             gNumElectrodes*sizeof(float));
+      *outVoltageT_V = gVoltageExchange->VoltageT_V;
+      theFrame = gVoltageExchange->Frame;
+   } while (!EndVoltageExchangeRead(theSequence));
+
+   return theFrame;
+}
+
+
+//---------------------------------------------------------------------------
+// ReadMonitorResult
+//
+// Returns the frame number of the last frame evaluated by the monitor,
+// and its minimum eigenvalue in outMinEigenvalue.  Frame 0 means that no
+// result has been written yet.
+//
+// called by:  closed loop controller
+//---------------------------------------------------------------------------
+unsigned int ReadMonitorResult(double *outMinEigenvalue)
+{
+   unsigned int theSequence;
+   unsigned int theFrame;
+
+   do
+   {
+      do
+      {
+         theSequence = gVoltageExchange->MonitorSequence;
+      } while (theSequence & 1);
+      VoltageExchangeBarrier();
+
+      theFrame = gVoltageExchange->MonitorFrame;
+      *outMinEigenvalue = gVoltageExchange->MonitorMinEigenvalue;
+
+      VoltageExchangeBarrier();
+   } while (gVoltageExchange->MonitorSequence != theSequence);
+
+   return theFrame;
+}
+
+
+//---------------------------------------------------------------------------
+// MonitorMinEigenvalue
+//
+// Solves for the equilibrium shape of the device, starting from the
+// monitor's current shape, and returns the minimum eigenvalue of Omega,
+// or NO_EQUILIBRIUM_EIGENVALUE if there is no equilibrium shape.  The
+// shape is left in gVoltageExchangeTrialShape.
+//---------------------------------------------------------------------------
+OmegaScalar MonitorMinEigenvalue(DeviceConfig *ioConfig)
+{
+   int j;
+
+   for (j=0;j<gVoltageExchangeDim;j++)
+      gVoltageExchangeTrialShape[j] = gVoltageExchangeShape[j];
+   ioConfig->ExpansionCoeff_MKS = gVoltageExchangeTrialShape;
+
+   if (SolveDeviceEquilibrium(ioConfig,50,1e-6) != EQUILIBRIUM_CONVERGED)
+      return NO_EQUILIBRIUM_EIGENVALUE;
+
+   return DeviceMinEigenvalue(ioConfig);
+}
+
+
+//---------------------------------------------------------------------------
+// SharedDeviceMinEigenvalue
+//
+// Evaluates the current frame of the segment opened by
+// OpenVoltageExchange():  the minimum eigenvalue of Omega at the
+// equilibrium shape for the published voltages, or
+// NO_EQUILIBRIUM_EIGENVALUE.  The gaps and the tension are those of the
+// monitor process (gDistA_um, gDistT_um, gMembraneTension_NByM).  The
+// result is written to the Monitor fields of the header, and the frame
+// number evaluated is returned in outFrame (may be NULL).
+//---------------------------------------------------------------------------
+OmegaScalar SharedDeviceMinEigenvalue(unsigned int *outFrame)
+{
+   int          j;
+   int          theTry;
+   int          theIsValid;
+   unsigned int theSequence;
+   unsigned int theFrame;
+   OmegaScalar  theMinEigenvalue;
+   DeviceConfig theConfig;
+
+   theConfig.DistT_um = gDistT_um;
+   theConfig.DistA_um = gDistA_um;
+   theConfig.MembraneTension_NByM = gMembraneTension_NByM;
+
+   theIsValid = 0;
+   theFrame = 0;
+   theMinEigenvalue = NO_EQUILIBRIUM_EIGENVALUE;
+   for (theTry=0;theTry<VOLTAGE_EXCHANGE_MAX_RETRIES && !theIsValid;theTry++)
+   {
+      // evaluate in place; discarded if the writer overruns it
+      theSequence = BeginVoltageExchangeRead();
+      theFrame = gVoltageExchange->Frame;
+      theConfig.VoltageT_V = gVoltageExchange->VoltageT_V;
+      theConfig.ElectrodeVoltage_V = gVoltageExchangeVoltage_V;
+
+      theMinEigenvalue = MonitorMinEigenvalue(&theConfig);
+
+      theIsValid = EndVoltageExchangeRead(theSequence);
+   }
+
+   if (!theIsValid)
+   {
+      theFrame = ReadVoltageExchange(gVoltageExchangeCopy_V, \
+                                     &theConfig.VoltageT_V);
+      theConfig.ElectrodeVoltage_V = gVoltageExchangeCopy_V;
+
+      theMinEigenvalue = MonitorMinEigenvalue(&theConfig);
+   }
+
+   // warm start for the next frame
+   if (theMinEigenvalue != NO_EQUILIBRIUM_EIGENVALUE)
+      for (j=0;j<gVoltageExchangeDim;j++)
+         gVoltageExchangeShape[j] = gVoltageExchangeTrialShape[j];
+
+   gVoltageExchange->MonitorSequence++;
+   VoltageExchangeBarrier();
+   gVoltageExchange->MonitorFrame = theFrame;
+   gVoltageExchange->MonitorMinEigenvalue = theMinEigenvalue;
+   VoltageExchangeBarrier();
+   gVoltageExchange->MonitorSequence++;
+
+   if (outFrame != NULL) *outFrame = theFrame;
+
+   return theMinEigenvalue;
+}
+
+
+//---------------------------------------------------------------------------
+// GetSharedDeviceStability
+//
+// Minimum eigenvalue of Omega for the current frame of the segment opened
+// by OpenVoltageExchange(); 0 if no segment is open for monitoring.
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+OmegaScalar GetSharedDeviceStability()
+{
+   if (gVoltageExchange == NULL || gVoltageExchangeIsWriter)
+   {
+      LogMessage("--- GetSharedDeviceStability:  no segment open ---");
+      return 0.0;
+   }
+
+   return SharedDeviceMinEigenvalue(NULL);
+}
+
+
+//---------------------------------------------------------------------------
+// RunVoltageExchangeMonitor
+//
+// Evaluates inNumFrames new frames of the segment opened by
+// OpenVoltageExchange(), waiting for the writer between frames.  Frames
+// published while the previous one is being evaluated are skipped; only
+// the most recent frame is evaluated.  Unstable frames (negative minimum
+// eigenvalue, or no equilibrium shape) are written to the log file.
+//
+// Returns the number of unstable frames, or -1 if no segment is open for
+// monitoring.
+//
+// called by:  Tcl (Savalidate.i)
+//---------------------------------------------------------------------------
+int RunVoltageExchangeMonitor(int inNumFrames)
+{
+   int          theNumEvaluated;
+   int          theNumUnstable;
+   unsigned int theFirstFrame;
+   unsigned int theLastFrame;
+   unsigned int theFrame;
+   OmegaScalar  theMinEigenvalue;
+   char         theMessage[150];
+
+   if (gVoltageExchange == NULL || gVoltageExchangeIsWriter)
+   {
+      LogMessage("--- RunVoltageExchangeMonitor:  no segment open ---");
+      return -1;
+   }
+
+   theNumEvaluated = 0;
+   theNumUnstable = 0;
+   theLastFrame = gVoltageExchange->MonitorFrame;
+   theFirstFrame = 0;
+
+   while (theNumEvaluated < inNumFrames)
+   {
+      if (gVoltageExchange->Frame == theLastFrame)
+      {
+         VoltageExchangeSleep();
+         continue;
+      }
+
+      theMinEigenvalue = SharedDeviceMinEigenvalue(&theFrame);
+      if (theNumEvaluated == 0) theFirstFrame = theFrame;
+      theLastFrame = theFrame;
+      theNumEvaluated++;
+
+      if (theMinEigenvalue < 0)
+      {
+         theNumUnstable++;
+         sprintf(theMessage,\
+                 "--- RunVoltageExchangeMonitor:  frame %u unstable, "\
+                 "min. eigenvalue %e ---", theFrame, theMinEigenvalue);
+         LogMessage(theMessage);
+      }
+   }
+
+   sprintf(theMessage,"RunVoltageExchangeMonitor:  %d frames evaluated "\
+                      "(%u published), %d unstable",\
+           theNumEvaluated, theLastFrame-theFirstFrame+1, theNumUnstable);
+   LogMessage(theMessage);
+
+   return theNumUnstable;
+}
@@ -0,0 +1,67 @@
+//---------------------------------------------------------------------------
+// VoltageExchange.h
+//
+// Shared memory exchange of the electrode voltages between the closed
+// loop controller (writer) and a stability monitor running in a separate
+// process (reader).
+//
+// The segment holds a VoltageExchangeHeader followed by the electrode
+// voltage vector [0...NumElectrodes-1], in the order of gElectrodeVoltage.
+// Access is synchronized with a sequence lock:  the writer makes Sequence
+// odd, updates the voltages, increments Frame and makes Sequence even
+// again.  A reader records an even Sequence, reads, and accepts what it
+// read only if Sequence is unchanged.  Neither side ever blocks the other
+// and the writer never waits.
+//
+// The monitor computes directly on the voltages in the segment (the
+// DeviceConfig voltage pointer points into the mapped memory), so no copy
+// is made unless the writer keeps overwriting the frame while it is being
+// evaluated.  Results are written back to the Monitor fields of the
+// header, under a second sequence counter owned by the monitor.
+//
+// There must be only one writer and one monitor per segment.
+//---------------------------------------------------------------------------
+#ifndef VOLTAGEEXCHANGE_H
+#define VOLTAGEEXCHANGE_H
+
+
+#include "FastStability.h"
+
+
+#define VOLTAGE_EXCHANGE_ID           0x53415658    // "SAVX"
+#define VOLTAGE_EXCHANGE_MAX_RETRIES  4   // zero copy reads before copying
+
+
+typedef struct
+{
+   unsigned int           ExchangeID;      // VOLTAGE_EXCHANGE_ID
+   int                    NumElectrodes;
+
+   volatile unsigned int  Sequence;        // odd while voltages are written
+   volatile unsigned int  Frame;           // number of frames published
+   volatile double        VoltageT_V;      // Transp. electrode voltage
+
+   volatile unsigned int  MonitorSequence; // odd while results are written
+   volatile unsigned int  MonitorFrame;    // frame of the last result
+   volatile double        MonitorMinEigenvalue;
+} VoltageExchangeHeader;
+
+
+int    CreateVoltageExchange(char *inName);
+int    OpenVoltageExchange(char *inName);
+void   CloseVoltageExchange();
+
+void   PublishDeviceVoltages(float *inVoltage_V, double inVoltageT_V);
+int    PublishElectrodeVoltages();
+
+unsigned int BeginVoltageExchangeRead();
+int    EndVoltageExchangeRead(unsigned int inSequence);
+unsigned int ReadVoltageExchange(float *outVoltage_V, double *outVoltageT_V);
+unsigned int ReadMonitorResult(double *outMinEigenvalue);
+
+OmegaScalar SharedDeviceMinEigenvalue(unsigned int *outFrame);
+OmegaScalar GetSharedDeviceStability();
+int    RunVoltageExchangeMonitor(int inNumFrames);
+
+
+#endif
@@ -6,6 +6,7 @@
 #include <math.h>
 #include "WavefrontGUI.h"
 #include "AberratedWavefront.h"
+#include "ZernikeBasis.h"
 
 //---------------------------------------------------------------------------
 // AberratedWavefront()
@@ -36,6 +37,12 @@ AberratedWavefront::AberratedWavefront(
                                           inArrayDimension)
 {
 
+   ZOffset_um     = inZOffset_um;
+   NumBasisPoints = 0;
+   BasisRowStart  = 0;
+   BasisColumn    = 0;
+   BasisImage     = 0;
+
    // initialize AberrationCoefficient_ums.
    // initialize Zernike polynomials: Zernike[i] --> Z(j_value = i)
    for (int i = 0;i<NUMBEROFZERNIKES;i++)
@@ -61,11 +68,66 @@ AberratedWavefront::AberratedWavefront(
 AberratedWavefront::AberratedWavefront()
 {
    AberrationCoefficient_um[0] = 9999;
+
+   ZOffset_um     = 0;
+   NumBasisPoints = 0;
+   BasisRowStart  = 0;
+   BasisColumn    = 0;
+   BasisImage     = 0;
 }
 
 AberratedWavefront::~AberratedWavefront()
 {
+   delete [] BasisRowStart;
+   delete [] BasisColumn;
+   delete [] BasisImage;
+}
+
+
+
+//---------------------------------------------------------------------------
+// HasGeometry()
+//
+// TRUE if an AberratedWavefront constructed with these parameters would
+// have the same grid, pupil, ROI and Z offset as this one, so that the
+// basis images remain valid and SetAberrationCoefficients() can be used
+// in place of a new AberratedWavefront.
+//
+// called by:  TWavefrontGUIForm::Reset_Wavefront()
+//---------------------------------------------------------------------------
+bool AberratedWavefront::HasGeometry(double inWavefrontWidth_mm,
+                                     int    inArrayDimension,
+                                     double inROIDimension_mm,
+                                     double inPupilRadius_mm,
+                                     double inZOffset_um)
+{
+   // Wavefront() takes the ROI dimension as int
+   return ( Width_mm == inWavefrontWidth_mm &&
+            ArrayDimension == inArrayDimension &&
+            ROIDimension_mm == (int) inROIDimension_mm &&
+            PupilRadius_mm == inPupilRadius_mm &&
+            ZOffset_um == inZOffset_um );
+}
 
+
+
+//---------------------------------------------------------------------------
+// SetAberrationCoefficients()
+//
+// Replaces the aberration coefficients and reconstructs Phase_rad and
+// Phase_um from the basis images.  Any change made to the phase since
+// construction (e.g. by Lens::Refract()) is overwritten.
+//
+// called by:  TWavefrontGUIForm::Reset_Wavefront()
+//---------------------------------------------------------------------------
+void AberratedWavefront::SetAberrationCoefficients(double *inAberrationCoeff)
+{
+   for (int k=0;k<NUMBEROFZERNIKES;k++)
+   {
+      AberrationCoefficient_um[k] = inAberrationCoeff[k];
+   }
+
+   ConstructExteriorExpansion();
 }
 
 
@@ -75,37 +137,65 @@ AberratedWavefront::~AberratedWavefront()
 // Constructs the phase aberrations of the AberratedWavefront by
 // peforming the Zernike expansion.
 //
+// All Zernike polynomials are evaluated at once, one row of the wavefront
+// at a time, by ZernikeBasis.  The Z offset of the ZOffsetZernikePolynomials
+// adds AberrationCoefficient_um[k]*ZOffset_um for each polynomial.
+//
 // called by:
 //---------------------------------------------------------------------------
 void AberratedWavefront::ConstructZernikeExpansion()
 {
-   double theScaledR;
-   double theTheta;
+   int     theNumPoints = ArrayDimension+1;
+   double *theX = new double[theNumPoints];
+   double *theY = new double[theNumPoints];
+   double *theZ = new double[NUMBEROFZERNIKES*theNumPoints];
+   double *thePhase;
+   double *theBasisImage;
+   double  theCoeff;
+   double  theOffset_um;
 
    double theMicronsToRadiansFactor = 1e-6 * (2*PI)/Wavelength_MKS;
 
+   ZernikeBasis theBasis( Zernike[NUMBEROFZERNIKES-1].GetRadialOrder() );
+
+   theOffset_um = 0;
+   for (int k=0;k<NUMBEROFZERNIKES;k++)
+   {
+      theOffset_um += AberrationCoefficient_um[k]*Zernike[k].GetOffset();
+   }
+
    // 0 ... N (inclusive) array indexing convention is NOT A MISTAKE
    // This will not cause a memory leak, because of array allocation
    // in Wavefront class.  See class definition file for details.
    for (int i=0;i<=ArrayDimension;i++)
    {
+      // scaled coordinates, r = R_scaled(), theta = Theta_rad()
       for (int j=0;j<=ArrayDimension;j++)
       {
+         theX[j] = XRel_mm(i,j)/PupilRadius_mm;
+         theY[j] = YRel_mm(i,j)/PupilRadius_mm;
+      }
+      theBasis.Evaluate(theNumPoints, theX, theY, theZ, theNumPoints);
 
-         theScaledR = R_scaled(i,j);
-         theTheta = Theta_rad(i,j);
-         Phase_rad[i][j] = 0;
-         for (int k=0;k<NUMBEROFZERNIKES;k++)
+      thePhase = Phase_rad[i];
+      for (int j=0;j<=ArrayDimension;j++)
+      {
+         thePhase[j] = theMicronsToRadiansFactor*theOffset_um;
+      }
+      for (int k=0;k<NUMBEROFZERNIKES;k++)
+      {
+         theCoeff = theMicronsToRadiansFactor*AberrationCoefficient_um[k];
+         theBasisImage = theZ + k*theNumPoints;
+         for (int j=0;j<=ArrayDimension;j++)
          {
-
-            Phase_rad[i][j] += theMicronsToRadiansFactor *
-                                AberrationCoefficient_um[k]*
-                                Zernike[k].Evaluate(theScaledR,theTheta);
-
+            thePhase[j] += theCoeff*theBasisImage[j];
          }
       }
    }
 
+   delete [] theX;
+   delete [] theY;
+   delete [] theZ;
 
 }
 
@@ -117,61 +207,151 @@ void AberratedWavefront::ConstructZernikeExpansion()
 // Constructs the phase aberrations of the AberratedWavefront by
 // peforming the Zernike expansion also adds the Exterior expansion.
 //
+// The expansion at each point of the pupil and ROI is the product of its
+// row of basis images with the coefficients;  the images are built on
+// the first call.  Points outside the ROI are set to zero.
+//
 // called by:  AberratedWavefront()
+//             SetAberrationCoefficients()
 //---------------------------------------------------------------------------
 void AberratedWavefront::ConstructExteriorExpansion()
 {
-   double theScaledR;
-   double theTheta;
+   double *thePhase_um;
+   double *thePhase_rad;
+   double *theImage;
+   double  theValue_um;
 
    double theMicronsToRadiansFactor = 1e-6 * (2*PI)/Wavelength_MKS;
 
+   if (BasisImage == 0)
+      BuildBasisImages();
+
    // 0 ... N (inclusive) array indexing convention is NOT A MISTAKE
    // This will not cause a memory leak, because of array allocation
    // in Wavefront class.  See class definition file for details.
+#pragma omp parallel for private(thePhase_um, thePhase_rad, theImage, theValue_um)
    for (int i=0;i<=ArrayDimension;i++)
    {
+      thePhase_um  = Phase_um[i];
+      thePhase_rad = Phase_rad[i];
       for (int j=0;j<=ArrayDimension;j++)
       {
+         thePhase_um[j]  = 0;
+         thePhase_rad[j] = 0;
+      }
 
-         theScaledR = R_scaled(i,j);
-         theTheta = Theta_rad(i,j);
-         Phase_um[i][j] = 0;
-         Phase_rad[i][j] = 0;
-         if (PointIsWithinPupil(i,j))
+      for (int p=BasisRowStart[i];p<BasisRowStart[i+1];p++)
+      {
+         theImage = BasisImage + p*NUMBEROFZERNIKES;
+         theValue_um = 0;
+         for (int k=0;k<NUMBEROFZERNIKES;k++)
          {
-            for (int k=0;k<NUMBEROFZERNIKES;k++)
-            {
+            theValue_um += AberrationCoefficient_um[k]*theImage[k];
+         }
+         thePhase_um[BasisColumn[p]]  = theValue_um;
+         thePhase_rad[BasisColumn[p]] = theMicronsToRadiansFactor*theValue_um;
+      }
+   }
 
+}
 
-               Phase_rad[i][j] += theMicronsToRadiansFactor *
-                                AberrationCoefficient_um[k]*
-                                Zernike[k].Evaluate(theScaledR,theTheta);
 
-               Phase_um[i][j] += AberrationCoefficient_um[k]*
-                              Zernike[k].Evaluate(theScaledR,theTheta);
 
-            }
-         }
-         else if (PointIsWithinROI(i,j))
-         {
-            for (int k=0;k<NUMBEROFZERNIKES;k++)
-            {
+//---------------------------------------------------------------------------
+// BuildBasisImages()
+//
+// Evaluates the ZOffsetZernikePolynomials at every point within the pupil,
+// the ExteriorPolynomials at every other point within the ROI.  The
+// Zernike polynomials are evaluated at once, for the points of each row
+// within the pupil, by ZernikeBasis.  The ExteriorPolynomials must have
+// been set by ComputeExteriorPatchFunctions().
+//
+// called by:  ConstructExteriorExpansion()
+//---------------------------------------------------------------------------
+void AberratedWavefront::BuildBasisImages()
+{
+   double theScaledR;
+   double theTheta;
+   double *theImage;
 
+   int     theNumPoints = ArrayDimension+1;
+   int     theNumInPupil;
+   int     p;
+   int    *thePoint = new int[theNumPoints];
+   double *theX = new double[theNumPoints];
+   double *theY = new double[theNumPoints];
+   double *theZ = new double[NUMBEROFZERNIKES*theNumPoints];
 
-               Phase_rad[i][j] += theMicronsToRadiansFactor *
-                                AberrationCoefficient_um[k]*
-                                Exterior[k].Evaluate(theScaledR,theTheta);
+   ZernikeBasis theBasis( Zernike[NUMBEROFZERNIKES-1].GetRadialOrder() );
 
+   delete [] BasisRowStart;
+   delete [] BasisColumn;
+   delete [] BasisImage;
 
-               Phase_um[i][j] += AberrationCoefficient_um[k]*
-                                Exterior[k].Evaluate(theScaledR,theTheta);
+   // count the points within the ROI (which contains the pupil)
+   BasisRowStart = new int[ArrayDimension+2];
+   NumBasisPoints = 0;
+   for (int i=0;i<=ArrayDimension;i++)
+   {
+      BasisRowStart[i] = NumBasisPoints;
+      for (int j=0;j<=ArrayDimension;j++)
+      {
+         if (PointIsWithinPupil(i,j) || PointIsWithinROI(i,j))
+            NumBasisPoints++;
+      }
+   }
+   BasisRowStart[ArrayDimension+1] = NumBasisPoints;
+
+   BasisColumn = new int[NumBasisPoints];
+   BasisImage  = new double[NumBasisPoints*NUMBEROFZERNIKES];
 
+   p = 0;
+   for (int i=0;i<=ArrayDimension;i++)
+   {
+      theNumInPupil = 0;
+      for (int j=0;j<=ArrayDimension;j++)
+      {
+         if (PointIsWithinPupil(i,j))
+         {
+            thePoint[theNumInPupil] = p;
+            theX[theNumInPupil] = XRel_mm(i,j)/PupilRadius_mm;
+            theY[theNumInPupil] = YRel_mm(i,j)/PupilRadius_mm;
+            theNumInPupil++;
+         }
+         else if (PointIsWithinROI(i,j))
+         {
+            theScaledR = R_scaled(i,j);
+            theTheta = Theta_rad(i,j);
+            theImage = BasisImage + p*NUMBEROFZERNIKES;
+            for (int k=0;k<NUMBEROFZERNIKES;k++)
+            {
+               theImage[k] = Exterior[k].Evaluate(theScaledR,theTheta);
             }
          }
+         else
+         {
+            continue;
+         }
+         BasisColumn[p] = j;
+         p++;
+      }
+
+      // Zernike polynomials at the points of this row within the pupil
+      theBasis.Evaluate(theNumInPupil, theX, theY, theZ, theNumPoints);
+      for (int q=0;q<theNumInPupil;q++)
+      {
+         theImage = BasisImage + thePoint[q]*NUMBEROFZERNIKES;
+         for (int k=0;k<NUMBEROFZERNIKES;k++)
+         {
+            theImage[k] = theZ[k*theNumPoints+q] + Zernike[k].GetOffset();
+         }
       }
    }
 
+   delete [] thePoint;
+   delete [] theX;
+   delete [] theY;
+   delete [] theZ;
 
 }
 
@@ -23,6 +23,21 @@ class AberratedWavefront : public Wavefront
 
     void                ComputeExteriorPatchFunctions();
 
+    // Basis images:  the value of every Zernike polynomial (within the
+    // pupil) or ExteriorPolynomial (within the ROI) at every point of the
+    // pupil and ROI, so that the expansion for any coefficients is one
+    // matrix-vector product.  Points are held by row:  the points of row
+    // i are BasisRowStart[i]...BasisRowStart[i+1]-1, at columns
+    // BasisColumn[], with the images at BasisImage[p*NUMBEROFZERNIKES+k].
+    // Depend on the grid, pupil, ROI and Z offset only.
+    double                      ZOffset_um;
+    int                         NumBasisPoints;
+    int                        *BasisRowStart;      // 0...ArrayDimension+1
+    int                        *BasisColumn;        // 0...NumBasisPoints-1
+    double                     *BasisImage;
+
+    void                BuildBasisImages();
+
 
   public:
      AberratedWavefront();
@@ -36,6 +51,14 @@ class AberratedWavefront : public Wavefront
 
 
      ~AberratedWavefront();
+
+     bool HasGeometry(double inWavefrontWidth_mm,
+                      int    inArrayDimension,
+                      double inROIDimension_mm,
+                      double inPupilRadius_mm,
+                      double inZOffset_um);
+
+     void SetAberrationCoefficients(double *inAberrationCoeff);
 };
 
 extern AberratedWavefront *theAberratedWavefront;
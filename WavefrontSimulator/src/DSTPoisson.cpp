@@ -0,0 +1,384 @@
+//---------------------------------------------------------------------------
+// DSTPoisson.cpp                                     C++ class
+//
+// Fast Poisson solver for the square Dirichlet membrane, by discrete sine
+// transform.  See DSTPoisson.h
+//
+// DST-I of x[1...N-1]:
+//
+//    X[k] = sum_i x[i] sin(PI i k / N),       k = 1...N-1
+//
+// The inverse transform is (2/N) times the forward transform.  With the
+// odd extension y of x (y[i] = x[i], y[2N-i] = -x[i], y[0] = y[N] = 0),
+// the FFT of y is Y[k] = -2i X[k].  Two real sequences a, b are
+// transformed by one FFT of z = y_a + i y_b, since then
+//
+//    Z[k] = -2i Xa[k] + 2 Xb[k],    Xa = -Im Z / 2,   Xb = Re Z / 2.
+//
+// called by:  MembranePDEProblem::SolveByDST()
+//---------------------------------------------------------------------------
+#include <math.h>
+
+#include "DSTPoisson.h"
+#include "NumRecipes.h"
+
+#ifndef PI
+#define PI 3.1415926535897932
+#endif
+
+
+
+//---------------------------------------------------------------------------
+// DSTPoisson()
+//
+// Computes the transform tables and allocates the scratch arrays for an
+// inArrayDimension x inArrayDimension grid with mesh size inMeshSize_MKS.
+//
+// called by:  MembranePDEProblem::SolveByDST()
+//---------------------------------------------------------------------------
+DSTPoisson::DSTPoisson(int inArrayDimension, double inMeshSize_MKS)
+{
+   int theBits;
+
+   N = inArrayDimension;
+   GridSpacing_MKS = inMeshSize_MKS;
+
+   // FFT of length 2N when N is a power of 2
+   if ( N >= 2 && (N & (N-1)) == 0 )
+   {
+      FFTLength = 2*N;
+   }
+   else
+   {
+      FFTLength = 0;
+   }
+
+   BitReverse = 0;
+   CosTable   = 0;
+   SinTable   = 0;
+   ReWork     = 0;
+   ImWork     = 0;
+   SineTable  = 0;
+   DirectWorkA = 0;
+   DirectWorkB = 0;
+
+   if (FFTLength > 0)
+   {
+      BitReverse = new int[FFTLength];
+      CosTable   = new double[FFTLength];
+      SinTable   = new double[FFTLength];
+      ReWork     = new double[FFTLength];
+      ImWork     = new double[FFTLength];
+
+      theBits = 0;
+      while ( (1 << theBits) < FFTLength ) theBits++;
+
+      for (int m=0;m<FFTLength;m++)
+      {
+         BitReverse[m] = 0;
+         for (int b=0;b<theBits;b++)
+         {
+            if ( m & (1 << b) ) BitReverse[m] |= 1 << (theBits-1-b);
+         }
+         CosTable[m] = cos(2*PI*m/FFTLength);
+         SinTable[m] = sin(2*PI*m/FFTLength);
+      }
+   }
+   else if (N >= 2)
+   {
+      SineTable  = dmatrix(1,N-1,1,N-1);
+      DirectWorkA = dvector(1,N-1);
+      DirectWorkB = dvector(1,N-1);
+
+      for (int i=1;i<N;i++)
+      {
+         for (int k=1;k<N;k++)
+         {
+            // reduce i*k modulo 2N before taking the sine
+            SineTable[i][k] = sin( PI*((i*k)%(2*N))/N );
+         }
+      }
+   }
+
+   Eigenvalue = new double[N+1];
+   for (int k=0;k<=N;k++)
+   {
+      Eigenvalue[k] = 2*cos(PI*k/N) - 2;
+   }
+
+   Coeff.Allocate(N,N);
+   ColumnA = new double[N+1];
+   ColumnB = new double[N+1];
+   Zero    = new double[N+1];
+   for (int i=0;i<=N;i++)
+   {
+      Zero[i] = 0;
+   }
+
+}
+
+
+
+DSTPoisson::~DSTPoisson()
+{
+   delete [] Zero;
+   delete [] ColumnB;
+   delete [] ColumnA;
+   delete [] Eigenvalue;
+
+   if (SineTable != 0)
+   {
+      free_dvector(DirectWorkB,1,N-1);
+      free_dvector(DirectWorkA,1,N-1);
+      free_dmatrix(SineTable,1,N-1,1,N-1);
+   }
+
+   delete [] ImWork;
+   delete [] ReWork;
+   delete [] SinTable;
+   delete [] CosTable;
+   delete [] BitReverse;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Solve()
+//
+// Solves del^2 ioSolution = inRHS at the interior points, for the
+// boundary values held in ioSolution.  Boundary values are not changed.
+//
+// outError_MKS:   summed residual of the solution, in the form of
+//                 NR Eq. 17.5.5 pg. 674 (units: m).  Round-off only.
+//
+// called by:  MembranePDEProblem::SolveByDST()
+//---------------------------------------------------------------------------
+void DSTPoisson::Solve(Grid2d &ioSolution,
+                       Grid2d &inRHS,
+                       double *outError_MKS)
+{
+   double theH2 = GridSpacing_MKS*GridSpacing_MKS;
+   double theScale;
+   double theError_MKS;
+
+   if (N < 2)
+   {
+      *outError_MKS = 0;
+      return;
+   }
+
+   // rhs, with the boundary values moved to the right hand side
+   for (int i=1;i<N;i++)
+   {
+      for (int j=1;j<N;j++)
+      {
+         Coeff[i][j] = theH2*inRHS[i][j];
+      }
+   }
+   for (int i=1;i<N;i++)
+   {
+      Coeff[1][i]   -= ioSolution[0][i];
+      Coeff[N-1][i] -= ioSolution[N][i];
+      Coeff[i][1]   -= ioSolution[i][0];
+      Coeff[i][N-1] -= ioSolution[i][N];
+   }
+
+   TransformRows(Coeff);
+   TransformColumns(Coeff);
+
+   // divide by the eigenvalues (times h^2) of the finite difference
+   // Laplacian; (2/N)^2 normalizes the inverse transform.
+   theScale = 4.0/((double)N*N);
+   for (int k=1;k<N;k++)
+   {
+      for (int l=1;l<N;l++)
+      {
+         Coeff[k][l] *= theScale/(Eigenvalue[k] + Eigenvalue[l]);
+      }
+   }
+
+   TransformRows(Coeff);
+   TransformColumns(Coeff);
+
+   for (int i=1;i<N;i++)
+   {
+      for (int j=1;j<N;j++)
+      {
+         ioSolution[i][j] = Coeff[i][j];
+      }
+   }
+
+   theError_MKS = 0;
+   for (int i=1;i<N;i++)
+   {
+      for (int j=1;j<N;j++)
+      {
+         theError_MKS += fabs( ioSolution[i+1][j] + ioSolution[i-1][j] +
+                               ioSolution[i][j+1] + ioSolution[i][j-1] -
+                               4*ioSolution[i][j] - theH2*inRHS[i][j] );
+      }
+   }
+   *outError_MKS = theError_MKS;
+}
+
+
+
+//---------------------------------------------------------------------------
+// TransformRows()
+//
+// DST-I of elements 1...N-1 of each row 1...N-1 of io, in place.
+//
+// called by:  Solve()
+//---------------------------------------------------------------------------
+void DSTPoisson::TransformRows(Grid2d &io)
+{
+   int i;
+
+   for (i=1;i+1<N;i+=2)
+   {
+      TransformPair(io[i],io[i+1]);
+   }
+   if (i < N)
+   {
+      TransformPair(io[i],Zero);
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// TransformColumns()
+//
+// DST-I of elements 1...N-1 of each column 1...N-1 of io, in place.
+//
+// called by:  Solve()
+//---------------------------------------------------------------------------
+void DSTPoisson::TransformColumns(Grid2d &io)
+{
+   int j;
+
+   for (j=1;j<N;j+=2)
+   {
+      for (int i=1;i<N;i++)
+      {
+         ColumnA[i] = io[i][j];
+         ColumnB[i] = (j+1 < N) ? io[i][j+1] : 0;
+      }
+
+      TransformPair(ColumnA,ColumnB);
+
+      for (int i=1;i<N;i++)
+      {
+         io[i][j] = ColumnA[i];
+         if (j+1 < N) io[i][j+1] = ColumnB[i];
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// TransformPair()
+//
+// DST-I of ioA[1...N-1] and ioB[1...N-1], in place.  ioB may be Zero,
+// which is left unchanged.
+//
+// called by:  TransformRows(), TransformColumns()
+//---------------------------------------------------------------------------
+void DSTPoisson::TransformPair(double *ioA, double *ioB)
+{
+   double theSumA, theSumB;
+
+   if (FFTLength == 0)
+   {
+      // direct transform, O(N^2)
+      for (int k=1;k<N;k++)
+      {
+         theSumA = 0;
+         theSumB = 0;
+         for (int i=1;i<N;i++)
+         {
+            theSumA += ioA[i]*SineTable[i][k];
+            theSumB += ioB[i]*SineTable[i][k];
+         }
+         DirectWorkA[k] = theSumA;
+         DirectWorkB[k] = theSumB;
+      }
+      for (int k=1;k<N;k++)
+      {
+         ioA[k] = DirectWorkA[k];
+         if (ioB != Zero) ioB[k] = DirectWorkB[k];
+      }
+      return;
+   }
+
+   // odd extensions of a (real part) and b (imaginary part)
+   ReWork[0] = 0;
+   ImWork[0] = 0;
+   ReWork[N] = 0;
+   ImWork[N] = 0;
+   for (int i=1;i<N;i++)
+   {
+      ReWork[i] = ioA[i];
+      ImWork[i] = ioB[i];
+      ReWork[FFTLength-i] = -ioA[i];
+      ImWork[FFTLength-i] = -ioB[i];
+   }
+
+   FFT();
+
+   for (int k=1;k<N;k++)
+   {
+      ioA[k] = -0.5*ImWork[k];
+      if (ioB != Zero) ioB[k] = 0.5*ReWork[k];
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// FFT()
+//
+// In place forward FFT of ReWork + i ImWork, length FFTLength (a power
+// of 2):  Z[k] = sum_m z[m] exp(-2 PI i m k / FFTLength).
+// Radix 2, decimation in time, with the tables of the constructor.
+//
+// called by:  TransformPair()
+//---------------------------------------------------------------------------
+void DSTPoisson::FFT()
+{
+   int    theHalf, theStep, j;
+   double theTemp, theWR, theWI, theTR, theTI;
+
+   for (int m=0;m<FFTLength;m++)
+   {
+      j = BitReverse[m];
+      if (j > m)
+      {
+         theTemp = ReWork[m]; ReWork[m] = ReWork[j]; ReWork[j] = theTemp;
+         theTemp = ImWork[m]; ImWork[m] = ImWork[j]; ImWork[j] = theTemp;
+      }
+   }
+
+   for (int theLength=2;theLength<=FFTLength;theLength*=2)
+   {
+      theHalf = theLength/2;
+      theStep = FFTLength/theLength;
+      for (int m=0;m<FFTLength;m+=theLength)
+      {
+         for (int k=0;k<theHalf;k++)
+         {
+            theWR =  CosTable[k*theStep];
+            theWI = -SinTable[k*theStep];
+
+            theTR = theWR*ReWork[m+k+theHalf] - theWI*ImWork[m+k+theHalf];
+            theTI = theWR*ImWork[m+k+theHalf] + theWI*ReWork[m+k+theHalf];
+
+            ReWork[m+k+theHalf] = ReWork[m+k] - theTR;
+            ImWork[m+k+theHalf] = ImWork[m+k] - theTI;
+            ReWork[m+k] += theTR;
+            ImWork[m+k] += theTI;
+         }
+      }
+   }
+}
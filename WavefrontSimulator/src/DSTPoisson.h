@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------
+// DSTPoisson.h                                       C++ Header file
+//
+// Class definition for the DSTPoisson class.  Direct (fast Poisson)
+// solver for the Poisson equation of MembranePDEProblem,
+//
+//    del^2 u = rhs      on the square grid 0...N x 0...N, mesh size h,
+//
+// with u fixed on the boundary rows and columns (Dirichlet's problem).
+// Arrays use the 0...N inclusive indexing of the rest of the project.
+//
+// The 5-point finite difference Laplacian is diagonal in the basis
+//
+//    sin(PI i k / N) sin(PI j l / N),      k,l = 1...N-1
+//
+// with eigenvalues (2 cos(PI k/N) + 2 cos(PI l/N) - 4) / h^2, so the
+// solution is a 2-D discrete sine transform (DST-I) of rhs, a division,
+// and an inverse transform.  Nonzero boundary values are moved to rhs.
+//
+// Each 1-D transform of length N-1 is computed with a complex FFT of
+// length 2N, two rows (columns) per FFT.  Cost is O(N^2 log N) when N is
+// a power of 2.  For other N, the transforms are evaluated directly from
+// a table of sines, at O(N^3) cost.
+//
+// Transform tables and scratch arrays are allocated by the constructor
+// and reused by every call to Solve().
+//
+// See Numerical Recipes in C, Ch 12.3 and 19.4.
+//---------------------------------------------------------------------------
+#ifndef DSTPoissonH
+#define DSTPoissonH
+#include "Grid2d.h"
+
+
+class DSTPoisson
+{
+   private:
+
+       int       N;                 // intervals per side
+       double    GridSpacing_MKS;   // h
+
+       int       FFTLength;         // 2N, or 0 when N is not a power of 2
+       int      *BitReverse;        // FFT index permutation
+       double   *CosTable;          // cos, sin (2 PI m / FFTLength)
+       double   *SinTable;
+       double   *ReWork;            // FFT work arrays, 0...FFTLength-1
+       double   *ImWork;
+
+       double  **SineTable;         // sin(PI i k / N), direct transform only
+       double   *DirectWorkA;
+       double   *DirectWorkB;
+
+       double   *Eigenvalue;        // 2 cos(PI k/N) - 2,   k = 1...N-1
+       Grid2d    Coeff;             // transform of rhs, 0...N x 0...N
+       double   *ColumnA;           // gathered columns, 1...N-1
+       double   *ColumnB;
+       double   *Zero;              // pairs with an odd row or column
+
+       void FFT();
+       void TransformPair(double *ioA, double *ioB);
+       void TransformRows(Grid2d &io);
+       void TransformColumns(Grid2d &io);
+
+   public:
+
+       DSTPoisson(int inArrayDimension, double inMeshSize_MKS);
+       ~DSTPoisson();
+
+       int    ArrayDimension() { return N; }
+       double MeshSize_MKS()   { return GridSpacing_MKS; }
+
+       void   Solve(Grid2d &ioSolution,
+                    Grid2d &inRHS,
+                    double *outError_MKS);
+
+};
+
+
+#endif
@@ -0,0 +1,201 @@
+//---------------------------------------------------------------------------
+// Grid2d.cpp                                         C++ class
+//
+// Contiguous, aligned 2-D array with 0...N inclusive indexing.  See
+// Grid2d.h
+//---------------------------------------------------------------------------
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "Grid2d.h"
+#include "NumRecipes.h"
+
+
+
+//---------------------------------------------------------------------------
+// Grid2d()
+//
+// Empty grid.  Allocate() before use.
+//
+// called by:  MembranePDEProblem, Wavefront, MembraneMirror,
+//             MembraneInverseProblem, DSTPoisson, StencilWorkspace,
+//             NewtonKrylovMembrane (Grid2d data members),
+//             MultigridPoisson::MultigridPoisson() (residual array of
+//             each level), NewtonKrylovMembrane::NewtonKrylovMembrane()
+//             (Krylov basis), StencilWorkspace::StencilWorkspace() (row
+//             batch buffers), ReducedMirrorModel::Build(),
+//             ReducedMirrorModel::ReadFromFile() (basis shapes)
+//---------------------------------------------------------------------------
+Grid2d::Grid2d()
+{
+   Allocation = 0;
+   Data       = 0;
+   NumRows    = 0;
+   NumColumns = 0;
+   Stride     = 0;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Grid2d()
+//
+// Grid with elements [0...inNRH][0...inNCH], set to zero.
+//
+// called by:  MembranePDEProblem::ComputeReferenceSolution(),
+//             MembranePDEProblem::TestSolveByMultigrid(),
+//             MembranePDEProblem::TestSolveByDST(),
+//             MembranePDEProblem::TestSolveBySOR(),
+//             MembranePDEProblem::TestSolveByADI(),
+//             MembranePDEProblem::TestSolveByIteration(),
+//             MembranePDEProblem::TestSolveIncremental(),
+//             MembranePDEProblem::TestInfluenceMatrix(),
+//             MembranePDEProblem::TestReducedMirrorModel(),
+//             MembranePDEProblem::ReferenceSolveByIteration(),
+//             MultigridPoisson::MultigridPoisson(),
+//             InfluenceMatrix::Generate()
+//---------------------------------------------------------------------------
+Grid2d::Grid2d(int inNRH, int inNCH)
+{
+   Allocation = 0;
+   Data       = 0;
+   NumRows    = 0;
+   NumColumns = 0;
+   Stride     = 0;
+
+   Allocate(inNRH,inNCH);
+}
+
+
+
+Grid2d::~Grid2d()
+{
+   Free();
+}
+
+
+
+//---------------------------------------------------------------------------
+// Allocate()
+//
+// (Re)allocates the grid for elements [0...inNRH][0...inNCH], and sets
+// every element to zero.  Previous contents are released.
+//
+// called by:  Grid2d(), Wavefront() (all constructors),
+//             MembranePDEProblem::InitializeMKSParamsAndDataArrays(),
+//             MembranePDEProblem::SolveIncremental(),
+//             MembraneInverseProblem::MembraneInverseProblem(),
+//             MembraneMirror::MembraneMirror(),
+//             MultigridPoisson::MultigridPoisson(),
+//             DSTPoisson::DSTPoisson(),
+//             StencilWorkspace::StencilWorkspace(),
+//             NewtonKrylovMembrane::NewtonKrylovMembrane(),
+//             ReducedMirrorModel::Build(),
+//             ReducedMirrorModel::ReadFromFile()
+//---------------------------------------------------------------------------
+void Grid2d::Allocate(int inNRH, int inNCH)
+{
+   int    theRowAlignment = GRID2D_ALIGNMENT/sizeof(double);
+   size_t theBytes;
+
+   Free();
+
+   NumRows    = inNRH+1;
+   NumColumns = inNCH+1;
+
+   // pad rows to a multiple of the alignment
+   Stride = ( (NumColumns + theRowAlignment - 1)/theRowAlignment )*
+            theRowAlignment;
+
+   theBytes = (size_t)NumRows*Stride*sizeof(double);
+   Allocation = (char *) malloc(theBytes + GRID2D_ALIGNMENT);
+   if (Allocation == 0) nrerror("allocation failure in Grid2d");
+
+   Data = (double *)( Allocation +
+                      ( GRID2D_ALIGNMENT -
+                        (size_t)Allocation%GRID2D_ALIGNMENT )%GRID2D_ALIGNMENT );
+
+   memset(Data,0,theBytes);
+}
+
+
+
+//---------------------------------------------------------------------------
+// Free()
+//
+// Releases the memory of the grid.
+//
+// called by:  ~Grid2d(), Allocate()
+//---------------------------------------------------------------------------
+void Grid2d::Free()
+{
+   if (Allocation != 0) free(Allocation);
+
+   Allocation = 0;
+   Data       = 0;
+   NumRows    = 0;
+   NumColumns = 0;
+   Stride     = 0;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Fill()
+//
+// Sets every element to inValue.
+//
+// called by:  NewtonKrylovMembrane::ApplyJacobian(),
+//             NewtonKrylovMembrane::SolveNewtonStep(),
+//             MembranePDEProblem::SolveIncremental(),
+//             MembranePDEProblem::TestInfluenceMatrix(),
+//             MembranePDEProblem::TestReducedMirrorModel(),
+//             InfluenceMatrix::Generate(),
+//             InfluenceMatrix::ComputeDeflection()
+//---------------------------------------------------------------------------
+void Grid2d::Fill(double inValue)
+{
+   double *theRow;
+
+   for (int i=0;i<NumRows;i++)
+   {
+      theRow = Data + i*Stride;
+      for (int j=0;j<NumColumns;j++)
+      {
+         theRow[j] = inValue;
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// CopyFrom()
+//
+// Copies the elements of inSource, which must have the same number of
+// rows and columns.
+//
+// called by:  NewtonKrylovMembrane::Solve(),
+//             NewtonKrylovMembrane::ApplyJacobian(),
+//             MembranePDEProblem::ComputeReferenceSolution(),
+//             MembranePDEProblem::TestSolveByIteration(),
+//             MembranePDEProblem::ReferenceSolveByIteration(),
+//             MembranePDEProblem::RestoreLinearRHS(),
+//             MembranePDEProblem::TestInfluenceMatrix(),
+//             MembranePDEProblem::TestReducedMirrorModel()
+//---------------------------------------------------------------------------
+void Grid2d::CopyFrom(const Grid2d &inSource)
+{
+   if ( inSource.NumRows != NumRows || inSource.NumColumns != NumColumns )
+   {
+      nrerror("Grid2d::CopyFrom:  grids differ in size");
+   }
+
+   for (int i=0;i<NumRows;i++)
+   {
+      memcpy(Data + i*Stride,
+             inSource.Data + i*inSource.Stride,
+             NumColumns*sizeof(double));
+   }
+}
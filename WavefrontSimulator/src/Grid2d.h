@@ -0,0 +1,63 @@
+//---------------------------------------------------------------------------
+// Grid2d.h                                           C++ Header file
+//
+// Class definition for the Grid2d class.  2-D array of doubles for the
+// wavefront and membrane data of the simulator, with the 0...N inclusive
+// row and column indexing of the Numerical Recipes matrix() used
+// previously:
+//
+//    Grid2d theGrid(N,N);          // elements [0...N][0...N], set to 0
+//    theGrid[i][j] = x;
+//    double *theRow = theGrid[i];  // row view, theRow[j] == theGrid[i][j]
+//
+// The elements are held in a single allocation, aligned to
+// GRID2D_ALIGNMENT bytes, with each row padded to a multiple of
+// GRID2D_ALIGNMENT bytes so that every row starts aligned.  Rows are
+// therefore contiguous in memory, RowStride() doubles apart.
+//
+// The memory is released by the destructor.  A Grid2d cannot be copied;
+// use CopyFrom() to copy the elements of a grid of the same size.
+//---------------------------------------------------------------------------
+#ifndef Grid2dH
+#define Grid2dH
+
+
+#define GRID2D_ALIGNMENT   64      // bytes;  a multiple of sizeof(double)
+
+
+class Grid2d
+{
+   private:
+
+       char    *Allocation;         // as returned by malloc()
+       double  *Data;               // element [0][0], aligned
+       int      NumRows;            // rows 0...NumRows-1
+       int      NumColumns;         // columns 0...NumColumns-1
+       int      Stride;             // doubles from one row to the next
+
+       Grid2d(const Grid2d &);               // not copyable
+       Grid2d &operator=(const Grid2d &);
+
+   public:
+
+       Grid2d();
+       Grid2d(int inNRH, int inNCH);
+       ~Grid2d();
+
+       void Allocate(int inNRH, int inNCH);
+       void Free();
+       void Fill(double inValue);
+       void CopyFrom(const Grid2d &inSource);
+
+       double       *operator[](int inRow)       { return Data + inRow*Stride; }
+       const double *operator[](int inRow) const { return Data + inRow*Stride; }
+
+       int  Rows() const       { return NumRows; }
+       int  Columns() const    { return NumColumns; }
+       int  RowStride() const  { return Stride; }
+       bool IsAllocated() const { return Data != 0; }
+
+};
+
+
+#endif
@@ -0,0 +1,716 @@
+//---------------------------------------------------------------------------
+// InfluenceMatrix.cpp                                C++ class
+//
+// Influence functions of an electrode array, solved by sine transform.
+// See InfluenceMatrix.h
+//
+// Images of the square 0...N x 0...N are numbered by 3 bits ("maps"):
+//
+//    bit 0:   transpose,       [i][j] -> [j][i]
+//    bit 1:   reflect rows,    i -> N-i
+//    bit 2:   reflect columns, j -> N-j
+//
+// applied in this order.  The hexagons of SetHexActuator() are not
+// symmetric under transposition, so the hexagonal electrodes use maps
+// 0, 2, 4, 6 only.  An electrode whose center is the image of the center
+// of an earlier one (under an allowed map) takes the image of that
+// electrode's footprint and influence function; electrodes with no such
+// earlier one are solved.
+//
+// called by:  MembranePDEProblem::ComputeInfluenceMatrix()
+//---------------------------------------------------------------------------
+#include <fstream.h>
+#include <math.h>
+#include <limits.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "InfluenceMatrix.h"
+#include "DSTPoisson.h"
+#include "NumRecipes.h"
+
+#ifndef E_zero
+#define E_zero 8.85E-12
+#endif
+
+
+
+//---------------------------------------------------------------------------
+// InfluenceMatrix()
+//
+// Empty matrix.  SetLayout() and Generate(), or ReadFromFile(), before
+// use.
+//
+// called by:  not called within the application;  see
+//             MembranePDEProblem::ComputeInfluenceMatrix()
+//---------------------------------------------------------------------------
+InfluenceMatrix::InfluenceMatrix()
+{
+   N                = 0;
+   GridSpacing_MKS  = 0;
+
+   Layout           = INFLUENCE_SQUARE_LAYOUT;
+   NumRows          = 0;
+   NumColumns       = 0;
+   Pitch_mm         = 0;
+   ElectrodeSize_mm = 0;
+   Threshold        = 0;
+
+   NumActuators     = 0;
+   ActuatorX_mm     = 0;
+   ActuatorY_mm     = 0;
+
+   NumNonZeros      = 0;
+   ColumnStart      = 0;
+   RowIndex         = 0;
+   Value            = 0;
+
+   NumSolves        = 0;
+}
+
+
+
+InfluenceMatrix::~InfluenceMatrix()
+{
+   Clear();
+}
+
+
+
+//---------------------------------------------------------------------------
+// Clear()
+//
+// Releases the electrode centers and the matrix.
+//
+// called by:  ~InfluenceMatrix(), Generate(), ReadFromFile()
+//---------------------------------------------------------------------------
+void InfluenceMatrix::Clear()
+{
+   delete [] ActuatorX_mm;
+   delete [] ActuatorY_mm;
+   delete [] ColumnStart;
+   delete [] RowIndex;
+   delete [] Value;
+
+   NumActuators = 0;
+   ActuatorX_mm = 0;
+   ActuatorY_mm = 0;
+   NumNonZeros  = 0;
+   ColumnStart  = 0;
+   RowIndex     = 0;
+   Value        = 0;
+   NumSolves    = 0;
+}
+
+
+
+//---------------------------------------------------------------------------
+// SetLayout()
+//
+// Sets the electrode array used by the next Generate().
+//
+// inLayout:            INFLUENCE_SQUARE_LAYOUT:  square electrodes of side
+//                      inElectrodeSize_mm on a square grid.
+//                      INFLUENCE_HEX_LAYOUT:  hexagonal electrodes of side
+//                      inElectrodeSize_mm (as SetHexActuator()), in
+//                      inNumColumns lines along x, inPitch_mm*sqrt(3)/2
+//                      apart in y, alternate lines offset by inPitch_mm/2.
+//                      inElectrodeSize_mm = inPitch_mm/sqrt(3) tiles the
+//                      plane.
+// inNumRows:           electrodes along x (membrane rows)
+// inNumColumns:        electrodes along y (membrane columns)
+// inPitch_mm:          center to center distance along x
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+void InfluenceMatrix::SetLayout(int    inLayout,
+                                int    inNumRows,
+                                int    inNumColumns,
+                                double inPitch_mm,
+                                double inElectrodeSize_mm)
+{
+   Layout           = inLayout;
+   NumRows          = inNumRows;
+   NumColumns       = inNumColumns;
+   Pitch_mm         = inPitch_mm;
+   ElectrodeSize_mm = inElectrodeSize_mm;
+}
+
+
+
+//---------------------------------------------------------------------------
+// PlaceActuators()
+//
+// Computes the electrode centers of the layout, centered on the membrane.
+// Electrode k = a*NumColumns + b is at position a along x, b along y.
+//
+// called by:  Generate()
+//---------------------------------------------------------------------------
+void InfluenceMatrix::PlaceActuators()
+{
+   double theCenter_mm = 0.5*N*GridSpacing_MKS*1e3;
+   double theLineSpacing_mm;
+   double theOffset_mm;
+   int    k;
+
+   NumActuators = NumRows*NumColumns;
+   ActuatorX_mm = new double[NumActuators];
+   ActuatorY_mm = new double[NumActuators];
+
+   theLineSpacing_mm = Pitch_mm;
+   if (Layout == INFLUENCE_HEX_LAYOUT) theLineSpacing_mm = Pitch_mm*sqrt(3.0)/2;
+
+   for (int a=0;a<NumRows;a++)
+   {
+      for (int b=0;b<NumColumns;b++)
+      {
+         k = a*NumColumns + b;
+
+         // alternate hexagon lines are shifted by half a pitch;  center
+         // the pair of lines
+         theOffset_mm = 0;
+         if (Layout == INFLUENCE_HEX_LAYOUT && NumColumns > 1)
+         {
+            theOffset_mm = (b%2)*Pitch_mm/2 - Pitch_mm/4;
+         }
+
+         ActuatorX_mm[k] = theCenter_mm + (a - 0.5*(NumRows-1))*Pitch_mm +
+                           theOffset_mm;
+         ActuatorY_mm[k] = theCenter_mm +
+                           (b - 0.5*(NumColumns-1))*theLineSpacing_mm;
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// InFootprint()
+//
+// TRUE if grid point [inRow][inColumn] lies on electrode inActuator:
+// within the square, or within the hexagon of
+// MembranePDEProblem::SetHexActuator().  Points on the border belong to
+// no electrode, so that the footprints of images are images of the
+// footprints.
+//
+// called by:  AddFootprintRHS()
+//---------------------------------------------------------------------------
+bool InfluenceMatrix::InFootprint(int inActuator, int inRow, int inColumn)
+{
+   double theMeshSize_mm = GridSpacing_MKS*1e3;
+   double theX = fabs( inRow*theMeshSize_mm - ActuatorX_mm[inActuator] );
+   double theY = fabs( inColumn*theMeshSize_mm - ActuatorY_mm[inActuator] );
+   double theSide = ElectrodeSize_mm;
+   double theTolerance = 1e-6*theMeshSize_mm;
+
+   if (Layout == INFLUENCE_HEX_LAYOUT)
+   {
+      return ( theX < theSide*sqrt(3.0)/2 - theTolerance &&
+               theY < theSide - theX/sqrt(3.0) - theTolerance );
+   }
+
+   return ( theX < theSide/2 - theTolerance &&
+            theY < theSide/2 - theTolerance );
+}
+
+
+
+//---------------------------------------------------------------------------
+// AddFootprintRHS()
+//
+// Adds inRHS_MKS to ioRHS, a grid of the membrane size, at the interior
+// points of the footprint of electrode inActuator (see InFootprint()).
+// Other points are not changed.
+//
+// called by:  Generate(), MembranePDEProblem::TestInfluenceMatrix(),
+//             MembranePDEProblem::TestReducedMirrorModel()
+//---------------------------------------------------------------------------
+void InfluenceMatrix::AddFootprintRHS(int     inActuator,
+                                      double  inRHS_MKS,
+                                      Grid2d &ioRHS)
+{
+   double theExtent_mm = ElectrodeSize_mm;
+   double theMeshSize_mm = GridSpacing_MKS*1e3;
+   int    theRowLow, theRowHigh, theColumnLow, theColumnHigh;
+
+   if (ioRHS.Rows() != N+1 || ioRHS.Columns() != N+1)
+   {
+      nrerror("InfluenceMatrix::AddFootprintRHS:  grid size mismatch");
+   }
+
+   // footprint, within its bounding square
+   theRowLow     = (int)floor( (ActuatorX_mm[inActuator]-theExtent_mm)/
+                               theMeshSize_mm );
+   theRowHigh    = (int)ceil(  (ActuatorX_mm[inActuator]+theExtent_mm)/
+                               theMeshSize_mm );
+   theColumnLow  = (int)floor( (ActuatorY_mm[inActuator]-theExtent_mm)/
+                               theMeshSize_mm );
+   theColumnHigh = (int)ceil(  (ActuatorY_mm[inActuator]+theExtent_mm)/
+                               theMeshSize_mm );
+   if (theRowLow < 1)        theRowLow = 1;
+   if (theRowHigh > N-1)     theRowHigh = N-1;
+   if (theColumnLow < 1)     theColumnLow = 1;
+   if (theColumnHigh > N-1)  theColumnHigh = N-1;
+
+   for (int i=theRowLow;i<=theRowHigh;i++)
+   {
+      for (int j=theColumnLow;j<=theColumnHigh;j++)
+      {
+         if (InFootprint(inActuator,i,j))
+         {
+            ioRHS[i][j] += inRHS_MKS;
+         }
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// MapPoint()
+//
+// Replaces grid point [*ioRow][*ioColumn] by its image under map inMap.
+//
+// called by:  Generate()
+//---------------------------------------------------------------------------
+void InfluenceMatrix::MapPoint(int inMap, int *ioRow, int *ioColumn)
+{
+   int theTemp;
+
+   if (inMap & 1)
+   {
+      theTemp = *ioRow;
+      *ioRow = *ioColumn;
+      *ioColumn = theTemp;
+   }
+   if (inMap & 2) *ioRow = N - *ioRow;
+   if (inMap & 4) *ioColumn = N - *ioColumn;
+}
+
+
+
+//---------------------------------------------------------------------------
+// MapsOnto()
+//
+// TRUE if map inMap takes the center of electrode inFrom to the center of
+// electrode inTo.
+//
+// called by:  Generate()
+//---------------------------------------------------------------------------
+bool InfluenceMatrix::MapsOnto(int inMap, int inFrom, int inTo)
+{
+   double theMeshSize_mm = GridSpacing_MKS*1e3;
+   double theRow    = ActuatorX_mm[inFrom]/theMeshSize_mm;
+   double theColumn = ActuatorY_mm[inFrom]/theMeshSize_mm;
+   double theTemp;
+
+   if (inMap & 1)
+   {
+      theTemp = theRow;
+      theRow = theColumn;
+      theColumn = theTemp;
+   }
+   if (inMap & 2) theRow = N - theRow;
+   if (inMap & 4) theColumn = N - theColumn;
+
+   return ( fabs(theRow - ActuatorX_mm[inTo]/theMeshSize_mm) < 1e-6 &&
+            fabs(theColumn - ActuatorY_mm[inTo]/theMeshSize_mm) < 1e-6 );
+}
+
+
+
+//---------------------------------------------------------------------------
+// Generate()
+//
+// Computes the influence matrix of the layout set by SetLayout(), for an
+// inArrayDimension x inArrayDimension membrane grid with mesh size
+// inMeshSize_MKS, tension inTension_MKS (N/m) and membrane-electrode gap
+// inGap_MKS (m).  Values below inThreshold times the peak of their
+// column are dropped.
+//
+// The solved electrodes are divided among the OpenMP threads, each with
+// its own DSTPoisson and work arrays;  the images are filled in
+// afterwards.
+//
+// called by:  MembranePDEProblem::ComputeInfluenceMatrix()
+//---------------------------------------------------------------------------
+void InfluenceMatrix::Generate(int    inArrayDimension,
+                               double inMeshSize_MKS,
+                               double inTension_MKS,
+                               double inGap_MKS,
+                               double inThreshold)
+{
+   int     *theSource;          // electrode whose image electrode k is
+   int     *theMap;             // map taking theSource[k] to k
+   int     *theCount;           // values kept, solved electrodes
+   int    **theIndex;
+   double **theValue;
+   double   theRHSFactor_MKS;
+   int      theMapStep;
+   double   theTotal;
+   int      theRow, theColumn;
+   int      k, c, t;
+
+   if (NumRows < 1 || NumColumns < 1)
+   {
+      nrerror("InfluenceMatrix::Generate:  no electrode layout");
+   }
+
+   Clear();
+
+   N = inArrayDimension;
+   GridSpacing_MKS = inMeshSize_MKS;
+   Threshold = inThreshold;
+
+   PlaceActuators();
+
+   // find the first electrode of each set of images
+   theMapStep = (Layout == INFLUENCE_HEX_LAYOUT) ? 2 : 1;
+   theSource = new int[NumActuators];
+   theMap    = new int[NumActuators];
+   for (k=0;k<NumActuators;k++)
+   {
+      theSource[k] = k;
+      theMap[k]    = 0;
+      for (c=0;c<k && theSource[k]==k;c++)
+      {
+         for (t=theMapStep;t<8;t+=theMapStep)
+         {
+            if ( theSource[c] == c && MapsOnto(t,c,k) )
+            {
+               theSource[k] = c;
+               theMap[k]    = t;
+               break;
+            }
+         }
+      }
+      if (theSource[k] == k) NumSolves++;
+   }
+
+   theCount = new int[NumActuators];
+   theIndex = new int*[NumActuators];
+   theValue = new double*[NumActuators];
+   for (k=0;k<NumActuators;k++)
+   {
+      theCount[k] = 0;
+      theIndex[k] = 0;
+      theValue[k] = 0;
+   }
+
+   // unit V^2 electrostatic pressure, over tension
+   theRHSFactor_MKS = -E_zero/(2*inTension_MKS*inGap_MKS*inGap_MKS);
+
+#pragma omp parallel private(k,theRow,theColumn)
+   {
+      DSTPoisson theSolver(N,GridSpacing_MKS);
+      Grid2d     theRHS(N,N);
+      Grid2d     theXi(N,N);
+      double     theError_MKS;
+      double     thePeak;
+      int        n;
+
+#pragma omp for schedule(dynamic)
+      for (k=0;k<NumActuators;k++)
+      {
+         if (theSource[k] != k) continue;
+
+         theRHS.Fill(0);
+         AddFootprintRHS(k,theRHSFactor_MKS,theRHS);
+
+         theXi.Fill(0);
+         theSolver.Solve(theXi,theRHS,&theError_MKS);
+
+         thePeak = 0;
+         for (theRow=1;theRow<N;theRow++)
+         {
+            for (theColumn=1;theColumn<N;theColumn++)
+            {
+               if (fabs(theXi[theRow][theColumn]) > thePeak)
+               {
+                  thePeak = fabs(theXi[theRow][theColumn]);
+               }
+            }
+         }
+
+         // keep the values above threshold.  An electrode off the
+         // membrane has an empty column.
+         n = 0;
+         for (theRow=1;theRow<N;theRow++)
+         {
+            for (theColumn=1;theColumn<N;theColumn++)
+            {
+               if ( thePeak > 0 &&
+                    fabs(theXi[theRow][theColumn]) >= Threshold*thePeak ) n++;
+            }
+         }
+         theCount[k] = n;
+         theIndex[k] = new int[n > 0 ? n : 1];
+         theValue[k] = new double[n > 0 ? n : 1];
+
+         n = 0;
+         for (theRow=1;theRow<N;theRow++)
+         {
+            for (theColumn=1;theColumn<N;theColumn++)
+            {
+               if ( thePeak > 0 &&
+                    fabs(theXi[theRow][theColumn]) >= Threshold*thePeak )
+               {
+                  theIndex[k][n] = theRow*(N+1) + theColumn;
+                  theValue[k][n] = theXi[theRow][theColumn];
+                  n++;
+               }
+            }
+         }
+      }
+   }
+
+   // assemble the columns, mapping the solved ones onto their images
+   theTotal = 0;
+   for (k=0;k<NumActuators;k++) theTotal += theCount[theSource[k]];
+   if (theTotal > INT_MAX)
+   {
+      nrerror("InfluenceMatrix::Generate:  too many values; raise the threshold");
+   }
+
+   ColumnStart = new int[NumActuators+1];
+   ColumnStart[0] = 0;
+   for (k=0;k<NumActuators;k++)
+   {
+      ColumnStart[k+1] = ColumnStart[k] + theCount[theSource[k]];
+   }
+   NumNonZeros = ColumnStart[NumActuators];
+   RowIndex = new int[NumNonZeros > 0 ? NumNonZeros : 1];
+   Value    = new double[NumNonZeros > 0 ? NumNonZeros : 1];
+
+   for (k=0;k<NumActuators;k++)
+   {
+      c = theSource[k];
+      for (int n=0;n<theCount[c];n++)
+      {
+         theRow    = theIndex[c][n]/(N+1);
+         theColumn = theIndex[c][n] - theRow*(N+1);
+         MapPoint(theMap[k],&theRow,&theColumn);
+
+         RowIndex[ColumnStart[k]+n] = theRow*(N+1) + theColumn;
+         Value[ColumnStart[k]+n]    = theValue[c][n];
+      }
+   }
+
+   for (k=0;k<NumActuators;k++)
+   {
+      delete [] theIndex[k];
+      delete [] theValue[k];
+   }
+   delete [] theValue;
+   delete [] theIndex;
+   delete [] theCount;
+   delete [] theMap;
+   delete [] theSource;
+}
+
+
+
+//---------------------------------------------------------------------------
+// AddColumn()
+//
+// Adds inScale times the influence function of electrode inActuator to
+// ioSurface, a grid of the membrane size.
+//
+// called by:  ComputeDeflection(), ReducedMirrorModel::Build(),
+//             MembranePDEProblem::TestInfluenceMatrix()
+//---------------------------------------------------------------------------
+void InfluenceMatrix::AddColumn(int inActuator, double inScale, Grid2d &ioSurface)
+{
+   int theRow, theColumn;
+
+   if (ioSurface.Rows() != N+1 || ioSurface.Columns() != N+1)
+   {
+      nrerror("InfluenceMatrix::AddColumn:  grid size mismatch");
+   }
+
+   for (int n=ColumnStart[inActuator];n<ColumnStart[inActuator+1];n++)
+   {
+      theRow    = RowIndex[n]/(N+1);
+      theColumn = RowIndex[n] - theRow*(N+1);
+      ioSurface[theRow][theColumn] += inScale*Value[n];
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// ComputeDeflection()
+//
+// Membrane deflection (m) for the electrode voltages squared
+// inVoltageSquared[0...NumActuators-1] (V^2):  the sum of the influence
+// functions, weighted by V^2.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+void InfluenceMatrix::ComputeDeflection(const double *inVoltageSquared,
+                                        Grid2d       &outDeflection_MKS)
+{
+   outDeflection_MKS.Fill(0);
+
+   for (int k=0;k<NumActuators;k++)
+   {
+      if (inVoltageSquared[k] != 0)
+      {
+         AddColumn(k,inVoltageSquared[k],outDeflection_MKS);
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// WriteToFile()
+//
+// Writes the layout, electrode centers and sparse matrix to a binary
+// file:  "WFIM", INFLUENCE_FILE_VERSION, N, h, Layout, NumRows,
+// NumColumns, Pitch_mm, ElectrodeSize_mm, Threshold, NumNonZeros,
+// ActuatorX_mm[], ActuatorY_mm[], ColumnStart[], RowIndex[], Value[].
+//
+// return value:  FALSE if the file could not be written.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+bool InfluenceMatrix::WriteToFile(const char *inFileName)
+{
+   int theVersion = INFLUENCE_FILE_VERSION;
+   bool theStatus;
+
+   fstream iofile(inFileName, ios::out | ios::binary);
+
+   if (iofile.fail())
+   {
+      return false;
+   }
+
+   iofile.write("WFIM",4);
+   iofile.write((char *)&theVersion,sizeof(int));
+   iofile.write((char *)&N,sizeof(int));
+   iofile.write((char *)&GridSpacing_MKS,sizeof(double));
+   iofile.write((char *)&Layout,sizeof(int));
+   iofile.write((char *)&NumRows,sizeof(int));
+   iofile.write((char *)&NumColumns,sizeof(int));
+   iofile.write((char *)&Pitch_mm,sizeof(double));
+   iofile.write((char *)&ElectrodeSize_mm,sizeof(double));
+   iofile.write((char *)&Threshold,sizeof(double));
+   iofile.write((char *)&NumNonZeros,sizeof(int));
+
+   iofile.write((char *)ActuatorX_mm,NumActuators*sizeof(double));
+   iofile.write((char *)ActuatorY_mm,NumActuators*sizeof(double));
+   iofile.write((char *)ColumnStart,(NumActuators+1)*sizeof(int));
+   iofile.write((char *)RowIndex,NumNonZeros*sizeof(int));
+   iofile.write((char *)Value,NumNonZeros*sizeof(double));
+
+   theStatus = !iofile.fail();
+   iofile.close();
+
+   return theStatus;
+}
+
+
+
+//---------------------------------------------------------------------------
+// ReadFromFile()
+//
+// Reads a matrix written by WriteToFile(), replacing the current one.
+// The sparse matrix is checked before use:  ColumnStart must run from 0
+// to NumNonZeros without decreasing, and every RowIndex must be a point
+// of the 0...N x 0...N grid.
+//
+// return value:  FALSE if the file could not be read, is not an
+//                influence matrix file, or holds an inconsistent
+//                matrix.  The matrix is then empty.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+bool InfluenceMatrix::ReadFromFile(const char *inFileName)
+{
+   char   theMagic[4];
+   int    theVersion;
+   double theNumPoints;
+   bool   theStatus;
+
+   Clear();
+
+   fstream iofile(inFileName, ios::in | ios::binary);
+
+   if (iofile.fail())
+   {
+      return false;
+   }
+
+   iofile.read(theMagic,4);
+   iofile.read((char *)&theVersion,sizeof(int));
+   if ( iofile.fail() ||
+        theMagic[0] != 'W' || theMagic[1] != 'F' ||
+        theMagic[2] != 'I' || theMagic[3] != 'M' ||
+        theVersion != INFLUENCE_FILE_VERSION )
+   {
+      iofile.close();
+      return false;
+   }
+
+   iofile.read((char *)&N,sizeof(int));
+   iofile.read((char *)&GridSpacing_MKS,sizeof(double));
+   iofile.read((char *)&Layout,sizeof(int));
+   iofile.read((char *)&NumRows,sizeof(int));
+   iofile.read((char *)&NumColumns,sizeof(int));
+   iofile.read((char *)&Pitch_mm,sizeof(double));
+   iofile.read((char *)&ElectrodeSize_mm,sizeof(double));
+   iofile.read((char *)&Threshold,sizeof(double));
+   iofile.read((char *)&NumNonZeros,sizeof(int));
+   if ( iofile.fail() || N < 1 ||
+        NumRows < 0 || NumColumns < 0 || NumNonZeros < 0 )
+   {
+      NumNonZeros = 0;
+      iofile.close();
+      return false;
+   }
+
+   NumActuators = NumRows*NumColumns;
+   ActuatorX_mm = new double[NumActuators];
+   ActuatorY_mm = new double[NumActuators];
+   ColumnStart  = new int[NumActuators+1];
+   RowIndex     = new int[NumNonZeros > 0 ? NumNonZeros : 1];
+   Value        = new double[NumNonZeros > 0 ? NumNonZeros : 1];
+
+   iofile.read((char *)ActuatorX_mm,NumActuators*sizeof(double));
+   iofile.read((char *)ActuatorY_mm,NumActuators*sizeof(double));
+   iofile.read((char *)ColumnStart,(NumActuators+1)*sizeof(int));
+   iofile.read((char *)RowIndex,NumNonZeros*sizeof(int));
+   iofile.read((char *)Value,NumNonZeros*sizeof(double));
+
+   if (iofile.fail())
+   {
+      iofile.close();
+      Clear();
+      return false;
+   }
+   iofile.close();
+
+   // AddColumn() indexes the grid with these, unchecked
+   theNumPoints = (double)(N+1)*(N+1);
+   theStatus = ( ColumnStart[0] == 0 &&
+                 ColumnStart[NumActuators] == NumNonZeros );
+   for (int k=0;k<NumActuators && theStatus;k++)
+   {
+      if (ColumnStart[k+1] < ColumnStart[k]) theStatus = false;
+   }
+   for (int n=0;n<NumNonZeros && theStatus;n++)
+   {
+      if (RowIndex[n] < 0 || RowIndex[n] >= theNumPoints) theStatus = false;
+   }
+   if (!theStatus)
+   {
+      Clear();
+      return false;
+   }
+
+   return true;
+}
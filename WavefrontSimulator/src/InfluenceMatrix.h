@@ -0,0 +1,122 @@
+//---------------------------------------------------------------------------
+// InfluenceMatrix.h                                  C++ Header file
+//
+// Class definition for the InfluenceMatrix class.  Influence functions of
+// an array of electrodes under the membrane of MembranePDEProblem:  column
+// k is the membrane deflection produced by electrode k at unit V^2, all
+// other electrodes at 0 V,
+//
+//    del^2 xi_k = - E_zero / (2 T d^2)     on the footprint of electrode k,
+//
+// on the square grid 0...N x 0...N, mesh size h, with xi_k = 0 on the
+// boundary.  The membrane equation with the gap taken at the flat
+// membrane is linear in V^2, so the deflection for electrode voltages V_k
+// is sum_k V_k^2 xi_k (ComputeDeflection()).
+//
+// Electrodes are square or hexagonal (as SetHexActuator()), on a square
+// or a hexagonal layout of NumRows x NumColumns electrodes, centered on
+// the membrane.  32 x 32 gives the 1024 electrode array.
+//
+// Each influence function is solved directly by sine transform (see
+// DSTPoisson.h), the electrodes divided among OpenMP threads.  The
+// fixed boundary of the membrane makes the influence functions depend on
+// position everywhere, so they are not shifted copies of each other.
+// The square with its boundary is however unchanged by reflection in its
+// center lines and diagonals; an electrode whose footprint is the image
+// of another one's has the image of its influence function.  Only one
+// electrode of each set of images is solved:  about 1/8 of the square
+// layout, 1/2 of the hexagonal one.
+//
+// Values below Threshold times the peak of their column are dropped, and
+// the remaining ones held by column (compressed sparse column format):
+// the values of column k are Value[ColumnStart[k]...ColumnStart[k+1]-1],
+// at grid points RowIndex[], numbered i*(N+1)+j for point [i][j].
+//
+// WriteToFile() and ReadFromFile() store the layout and the sparse
+// matrix in a binary file.
+//---------------------------------------------------------------------------
+#ifndef InfluenceMatrixH
+#define InfluenceMatrixH
+#include "Grid2d.h"
+
+
+#define INFLUENCE_SQUARE_LAYOUT   0
+#define INFLUENCE_HEX_LAYOUT      1
+
+#define INFLUENCE_FILE_VERSION    1
+
+
+class ReducedMirrorModel;
+
+class InfluenceMatrix
+{
+   friend ReducedMirrorModel;
+
+   private:
+
+       int       N;                   // membrane intervals per side
+       double    GridSpacing_MKS;     // h
+
+       int       Layout;              // INFLUENCE_SQUARE_LAYOUT or ..._HEX_...
+       int       NumRows;             // electrodes per column, per row
+       int       NumColumns;
+       double    Pitch_mm;            // center to center distance
+       double    ElectrodeSize_mm;    // side of square, side of hexagon
+       double    Threshold;           // fraction of the column peak
+
+       int       NumActuators;
+       double   *ActuatorX_mm;        // electrode centers, 0...NumActuators-1
+       double   *ActuatorY_mm;
+
+       int       NumNonZeros;
+       int      *ColumnStart;         // 0...NumActuators
+       int      *RowIndex;            // 0...NumNonZeros-1
+       double   *Value;               // m/V^2
+
+       int       NumSolves;           // influence functions solved
+
+       void   Clear();
+       void   PlaceActuators();
+       bool   InFootprint(int inActuator, int inRow, int inColumn);
+       void   MapPoint(int inMap, int *ioRow, int *ioColumn);
+       bool   MapsOnto(int inMap, int inFrom, int inTo);
+
+   public:
+
+       InfluenceMatrix();
+       ~InfluenceMatrix();
+
+       void   SetLayout(int    inLayout,
+                        int    inNumRows,
+                        int    inNumColumns,
+                        double inPitch_mm,
+                        double inElectrodeSize_mm);
+
+       void   Generate(int    inArrayDimension,
+                       double inMeshSize_MKS,
+                       double inTension_MKS,
+                       double inGap_MKS,
+                       double inThreshold);
+
+       void   AddFootprintRHS(int     inActuator,
+                              double  inRHS_MKS,
+                              Grid2d &ioRHS);
+       void   AddColumn(int inActuator, double inScale, Grid2d &ioSurface);
+       void   ComputeDeflection(const double *inVoltageSquared,
+                                Grid2d       &outDeflection_MKS);
+
+       bool   WriteToFile(const char *inFileName);
+       bool   ReadFromFile(const char *inFileName);
+
+       int    ArrayDimension() { return N; }
+       double MeshSize_MKS()   { return GridSpacing_MKS; }
+       int    Actuators()      { return NumActuators; }
+       int    NonZeros()       { return NumNonZeros; }
+       int    Solves()         { return NumSolves; }
+       double ActuatorX(int inActuator) { return ActuatorX_mm[inActuator]; }
+       double ActuatorY(int inActuator) { return ActuatorY_mm[inActuator]; }
+
+};
+
+
+#endif
@@ -53,8 +53,8 @@ void Lens::Refract(Wavefront *ioWavefront)
 
    // NOTE:  Array indexing from 0...N inclusive is intentional!
    // this is for compatibility with MembranePDEproblem arrays, and
-   // does not cause a memory leak because of NR routine matrix()
-   // which allocates from 0...N inclusive.
+   // does not cause a memory leak because Grid2d (like NR routine
+   // matrix()) allocates from 0...N inclusive.
    for (int i=0;i<=ioWavefront->ArrayDimension;i++)
    {
       theX_MKS = i*ioWavefront->MeshSize_MKS - theXC_MKS;
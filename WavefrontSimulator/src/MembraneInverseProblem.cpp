@@ -55,10 +55,10 @@ MembraneInverseProblem::MembraneInverseProblem(Wavefront *inWavefront,
    double          theDeformation_MKS;
    double          thePhaseToMKSFactor = inWavefront->Wavelength_MKS/(2*PI);
 
-   RealElectrodeVoltage=matrix(0,ArrayDimension,0,ArrayDimension);
-   RealElectrodeVoltage_Graph=matrix(0,ArrayDimension,0,ArrayDimension);
-   ImagElectrodeVoltage=matrix(0,ArrayDimension,0,ArrayDimension);
-   ImagElectrodeVoltage_Graph=matrix(0,ArrayDimension,0,ArrayDimension);
+   RealElectrodeVoltage.Allocate(ArrayDimension,ArrayDimension);
+   RealElectrodeVoltage_Graph.Allocate(ArrayDimension,ArrayDimension);
+   ImagElectrodeVoltage.Allocate(ArrayDimension,ArrayDimension);
+   ImagElectrodeVoltage_Graph.Allocate(ArrayDimension,ArrayDimension);
 
    // Allocate arrays for solution data etc.
    // this method defined in MembranePDEProblem
@@ -73,12 +73,6 @@ MembraneInverseProblem::MembraneInverseProblem(Wavefront *inWavefront,
    {
       for (int j=0;j<=ArrayDimension;j++)
       {
-         //initialize these arrays
-         RealElectrodeVoltage[i][j]=0;
-         RealElectrodeVoltage_Graph[i][j]=0;
-         ImagElectrodeVoltage[i][j]=0;
-         ImagElectrodeVoltage_Graph[i][j]=0;
-
          // set SolutionData to the deformation appropriate
          // to generate the input wavefront.
          //
@@ -527,8 +521,8 @@ void MembraneInverseProblem::WriteHeaderDataToFile(AnsiString inFileName)
 // called by: WriteElectrodeDataToFile()
 //
 //---------------------------------------------------------------------------
-void MembraneInverseProblem::AppendArrayDataToFile(AnsiString inFileName,
-                                                   double  **inArrayData)
+void MembraneInverseProblem::AppendArrayDataToFile(AnsiString    inFileName,
+                                                   const Grid2d &inArrayData)
 {
 
 
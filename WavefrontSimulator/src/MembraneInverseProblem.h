@@ -59,15 +59,15 @@ class MembraneInverseProblem : public MembranePDEProblem
 
       double   InvertedMembraneSign;
 
-      double   **RealElectrodeVoltage;
-      double   **ImagElectrodeVoltage;
-      double   **RealElectrodeVoltage_Graph;
-      double   **ImagElectrodeVoltage_Graph;
+      Grid2d     RealElectrodeVoltage;
+      Grid2d     ImagElectrodeVoltage;
+      Grid2d     RealElectrodeVoltage_Graph;
+      Grid2d     ImagElectrodeVoltage_Graph;
 
       void     ComputeElectrodeVoltagesFromPoissonEquation();
       void     WriteHeaderDataToFile(AnsiString inFileName);
-      void     AppendArrayDataToFile(AnsiString   inFileName,
-                                     double     **inArrayData);
+      void     AppendArrayDataToFile(AnsiString    inFileName,
+                                     const Grid2d &inArrayData);
 
    public:
 
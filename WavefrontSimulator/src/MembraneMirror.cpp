@@ -36,13 +36,13 @@ MembraneMirror::MembraneMirror(Wavefront *inWavefront)
 
    // initialize the membrane mirror deformation to be
    // the same as the solution of the corresponding MembranePDEproblem
-   Deformation_MKS = matrix(0,ArrayDimension,0,ArrayDimension);
+   Deformation_MKS.Allocate(ArrayDimension,ArrayDimension);
 
    double          theDeformation_MKS;
    double          thePhaseToMKSFactor = inWavefront->Wavelength_MKS/(2*PI);
 
    // note 0...N inclusive indexing scheme is intentional, and
-   // in keeping with numerical recipes matrix definition and
+   // in keeping with numerical recipes matrix definition, Grid2d and
    // other class libraries within this project.  This will not
    // cause a memory leak.
    for (int i=0;i<=ArrayDimension;i++)
@@ -95,21 +95,3 @@ void MembraneMirror::Reflect(Wavefront *ioWavefront)
 
 
 }
-
-
-
-
-double **MembraneMirror::matrix(int nrl, int nrh, int ncl, int nch)
-{
-   int i;
-   double **m;
-   m=(double **) malloc((unsigned) (nrh-nrl+1)*sizeof(double*));
-   m-=nrl;
-   for (i=nrl;i<=nrh;i++)   {
-      m[i]=(double *) malloc((unsigned) (nch-ncl+1)*sizeof(double));
-      m[i]-=ncl;
-   }
-   return m;
-}
-
-
@@ -16,13 +16,14 @@
 #define MembraneMirrorH
 #include "Graphics3d.h"
 #include "Wavefront.h"
+#include "Grid2d.h"
 
 
 class MembraneMirror
 {
    private:
       int          ArrayDimension;
-      double     **Deformation_MKS;
+      Grid2d       Deformation_MKS;
       double       Width_mm;             // Width of membrane, Units: mm
       double       Width_MKS;            // Width of square membrane, units: m
 
@@ -31,8 +32,6 @@ class MembraneMirror
       double       MeshSize_mm;          // mesh size (in 3d coords)
       double       MeshSize_MKS;         // mesh size in MKS,  units:  m
 
-      double **matrix(int nrl, int nrh, int ncl, int nch);
-
    public:
 
       MembraneMirror(Wavefront *inWavefront);
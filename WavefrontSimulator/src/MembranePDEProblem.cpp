@@ -53,10 +53,23 @@ MembranePDEProblem::MembranePDEProblem()
 
    MeshSize_mm         = 0;        // step size in x,y
 
-   DesiredFractionalError = 0;   //fractional error for iterative solution
+   DesiredFractionalError = 1e-5;   //fractional error for iterative solution
 
    TotalIterations     = 0;
 
+   Multigrid           = NULL;
+   FastPoisson         = NULL;
+   ADIWorkspace        = NULL;
+   NewtonKrylov        = NULL;
+   PullIn              = false;
+   WindowPoisson       = NULL;
+
+   // no changes:  Low = ArrayDimension, High = -1, as ClearRHSChange()
+   ChangedRowLow       = ArrayDimension;
+   ChangedRowHigh      = -1;
+   ChangedColumnLow    = ArrayDimension;
+   ChangedColumnHigh   = -1;
+
    // pointer to the StaticTextBox where the peak deflection information
    // will be displayed, after the problem is solved.
    // PeakDeflectionTextBox = ???;
@@ -150,6 +163,13 @@ MembranePDEProblem::MembranePDEProblem(TEdit       *inStress,
    TotalIterationsTextBox = inTotalIterationsTextBox;
    TotalIterations = -1;
 
+   Multigrid = NULL;
+   FastPoisson = NULL;
+   ADIWorkspace = NULL;
+   NewtonKrylov = NULL;
+   PullIn = false;
+   WindowPoisson = NULL;
+
    InitializeMKSParamsAndDataArrays();
 
 
@@ -168,6 +188,11 @@ MembranePDEProblem::~MembranePDEProblem()
 {
    // destroy the MembranePDEProblem
 
+   delete Multigrid;
+   delete FastPoisson;
+   delete ADIWorkspace;
+   delete NewtonKrylov;
+   delete WindowPoisson;
 }
 
 
@@ -189,30 +214,25 @@ void MembranePDEProblem::InitializeMKSParamsAndDataArrays()
    TopElectrodeDistance_MKS = TopElectrodeDistance_um * 1e-6;
 
 
-   SolutionData_Graph=matrix(0,ArrayDimension,0,ArrayDimension);
-   rhs_Graph=matrix(0,ArrayDimension,0,ArrayDimension);
-   ElectrodeVoltage_Graph=matrix(0,ArrayDimension,0,ArrayDimension);
+   // arrays 0...ArrayDimension inclusive, set to 0
+   SolutionData_Graph.Allocate(ArrayDimension,ArrayDimension);
+   rhs_Graph.Allocate(ArrayDimension,ArrayDimension);
+   ElectrodeVoltage_Graph.Allocate(ArrayDimension,ArrayDimension);
 
 
 
-   SolutionData=matrix(0,ArrayDimension,0,ArrayDimension);
-   rhs=matrix(0,ArrayDimension,0,ArrayDimension);
-   ElectrodeVoltage=matrix(0,ArrayDimension,0,ArrayDimension);
-
-   for (int i=0;i<=ArrayDimension;i++)
-   {
-      for (int j=0;j<=ArrayDimension;j++)
-      {
-         SolutionData[i][j]=0;
-	 rhs[i][j]=0;
-         ElectrodeVoltage[i][j]=0;
-         SolutionData_Graph[i][j]=0;
-	 rhs_Graph[i][j]=0;
-         ElectrodeVoltage_Graph[i][j]=0;
-
-      }
-   }
+   SolutionData.Allocate(ArrayDimension,ArrayDimension);
+   rhs.Allocate(ArrayDimension,ArrayDimension);
+   ElectrodeVoltage.Allocate(ArrayDimension,ArrayDimension);
 
+   // no rhs changes yet:  SolutionData (zero) solves the zero rhs
+   ElectrodeRHS.Allocate(ArrayDimension,ArrayDimension);
+   RHSIsNonlinear = false;
+   RHSChange.Allocate(ArrayDimension,ArrayDimension);
+   ChangedRowLow     = ArrayDimension;
+   ChangedRowHigh    = -1;
+   ChangedColumnLow  = ArrayDimension;
+   ChangedColumnHigh = -1;
 
 }
 
@@ -283,8 +303,7 @@ void MembranePDEProblem::SetActuator(double inXL,
    {
       for (int j=jL; j<=jH; j++)
       {
-         rhs[i][j] = theRHSFactor_MKS;
-         ElectrodeVoltage[i][j] = inVoltage_MKS;
+         SetElectrodePoint(i,j,inVoltage_MKS,theRHSFactor_MKS);
       }
    }
 
@@ -360,8 +379,8 @@ void MembranePDEProblem::SetHexActuator(double inXCenter_mm,
 
                 // set the appropriate element of voltage, rhs arrays
                 // to the desired values.
-                ElectrodeVoltage[theRow][theColumn] = inVoltage_MKS;
-                rhs[theRow][theColumn]= theRHSFactor_MKS;
+                SetElectrodePoint(theRow,theColumn,
+                                  inVoltage_MKS,theRHSFactor_MKS);
 
 
          }
@@ -398,8 +417,7 @@ void MembranePDEProblem::SetBias()
    {
       for (int j=1; j<ArrayDimension; j++)
       {
-         rhs[i][j] = theRHSFactor_MKS;
-         ElectrodeVoltage[i][j] = Bias_V;
+         SetElectrodePoint(i,j,Bias_V,theRHSFactor_MKS);
       }
    }
 
@@ -407,6 +425,95 @@ void MembranePDEProblem::SetBias()
 
 
 
+//----------------------------------------------------------------------------
+// SetElectrodePoint()
+//
+// Sets the electrode voltage and the corresponding rhs of the Poisson
+// equation at one grid point.  The change of ElectrodeRHS at interior
+// points is added to RHSChange, for SolveIncremental();  setting a point
+// to its present value is no change.  After SolveByIteration(), rhs
+// holds the nonlinear rhs, and is left to RestoreLinearRHS().
+//
+// called by:  SetActuator(), SetHexActuator(), SetBias()
+//
+//----------------------------------------------------------------------------
+void MembranePDEProblem::SetElectrodePoint(int    inRow,
+                                           int    inColumn,
+                                           double inVoltage_MKS,
+                                           double inRHS_MKS)
+{
+   if ( inRow > 0 && inRow < ArrayDimension &&
+        inColumn > 0 && inColumn < ArrayDimension &&
+        inRHS_MKS != ElectrodeRHS[inRow][inColumn] )
+   {
+      RHSChange[inRow][inColumn] += inRHS_MKS - ElectrodeRHS[inRow][inColumn];
+
+      if (inRow < ChangedRowLow)          ChangedRowLow = inRow;
+      if (inRow > ChangedRowHigh)         ChangedRowHigh = inRow;
+      if (inColumn < ChangedColumnLow)    ChangedColumnLow = inColumn;
+      if (inColumn > ChangedColumnHigh)   ChangedColumnHigh = inColumn;
+   }
+
+   ElectrodeRHS[inRow][inColumn] = inRHS_MKS;
+   if (!RHSIsNonlinear)
+   {
+      rhs[inRow][inColumn] = inRHS_MKS;
+   }
+   ElectrodeVoltage[inRow][inColumn] = inVoltage_MKS;
+}
+
+
+
+//----------------------------------------------------------------------------
+// RestoreLinearRHS()
+//
+// Called by the linear solvers:  if SolveByIteration() has replaced rhs
+// by the rhs at the deflected membrane, restores the rhs of the linear
+// problem, ElectrodeRHS.
+//
+// called by:  Solve(), SolveBySOR(), SolveByADI(), SolveByMultigrid(),
+//             SolveByDST(), ComputeReferenceSolution()
+//
+//----------------------------------------------------------------------------
+void MembranePDEProblem::RestoreLinearRHS()
+{
+   if (RHSIsNonlinear)
+   {
+      rhs.CopyFrom(ElectrodeRHS);
+      RHSIsNonlinear = false;
+   }
+}
+
+
+
+//----------------------------------------------------------------------------
+// ClearRHSChange()
+//
+// Called when SolutionData has been solved for the current rhs:  there
+// are no changes left for SolveIncremental().
+//
+// called by:  Solve(), SolveBySOR(), SolveByADI(), SolveByMultigrid(),
+//             SolveByDST(), SolveByIteration(), SolveIncremental()
+//
+//----------------------------------------------------------------------------
+void MembranePDEProblem::ClearRHSChange()
+{
+   for (int i=ChangedRowLow; i<=ChangedRowHigh; i++)
+   {
+      for (int j=ChangedColumnLow; j<=ChangedColumnHigh; j++)
+      {
+         RHSChange[i][j] = 0;
+      }
+   }
+
+   ChangedRowLow     = ArrayDimension;
+   ChangedRowHigh    = -1;
+   ChangedColumnLow  = ArrayDimension;
+   ChangedColumnHigh = -1;
+}
+
+
+
 
 
 
@@ -435,6 +542,7 @@ void MembranePDEProblem::Solve()
    double righthandside;
    int theMaxNumberOfIterations = 5000;
 
+   RestoreLinearRHS();
 
    //Gauss-Seidel iteration
    for (int count=0;count<theMaxNumberOfIterations;count++)
@@ -463,6 +571,7 @@ void MembranePDEProblem::Solve()
    }
 
    TotalIterations = theMaxNumberOfIterations;
+   ClearRHSChange();
    ComputeSolutionStatistics();
 }
 
@@ -473,64 +582,54 @@ void MembranePDEProblem::Solve()
 // SolveBySOR()
 //
 // Implements the Numerical Recipes SOR code for solving the Poisson equation
-// Uses SOR.C as well as NRUTIL.C routines
+// with the constant coefficients of NR Eq. 17.5.25 pg. 678 compiled into
+// the kernel.  Red-black half sweeps, rows divided among OpenMP threads.
+// See PoissonStencil.h
+//
+// note peculiar 0...n array index convention.  In keeping with
+// NR, only 1...n indexed elements are used.  0 elements are for
+// consistency with the rest of this code.  0 elements are ignored
+// in this solution.
 //
 // called by: TForm1::RunSolveSORExecute()
 //---------------------------------------------------------------------------
 void MembranePDEProblem::SolveBySOR()
 {
-   double **a, **b, **c, **d, **e, **f;
    double rjac;
 
-   a=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   b=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   c=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   d=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   e=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   f=dmatrix(0,ArrayDimension,0,ArrayDimension);
-
-   // note peculiar 0...n array index convention.  In keeping with
-   // NR, these arrays will only use 1...n indexed elements.  0 elements
-   // are for consistency with the rest of this code.  0 elements will
-   // be ignored in this solution (set to zero).
-   for (int i=0;i<=ArrayDimension;i++)
-   {
-      for (int j=0;j<=ArrayDimension;j++)
-      {
-
-         // coeffs. of NR Eq. 17.5.25 pg. 678
-         a[i][j] =  1;
-         b[i][j] =  1;
-         c[i][j] =  1;
-         d[i][j] =  1;
-         e[i][j] = -4;
-
-         // this corrects an omission from Numerical Recipes!
-         // NR algorithm implemented as a "black box" for the
-         // Poisson problem is equivalent to using f[i][j] = rhs[i][j].
-         // THIS IS WRONG!  (e.g. compare units--rhs has units of 1/m
-         // in MKS).  The constant of proportionality between
-         // f[i][j] and rhs[i][j] is alluded to on pg. 678 in reference
-         // to NR Eq. 17.5.25, but is not explicitly mentioned.
-         // The correct constant of proportionality can be found
-         // by considering the finite difference scheme for the
-         // Poisson equation, and deriving NR Eq. 17.5.25.  See
-         // for example NR Eq. 17.5.5 on pg. 674 for finite difference
-         // scheme for Poisson equation as part of discussion of
-         // Jacobi's method.
-         // plk 4/9/2003
-         f[i][j] = (MeshSize_MKS*MeshSize_MKS)* rhs[i][j];
-      }
-   }
+   RestoreLinearRHS();
 
+   // NR Eq. 17.5.25 pg. 678:  a = b = c = d = 1, e = -4, and
+   // f[i][j] = (MeshSize_MKS*MeshSize_MKS)* rhs[i][j]
+   //
+   // this corrects an omission from Numerical Recipes!
+   // NR algorithm implemented as a "black box" for the
+   // Poisson problem is equivalent to using f[i][j] = rhs[i][j].
+   // THIS IS WRONG!  (e.g. compare units--rhs has units of 1/m
+   // in MKS).  The constant of proportionality between
+   // f[i][j] and rhs[i][j] is alluded to on pg. 678 in reference
+   // to NR Eq. 17.5.25, but is not explicitly mentioned.
+   // The correct constant of proportionality can be found
+   // by considering the finite difference scheme for the
+   // Poisson equation, and deriving NR Eq. 17.5.25.  See
+   // for example NR Eq. 17.5.5 on pg. 674 for finite difference
+   // scheme for Poisson equation as part of discussion of
+   // Jacobi's method.
+   // plk 4/9/2003
 
    // implement NR eq. 17.5.24 p. 678 for the rho_jacobi parameter.
    // NOTE "J" = "L" = ArrayDimension; "DeltaX" = "DeltaY" = MeshSize_MKS
    double theArg = PI/ArrayDimension;
    rjac = cos(theArg);
 
-   sor(a,b,c,d,e,f,SolutionData,ArrayDimension,rjac);
+   TotalIterations = StencilSOR<1,1,1,1,-4>(rhs,
+                                            MeshSize_MKS*MeshSize_MKS,
+                                            SolutionData,
+                                            ArrayDimension,
+                                            rjac,
+                                            &ActualSolutionError_MKS);
 
+   ClearRHSChange();
    ComputeSolutionStatistics();
 }
 
@@ -545,49 +644,37 @@ void MembranePDEProblem::SolveBySOR()
 // SolveByADI()
 //
 // Implements the Numerical Recipes ADI code for solving the Poisson equation
-// Uses ADI.C as well as NRUTIL.C routines
+// with the constant coefficients of NR Eq. 17.6.22 pg. 685 compiled into
+// the kernel.  See PoissonStencil.h
+//
+// The ADI work arrays are allocated by the first call, and reused.
 //
 // called by: TForm1::RunSolveADIExecute()
 //
 //---------------------------------------------------------------------------
 void MembranePDEProblem::SolveByADI()
 {
-   double **a, **b, **c, **d, **e, **f, **g;
    double alpha, beta, eps;
-   int jmax, k;
+   int k;
 
-   a=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   b=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   c=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   d=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   e=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   f=dmatrix(0,ArrayDimension,0,ArrayDimension);
-   g=dmatrix(0,ArrayDimension,0,ArrayDimension);
+   RestoreLinearRHS();
 
+   // coeffs. of NR Eq. 17.6.22 pg. 685, taken from
+   // NR Eq. 17.6.10 pg. 682:  a = c = d = f = -1, b = e = 2, and
+   // g[i][j] = (MeshSize_MKS*MeshSize_MKS)* rhs[i][j]
+   //
+   // this corrects an omission from Numerical Recipes!!
+   // See note above in SolveBySOR()
+   // plk 4/9/2003
 
-   // note peculiar 0...n array index convention.  In keeping with
-   // NR, these arrays will only use 1...n indexed elements.  0 elements
-   // are for consistency with the rest of this code.  0 elements will
-   // be ignored in this solution (set to zero).
-   for (int i=0;i<=ArrayDimension;i++)
+   if (ADIWorkspace != NULL && ADIWorkspace->N < ArrayDimension)
    {
-      for (int j=0;j<=ArrayDimension;j++)
-      {
-         // coeffs. of NR Eq. 17.6.22 pg. 685, taken from
-         // NR Eq. 17.6.10 pg. 682.
-
-         a[i][j] = -1;
-         b[i][j] =  2;
-         c[i][j] = -1;
-         d[i][j] = -1;
-         e[i][j] =  2;
-         f[i][j] = -1;
-
-         // this corrects an omission from Numerical Recipes!!
-         // See note above in SolveBySOR()
-         // plk 4/9/2003
-         g[i][j] = (MeshSize_MKS*MeshSize_MKS)* rhs[i][j];
-      }
+      delete ADIWorkspace;
+      ADIWorkspace = NULL;
+   }
+   if (ADIWorkspace == NULL)
+   {
+      ADIWorkspace = new StencilWorkspace(ArrayDimension);
    }
 
    // Number of sub-iterations in adi() is 2^k
@@ -603,6 +690,10 @@ void MembranePDEProblem::SolveByADI()
    //     100                 5
    //     200                 6
    //     500                 6
+   //
+   // k=4 is kept for every grid:  at this tolerance larger k gains
+   // nothing (2048 and 4096 converge in 32 sub-iterations with k=3...5),
+   // and k much above 5 stalls the iteration on large grids.
 
    k=4;
 
@@ -617,8 +708,67 @@ void MembranePDEProblem::SolveByADI()
 
    eps = 1e-5;
 
-   adi(a,b,c,d,e,f,g,SolutionData,ArrayDimension,k,alpha,beta,eps);
+   TotalIterations = StencilADI<-1,2,-1,-1,2,-1>(rhs,
+                                                 MeshSize_MKS*MeshSize_MKS,
+                                                 SolutionData,
+                                                 ArrayDimension,
+                                                 k,
+                                                 alpha,
+                                                 beta,
+                                                 eps,
+                                                 ADIWorkspace,
+                                                 &ActualSolutionError_MKS);
+
+   ClearRHSChange();
+   ComputeSolutionStatistics();
+}
+
+
+
 
+//---------------------------------------------------------------------------
+// SolveByMultigrid()
+//
+// Solves the Poisson equation by geometric multigrid cycles (see
+// MultigridPoisson.h), starting from the current SolutionData.  Cycles
+// are repeated until the summed residual is less than
+// DesiredFractionalError times the summed residual of a zero solution.
+// Cost is O(ArrayDimension^2) per cycle, and a few cycles are needed for
+// any grid size.  ArrayDimension should be a power of 2.
+//
+// The grid hierarchy is allocated by the first call, and reused.
+//
+// inCycleIndex:    MG_V_CYCLE or MG_W_CYCLE
+//
+// called by: not called within the application;  see
+//            TestSolveByMultigrid()
+//---------------------------------------------------------------------------
+void MembranePDEProblem::SolveByMultigrid(int inCycleIndex)
+{
+   int theMaxNumberOfCycles = 100;
+
+   RestoreLinearRHS();
+
+   if ( Multigrid != NULL &&
+        ( Multigrid->ArrayDimension() != ArrayDimension ||
+          Multigrid->MeshSize_MKS() != MeshSize_MKS ) )
+   {
+      delete Multigrid;
+      Multigrid = NULL;
+   }
+   if (Multigrid == NULL)
+   {
+      Multigrid = new MultigridPoisson(ArrayDimension,MeshSize_MKS);
+   }
+
+   TotalIterations = Multigrid->Solve(SolutionData,
+                                      rhs,
+                                      DesiredFractionalError,
+                                      theMaxNumberOfCycles,
+                                      inCycleIndex,
+                                      &ActualSolutionError_MKS);
+
+   ClearRHSChange();
    ComputeSolutionStatistics();
 }
 
@@ -626,133 +776,867 @@ void MembranePDEProblem::SolveByADI()
 
 
 //---------------------------------------------------------------------------
-// SolveByIteration()
+// SolveByDST()
 //
-// Solves the full nonlinear Poisson problem using an iterative procedure.
-// The 0'th order problme is solved, and the solution is fed into the
-// right hand side of the Poisson equation.  The 0'th order Poisson problem
-// is then solved again...
+// Solves the Poisson equation directly, by discrete sine transform (see
+// DSTPoisson.h).  Exact for the finite difference equation of the other
+// solvers, up to round-off; the result does not depend on the starting
+// SolutionData.  Cost is O(N^2 log N) for ArrayDimension N a power of 2,
+// O(N^3) otherwise.
 //
-// called by:  TForm1::RunIterativeSolverExecute()
+// The transform tables are computed by the first call, and reused.
 //
+// called by: not called within the application;  see TestSolveByDST()
 //---------------------------------------------------------------------------
-void MembranePDEProblem::SolveByIteration()
+void MembranePDEProblem::SolveByDST()
 {
-   int      theMaxNumberOfIterations = 10;
-   double   a,b,c,d,e,f;
-   double   theDist_MKS;
-   double   theVV;
-   double   theDenom;
-   double   theStartError_MKS;
-   double   theRHSTerm;
-   double   theResidual;
-   double **theTempSolution;
-
-   // coeffs for finite differencing of Poisson equation; for
-   // error computation.  Seen NR. Eq. 17.5.25 pg. 678 and note
-   // in SolveBySOR() concerning f
-   a=1;
-   b=1;
-   c=1;
-   d=1;
-   e=-4;
-   f=MeshSize_MKS*MeshSize_MKS;
-
-
-   // compute starting error, assuming trial solution is 0 everywhere,
-   // and coefficient matrix for computing error.  See NOTE below
-   // in Error computation.
-   theStartError_MKS = 0;
-   for (int i=1;i<ArrayDimension;i++)
+   RestoreLinearRHS();
+
+   if ( FastPoisson != NULL &&
+        ( FastPoisson->ArrayDimension() != ArrayDimension ||
+          FastPoisson->MeshSize_MKS() != MeshSize_MKS ) )
    {
-         for (int j=1;j<ArrayDimension;j++)
-         {
-            theStartError_MKS += fabs( rhs[i][j] );
-         }
+      delete FastPoisson;
+      FastPoisson = NULL;
+   }
+   if (FastPoisson == NULL)
+   {
+      FastPoisson = new DSTPoisson(ArrayDimension,MeshSize_MKS);
    }
 
+   FastPoisson->Solve(SolutionData,rhs,&ActualSolutionError_MKS);
 
+   // direct solution:  one pass
+   TotalIterations = 1;
 
-   theTempSolution = matrix(0,ArrayDimension,0,ArrayDimension);
-   for (int i=0;i<=ArrayDimension;i++)
+   ClearRHSChange();
+   ComputeSolutionStatistics();
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// TestSolveByMultigrid()
+//
+// Checks SolveByMultigrid() against the Numerical Recipes SOR solution
+// of the same problem (ReferenceSolveBySOR()).  Both solvers start from
+// the current SolutionData;  the multigrid solution is kept.  Returns
+// the largest difference of the two solutions relative to the peak of
+// the SOR solution (see SolutionDifference()), or -1 if the grid is
+// too large for the reference solution.
+//
+// inCycleIndex:    MG_V_CYCLE or MG_W_CYCLE
+//
+// called by: not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double MembranePDEProblem::TestSolveByMultigrid(int inCycleIndex)
+{
+   double theDifference;
+
+   if (ArrayDimension > REFERENCE_SOR_MAX_DIMENSION) return -1.0;
+
+   Grid2d theReference(ArrayDimension,ArrayDimension);
+   ComputeReferenceSolution(theReference,REFERENCE_SOR,true);
+
+   SolveByMultigrid(inCycleIndex);
+   theDifference = SolutionDifference(theReference);
+
+   return theDifference;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// TestSolveByDST()
+//
+// Checks SolveByDST() against the Numerical Recipes SOR solution of the
+// same problem (ReferenceSolveBySOR()), as TestSolveByMultigrid() does.
+// The sine transform solution is exact up to round-off, so the result
+// is the error of the SOR solution.  The DST solution is kept.
+//
+// called by: not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double MembranePDEProblem::TestSolveByDST()
+{
+   double theDifference;
+
+   if (ArrayDimension > REFERENCE_SOR_MAX_DIMENSION) return -1.0;
+
+   Grid2d theReference(ArrayDimension,ArrayDimension);
+   ComputeReferenceSolution(theReference,REFERENCE_SOR,true);
+
+   SolveByDST();
+   theDifference = SolutionDifference(theReference);
+
+   return theDifference;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// TestSolveBySOR()
+//
+// Checks SolveBySOR() against the Numerical Recipes sor() called as the
+// original SolveBySOR() did (same grid index range, coefficient arrays).
+// The stencil kernel performs the same iterations, in the same red-black
+// order, so the difference should be round-off for any number of OpenMP
+// threads.  Both solvers start from the current SolutionData;  the
+// SolveBySOR() solution is kept.  Returns the largest difference
+// relative to the peak of the sor() solution, or -1 if the grid is too
+// large for sor().
+//
+// called by: not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double MembranePDEProblem::TestSolveBySOR()
+{
+   double theDifference;
+
+   if (ArrayDimension > REFERENCE_SOR_MAX_DIMENSION) return -1.0;
+
+   Grid2d theReference(ArrayDimension,ArrayDimension);
+   ComputeReferenceSolution(theReference,REFERENCE_SOR,false);
+
+   SolveBySOR();
+   theDifference = SolutionDifference(theReference);
+
+   return theDifference;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// TestSolveByADI()
+//
+// Checks SolveByADI() against the Numerical Recipes adi() called as the
+// original SolveByADI() did, as TestSolveBySOR() does for SolveBySOR().
+// Returns -1 if the grid is too large for adi() (JJ in ADI.C).
+//
+// called by: not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double MembranePDEProblem::TestSolveByADI()
+{
+   double theDifference;
+
+   if (ArrayDimension > REFERENCE_ADI_MAX_DIMENSION) return -1.0;
+
+   Grid2d theReference(ArrayDimension,ArrayDimension);
+   ComputeReferenceSolution(theReference,REFERENCE_ADI,false);
+
+   SolveByADI();
+   theDifference = SolutionDifference(theReference);
+
+   return theDifference;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// TestSolveByIteration()
+//
+// Checks SolveByIteration() against a fixed point iteration of the same
+// nonlinear problem (ReferenceSolveByIteration()).  The Newton-Krylov
+// solution is kept.  Returns the largest difference of the two solutions
+// relative to the peak of the fixed point solution, or -1 if the grid is
+// too large for the reference solution, or if either iteration finds no
+// equilibrium (pull-in).
+//
+// called by: not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double MembranePDEProblem::TestSolveByIteration()
+{
+   double theDifference;
+   bool   theReferenceConverged;
+
+   if (ArrayDimension > REFERENCE_SOR_MAX_DIMENSION) return -1.0;
+
+   Grid2d theStart(ArrayDimension,ArrayDimension);
+   Grid2d theReference(ArrayDimension,ArrayDimension);
+
+   theStart.CopyFrom(SolutionData);
+   theReferenceConverged = ReferenceSolveByIteration();
+   theReference.CopyFrom(SolutionData);
+   SolutionData.CopyFrom(theStart);
+
+   SolveByIteration();
+   if (!theReferenceConverged || PullIn) return -1.0;
+
+   theDifference = SolutionDifference(theReference);
+
+   return theDifference;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// TestSolveIncremental()
+//
+// Checks SolveIncremental() against the Numerical Recipes SOR solution
+// of the changed problem over the entire grid (ReferenceSolveBySOR()),
+// as TestSolveByMultigrid() does.  SolutionData must be the solution
+// before the changes, as for SolveIncremental();  the incremental
+// solution is kept.  With INCREMENTAL_FULL_GRID the result is the error
+// of the SOR solution;  with a window margin it includes the error of
+// neglecting the correction outside the window.  Returns -1 if the grid
+// is too large for the reference solution, or after SolveByIteration()
+// (see TestSolveByIteration()).
+//
+// inWindowMargin:  see SolveIncremental()
+//
+// called by: not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double MembranePDEProblem::TestSolveIncremental(int inWindowMargin)
+{
+   double theDifference;
+
+   if (ArrayDimension > REFERENCE_SOR_MAX_DIMENSION) return -1.0;
+   if (RHSIsNonlinear) return -1.0;
+
+   Grid2d theReference(ArrayDimension,ArrayDimension);
+   ComputeReferenceSolution(theReference,REFERENCE_SOR,true);
+
+   SolveIncremental(inWindowMargin);
+   theDifference = SolutionDifference(theReference);
+
+   return theDifference;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// TestInfluenceMatrix()
+//
+// Checks column inActuator of an influence matrix computed for this
+// membrane (ComputeInfluenceMatrix()) against the Numerical Recipes SOR
+// solution for that electrode alone at 1 V (ReferenceSolveBySOR()), over
+// the entire grid.  Most columns of the matrix are images of solved ones
+// (see InfluenceMatrix.h);  the reference is solved for the electrode's
+// own footprint, so it also checks the symmetry.  The result includes
+// the values dropped below the threshold of the matrix.  SolutionData
+// and rhs are left unchanged.
+//
+// Returns the largest difference relative to the peak of the SOR
+// solution, or -1 if the grid is too large for the reference solution,
+// if the matrix is for another grid, or if the electrode is off the
+// membrane.
+//
+// called by: not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double MembranePDEProblem::TestInfluenceMatrix(InfluenceMatrix &inMatrix,
+                                               int              inActuator)
+{
+   double theDifference;
+   double theUnitRHS_MKS;
+
+   if (ArrayDimension > REFERENCE_SOR_MAX_DIMENSION) return -1.0;
+   if ( inMatrix.ArrayDimension() != ArrayDimension ||
+        inMatrix.MeshSize_MKS() != MeshSize_MKS ) return -1.0;
+
+   Grid2d theSolution(ArrayDimension,ArrayDimension);
+   Grid2d theRHS(ArrayDimension,ArrayDimension);
+   Grid2d theReference(ArrayDimension,ArrayDimension);
+
+   theSolution.CopyFrom(SolutionData);
+   theRHS.CopyFrom(rhs);
+
+   // 1 V on the electrode, gap at the flat membrane (see SetActuator())
+   theUnitRHS_MKS = -E_zero/(2*MembraneTension_MKS*
+                             GapDistance_MKS*GapDistance_MKS);
+   rhs.Fill(0);
+   inMatrix.AddFootprintRHS(inActuator,theUnitRHS_MKS,rhs);
+   SolutionData.Fill(0);
+   ReferenceSolveBySOR(true);
+   theReference.CopyFrom(SolutionData);
+
+   SolutionData.Fill(0);
+   inMatrix.AddColumn(inActuator,1.0,SolutionData);
+   theDifference = SolutionDifference(theReference);
+
+   SolutionData.CopyFrom(theSolution);
+   rhs.CopyFrom(theRHS);
+
+   return theDifference;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// TestReducedMirrorModel()
+//
+// Checks the deflection of a reduced model (ReducedMirrorModel.h) built
+// from inMatrix, for the electrode voltages squared
+// inVoltageSquared[0...Actuators()-1], against the Numerical Recipes SOR
+// solution for the same voltages on the electrodes of inMatrix
+// (ReferenceSolveBySOR(), entire grid), as TestInfluenceMatrix() does
+// for one electrode.  The result includes the modes dropped from the
+// model (see ReducedMirrorModel::ErrorBound()) and the values dropped
+// from the influence matrix.  SolutionData and rhs are left unchanged.
+//
+// Returns the largest difference relative to the peak of the SOR
+// solution, or -1 if the grid is too large for the reference solution,
+// or if the model or the matrix is for another grid or electrode array.
+//
+// called by: not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double MembranePDEProblem::TestReducedMirrorModel(ReducedMirrorModel &inModel,
+                                                  InfluenceMatrix    &inMatrix,
+                                                  const double       *inVoltageSquared)
+{
+   double theDifference;
+   double theUnitRHS_MKS;
+
+   if (ArrayDimension > REFERENCE_SOR_MAX_DIMENSION) return -1.0;
+   if ( inMatrix.ArrayDimension() != ArrayDimension ||
+        inMatrix.MeshSize_MKS() != MeshSize_MKS ||
+        inModel.ArrayDimension() != ArrayDimension ||
+        inModel.MeshSize_MKS() != MeshSize_MKS ||
+        inModel.Actuators() != inMatrix.Actuators() ) return -1.0;
+
+   Grid2d theSolution(ArrayDimension,ArrayDimension);
+   Grid2d theRHS(ArrayDimension,ArrayDimension);
+   Grid2d theReference(ArrayDimension,ArrayDimension);
+
+   theSolution.CopyFrom(SolutionData);
+   theRHS.CopyFrom(rhs);
+
+   // 1 V on the electrode, gap at the flat membrane (see SetActuator())
+   theUnitRHS_MKS = -E_zero/(2*MembraneTension_MKS*
+                             GapDistance_MKS*GapDistance_MKS);
+   rhs.Fill(0);
+   for (int k=0;k<inMatrix.Actuators();k++)
    {
-      for (int j=0;j<=ArrayDimension;j++)
+      if (inVoltageSquared[k] != 0)
       {
-         theTempSolution[i][j]=0;
+         inMatrix.AddFootprintRHS(k,inVoltageSquared[k]*theUnitRHS_MKS,rhs);
       }
    }
+   SolutionData.Fill(0);
+   ReferenceSolveBySOR(true);
+   theReference.CopyFrom(SolutionData);
+
+   inModel.ComputeDeflection(inVoltageSquared,SolutionData);
+   theDifference = SolutionDifference(theReference);
+
+   SolutionData.CopyFrom(theSolution);
+   rhs.CopyFrom(theRHS);
+
+   return theDifference;
+}
 
-   // MAIN ITERATION LOOP:  Maximum Number of Iterations set above.
-   for (int k=0;k<theMaxNumberOfIterations;k++)
+
+
+
+//---------------------------------------------------------------------------
+// ComputeReferenceSolution()
+//
+// Writes the ReferenceSolveBySOR() or ReferenceSolveByADI() solution,
+// started from the current SolutionData, to outReference
+// (0...ArrayDimension indexing).  SolutionData are left unchanged.  The
+// linear problem is solved, as by the solvers checked:  rhs is restored
+// first (RestoreLinearRHS()).
+//
+// inSolver:        REFERENCE_SOR or REFERENCE_ADI
+// inEntireGrid:    see ReferenceSolveBySOR()
+//
+// called by:  TestSolveByMultigrid(), TestSolveByDST(), TestSolveBySOR(),
+//             TestSolveByADI(), TestSolveIncremental()
+//---------------------------------------------------------------------------
+void MembranePDEProblem::ComputeReferenceSolution(Grid2d &outReference,
+                                                  int     inSolver,
+                                                  bool    inEntireGrid)
+{
+   Grid2d theStart(ArrayDimension,ArrayDimension);
+
+   RestoreLinearRHS();
+   theStart.CopyFrom(SolutionData);
+
+   if (inSolver == REFERENCE_ADI)
    {
+      ReferenceSolveByADI(inEntireGrid);
+   }
+   else
+   {
+      ReferenceSolveBySOR(inEntireGrid);
+   }
 
-      // set rhs array to adjust membrane-electrode distance at each
-      // point for the previous iterate of the membrane deflection
-      for (int i=0;i<=ArrayDimension;i++)
+   outReference.CopyFrom(SolutionData);
+   SolutionData.CopyFrom(theStart);
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// ReferenceSolveBySOR()
+//
+// Solves the Poisson equation with the Numerical Recipes sor(), for the
+// checks of the other solvers.  sor() updates the points 2...jmax-1 of
+// 1...jmax arrays.  The original SolveBySOR() passed the 0...N arrays as
+// they are, so rows and columns 1 and N are held at their initial
+// values (inEntireGrid false;  SolveBySOR() keeps this index range).
+// With inEntireGrid true the arrays are passed shifted by one
+// (jmax = N+1), so that the interior 1...N-1 is updated, as by the
+// multigrid and sine transform solvers.
+//
+// sor() stops the program if it does not converge in 1000 iterations,
+// which happens for ArrayDimension above about 160 (see
+// REFERENCE_SOR_MAX_DIMENSION).
+//
+// called by:  ComputeReferenceSolution()
+//---------------------------------------------------------------------------
+void MembranePDEProblem::ReferenceSolveBySOR(bool inEntireGrid)
+{
+   double **a, **b, **c, **d, **e, **f, **u;
+   int    theShift = (inEntireGrid ? 1 : 0);
+   int    jmax = ArrayDimension+theShift;
+
+   a=dmatrix(1,jmax,1,jmax);
+   b=dmatrix(1,jmax,1,jmax);
+   c=dmatrix(1,jmax,1,jmax);
+   d=dmatrix(1,jmax,1,jmax);
+   e=dmatrix(1,jmax,1,jmax);
+   f=dmatrix(1,jmax,1,jmax);
+   u=new double*[jmax+1];
+
+   for (int j=1;j<=jmax;j++)
+   {
+      // u[j][l] = SolutionData[j-theShift][l-theShift]
+      u[j] = SolutionData[j-theShift] - theShift;
+
+      for (int l=1;l<=jmax;l++)
       {
-         for (int j=0;j<=ArrayDimension;j++)
-         {
-            theDist_MKS= GapDistance_MKS - theTempSolution[i][j];
-            theDenom = 2*MembraneTension_MKS*theDist_MKS*theDist_MKS;
-            theVV =  ElectrodeVoltage[i][j]*ElectrodeVoltage[i][j];
-            rhs[i][j]=-1 * E_zero * theVV  / theDenom;
+         // NR Eq. 17.5.25;  see the note on f in SolveBySOR()
+         a[j][l] =  1;
+         b[j][l] =  1;
+         c[j][l] =  1;
+         d[j][l] =  1;
+         e[j][l] = -4;
+         f[j][l] = (MeshSize_MKS*MeshSize_MKS)*
+                   rhs[j-theShift][l-theShift];
+      }
+   }
 
-         }
+   sor(a,b,c,d,e,f,u,jmax,cos(PI/ArrayDimension));
+
+   delete [] u;
+   free_dmatrix(a,1,jmax,1,jmax);
+   free_dmatrix(b,1,jmax,1,jmax);
+   free_dmatrix(c,1,jmax,1,jmax);
+   free_dmatrix(d,1,jmax,1,jmax);
+   free_dmatrix(e,1,jmax,1,jmax);
+   free_dmatrix(f,1,jmax,1,jmax);
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// ReferenceSolveByADI()
+//
+// Solves the Poisson equation with the Numerical Recipes adi(), with the
+// parameters of SolveByADI(), for the checks of the other solvers.
+// Grid index ranges as in ReferenceSolveBySOR().
+//
+// adi() stops the program for jmax above JJ = 500 (ADI.C), see
+// REFERENCE_ADI_MAX_DIMENSION.
+//
+// called by:  ComputeReferenceSolution()
+//---------------------------------------------------------------------------
+void MembranePDEProblem::ReferenceSolveByADI(bool inEntireGrid)
+{
+   double **a, **b, **c, **d, **e, **f, **g, **u;
+   double alpha, beta;
+   int    theShift = (inEntireGrid ? 1 : 0);
+   int    jmax = ArrayDimension+theShift;
+
+   a=dmatrix(1,jmax,1,jmax);
+   b=dmatrix(1,jmax,1,jmax);
+   c=dmatrix(1,jmax,1,jmax);
+   d=dmatrix(1,jmax,1,jmax);
+   e=dmatrix(1,jmax,1,jmax);
+   f=dmatrix(1,jmax,1,jmax);
+   g=dmatrix(1,jmax,1,jmax);
+   u=new double*[jmax+1];
+
+   for (int j=1;j<=jmax;j++)
+   {
+      u[j] = SolutionData[j-theShift] - theShift;
+
+      for (int l=1;l<=jmax;l++)
+      {
+         // NR Eq. 17.6.22;  see the note on f in SolveBySOR()
+         a[j][l] = -1;
+         b[j][l] =  2;
+         c[j][l] = -1;
+         d[j][l] = -1;
+         e[j][l] =  2;
+         f[j][l] = -1;
+         g[j][l] = (MeshSize_MKS*MeshSize_MKS)*
+                   rhs[j-theShift][l-theShift];
       }
+   }
+
+   // see SolveByADI()
+   alpha = 2 * ( 1 - cos((double)(PI/ArrayDimension)) );
+   beta  = 2 * ( 1 - cos( (double)((ArrayDimension - 1)*PI/ArrayDimension) ) );
+
+   adi(a,b,c,d,e,f,g,u,jmax,4,alpha,beta,1e-5);
+
+   delete [] u;
+   free_dmatrix(a,1,jmax,1,jmax);
+   free_dmatrix(b,1,jmax,1,jmax);
+   free_dmatrix(c,1,jmax,1,jmax);
+   free_dmatrix(d,1,jmax,1,jmax);
+   free_dmatrix(e,1,jmax,1,jmax);
+   free_dmatrix(f,1,jmax,1,jmax);
+   free_dmatrix(g,1,jmax,1,jmax);
+}
+
+
 
-      // solve the membrane problem using the updated membrane-electrode
-      // distances.  (0'th order Poisson problem is solved here)
-      SolveByADI();
 
-      // store the new solution data for the next iteration
+//---------------------------------------------------------------------------
+// ReferenceSolveByIteration()
+//
+// Solves the nonlinear problem of SolveByIteration() by fixed point
+// iteration, for the check of SolveByIteration():  rhs is computed from
+// the previous membrane shape, and the Poisson equation is solved with
+// ReferenceSolveBySOR() over the entire grid, starting from a flat
+// membrane.  Iteration stops when the solution changes by less than
+// 1e-6 of its peak;  sor() itself stops at a summed residual of 1e-5 of
+// the rhs, so smaller changes are not meaningful.  The rhs is left for
+// the solution.
+//
+// return value:   TRUE if the iteration converged within the gap.
+//                 FALSE for pull-in, or no convergence in 100 iterations.
+//
+// called by:  TestSolveByIteration()
+//---------------------------------------------------------------------------
+bool MembranePDEProblem::ReferenceSolveByIteration()
+{
+   int    theMaxNumberOfIterations = 100;
+   double thePressureFactor = E_zero/(2*MembraneTension_MKS);
+   double theD, theDT;
+   double theChange;
+
+   Grid2d thePrevious(ArrayDimension,ArrayDimension);
+
+   for (int i=1;i<ArrayDimension;i++)
+   {
+      for (int j=1;j<ArrayDimension;j++)
+      {
+         SolutionData[i][j] = 0;
+      }
+   }
+
+   for (int theIteration=0;theIteration<theMaxNumberOfIterations;theIteration++)
+   {
       for (int i=0;i<=ArrayDimension;i++)
       {
          for (int j=0;j<=ArrayDimension;j++)
          {
-            theTempSolution[i][j] = SolutionData[i][j];
+            theD  = GapDistance_MKS - SolutionData[i][j];
+            theDT = TopElectrodeDistance_MKS + SolutionData[i][j];
+            if (theD <= 0 || theDT <= 0) return false;
+
+            rhs[i][j] = -thePressureFactor*ElectrodeVoltage[i][j]*
+                                           ElectrodeVoltage[i][j]/(theD*theD) +
+                         thePressureFactor*TopElectrode_V*
+                                           TopElectrode_V/(theDT*theDT);
          }
       }
 
-#if 0
-      // compute the error by calculating  (del^2 xi - rhs) --> 0
-      // for finite differencing of Poisson equation, see NR. Eq. 17.5.25
-      // on pg. 678, and the IMPORTANT note in SolveBySOR() about the
-      // f coefficient.
-      ActualSolutionError_MKS=0.0;
-      for (int i=1;i<ArrayDimension;i++)
+      thePrevious.CopyFrom(SolutionData);
+      ReferenceSolveBySOR(true);
+
+      theChange = SolutionDifference(thePrevious);
+      if (theChange >= 0 && theChange < 1e-6) return true;
+   }
+
+   return false;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// SolutionDifference()
+//
+// Returns the largest difference between SolutionData and inReference
+// (0...ArrayDimension indexing) relative to the largest magnitude of
+// inReference, or -1 if inReference is zero.
+//
+// called by:  TestSolveByMultigrid(), TestSolveByDST(), TestSolveBySOR(),
+//             TestSolveByADI(), TestSolveByIteration(),
+//             TestSolveIncremental(), TestInfluenceMatrix(),
+//             TestReducedMirrorModel(), ReferenceSolveByIteration()
+//---------------------------------------------------------------------------
+double MembranePDEProblem::SolutionDifference(const Grid2d &inReference)
+{
+   double theMaxDifference = 0.0;
+   double theMaxReference  = 0.0;
+
+   for (int i=0;i<=ArrayDimension;i++)
+   {
+      for (int j=0;j<=ArrayDimension;j++)
       {
-         for (int j=1;j<ArrayDimension;j++)
-         {
-            theVV = ElectrodeVoltage[i][j]*ElectrodeVoltage[i][j];
-            theDist_MKS = GapDistance_MKS - SolutionData[i][j];
-            theDenom = 2*MembraneTension_MKS*theDist_MKS*theDist_MKS;
-            theRHSTerm = E_zero*theVV/theDenom;
-            theResidual = a*SolutionData[i+1][j]+
-                          b*SolutionData[i-1][j]+
-                          c*SolutionData[i][j+1]+
-                          d*SolutionData[i][j-1]+
-                          e*SolutionData[i][j]  -
-                          f*theRHSTerm;
-            ActualSolutionError_MKS += fabs(theResidual);
-         }
+         if (fabs(SolutionData[i][j]-inReference[i][j]) > theMaxDifference)
+            theMaxDifference = fabs(SolutionData[i][j]-inReference[i][j]);
+         if (fabs(inReference[i][j]) > theMaxReference)
+            theMaxReference = fabs(inReference[i][j]);
       }
+   }
+
+   if (theMaxReference == 0.0) return -1.0;
+   return theMaxDifference/theMaxReference;
+}
+
+
+
+
+//---------------------------------------------------------------------------
+// SolveByIteration()
+//
+// Solves the full nonlinear Poisson problem, with the membrane-electrode
+// distance of the electrostatic pressure taken at the deflected membrane,
+// and the pull of the top electrode included:
+//
+//    del^2 xi = - E_zero V^2/(2 T (d - xi)^2) + E_zero VT^2/(2 T (dT + xi)^2)
+//
+// by Jacobian-free Newton-Krylov iteration (see NewtonKrylov.h), starting
+// from the current SolutionData.  Iteration stops when the summed residual
+// is less than DesiredFractionalError times that of a flat membrane.
+// On return rhs holds the Poisson equation rhs for the solution;  the
+// linear solvers restore the rhs at the flat membrane (ElectrodeRHS).
+//
+// If the iteration diverges, there is no equilibrium and the membrane
+// pulls in to the electrode:  PullInDetected() returns TRUE,
+// SolutionData holds the last iterate, and the error is set to 9999.
+//
+// The work arrays are allocated by the first call, and reused.
+//
+// called by:  TForm1::RunIterativeSolverExecute()
+//             SolveIncremental()
+//
+//---------------------------------------------------------------------------
+void MembranePDEProblem::SolveByIteration()
+{
+   int theStatus;
 
-      // if the error is small enough, display it on the GUI and quit iteration
-      if ( k > 0 &&
-           ActualSolutionError_MKS < DesiredFractionalError*theStartError_MKS)
+   if ( NewtonKrylov != NULL &&
+        ( NewtonKrylov->ArrayDimension() != ArrayDimension ||
+          NewtonKrylov->MeshSize_MKS() != MeshSize_MKS ) )
+   {
+      delete NewtonKrylov;
+      NewtonKrylov = NULL;
+   }
+   if (NewtonKrylov == NULL)
+   {
+      NewtonKrylov = new NewtonKrylovMembrane(ArrayDimension,MeshSize_MKS);
+   }
+
+   theStatus = NewtonKrylov->Solve(SolutionData,
+                                   ElectrodeVoltage,
+                                   MembraneTension_MKS,
+                                   GapDistance_MKS,
+                                   TopElectrode_V,
+                                   TopElectrodeDistance_MKS,
+                                   DesiredFractionalError,
+                                   rhs,
+                                   &TotalIterations,
+                                   &ActualSolutionError_MKS);
+   RHSIsNonlinear = true;
+
+   PullIn = (theStatus == NK_PULL_IN);
+   if (PullIn)
+   {
+      ActualSolutionError_MKS=9999;
+   }
+
+   ClearRHSChange();
+   ComputeSolutionStatistics();
+}
+
+
+
+//---------------------------------------------------------------------------
+// SolveIncremental()
+//
+// Updates SolutionData for the actuators changed (SetActuator(),
+// SetHexActuator(), SetBias()) since the last solution.  The Poisson
+// problem is linear, so the new solution is the old one plus the
+// solution of
+//
+//    del^2 correction = RHSChange,     correction = 0 on the boundary,
+//
+// which is solved directly by sine transform (see DSTPoisson.h) and added
+// to SolutionData.  SolutionData must hold the solution for the rhs
+// before the changes, i.e. the result of one of the linear Solve...()
+// functions (or zero, before the first solution).  The nonlinear problem
+// has no such superposition:  after SolveByIteration(), a change is
+// solved by SolveByIteration() again, starting from the present shape.
+//
+// inWindowMargin:  INCREMENTAL_FULL_GRID corrects the entire membrane,
+//                  exactly.  Otherwise the correction is solved on a
+//                  square window of 2^n intervals that extends at least
+//                  inWindowMargin points beyond the changed points, with
+//                  the correction set to zero on the window boundary;
+//                  it is neglected outside the window.  The cost is that
+//                  of a DST solve of the window size, so compact changes
+//                  cost a small fraction of a full solve.  The error
+//                  grows as the margin shrinks; use a margin of several
+//                  actuator widths.
+//
+// A window that would be larger than the membrane is replaced by the
+// full grid.  The full grid is solved in O(N^2 log N) when ArrayDimension
+// is a power of 2, O(N^3) otherwise.  Transform tables are computed by
+// the first call for each window size, and reused.
+//
+// called by:  not called within the application;  see
+//             TestSolveIncremental()
+//
+//---------------------------------------------------------------------------
+void MembranePDEProblem::SolveIncremental(int inWindowMargin)
+{
+   int         theWindow;         // window intervals per side
+   int         theExtent;
+   int         theRow0;           // window origin on the membrane grid
+   int         theColumn0;
+   DSTPoisson *theSolver;
+
+   // nothing changed:  SolutionData is the solution
+   if (ChangedRowHigh < ChangedRowLow)
+   {
+      TotalIterations = 0;
+      ComputeSolutionStatistics();
+      return;
+   }
+
+   if (RHSIsNonlinear)
+   {
+      SolveByIteration();
+      return;
+   }
+
+   theWindow = ArrayDimension;
+   if (inWindowMargin != INCREMENTAL_FULL_GRID)
+   {
+      theExtent = ChangedRowHigh - ChangedRowLow;
+      if (ChangedColumnHigh - ChangedColumnLow > theExtent)
       {
-         TotalIterations = k+1;
-         ComputeSolutionStatistics();
-         return;
+         theExtent = ChangedColumnHigh - ChangedColumnLow;
       }
-#endif
+      theExtent += 2*(inWindowMargin + 1);
 
+      theWindow = 4;
+      while (theWindow < theExtent) theWindow *= 2;
+      if (theWindow > ArrayDimension) theWindow = ArrayDimension;
    }
 
-   TotalIterations = theMaxNumberOfIterations;
-   ActualSolutionError_MKS=9999;
+   // center the window on the changes, and keep it on the membrane.
+   // The changes are interior to the membrane, so they stay interior to
+   // the window.
+   theRow0 = ( ChangedRowLow + ChangedRowHigh - theWindow )/2;
+   if (theRow0 > ArrayDimension - theWindow) theRow0 = ArrayDimension - theWindow;
+   if (theRow0 < 0) theRow0 = 0;
+
+   theColumn0 = ( ChangedColumnLow + ChangedColumnHigh - theWindow )/2;
+   if (theColumn0 > ArrayDimension - theWindow) theColumn0 = ArrayDimension - theWindow;
+   if (theColumn0 < 0) theColumn0 = 0;
+
+   if (theWindow == ArrayDimension)
+   {
+      if ( FastPoisson != NULL &&
+           ( FastPoisson->ArrayDimension() != ArrayDimension ||
+             FastPoisson->MeshSize_MKS() != MeshSize_MKS ) )
+      {
+         delete FastPoisson;
+         FastPoisson = NULL;
+      }
+      if (FastPoisson == NULL)
+      {
+         FastPoisson = new DSTPoisson(ArrayDimension,MeshSize_MKS);
+      }
+      theSolver = FastPoisson;
+   }
+   else
+   {
+      if ( WindowPoisson != NULL &&
+           ( WindowPoisson->ArrayDimension() != theWindow ||
+             WindowPoisson->MeshSize_MKS() != MeshSize_MKS ) )
+      {
+         delete WindowPoisson;
+         WindowPoisson = NULL;
+      }
+      if (WindowPoisson == NULL)
+      {
+         WindowPoisson = new DSTPoisson(theWindow,MeshSize_MKS);
+      }
+      theSolver = WindowPoisson;
+   }
+
+   if (WindowRHS.Rows() != theWindow+1)
+   {
+      WindowRHS.Allocate(theWindow,theWindow);
+      WindowCorrection.Allocate(theWindow,theWindow);
+   }
+
+   for (int i=1;i<theWindow;i++)
+   {
+      for (int j=1;j<theWindow;j++)
+      {
+         WindowRHS[i][j] = RHSChange[theRow0+i][theColumn0+j];
+      }
+   }
+   WindowCorrection.Fill(0);
+
+   theSolver->Solve(WindowCorrection,WindowRHS,&ActualSolutionError_MKS);
+
+   for (int i=1;i<theWindow;i++)
+   {
+      for (int j=1;j<theWindow;j++)
+      {
+         SolutionData[theRow0+i][theColumn0+j] += WindowCorrection[i][j];
+      }
+   }
+
+   // direct solution:  one pass
+   TotalIterations = 1;
+
+   ClearRHSChange();
    ComputeSolutionStatistics();
 }
+
+
+
+//---------------------------------------------------------------------------
+// ComputeInfluenceMatrix()
+//
+// Computes the influence functions of the electrode layout set in
+// ioMatrix (see InfluenceMatrix.h) for this membrane:  its grid, tension
+// and gap.  Values below inThreshold times the peak of their influence
+// function are dropped.  SolutionData and rhs are not changed.
+//
+// called by:  not called within the application;  see
+//             TestInfluenceMatrix()
+//
+//---------------------------------------------------------------------------
+void MembranePDEProblem::ComputeInfluenceMatrix(InfluenceMatrix &ioMatrix,
+                                                double           inThreshold)
+{
+   ioMatrix.Generate(ArrayDimension,
+                     MeshSize_MKS,
+                     MembraneTension_MKS,
+                     GapDistance_MKS,
+                     inThreshold);
+}
 //---------------------------------------------------------------------------
 
 
@@ -1173,6 +2057,8 @@ int MembranePDEProblem::YValueToColumnIndex(double inYValue_mm)
 //
 // called by:   Solve()
 //              SolveByADI()
+//              SolveByMultigrid()
+//              SolveByDST()
 //              SolveByIteration()
 //
 //---------------------------------------------------------------------------
@@ -1288,25 +2174,3 @@ bool MembranePDEProblem::PointIsWithinROI(int inRowIndex, int inColumnIndex)
    }
 
 }
-
-
-
-double **MembranePDEProblem::matrix(int nrl, int nrh, int ncl, int nch)
-{
-   int i;
-   double **m;
-   m=(double **) malloc((unsigned) (nrh-nrl+1)*sizeof(double*));
-   m-=nrl;
-   for (i=nrl;i<=nrh;i++)   {
-      m[i]=(double *) malloc((unsigned) (nch-ncl+1)*sizeof(double));
-      m[i]-=ncl;
-   }
-   return m;
-}
-
-
-
-
-
-
-
@@ -2,8 +2,11 @@
 // MembranePDEProblem.h                          C++ Header file
 //
 // Solves a static membrane deflection problem for a specified electrode
-// geometry.  Poisson equation is solved using Gauss-Seidel, SOR, ADI
-// or an iterative scheme (full nonlinear equation).
+// geometry.  Poisson equation is solved using Gauss-Seidel, SOR, ADI,
+// multigrid, sine transform or an iterative scheme (full nonlinear
+// equation).
+// Changes of a few actuators can be applied to a solution incrementally,
+// by solving for the correction only (SolveIncremental()).
 //
 // Boundary conditions take the form of specified values of the function
 // on the boundaries (Dirichlet's Problem)
@@ -22,9 +25,27 @@
 #define MembranePDEproblemH
 #include <StdCtrls.hpp>               // for TStaticText
 #include "Graphics3d.h"
+#include "Grid2d.h"
+#include "MultigridPoisson.h"
+#include "DSTPoisson.h"
+#include "PoissonStencil.h"
+#include "NewtonKrylov.h"
+#include "InfluenceMatrix.h"
+#include "ReducedMirrorModel.h"
 
 #define E_zero 8.85E-12
 
+#define REFERENCE_SOR_MAX_DIMENSION  160   // largest grid for which NR
+                                           // sor() converges, see
+                                           // ReferenceSolveBySOR()
+#define REFERENCE_ADI_MAX_DIMENSION  500   // JJ of ADI.C
+#define REFERENCE_SOR                0     // ComputeReferenceSolution()
+#define REFERENCE_ADI                1     // solvers
+
+#define INCREMENTAL_FULL_GRID       -1     // SolveIncremental() window
+                                           // margin:  correct the entire
+                                           // membrane
+
 
 class MembraneMirror;
 
@@ -59,18 +80,18 @@ class MembranePDEProblem
        double PeakDeflection_um;     // Peak deflection of membrane, computed
                                     // from solution, units:  microns
 
-       double **SolutionData;       // pointer to array for storing result
-       double **rhs;                // pointer to array for rhs of Poisson
+       Grid2d SolutionData;         // array for storing result
+       Grid2d rhs;                  // array for rhs of Poisson
                                     // Equation
-       double **ElectrodeVoltage;   // electrode voltage array.  Same grid
+       Grid2d ElectrodeVoltage;     // electrode voltage array.  Same grid
                                     // density as SolutionData
 
        AnsiString EntireSolutionDataFileName; //text file for writing solution
        AnsiString ROISolutionDataFileName;
 
-       double **SolutionData_Graph; // scaled versions of above arrays, for
-       double **rhs_Graph;          // use in the graphics canvas
-       double **ElectrodeVoltage_Graph;
+       Grid2d SolutionData_Graph;   // scaled versions of above arrays, for
+       Grid2d rhs_Graph;            // use in the graphics canvas
+       Grid2d ElectrodeVoltage_Graph;
 
 
        double ActualSolutionError_MKS; // summed error.  See SolveByIteration()
@@ -80,21 +101,44 @@ class MembranePDEProblem
        int    TotalIterations;       // number of iterations to get solution
        TStaticText *TotalIterationsTextBox;
 
+       MultigridPoisson *Multigrid;  // grid hierarchy for SolveByMultigrid()
+       DSTPoisson *FastPoisson;      // transform tables for SolveByDST()
+       StencilWorkspace *ADIWorkspace; // work arrays for SolveByADI()
+       NewtonKrylovMembrane *NewtonKrylov; // work arrays for SolveByIteration()
+       bool   PullIn;                // SolveByIteration() found no
+                                     // equilibrium:  membrane pulls in
+
+       Grid2d ElectrodeRHS;          // rhs set by the Set...() functions,
+                                     // pressure at the flat membrane
+       bool   RHSIsNonlinear;        // rhs is that of SolveByIteration()
+       Grid2d RHSChange;             // ElectrodeRHS changes made by the
+                                     // Set...() functions since the last
+                                     // solution
+       int    ChangedRowLow;         // rows, columns spanned by the
+       int    ChangedRowHigh;        // changes;  empty when High < Low
+       int    ChangedColumnLow;
+       int    ChangedColumnHigh;
+       DSTPoisson *WindowPoisson;    // transform tables for a
+                                     // SolveIncremental() window
+       Grid2d WindowRHS;             // rhs, correction of the window
+       Grid2d WindowCorrection;
+
        void InitializeMKSParamsAndDataArrays();
        void SetBoundaryConditions();
-
-       void SetActuator(double inXL,
-                        double inYL,
-                        double inXH,
-                        double inYH,
-                        double inVoltage_MKS);
-
-       void SetHexActuator(double inXCenter_mm,
-                           double inYCenter_mm,
-                           double inSideLength_mm,
-                           double inVoltage_MKS);
-
-       void SetBias();
+       void   ReferenceSolveBySOR(bool inEntireGrid);
+       void   ReferenceSolveByADI(bool inEntireGrid);
+       bool   ReferenceSolveByIteration();
+       void   ComputeReferenceSolution(Grid2d &outReference,
+                                       int     inSolver,
+                                       bool    inEntireGrid);
+       double SolutionDifference(const Grid2d &inReference);
+
+       void SetElectrodePoint(int    inRow,
+                              int    inColumn,
+                              double inVoltage_MKS,
+                              double inRHS_MKS);
+       void ClearRHSChange();
+       void RestoreLinearRHS();
 
        double RowIndexToXValue(int inRow);
        double ColumnIndexToYValue(int inColumn);
@@ -103,7 +147,6 @@ class MembranePDEProblem
        void ComputeSolutionStatistics();
       // bool PointIsWithinPupil(int inRowIndex, int inColumnIndex);
        bool PointIsWithinROI(int inRowIndex, int inColumnIndex);
-       double **matrix(int nrl, int nrh, int ncl, int nch);
 
    public:
 
@@ -128,11 +171,41 @@ class MembranePDEProblem
 
        ~MembranePDEProblem();
 
+       void SetActuator(double inXL,
+                        double inYL,
+                        double inXH,
+                        double inYH,
+                        double inVoltage_MKS);
+
+       void SetHexActuator(double inXCenter_mm,
+                           double inYCenter_mm,
+                           double inSideLength_mm,
+                           double inVoltage_MKS);
+
+       void SetBias();
+
 
        void Solve();
        void SolveBySOR();
        void SolveByADI();
+       void SolveByMultigrid(int inCycleIndex = MG_V_CYCLE);
+       void SolveByDST();
        void SolveByIteration();
+       void SolveIncremental(int inWindowMargin = INCREMENTAL_FULL_GRID);
+       void ComputeInfluenceMatrix(InfluenceMatrix &ioMatrix,
+                                   double           inThreshold);
+       bool PullInDetected() { return PullIn; }
+
+       double TestSolveByMultigrid(int inCycleIndex = MG_V_CYCLE);
+       double TestSolveByDST();
+       double TestSolveBySOR();
+       double TestSolveByADI();
+       double TestSolveByIteration();
+       double TestSolveIncremental(int inWindowMargin = INCREMENTAL_FULL_GRID);
+       double TestInfluenceMatrix(InfluenceMatrix &inMatrix, int inActuator);
+       double TestReducedMirrorModel(ReducedMirrorModel &inModel,
+                                     InfluenceMatrix    &inMatrix,
+                                     const double       *inVoltageSquared);
 
        virtual void WriteEntireSolutionDataToFile();
        virtual void WriteROISolutionDataToFile();
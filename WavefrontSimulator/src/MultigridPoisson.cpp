@@ -0,0 +1,399 @@
+//---------------------------------------------------------------------------
+// MultigridPoisson.cpp                               C++ class
+//
+// Geometric multigrid solver for the membrane Poisson equation.  See
+// MultigridPoisson.h
+//
+// Finite difference equation (NR Eq. 17.5.5 pg. 674), at interior points:
+//
+//    u[i+1][j] + u[i-1][j] + u[i][j+1] + u[i][j-1] - 4 u[i][j] = h^2 rhs[i][j]
+//
+// Level l+1 has half the grid points per side of level l and twice the
+// mesh size.  Arrays of the coarse levels are allocated once, by the
+// constructor; level 0 uses the caller's arrays.
+//
+// called by:  MembranePDEProblem::SolveByMultigrid()
+//---------------------------------------------------------------------------
+#include <math.h>
+
+#include "MultigridPoisson.h"
+
+#ifndef PI
+#define PI 3.1415926535
+#endif
+
+
+
+//---------------------------------------------------------------------------
+// MultigridPoisson()
+//
+// Sets up the grid hierarchy for an inArrayDimension x inArrayDimension
+// grid with mesh size inMeshSize_MKS.  The grid is halved while the number
+// of intervals per side is even and the coarse grid still has an
+// interior point.
+//
+// called by:  MembranePDEProblem::SolveByMultigrid()
+//---------------------------------------------------------------------------
+MultigridPoisson::MultigridPoisson(int inArrayDimension, double inMeshSize_MKS)
+{
+   int theN;
+   int theLevel;
+
+   PreSmoothingSweeps  = 2;
+   PostSmoothingSweeps = 2;
+
+   NumLevels = 1;
+   theN = inArrayDimension;
+   while (theN%2 == 0 && theN/2 >= 2)
+   {
+      theN /= 2;
+      NumLevels++;
+   }
+
+   // at most 4 N SOR sweeps on the coarsest grid; enough to reduce the
+   // error by ~1e-3 at the optimum over-relaxation parameter.
+   MaxCoarseSweeps = 4*theN + 4;
+
+   LevelDimension    = new int[NumLevels];
+   LevelMeshSize_MKS = new double[NumLevels];
+   U = new Grid2d*[NumLevels];
+   F = new Grid2d*[NumLevels];
+   R = new Grid2d[NumLevels];
+
+   theN = inArrayDimension;
+   for (theLevel=0;theLevel<NumLevels;theLevel++)
+   {
+      LevelDimension[theLevel]    = theN;
+      LevelMeshSize_MKS[theLevel] = inMeshSize_MKS*(1 << theLevel);
+
+      // level 0 uses the arrays passed to Solve()
+      if (theLevel == 0)
+      {
+         U[theLevel] = 0;
+         F[theLevel] = 0;
+      }
+      else
+      {
+         U[theLevel] = new Grid2d(theN,theN);
+         F[theLevel] = new Grid2d(theN,theN);
+      }
+      R[theLevel].Allocate(theN,theN);
+
+      theN /= 2;
+   }
+
+}
+
+
+
+MultigridPoisson::~MultigridPoisson()
+{
+   for (int theLevel=1;theLevel<NumLevels;theLevel++)
+   {
+      delete U[theLevel];
+      delete F[theLevel];
+   }
+
+   delete [] R;
+   delete [] F;
+   delete [] U;
+   delete [] LevelMeshSize_MKS;
+   delete [] LevelDimension;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Solve()
+//
+// Solves del^2 ioSolution = inRHS by multigrid cycles, starting from the
+// current contents of ioSolution.  Boundary values of ioSolution are not
+// changed.  Iteration stops when the summed residual is less than
+// inFractionalError times the summed residual of a zero solution, as in
+// MembranePDEProblem::SolveByIteration(), or after inMaxCycles cycles.
+//
+// Residuals are summed over the interior points in the form of the
+// finite difference equation above (units: m).
+//
+// inCycleIndex:      MG_V_CYCLE or MG_W_CYCLE
+// outError_MKS:      summed residual of the returned solution
+//
+// return value:      number of cycles performed
+//
+// called by:  MembranePDEProblem::SolveByMultigrid()
+//---------------------------------------------------------------------------
+int MultigridPoisson::Solve(Grid2d &ioSolution,
+                            Grid2d &inRHS,
+                            double  inFractionalError,
+                            int     inMaxCycles,
+                            int     inCycleIndex,
+                            double *outError_MKS)
+{
+   int    theN = LevelDimension[0];
+   double theH2 = LevelMeshSize_MKS[0]*LevelMeshSize_MKS[0];
+   double theStartError_MKS;
+   double theError_MKS;
+   int    theCycle;
+
+   U[0] = &ioSolution;
+   F[0] = &inRHS;
+
+   theStartError_MKS = 0;
+   for (int i=1;i<theN;i++)
+   {
+      for (int j=1;j<theN;j++)
+      {
+         theStartError_MKS += fabs( theH2*inRHS[i][j] );
+      }
+   }
+
+   theError_MKS = ComputeResidual(*U[0],*F[0],R[0],theN,LevelMeshSize_MKS[0]);
+
+   // zero rhs: the solution is set by the boundary values alone
+   if (theStartError_MKS == 0) theStartError_MKS = theError_MKS;
+
+   theCycle = 0;
+   while ( theCycle < inMaxCycles &&
+           theError_MKS > inFractionalError*theStartError_MKS )
+   {
+      Cycle(0,inCycleIndex);
+      theCycle++;
+
+      theError_MKS = ComputeResidual(*U[0],*F[0],R[0],theN,LevelMeshSize_MKS[0]);
+   }
+
+   U[0] = 0;
+   F[0] = 0;
+
+   *outError_MKS = theError_MKS;
+   return theCycle;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Cycle()
+//
+// One multigrid cycle on level inLevel:  pre-smoothing, coarse grid
+// correction (inCycleIndex recursive cycles on level inLevel+1), and
+// post-smoothing.
+//
+// called by:  Solve(), Cycle()
+//---------------------------------------------------------------------------
+void MultigridPoisson::Cycle(int inLevel, int inCycleIndex)
+{
+   int theCoarseN;
+
+   if (inLevel == NumLevels-1)
+   {
+      SolveCoarsest();
+      return;
+   }
+
+   Smooth(inLevel,PreSmoothingSweeps,1.0);
+
+   ComputeResidual(*U[inLevel],
+                   *F[inLevel],
+                   R[inLevel],
+                   LevelDimension[inLevel],
+                   LevelMeshSize_MKS[inLevel]);
+
+   theCoarseN = LevelDimension[inLevel+1];
+   Restrict(R[inLevel],*F[inLevel+1],theCoarseN);
+
+   // coarse grid correction starts from zero, with zero boundary values
+   U[inLevel+1]->Fill(0);
+
+   for (int k=0;k<inCycleIndex;k++)
+   {
+      Cycle(inLevel+1,inCycleIndex);
+
+      // the coarsest grid is solved directly; repeating is no help
+      if (inLevel+1 == NumLevels-1) break;
+   }
+
+   Prolongate(*U[inLevel+1],*U[inLevel],theCoarseN);
+
+   Smooth(inLevel,PostSmoothingSweeps,1.0);
+}
+
+
+
+//---------------------------------------------------------------------------
+// Smooth()
+//
+// inNumSweeps red-black Gauss-Seidel (inOmega = 1) or SOR sweeps on level
+// inLevel.  Points with i+j even are updated first, then points with i+j
+// odd; each half sweep uses only values of the other colour.
+//
+// called by:  Cycle(), SolveCoarsest()
+//---------------------------------------------------------------------------
+void MultigridPoisson::Smooth(int inLevel, int inNumSweeps, double inOmega)
+{
+   Grid2d  &u = *U[inLevel];
+   Grid2d  &f = *F[inLevel];
+   int      theN = LevelDimension[inLevel];
+   double   theH2 = LevelMeshSize_MKS[inLevel]*LevelMeshSize_MKS[inLevel];
+   double   v;
+
+   for (int theSweep=0;theSweep<inNumSweeps;theSweep++)
+   {
+      for (int theColour=0;theColour<2;theColour++)
+      {
+         for (int i=1;i<theN;i++)
+         {
+            // first j in 1...theN-1 with (i+j)%2 == theColour
+            for (int j=2-(i+theColour)%2;j<theN;j+=2)
+            {
+               v = 0.25*( u[i-1][j] + u[i+1][j] +
+                          u[i][j-1] + u[i][j+1] - theH2*f[i][j] );
+               u[i][j] += inOmega*(v - u[i][j]);
+            }
+         }
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// ComputeResidual()
+//
+// outResidual = inF - del^2 inU at the interior points; zero on the
+// boundary.
+//
+// return value:   sum over the interior of |h^2 outResidual|,  units: m
+//
+// called by:  Solve(), Cycle(), SolveCoarsest()
+//---------------------------------------------------------------------------
+double MultigridPoisson::ComputeResidual(Grid2d &inU,
+                                         Grid2d &inF,
+                                         Grid2d &outResidual,
+                                         int     inN,
+                                         double  inMeshSize_MKS)
+{
+   double theH2 = inMeshSize_MKS*inMeshSize_MKS;
+   double theScaledResidual;
+   double theSum = 0;
+
+   for (int i=1;i<inN;i++)
+   {
+      for (int j=1;j<inN;j++)
+      {
+         theScaledResidual = theH2*inF[i][j] -
+                             ( inU[i+1][j] + inU[i-1][j] +
+                               inU[i][j+1] + inU[i][j-1] - 4*inU[i][j] );
+         outResidual[i][j] = theScaledResidual/theH2;
+         theSum += fabs(theScaledResidual);
+      }
+   }
+
+   return theSum;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Restrict()
+//
+// Full weighting restriction of inFine (2 inCoarseN intervals per side)
+// onto the interior of outCoarse (inCoarseN intervals per side):
+//
+//            1  | 1 2 1 |
+//           --- | 2 4 2 |
+//           16  | 1 2 1 |
+//
+// called by:  Cycle()
+//---------------------------------------------------------------------------
+void MultigridPoisson::Restrict(Grid2d &inFine,
+                                Grid2d &outCoarse,
+                                int     inCoarseN)
+{
+   int i, j;
+
+   for (int I=1;I<inCoarseN;I++)
+   {
+      i = 2*I;
+      for (int J=1;J<inCoarseN;J++)
+      {
+         j = 2*J;
+         outCoarse[I][J] = 0.0625*( 4*inFine[i][j] +
+                                    2*( inFine[i-1][j] + inFine[i+1][j] +
+                                        inFine[i][j-1] + inFine[i][j+1] ) +
+                                    inFine[i-1][j-1] + inFine[i-1][j+1] +
+                                    inFine[i+1][j-1] + inFine[i+1][j+1] );
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// Prolongate()
+//
+// Adds the bilinear interpolation of the coarse grid correction inCoarse
+// to the interior of ioFine.  Fine point (i,j) lies between coarse points
+// i/2 ... (i+1)/2 and j/2 ... (j+1)/2, which coincide for even i, j.
+//
+// called by:  Cycle()
+//---------------------------------------------------------------------------
+void MultigridPoisson::Prolongate(Grid2d &inCoarse,
+                                  Grid2d &ioFine,
+                                  int     inCoarseN)
+{
+   int theFineN = 2*inCoarseN;
+   int I0, I1, J0, J1;
+
+   for (int i=1;i<theFineN;i++)
+   {
+      I0 = i/2;
+      I1 = (i+1)/2;
+      for (int j=1;j<theFineN;j++)
+      {
+         J0 = j/2;
+         J1 = (j+1)/2;
+         ioFine[i][j] += 0.25*( inCoarse[I0][J0] + inCoarse[I0][J1] +
+                                inCoarse[I1][J0] + inCoarse[I1][J1] );
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// SolveCoarsest()
+//
+// Solves the coarsest level by red-black SOR with the optimum
+// over-relaxation parameter (NR Eq. 17.5.19 pg. 676), until the summed
+// residual is reduced 1000 fold, or for at most MaxCoarseSweeps sweeps.
+// One sweep is exact when the coarsest grid has a single interior point.
+//
+// called by:  Cycle()
+//---------------------------------------------------------------------------
+void MultigridPoisson::SolveCoarsest()
+{
+   int    theLevel = NumLevels-1;
+   int    theN = LevelDimension[theLevel];
+   double theOmega = 2/(1 + sin(PI/theN));
+   double theStartResidual;
+   double theResidual;
+
+   theStartResidual = ComputeResidual(*U[theLevel],
+                                      *F[theLevel],
+                                      R[theLevel],
+                                      theN,
+                                      LevelMeshSize_MKS[theLevel]);
+   theResidual = theStartResidual;
+
+   for (int theSweep=0;theSweep<MaxCoarseSweeps;theSweep+=theN)
+   {
+      Smooth(theLevel,theN,theOmega);
+
+      theResidual = ComputeResidual(*U[theLevel],
+                                    *F[theLevel],
+                                    R[theLevel],
+                                    theN,
+                                    LevelMeshSize_MKS[theLevel]);
+      if (theResidual <= 1e-3*theStartResidual) break;
+   }
+}
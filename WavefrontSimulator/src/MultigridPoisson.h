@@ -0,0 +1,77 @@
+//---------------------------------------------------------------------------
+// MultigridPoisson.h                                 C++ Header file
+//
+// Class definition for the MultigridPoisson class.  Geometric multigrid
+// solver for the Poisson equation of MembranePDEProblem,
+//
+//    del^2 u = rhs      on the square grid 0...N x 0...N, mesh size h,
+//
+// with u fixed on the boundary rows and columns (Dirichlet's problem).
+// Arrays use the 0...N inclusive indexing of the rest of the project.
+//
+// Each cycle performs red-black Gauss-Seidel smoothing, full weighting
+// restriction of the residual and bilinear prolongation of the coarse
+// grid correction.  The grid is coarsened while N is even, so N should be
+// a power of 2 (N = 1024 for a 1025 x 1025 membrane); the coarsest grid
+// is solved by SOR.  CycleIndex 1 gives V-cycles, 2 gives W-cycles.
+//
+// Work per cycle is O(N^2) and the number of cycles does not grow with N.
+//
+// See W. Briggs, A Multigrid Tutorial, Ch. 3-4, and Numerical Recipes
+// in C, Ch 19.6.
+//---------------------------------------------------------------------------
+#ifndef MultigridPoissonH
+#define MultigridPoissonH
+#include "Grid2d.h"
+
+
+#define MG_V_CYCLE    1
+#define MG_W_CYCLE    2
+
+
+class MultigridPoisson
+{
+   private:
+
+       int       NumLevels;           // level 0 is the finest grid
+       int      *LevelDimension;      // N of each level
+       double   *LevelMeshSize_MKS;   // h of each level
+
+       Grid2d  **U;                   // solution (correction) of each level
+       Grid2d  **F;                   // rhs of each level
+       Grid2d   *R;                   // residual of each level
+
+       int       PreSmoothingSweeps;
+       int       PostSmoothingSweeps;
+       int       MaxCoarseSweeps;
+
+       void   Smooth(int inLevel, int inNumSweeps, double inOmega);
+       double ComputeResidual(Grid2d &inU,
+                              Grid2d &inF,
+                              Grid2d &outResidual,
+                              int     inN,
+                              double  inMeshSize_MKS);
+       void   Restrict(Grid2d &inFine, Grid2d &outCoarse, int inCoarseN);
+       void   Prolongate(Grid2d &inCoarse, Grid2d &ioFine, int inCoarseN);
+       void   SolveCoarsest();
+       void   Cycle(int inLevel, int inCycleIndex);
+
+   public:
+
+       MultigridPoisson(int inArrayDimension, double inMeshSize_MKS);
+       ~MultigridPoisson();
+
+       int    ArrayDimension() { return LevelDimension[0]; }
+       double MeshSize_MKS()   { return LevelMeshSize_MKS[0]; }
+
+       int    Solve(Grid2d &ioSolution,
+                    Grid2d &inRHS,
+                    double  inFractionalError,
+                    int     inMaxCycles,
+                    int     inCycleIndex,
+                    double *outError_MKS);
+
+};
+
+
+#endif
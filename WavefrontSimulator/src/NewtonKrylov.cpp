@@ -0,0 +1,560 @@
+//---------------------------------------------------------------------------
+// NewtonKrylov.cpp                                   C++ class
+//
+// Jacobian-free Newton-Krylov solver for the nonlinear membrane equation.
+// See NewtonKrylov.h
+//
+// Residuals are held scaled by h^2, in the form of the finite difference
+// equation (NR Eq. 17.5.5 pg. 674), at interior points:
+//
+//    h^2 F[i][j] = xi[i+1][j] + xi[i-1][j] + xi[i][j+1] + xi[i][j-1]
+//                  - 4 xi[i][j] - h^2 rhs(xi[i][j])             (units: m)
+//
+// and are zero on the boundary.  GMRES works with these; its Krylov
+// vectors also vanish on the boundary.
+//
+// called by:  MembranePDEProblem::SolveByIteration()
+//---------------------------------------------------------------------------
+#include <math.h>
+
+#include "NewtonKrylov.h"
+#include "NumRecipes.h"
+
+#ifndef E_zero
+#define E_zero 8.85E-12
+#endif
+
+
+
+//---------------------------------------------------------------------------
+// NewtonKrylovMembrane()
+//
+// Allocates the Krylov basis and work arrays for an inArrayDimension x
+// inArrayDimension grid with mesh size inMeshSize_MKS.
+//
+// called by:  MembranePDEProblem::SolveByIteration()
+//---------------------------------------------------------------------------
+NewtonKrylovMembrane::NewtonKrylovMembrane(int    inArrayDimension,
+                                           double inMeshSize_MKS)
+{
+   N = inArrayDimension;
+   GridSpacing_MKS = inMeshSize_MKS;
+
+   // the Laplacian preconditioner leaves a compact perturbation of the
+   // identity; a few GMRES iterations reduce the linear residual 1000 fold
+   KrylovDimension     = 10;
+   MaxRestarts         = 4;
+   ForcingTerm         = 1e-3;
+   MaxNewtonIterations = 50;
+   MaxStepHalvings     = 10;
+
+   Preconditioner = new DSTPoisson(N,GridSpacing_MKS);
+
+   Basis = new Grid2d[KrylovDimension+1];
+   for (int k=0;k<=KrylovDimension;k++)
+   {
+      Basis[k].Allocate(N,N);
+   }
+   Residual.Allocate(N,N);
+   Step.Allocate(N,N);
+   KrylovResidual.Allocate(N,N);
+   Work.Allocate(N,N);
+   Trial.Allocate(N,N);
+   TrialResidual.Allocate(N,N);
+   ScaledRHS.Allocate(N,N);
+
+   Hessenberg  = new double[(KrylovDimension+1)*KrylovDimension];
+   GivensCos   = new double[KrylovDimension];
+   GivensSin   = new double[KrylovDimension];
+   ReducedRHS  = new double[KrylovDimension+1];
+   KrylovCoeff = new double[KrylovDimension];
+
+   ElectrodeVoltage = 0;
+}
+
+
+
+NewtonKrylovMembrane::~NewtonKrylovMembrane()
+{
+   delete [] KrylovCoeff;
+   delete [] ReducedRHS;
+   delete [] GivensSin;
+   delete [] GivensCos;
+   delete [] Hessenberg;
+   delete [] Basis;
+   delete Preconditioner;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Solve()
+//
+// Solves the nonlinear membrane equation by Newton's method, starting
+// from the current contents of ioSolution (warm start), or from a flat
+// membrane if ioSolution does not lie within the gap.  Boundary values of
+// ioSolution are not changed.  Iteration stops when the summed residual
+// is less than inFractionalError times the summed residual of a flat
+// membrane, as in MultigridPoisson::Solve().
+//
+// inElectrodeVoltage:   electrode voltage at each grid point, V
+// inTension_MKS:        membrane tension, N/m
+// inGap_MKS:            membrane-electrode distance, m
+// inTopElectrode_V:     top electrode voltage, V
+// inTopElectrodeDistance_MKS:  membrane-top electrode distance, m
+//
+// outRHS:               rhs of the Poisson equation at the returned
+//                       solution, 1/m
+// outIterations:        number of Newton iterations performed
+// outError_MKS:         summed residual of the returned solution, m
+//
+// return value:   NK_CONVERGED, or NK_PULL_IN if the iteration diverged.
+//                 ioSolution is then the last iterate within the gap.
+//
+// called by:  MembranePDEProblem::SolveByIteration()
+//---------------------------------------------------------------------------
+int NewtonKrylovMembrane::Solve(Grid2d &ioSolution,
+                                Grid2d &inElectrodeVoltage,
+                                double  inTension_MKS,
+                                double  inGap_MKS,
+                                double  inTopElectrode_V,
+                                double  inTopElectrodeDistance_MKS,
+                                double  inFractionalError,
+                                Grid2d &outRHS,
+                                int    *outIterations,
+                                double *outError_MKS)
+{
+   int    theStatus = NK_PULL_IN;
+   int    theIteration;
+   bool   theStepAccepted;
+   double theStartError_MKS;
+   double theError_MKS;
+   double theNorm;
+   double theLambda;
+   double theTrialError_MKS;
+   double theTrialNorm;
+   double theXi, theD, theDT;
+
+   if (ioSolution.Rows() != N+1 || inElectrodeVoltage.Rows() != N+1)
+   {
+      nrerror("NewtonKrylovMembrane::Solve:  grid size mismatch");
+   }
+
+   ElectrodeVoltage         = &inElectrodeVoltage;
+   PressureFactor           = E_zero/(2*inTension_MKS);
+   Gap_MKS                  = inGap_MKS;
+   TopElectrodeV2           = inTopElectrode_V*inTopElectrode_V;
+   TopElectrodeDistance_MKS = inTopElectrodeDistance_MKS;
+
+   // warm start from the previous solution, if it is a possible shape
+   if ( !WithinGap(ioSolution) )
+   {
+      for (int i=1;i<N;i++)
+      {
+         for (int j=1;j<N;j++)
+         {
+            ioSolution[i][j] = 0;
+         }
+      }
+   }
+
+   // reference error:  flat membrane with the given boundary values
+   Trial.CopyFrom(ioSolution);
+   for (int i=1;i<N;i++)
+   {
+      for (int j=1;j<N;j++)
+      {
+         Trial[i][j] = 0;
+      }
+   }
+   theStartError_MKS = ComputeResidual(Trial,TrialResidual);
+
+   theError_MKS = ComputeResidual(ioSolution,Residual);
+   theNorm = sqrt(Dot(Residual,Residual));
+
+   // zero voltage:  the solution is set by the boundary values alone
+   if (theStartError_MKS == 0) theStartError_MKS = theError_MKS;
+
+   for (theIteration=0;;theIteration++)
+   {
+      if (theError_MKS <= inFractionalError*theStartError_MKS)
+      {
+         theStatus = NK_CONVERGED;
+         break;
+      }
+      if (theIteration == MaxNewtonIterations) break;
+
+      // no descent direction:  the Jacobian is (nearly) singular
+      if ( !SolveNewtonStep(ioSolution,ForcingTerm*theNorm) ) break;
+
+      // backtrack until the membrane stays within the gap and the
+      // residual decreases sufficiently (Armijo rule)
+      theStepAccepted = false;
+      theLambda = 1;
+      for (int theHalving=0;theHalving<=MaxStepHalvings;theHalving++)
+      {
+         Trial.CopyFrom(ioSolution);
+         Axpy(theLambda,Step,Trial);
+
+         if ( WithinGap(Trial) )
+         {
+            theTrialError_MKS = ComputeResidual(Trial,TrialResidual);
+            theTrialNorm = sqrt(Dot(TrialResidual,TrialResidual));
+            if (theTrialNorm < (1 - 1e-4*theLambda)*theNorm)
+            {
+               theStepAccepted = true;
+               break;
+            }
+         }
+         theLambda *= 0.5;
+      }
+      if (!theStepAccepted) break;
+
+      ioSolution.CopyFrom(Trial);
+      Residual.CopyFrom(TrialResidual);
+      theError_MKS = theTrialError_MKS;
+      theNorm = theTrialNorm;
+   }
+
+   // Poisson equation rhs for the returned membrane shape
+   for (int i=0;i<=N;i++)
+   {
+      for (int j=0;j<=N;j++)
+      {
+         theXi = ioSolution[i][j];
+         theD  = Gap_MKS - theXi;
+         theDT = TopElectrodeDistance_MKS + theXi;
+         outRHS[i][j] = -PressureFactor*inElectrodeVoltage[i][j]*
+                                        inElectrodeVoltage[i][j]/(theD*theD);
+         if (TopElectrodeV2 != 0)
+         {
+            outRHS[i][j] += PressureFactor*TopElectrodeV2/(theDT*theDT);
+         }
+      }
+   }
+
+   ElectrodeVoltage = 0;
+
+   *outIterations = theIteration;
+   *outError_MKS = theError_MKS;
+   return theStatus;
+}
+
+
+
+//---------------------------------------------------------------------------
+// ComputeResidual()
+//
+// outResidual = h^2 F(inXi) at the interior points; zero on the boundary.
+//
+// return value:   sum over the interior of |outResidual|,  units: m
+//
+// called by:  Solve(), ApplyJacobian()
+//---------------------------------------------------------------------------
+double NewtonKrylovMembrane::ComputeResidual(Grid2d &inXi,
+                                             Grid2d &outResidual)
+{
+   double theH2 = GridSpacing_MKS*GridSpacing_MKS;
+   double theSum = 0;
+   double theXi, theD, theDT, theV, theRHS;
+   double *theUp, *theRow, *theDown, *theVoltage, *theResidual;
+
+   for (int i=1;i<N;i++)
+   {
+      theUp       = inXi[i+1];
+      theRow      = inXi[i];
+      theDown     = inXi[i-1];
+      theVoltage  = (*ElectrodeVoltage)[i];
+      theResidual = outResidual[i];
+
+      for (int j=1;j<N;j++)
+      {
+         theXi = theRow[j];
+         theD  = Gap_MKS - theXi;
+         theV  = theVoltage[j];
+         theRHS = -PressureFactor*theV*theV/(theD*theD);
+         if (TopElectrodeV2 != 0)
+         {
+            theDT = TopElectrodeDistance_MKS + theXi;
+            theRHS += PressureFactor*TopElectrodeV2/(theDT*theDT);
+         }
+
+         theResidual[j] = theUp[j] + theDown[j] + theRow[j+1] + theRow[j-1] -
+                          4*theXi - theH2*theRHS;
+         theSum += fabs(theResidual[j]);
+      }
+   }
+
+   return theSum;
+}
+
+
+
+//---------------------------------------------------------------------------
+// WithinGap()
+//
+// return TRUE if every interior point of inXi lies between the actuating
+// electrode and the top electrode.
+//
+// called by:  Solve()
+//---------------------------------------------------------------------------
+bool NewtonKrylovMembrane::WithinGap(Grid2d &inXi)
+{
+   double *theRow;
+
+   for (int i=1;i<N;i++)
+   {
+      theRow = inXi[i];
+      for (int j=1;j<N;j++)
+      {
+         if (theRow[j] >= Gap_MKS) return false;
+         if (TopElectrodeV2 != 0 && theRow[j] <= -TopElectrodeDistance_MKS)
+         {
+            return false;
+         }
+      }
+   }
+
+   return true;
+}
+
+
+
+//---------------------------------------------------------------------------
+// ApplyPreconditioner()
+//
+// outZ = (h^2 del^2)^-1 inV, with zero boundary values, by DSTPoisson.
+//
+// called by:  SolveNewtonStep()
+//---------------------------------------------------------------------------
+void NewtonKrylovMembrane::ApplyPreconditioner(Grid2d &inV, Grid2d &outZ)
+{
+   double theInvH2 = 1/(GridSpacing_MKS*GridSpacing_MKS);
+   double theError_MKS;
+
+   for (int i=1;i<N;i++)
+   {
+      for (int j=1;j<N;j++)
+      {
+         ScaledRHS[i][j] = theInvH2*inV[i][j];
+      }
+   }
+
+   // boundary values of outZ are zero, and are not changed by Solve()
+   Preconditioner->Solve(outZ,ScaledRHS,&theError_MKS);
+}
+
+
+
+//---------------------------------------------------------------------------
+// ApplyJacobian()
+//
+// outJV = h^2 J(inXi) inV, by the forward difference
+//
+//    ( F(inXi + eps inV) - F(inXi) ) / eps
+//
+// inResidual must hold h^2 F(inXi).  eps is set so that the perturbation
+// is sqrt(machine precision) relative to the gap (Kelley, Ch. 3.2.1).
+//
+// called by:  SolveNewtonStep()
+//---------------------------------------------------------------------------
+void NewtonKrylovMembrane::ApplyJacobian(Grid2d &inXi,
+                                         Grid2d &inResidual,
+                                         Grid2d &inV,
+                                         Grid2d &outJV)
+{
+   double theNormV = sqrt(Dot(inV,inV));
+   double theEps;
+
+   if (theNormV == 0)
+   {
+      outJV.Fill(0);
+      return;
+   }
+
+   theEps = 1.5e-8*( sqrt(Dot(inXi,inXi)) + Gap_MKS*(N-1) )/theNormV;
+
+   Trial.CopyFrom(inXi);
+   Axpy(theEps,inV,Trial);
+   ComputeResidual(Trial,TrialResidual);
+
+   for (int i=1;i<N;i++)
+   {
+      for (int j=1;j<N;j++)
+      {
+         outJV[i][j] = (TrialResidual[i][j] - inResidual[i][j])/theEps;
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// SolveNewtonStep()
+//
+// Solves J Step = -F at inXi (Residual must hold h^2 F(inXi)) by
+// restarted GMRES with right preconditioning, until the linear residual
+// is less than inTolerance or MaxRestarts restarts have been made.
+// Modified Gram-Schmidt orthogonalization, Givens rotations for the least
+// squares problem (Saad, Iterative Methods for Sparse Linear Systems,
+// Ch. 6.5 and 9.3.2).
+//
+// return value:   FALSE if GMRES did not reduce the linear residual at
+//                 all, i.e. Step is no descent direction
+//
+// called by:  Solve()
+//---------------------------------------------------------------------------
+bool NewtonKrylovMembrane::SolveNewtonStep(Grid2d &inXi, double inTolerance)
+{
+   int    m = KrylovDimension;
+   int    theDimension;
+   double theBeta;
+   double theStartBeta;
+   double theTemp, theDenom;
+   double *h;
+
+   Step.Fill(0);
+   KrylovResidual.Fill(0);
+   Axpy(-1,Residual,KrylovResidual);
+   theStartBeta = sqrt(Dot(KrylovResidual,KrylovResidual));
+   theBeta = theStartBeta;
+
+   for (int theRestart=0;theRestart<=MaxRestarts;theRestart++)
+   {
+      if (theBeta <= inTolerance) return true;
+
+      Basis[0].Fill(0);
+      Axpy(1/theBeta,KrylovResidual,Basis[0]);
+      ReducedRHS[0] = theBeta;
+
+      theDimension = 0;
+      for (int k=0;k<m;k++)
+      {
+         // new direction:  J P^-1 v_k
+         ApplyPreconditioner(Basis[k],Work);
+         ApplyJacobian(inXi,Residual,Work,Basis[k+1]);
+
+         h = Hessenberg + k;       // column k, row stride m
+         for (int i=0;i<=k;i++)
+         {
+            h[i*m] = Dot(Basis[k+1],Basis[i]);
+            Axpy(-h[i*m],Basis[i],Basis[k+1]);
+         }
+         h[(k+1)*m] = sqrt(Dot(Basis[k+1],Basis[k+1]));
+
+         // previous rotations, then the one that zeroes h[k+1][k]
+         for (int i=0;i<k;i++)
+         {
+            theTemp    =  GivensCos[i]*h[i*m] + GivensSin[i]*h[(i+1)*m];
+            h[(i+1)*m] = -GivensSin[i]*h[i*m] + GivensCos[i]*h[(i+1)*m];
+            h[i*m]     =  theTemp;
+         }
+         theDenom = sqrt(h[k*m]*h[k*m] + h[(k+1)*m]*h[(k+1)*m]);
+         if (theDenom == 0) break;
+         GivensCos[k] = h[k*m]/theDenom;
+         GivensSin[k] = h[(k+1)*m]/theDenom;
+
+         if (h[(k+1)*m] != 0)
+         {
+            theTemp = 1/h[(k+1)*m];
+            for (int i=1;i<N;i++)
+            {
+               for (int j=1;j<N;j++)
+               {
+                  Basis[k+1][i][j] *= theTemp;
+               }
+            }
+         }
+
+         h[k*m]     = theDenom;
+         h[(k+1)*m] = 0;
+         ReducedRHS[k+1] = -GivensSin[k]*ReducedRHS[k];
+         ReducedRHS[k]   =  GivensCos[k]*ReducedRHS[k];
+
+         theDimension = k+1;
+         if (fabs(ReducedRHS[k+1]) <= inTolerance) break;
+      }
+
+      if (theDimension == 0) break;
+
+      // y = H^-1 g, upper triangular
+      for (int i=theDimension-1;i>=0;i--)
+      {
+         theTemp = ReducedRHS[i];
+         for (int k=i+1;k<theDimension;k++)
+         {
+            theTemp -= Hessenberg[i*m+k]*KrylovCoeff[k];
+         }
+         KrylovCoeff[i] = theTemp/Hessenberg[i*m+i];
+      }
+
+      // Step += P^-1 V y
+      KrylovResidual.Fill(0);
+      for (int k=0;k<theDimension;k++)
+      {
+         Axpy(KrylovCoeff[k],Basis[k],KrylovResidual);
+      }
+      ApplyPreconditioner(KrylovResidual,Work);
+      Axpy(1,Work,Step);
+
+      // true linear residual for the restart:  -F - J Step
+      ApplyJacobian(inXi,Residual,Step,Work);
+      KrylovResidual.Fill(0);
+      Axpy(-1,Residual,KrylovResidual);
+      Axpy(-1,Work,KrylovResidual);
+      theBeta = sqrt(Dot(KrylovResidual,KrylovResidual));
+   }
+
+   return (theBeta < theStartBeta);
+}
+
+
+
+//---------------------------------------------------------------------------
+// Dot()
+//
+// Sum of inA[i][j]*inB[i][j] over the interior points.
+//
+// called by:  Solve(), ApplyJacobian(), SolveNewtonStep()
+//---------------------------------------------------------------------------
+double NewtonKrylovMembrane::Dot(Grid2d &inA, Grid2d &inB)
+{
+   double  theSum = 0;
+   double *theA, *theB;
+
+   for (int i=1;i<N;i++)
+   {
+      theA = inA[i];
+      theB = inB[i];
+      for (int j=1;j<N;j++)
+      {
+         theSum += theA[j]*theB[j];
+      }
+   }
+
+   return theSum;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Axpy()
+//
+// ioY += inA*inX at the interior points.
+//
+// called by:  Solve(), ApplyJacobian(), SolveNewtonStep()
+//---------------------------------------------------------------------------
+void NewtonKrylovMembrane::Axpy(double inA, Grid2d &inX, Grid2d &ioY)
+{
+   double *theX, *theY;
+
+   for (int i=1;i<N;i++)
+   {
+      theX = inX[i];
+      theY = ioY[i];
+      for (int j=1;j<N;j++)
+      {
+         theY[j] += inA*theX[j];
+      }
+   }
+}
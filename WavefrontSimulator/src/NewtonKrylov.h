@@ -0,0 +1,117 @@
+//---------------------------------------------------------------------------
+// NewtonKrylov.h                                     C++ Header file
+//
+// Class definition for the NewtonKrylovMembrane class.  Jacobian-free
+// Newton-Krylov solver for the full nonlinear membrane equation of
+// MembranePDEProblem,
+//
+//                     E_zero V^2             E_zero VT^2
+//    del^2 xi = - ---------------- + -----------------------
+//                  2 T (d - xi)^2       2 T (dT + xi)^2
+//
+// on the square grid 0...N x 0...N, mesh size h, with xi fixed on the
+// boundary.  V is the electrode voltage at each grid point (bias
+// included), d the membrane-electrode gap, VT and dT the voltage and
+// distance of the top (transparent) electrode, T the membrane tension.
+// Arrays use the 0...N inclusive indexing of the rest of the project.
+//
+// Each Newton step solves J dxi = -F, F = del^2 xi - rhs(xi), by
+// restarted GMRES.  Products J v are finite differences of F, so the
+// Jacobian is never formed.  GMRES is right preconditioned by the
+// Laplacian itself, inverted by DSTPoisson, so that only the (diagonal)
+// electrostatic stiffness is left to the Krylov iteration, and a few
+// GMRES iterations per Newton step suffice for any N.  Steps are
+// shortened (backtracking) until the residual decreases and the membrane
+// stays within the gap.
+//
+// The electrostatic stiffness grows as the membrane approaches the
+// electrode, and at pull-in the Jacobian becomes singular:  no
+// equilibrium exists beyond it.  When the Newton iteration diverges, no
+// step decreases the residual, or the membrane reaches an electrode,
+// Solve() returns NK_PULL_IN.
+//
+// See C. T. Kelley, Solving Nonlinear Equations with Newton's Method,
+// Ch. 3, and D. Knoll and D. Keyes, J. Comput. Phys. 193, 357 (2004).
+//---------------------------------------------------------------------------
+#ifndef NewtonKrylovH
+#define NewtonKrylovH
+#include "Grid2d.h"
+#include "DSTPoisson.h"
+
+
+#define NK_CONVERGED   0
+#define NK_PULL_IN     1
+
+
+class NewtonKrylovMembrane
+{
+   private:
+
+       int         N;                    // intervals per side
+       double      GridSpacing_MKS;      // h
+
+       int         KrylovDimension;      // GMRES restart length
+       int         MaxRestarts;
+       double      ForcingTerm;          // relative GMRES tolerance
+       int         MaxNewtonIterations;
+       int         MaxStepHalvings;
+
+       DSTPoisson *Preconditioner;
+
+       Grid2d     *Basis;                // Krylov basis, 0...KrylovDimension
+       Grid2d      Residual;             // h^2 F(xi)
+       Grid2d      Step;                 // Newton step dxi
+       Grid2d      KrylovResidual;       // -h^2 F - h^2 J dxi
+       Grid2d      Work;                 // preconditioned vector, J v
+       Grid2d      Trial;                // perturbed or updated xi
+       Grid2d      TrialResidual;
+       Grid2d      ScaledRHS;            // preconditioner rhs
+
+       double     *Hessenberg;           // (KrylovDimension+1) x KrylovDimension
+       double     *GivensCos;
+       double     *GivensSin;
+       double     *ReducedRHS;
+       double     *KrylovCoeff;
+
+       // membrane parameters of the current Solve()
+       Grid2d     *ElectrodeVoltage;
+       double      PressureFactor;       // E_zero / (2 T),    units: m/V^2
+       double      Gap_MKS;
+       double      TopElectrodeV2;       // VT^2
+       double      TopElectrodeDistance_MKS;
+
+       double ComputeResidual(Grid2d &inXi, Grid2d &outResidual);
+       bool   WithinGap(Grid2d &inXi);
+       void   ApplyPreconditioner(Grid2d &inV, Grid2d &outZ);
+       void   ApplyJacobian(Grid2d &inXi,
+                            Grid2d &inResidual,
+                            Grid2d &inV,
+                            Grid2d &outJV);
+       bool   SolveNewtonStep(Grid2d &inXi, double inTolerance);
+
+       double Dot(Grid2d &inA, Grid2d &inB);
+       void   Axpy(double inA, Grid2d &inX, Grid2d &ioY);
+
+   public:
+
+       NewtonKrylovMembrane(int inArrayDimension, double inMeshSize_MKS);
+       ~NewtonKrylovMembrane();
+
+       int    ArrayDimension() { return N; }
+       double MeshSize_MKS()   { return GridSpacing_MKS; }
+
+       int    Solve(Grid2d &ioSolution,
+                    Grid2d &inElectrodeVoltage,
+                    double  inTension_MKS,
+                    double  inGap_MKS,
+                    double  inTopElectrode_V,
+                    double  inTopElectrodeDistance_MKS,
+                    double  inFractionalError,
+                    Grid2d &outRHS,
+                    int    *outIterations,
+                    double *outError_MKS);
+
+};
+
+
+#endif
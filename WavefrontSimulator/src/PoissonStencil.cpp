@@ -0,0 +1,49 @@
+//---------------------------------------------------------------------------
+// PoissonStencil.cpp                                 C++ class
+//
+// Work arrays of the constant coefficient SOR and ADI kernels.  See
+// PoissonStencil.h
+//---------------------------------------------------------------------------
+#include "PoissonStencil.h"
+
+
+
+//---------------------------------------------------------------------------
+// StencilWorkspace()
+//
+// Allocates the work arrays of StencilADI() for grids 0...N x 0...N,
+// N <= inArrayDimension:  one row batch buffer for each OpenMP thread,
+// as many as omp_get_max_threads() at the time of allocation.
+// StencilADI() runs its row half steps on this many threads.
+//
+// called by:  MembranePDEProblem::SolveByADI()
+//---------------------------------------------------------------------------
+StencilWorkspace::StencilWorkspace(int inArrayDimension)
+{
+   N = inArrayDimension;
+
+   Psi.Allocate(N,N);
+   Shift   = dvector(1,1 << (STENCIL_ADI_KK-1));
+   Gamma   = dvector(1,N);
+   InvBeta = dvector(1,N);
+
+   NumRowBatches = 1;
+#ifdef _OPENMP
+   NumRowBatches = omp_get_max_threads();
+#endif
+   RowBatch = new Grid2d[NumRowBatches];
+   for (int t=0;t<NumRowBatches;t++)
+   {
+      RowBatch[t].Allocate(N,STENCIL_ADI_ROWS-1);
+   }
+}
+
+
+
+StencilWorkspace::~StencilWorkspace()
+{
+   delete [] RowBatch;
+   free_dvector(InvBeta,1,N);
+   free_dvector(Gamma,1,N);
+   free_dvector(Shift,1,1 << (STENCIL_ADI_KK-1));
+}
@@ -0,0 +1,458 @@
+//---------------------------------------------------------------------------
+// PoissonStencil.h                                   C++ Header file
+//
+// Constant coefficient versions of the Numerical Recipes sor() (SOR.C)
+// and adi() (ADI.C) for the membrane Poisson equation.
+//
+// NR sor() and adi() read the coefficients a...f of the finite difference
+// equation from one (N+1) x (N+1) array each, although every element of
+// these arrays is the same constant.  Here the coefficients are template
+// arguments, so the compiler folds them into the update formulas, and the
+// right hand side is read from rhs and scaled by h^2 at each point:
+//
+//    StencilSOR<1,1,1,1,-4>          NR Eq. 17.5.25 pg. 678
+//    StencilADI<-1,2,-1,-1,2,-1>     NR Eq. 17.6.22 pg. 685
+//
+// Iterations, grid index ranges (2...jmax-1, as in NR) and stopping
+// criteria are those of the NR routines, so the results are unchanged.
+// Work arrays of adi() are held in a StencilWorkspace, allocated once per
+// grid and owned by the caller, instead of being allocated and freed by
+// every call, and sized for the grid:  unlike ADI.C (JJ = 500) there is
+// no limit on the grid size.  Both kernels return the number of
+// iterations and the summed residual (units of h^2 rhs).
+//
+// StencilSOR() divides the rows of each half sweep among OpenMP threads,
+// StencilADI() the column blocks and row batches of each half step.
+// The C++Builder 5 project is compiled without OpenMP:  the pragmas are
+// ignored there and the kernels run on one thread, so the multithreading
+// only has an effect in builds with OpenMP (e.g. g++ -fopenmp).
+//
+// called by:  MembranePDEProblem::SolveBySOR()
+//             MembranePDEProblem::SolveByADI()
+//---------------------------------------------------------------------------
+#ifndef PoissonStencilH
+#define PoissonStencilH
+#include <math.h>
+#include "NumRecipes.h"
+#include "Grid2d.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+#define STENCIL_SOR_MAXITS    1000     // SOR.C
+#define STENCIL_SOR_EPS       1.e-5
+#define STENCIL_ADI_MAXITS    1000     // ADI.C
+#define STENCIL_ADI_KK        13       // at most 2^(KK-1) ADI sub-iterations
+#define STENCIL_ADI_COLUMNS   256      // columns per block, column sweeps
+#define STENCIL_ADI_ROWS      8        // rows per batch, row sweeps
+
+
+class StencilWorkspace
+{
+   public:
+
+       int       N;               // grid 0...N x 0...N
+
+       Grid2d    Psi;             // adi() work array
+       double   *Shift;           // ADI acceleration parameters r[1...2^k]
+       double   *Gamma;           // tridiagonal elimination factors, 1...N
+       double   *InvBeta;         //      "      inverse pivots
+
+       int       NumRowBatches;   // one per thread
+       Grid2d   *RowBatch;        // STENCIL_ADI_ROWS rows, transposed:
+                                  // RowBatch[t][l][w] = row w, column l
+
+       StencilWorkspace(int inArrayDimension);
+       ~StencilWorkspace();
+};
+
+
+
+//---------------------------------------------------------------------------
+// StencilTridiagonalFactor()
+//
+// Elimination factors of the tridiagonal system with constant diagonals
+// A (sub), B (main), C (super), of order n.  The factors depend only on
+// the diagonals, so they are computed once for all rows (columns) of an
+// ADI half step.  See NR tridag(), Ch 2.4.
+//
+// called by:  StencilADI()
+//---------------------------------------------------------------------------
+inline void StencilTridiagonalFactor(double  inA,
+                                     double  inB,
+                                     double  inC,
+                                     int     n,
+                                     double *outGamma,
+                                     double *outInvBeta)
+{
+   double theBeta;
+
+   if (inB == 0.0) nrerror("error 1 in TRIDAG");
+   theBeta = inB;
+   outInvBeta[1] = 1/theBeta;
+   for (int j=2;j<=n;j++)
+   {
+      outGamma[j] = inC/theBeta;
+      theBeta = inB - inA*outGamma[j];
+      if (theBeta == 0.0) nrerror("error 2 in TRIDAG");
+      outInvBeta[j] = 1/theBeta;
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// StencilSOR()
+//
+// NR sor() with constant coefficients A...E:  solves
+//
+//    A u[j+1][l] + B u[j-1][l] + C u[j][l+1] + D u[j][l-1] + E u[j][l]
+//                                                      = h^2 rhs[j][l]
+//
+// by odd-even (red-black) SOR with Chebyshev acceleration.  inRJac is the
+// spectral radius of the Jacobi iteration.
+//
+// As in NR, iteration n updates the points with (j+l)%2 == n%2 only,
+// and omega is changed after each of these half sweeps.  Points of one
+// colour depend only on points of the other colour, so each row of a
+// half sweep is a branch free loop over every second point, and the rows
+// are divided among the OpenMP threads, each summing the residual of
+// its own rows.  The result does not depend on the number of threads.
+//
+// return value:   number of iterations (half sweeps)
+//
+// called by:  MembranePDEProblem::SolveBySOR()
+//---------------------------------------------------------------------------
+template <int A, int B, int C, int D, int E>
+int StencilSOR(Grid2d  &inRHS,
+               double   inH2,
+               Grid2d  &ioU,
+               int      inJMax,
+               double   inRJac,
+               double  *outError)
+{
+   int    n, j;
+   double omega, anormf, anorm;
+
+   anormf = 0.0;
+#pragma omp parallel for reduction(+:anormf) schedule(static)
+   for (j=2;j<inJMax;j++)
+      for (int l=2;l<inJMax;l++)
+         anormf += fabs(inH2*inRHS[j][l]);
+
+   omega = 1.0;
+   for (n=1;n<=STENCIL_SOR_MAXITS;n++)
+   {
+      anorm = 0.0;
+
+#pragma omp parallel for reduction(+:anorm) schedule(static)
+      for (j=2;j<inJMax;j++)
+      {
+         double *theUp    = ioU[j+1];
+         double *theRow   = ioU[j];
+         double *theDown  = ioU[j-1];
+         double *theRHS   = inRHS[j];
+         double  theResid;
+         double  theSum = 0.0;
+
+         // first l >= 2 with (j+l)%2 == n%2
+         for (int l=2+(j+n)%2;l<inJMax;l+=2)
+         {
+            theResid = A*theUp[l] + B*theDown[l] +
+                       C*theRow[l+1] + D*theRow[l-1] +
+                       E*theRow[l] - inH2*theRHS[l];
+            theSum += fabs(theResid);
+            theRow[l] -= omega*theResid/E;
+         }
+         anorm += theSum;
+      }
+
+      omega = (n == 1 ? 1.0/(1.0-0.5*inRJac*inRJac) :
+                        1.0/(1.0-0.25*inRJac*inRJac*omega));
+      if (n > 1 && anorm < STENCIL_SOR_EPS*anormf)
+      {
+         *outError = anorm;
+         return n;
+      }
+   }
+
+   nrerror("Maximum number of iterations exceeded in SOR");
+   return n;
+}
+
+
+
+//---------------------------------------------------------------------------
+// StencilADIShifts()
+//
+// ADI acceleration parameters r[1...2^ink] for eigenvalue bounds inAlpha,
+// inBeta (NR Eq. 17.6.20 pg. 684), as computed by NR adi().  The
+// parameters of each level are computed in place from those of the
+// previous level, highest index first.
+//
+// called by:  StencilADI()
+//---------------------------------------------------------------------------
+inline void StencilADIShifts(double  inAlpha,
+                             double  inBeta,
+                             int     ink,
+                             double *r)
+{
+   double alph[STENCIL_ADI_KK+1];
+   double bet[STENCIL_ADI_KK+1];
+   double ab, disc;
+   int    k1 = ink+1;
+   int    twopwr;
+
+   alph[1] = inAlpha;
+   bet[1] = inBeta;
+   for (int j=1;j<=ink;j++)
+   {
+      alph[j+1] = sqrt(alph[j]*bet[j]);
+      bet[j+1] = 0.5*(alph[j]+bet[j]);
+   }
+   r[1] = sqrt(alph[k1]*bet[k1]);
+   twopwr = 1;
+   for (int j=1;j<=ink;j++)
+   {
+      ab = alph[k1-j]*bet[k1-j];
+      for (int n=twopwr;n>=1;n--)
+      {
+         disc = sqrt(r[n]*r[n]-ab);
+         r[2*n] = r[n]+disc;
+         r[2*n-1] = ab/r[2*n];
+      }
+      twopwr *= 2;
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// StencilADI()
+//
+// NR adi() with constant coefficients A...F:  solves
+//
+//    A u[j-1][l] + B u[j][l] + C u[j+1][l]
+//  + D u[j][l-1] + E u[j][l] + F u[j][l+1]  = -h^2 rhs[j][l]
+//
+// by ADI with 2^ink sub-iterations per iteration, for eigenvalue bounds
+// inAlpha, inBeta (NR Eq. 17.6.20 pg. 684).  ioWork must have been
+// allocated for a grid of at least inJMax.
+//
+// The coefficients are the same for every column (row), so each half
+// step factors its tridiagonal matrix once, and solves all columns
+// (rows) together:
+//
+//    columns:  the elimination runs down the rows, over blocks of
+//              STENCIL_ADI_COLUMNS adjacent columns at a time;  the
+//              inner loops run along rows and vectorize.  The solution
+//              is held in ioU, which the row half step overwrites.
+//    rows:     STENCIL_ADI_ROWS rows at a time are copied to a transposed
+//              buffer, and eliminated together, again with inner loops
+//              over contiguous elements.
+//
+// Blocks and batches are divided among the OpenMP threads.  Each element
+// is computed by the same operations as in NR adi(), so the result does
+// not depend on the number of threads.  The row half step uses one row
+// buffer per thread, so its thread count is fixed to the number of
+// buffers allocated with ioWork, even if omp_set_num_threads() was
+// called since.
+//
+// return value:   number of sub-iterations
+//
+// called by:  MembranePDEProblem::SolveByADI()
+//---------------------------------------------------------------------------
+template <int A, int B, int C, int D, int E, int F>
+int StencilADI(Grid2d            &inRHS,
+               double             inH2,
+               Grid2d            &ioU,
+               int                inJMax,
+               int                ink,
+               double             inAlpha,
+               double             inBeta,
+               double             inEps,
+               StencilWorkspace  *ioWork,
+               double            *outError)
+{
+   int    nr, nits, next, n, kits, j;
+   int    theNumBlocks, theNumBatches;
+   double rfact, twor, anormg, anorm;
+   double *r    = ioWork->Shift;
+   Grid2d &psi  = ioWork->Psi;
+   double *gam  = ioWork->Gamma;
+   double *ibet = ioWork->InvBeta;
+
+   if (inJMax > ioWork->N) nrerror("in ADI, workspace too small");
+   if (ink > STENCIL_ADI_KK-1) nrerror("in ADI, increase KK");
+   if (inJMax < 3)
+   {
+      *outError = 0;
+      return 0;
+   }
+
+   nr = 1 << ink;
+   StencilADIShifts(inAlpha,inBeta,ink,r);
+
+   theNumBlocks  = (inJMax-2 + STENCIL_ADI_COLUMNS-1)/STENCIL_ADI_COLUMNS;
+   theNumBatches = (inJMax-2 + STENCIL_ADI_ROWS-1)/STENCIL_ADI_ROWS;
+
+   anormg = 0.0;
+#pragma omp parallel for reduction(+:anormg) schedule(static)
+   for (j=2;j<=inJMax-1;j++)
+   {
+      double *theU   = ioU[j];
+      double *thePsi = psi[j];
+      double *theRHS = inRHS[j];
+
+      for (int l=2;l<=inJMax-1;l++)
+      {
+         anormg += fabs(inH2*theRHS[l]);
+         thePsi[l] = -D*theU[l-1] + (r[1]-E)*theU[l] - F*theU[l+1];
+      }
+   }
+
+   nits = STENCIL_ADI_MAXITS/nr;
+   for (kits=1;kits<=nits;kits++)
+   {
+      for (n=1;n<=nr;n++)
+      {
+         next = n == nr ? 1 : n+1;
+         rfact = r[n]+r[next];
+         twor = 2.0*r[n];
+
+         // columns:  tridiagonal systems along j, A u[j-1] + (B+r) u[j]
+         // + C u[j+1] = psi - h^2 rhs, solutions held in ioU
+         StencilTridiagonalFactor(A,B+r[n],C,inJMax-2,gam,ibet);
+#pragma omp parallel for schedule(static)
+         for (int theBlock=0;theBlock<theNumBlocks;theBlock++)
+         {
+            int     l0 = 2 + theBlock*STENCIL_ADI_COLUMNS;
+            int     l1 = l0 + STENCIL_ADI_COLUMNS;
+            double *theV, *thePrev, *thePsi, *theRHS;
+            double  theIB, theG;
+
+            if (l1 > inJMax) l1 = inJMax;
+
+            theV = ioU[2];  thePsi = psi[2];  theRHS = inRHS[2];
+            theIB = ibet[1];
+            for (int l=l0;l<l1;l++)
+               theV[l] = (thePsi[l] - inH2*theRHS[l])*theIB;
+
+            for (int jj=3;jj<=inJMax-1;jj++)
+            {
+               thePrev = theV;
+               theV = ioU[jj];  thePsi = psi[jj];  theRHS = inRHS[jj];
+               theIB = ibet[jj-1];
+               for (int l=l0;l<l1;l++)
+                  theV[l] = ((thePsi[l] - inH2*theRHS[l]) - A*thePrev[l])*theIB;
+            }
+
+            // back substitution, and the psi update of each finished row
+            for (int l=l0;l<l1;l++)
+               thePsi[l] = -thePsi[l] + twor*theV[l];
+            for (int jj=inJMax-2;jj>=2;jj--)
+            {
+               thePrev = theV;
+               theV = ioU[jj];  thePsi = psi[jj];
+               theG = gam[jj];
+               for (int l=l0;l<l1;l++)
+               {
+                  theV[l] -= theG*thePrev[l];
+                  thePsi[l] = -thePsi[l] + twor*theV[l];
+               }
+            }
+         }
+
+         // rows:  tridiagonal systems along l, D u[l-1] + (E+r) u[l]
+         // + F u[l+1] = psi
+         StencilTridiagonalFactor(D,E+r[n],F,inJMax-2,gam,ibet);
+#pragma omp parallel for schedule(static) num_threads(ioWork->NumRowBatches)
+         for (int theBatch=0;theBatch<theNumBatches;theBatch++)
+         {
+            int     theThread = 0;
+            int     j0 = 2 + theBatch*STENCIL_ADI_ROWS;
+            int     theWidth = STENCIL_ADI_ROWS;
+            double *theRow, *thePrev;
+            double *thePsi[STENCIL_ADI_ROWS];
+            double *theU[STENCIL_ADI_ROWS];
+            double  theIB, theG;
+
+#ifdef _OPENMP
+            theThread = omp_get_thread_num();
+#endif
+            if (theThread >= ioWork->NumRowBatches)
+               nrerror("in ADI, more threads than row buffers");
+            Grid2d &T = ioWork->RowBatch[theThread];
+
+            if (j0 + theWidth > inJMax) theWidth = inJMax - j0;
+            for (int w=0;w<theWidth;w++)
+            {
+               thePsi[w] = psi[j0+w];
+               theU[w]   = ioU[j0+w];
+            }
+
+            theRow = T[2];
+            theIB = ibet[1];
+            for (int w=0;w<theWidth;w++)
+               theRow[w] = thePsi[w][2]*theIB;
+
+            for (int l=3;l<=inJMax-1;l++)
+            {
+               thePrev = theRow;
+               theRow = T[l];
+               theIB = ibet[l-1];
+               for (int w=0;w<theWidth;w++)
+                  theRow[w] = (thePsi[w][l] - D*thePrev[w])*theIB;
+            }
+
+            for (int l=inJMax-2;l>=2;l--)
+            {
+               thePrev = T[l+1];
+               theRow = T[l];
+               theG = gam[l];
+               for (int w=0;w<theWidth;w++)
+                  theRow[w] -= theG*thePrev[w];
+            }
+
+            for (int w=0;w<theWidth;w++)
+            {
+               for (int l=2;l<=inJMax-1;l++)
+               {
+                  theU[w][l] = T[l][w];
+                  thePsi[w][l] = -thePsi[w][l] + rfact*T[l][w];
+               }
+            }
+         }
+      }
+
+      anorm = 0.0;
+#pragma omp parallel for reduction(+:anorm) schedule(static)
+      for (j=2;j<=inJMax-1;j++)
+      {
+         double *theUp   = ioU[j+1];
+         double *theRow  = ioU[j];
+         double *theDown = ioU[j-1];
+         double *theRHS  = inRHS[j];
+         double  theResid;
+
+         for (int l=2;l<=inJMax-1;l++)
+         {
+            theResid = A*theDown[l] + (B+E)*theRow[l] + C*theUp[l] +
+                       D*theRow[l-1] + F*theRow[l+1] + inH2*theRHS[l];
+            anorm += fabs(theResid);
+         }
+      }
+      if (anorm < inEps*anormg)
+      {
+         *outError = anorm;
+         return kits*nr;
+      }
+   }
+
+   nrerror("in ADI, too many iterations");
+   return nits*nr;
+}
+
+
+#endif
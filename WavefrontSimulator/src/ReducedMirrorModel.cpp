@@ -0,0 +1,629 @@
+//---------------------------------------------------------------------------
+// ReducedMirrorModel.cpp                             C++ class
+//
+// Reduced order membrane mirror model from the singular value
+// decomposition of an influence matrix.  See ReducedMirrorModel.h
+//
+// With A^T A = W L W^T (eigenvalues L, orthonormal eigenvectors W), the
+// singular values of A are s_i = sqrt(L_i), V = W, and U_i = A W_i / s_i.
+//
+// called by:  not called within the application;  see
+//             MembranePDEProblem::TestReducedMirrorModel()
+//---------------------------------------------------------------------------
+#include <fstream.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "ReducedMirrorModel.h"
+#include "NumRecipes.h"
+
+
+
+//---------------------------------------------------------------------------
+// Pythag()
+//
+// sqrt(a^2 + b^2) without overflow or destructive underflow.  NR pg. 70.
+//
+// called by:  ReducedMirrorModel::DiagonalizeTridiagonal()
+//---------------------------------------------------------------------------
+static double Pythag(double inA, double inB)
+{
+   double theA = fabs(inA);
+   double theB = fabs(inB);
+
+   if (theA > theB) return theA*sqrt( 1.0 + (theB/theA)*(theB/theA) );
+   if (theB == 0.0) return 0.0;
+   return theB*sqrt( 1.0 + (theA/theB)*(theA/theB) );
+}
+
+
+
+//---------------------------------------------------------------------------
+// ReducedMirrorModel()
+//
+// Empty model.  Build() or ReadFromFile() before use.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+ReducedMirrorModel::ReducedMirrorModel()
+{
+   N               = 0;
+   GridSpacing_MKS = 0;
+   NumActuators    = 0;
+   NumModes        = 0;
+
+   SingularValue   = 0;
+   ModalMatrix     = 0;
+   Basis           = 0;
+   ModalCoeff      = 0;
+}
+
+
+
+ReducedMirrorModel::~ReducedMirrorModel()
+{
+   Clear();
+}
+
+
+
+//---------------------------------------------------------------------------
+// Clear()
+//
+// Releases the model.
+//
+// called by:  ~ReducedMirrorModel(), Build(), ReadFromFile()
+//---------------------------------------------------------------------------
+void ReducedMirrorModel::Clear()
+{
+   delete [] SingularValue;
+   delete [] ModalMatrix;
+   delete [] Basis;
+   delete [] ModalCoeff;
+
+   NumActuators  = 0;
+   NumModes      = 0;
+   SingularValue = 0;
+   ModalMatrix   = 0;
+   Basis         = 0;
+   ModalCoeff    = 0;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Build()
+//
+// Computes the model of inMatrix:  the modes with singular value above
+// inTolerance times the largest, at most inMaxModes of them.
+//
+// A^T A is summed one column of A at a time, scattered on the grid, the
+// columns divided among the OpenMP threads;  so are the basis shapes.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+void ReducedMirrorModel::Build(InfluenceMatrix &inMatrix,
+                               double           inTolerance,
+                               int              inMaxModes)
+{
+   double **theGram;            // A^T A, then its eigenvectors (rows)
+   double  *theD;
+   double  *theE;
+   int     *theOrder;           // eigenvalues, descending
+   int      theNumPoints;
+   int      theTemp;
+   double   theSwap;
+   int      K;
+   int      i, k, l;
+
+   Clear();
+
+   N               = inMatrix.N;
+   GridSpacing_MKS = inMatrix.GridSpacing_MKS;
+   K = NumActuators = inMatrix.NumActuators;
+   theNumPoints    = (N+1)*(N+1);
+
+   if (K < 1)
+   {
+      nrerror("ReducedMirrorModel::Build:  empty influence matrix");
+   }
+
+   theGram = dmatrix(1,K,1,K);
+   theD    = dvector(1,K);
+   theE    = dvector(1,K);
+
+#pragma omp parallel private(k,l)
+   {
+      double *theColumn = new double[theNumPoints];
+      double  theSum;
+      int     n;
+
+      for (n=0;n<theNumPoints;n++) theColumn[n] = 0;
+
+#pragma omp for schedule(dynamic)
+      for (l=0;l<K;l++)
+      {
+         for (n=inMatrix.ColumnStart[l];n<inMatrix.ColumnStart[l+1];n++)
+         {
+            theColumn[inMatrix.RowIndex[n]] = inMatrix.Value[n];
+         }
+
+         for (k=0;k<=l;k++)
+         {
+            theSum = 0;
+            for (n=inMatrix.ColumnStart[k];n<inMatrix.ColumnStart[k+1];n++)
+            {
+               theSum += inMatrix.Value[n]*theColumn[inMatrix.RowIndex[n]];
+            }
+            theGram[k+1][l+1] = theSum;
+            theGram[l+1][k+1] = theSum;
+         }
+
+         for (n=inMatrix.ColumnStart[l];n<inMatrix.ColumnStart[l+1];n++)
+         {
+            theColumn[inMatrix.RowIndex[n]] = 0;
+         }
+      }
+
+      delete [] theColumn;
+   }
+
+   Tridiagonalize(theGram,K,theD,theE);
+
+   // eigenvectors as rows, for the QL rotations
+   for (i=1;i<=K;i++)
+   {
+      for (k=i+1;k<=K;k++)
+      {
+         theSwap = theGram[i][k];
+         theGram[i][k] = theGram[k][i];
+         theGram[k][i] = theSwap;
+      }
+   }
+
+   DiagonalizeTridiagonal(theD,theE,K,theGram);
+
+   // sort by decreasing eigenvalue (insertion sort of the index)
+   theOrder = new int[K];
+   for (i=0;i<K;i++)
+   {
+      theTemp = i+1;
+      for (k=i;k>0 && theD[theOrder[k-1]] < theD[theTemp];k--)
+      {
+         theOrder[k] = theOrder[k-1];
+      }
+      theOrder[k] = theTemp;
+   }
+
+   SingularValue = new double[K];
+   for (i=0;i<K;i++)
+   {
+      SingularValue[i] = theD[theOrder[i]] > 0 ? sqrt(theD[theOrder[i]]) : 0;
+   }
+
+   NumModes = 0;
+   while ( NumModes < K && NumModes < inMaxModes &&
+           SingularValue[NumModes] > 0 &&
+           SingularValue[NumModes] > inTolerance*SingularValue[0] )
+   {
+      NumModes++;
+   }
+
+   ModalMatrix = new double[K*K];
+   ModalCoeff  = new double[NumModes > 0 ? NumModes : 1];
+   Basis       = new Grid2d[NumModes > 0 ? NumModes : 1];
+
+   for (i=0;i<K;i++)
+   {
+      for (k=0;k<K;k++)
+      {
+         ModalMatrix[i*K+k] = SingularValue[i]*theGram[theOrder[i]][k+1];
+      }
+   }
+
+#pragma omp parallel for private(k) schedule(dynamic)
+   for (i=0;i<NumModes;i++)
+   {
+      Basis[i].Allocate(N,N);
+      for (k=0;k<K;k++)
+      {
+         inMatrix.AddColumn(k,theGram[theOrder[i]][k+1]/SingularValue[i],
+                            Basis[i]);
+      }
+   }
+
+   delete [] theOrder;
+   free_dvector(theE,1,K);
+   free_dvector(theD,1,K);
+   free_dmatrix(theGram,1,K,1,K);
+}
+
+
+
+//---------------------------------------------------------------------------
+// Tridiagonalize()
+//
+// Householder reduction of the real symmetric matrix ioA[1...inN][1...inN]
+// to tridiagonal form (NR tred2, pg. 474).  On return ioA holds the
+// orthogonal transformation, outD the diagonal and outE the off-diagonal
+// elements (outE[1] = 0).
+//
+// called by:  Build()
+//---------------------------------------------------------------------------
+void ReducedMirrorModel::Tridiagonalize(double **ioA,
+                                        int      inN,
+                                        double  *outD,
+                                        double  *outE)
+{
+   int    i, j, k, l;
+   double theScale, theHH, theH, theG, theF;
+
+   for (i=inN;i>=2;i--)
+   {
+      l = i-1;
+      theH = theScale = 0.0;
+      if (l > 1)
+      {
+         for (k=1;k<=l;k++) theScale += fabs(ioA[i][k]);
+
+         if (theScale == 0.0)
+         {
+            outE[i] = ioA[i][l];
+         }
+         else
+         {
+            for (k=1;k<=l;k++)
+            {
+               ioA[i][k] /= theScale;
+               theH += ioA[i][k]*ioA[i][k];
+            }
+            theF = ioA[i][l];
+            theG = (theF >= 0.0 ? -sqrt(theH) : sqrt(theH));
+            outE[i] = theScale*theG;
+            theH -= theF*theG;
+            ioA[i][l] = theF - theG;
+            theF = 0.0;
+            for (j=1;j<=l;j++)
+            {
+               ioA[j][i] = ioA[i][j]/theH;
+               theG = 0.0;
+               for (k=1;k<=j;k++)   theG += ioA[j][k]*ioA[i][k];
+               for (k=j+1;k<=l;k++) theG += ioA[k][j]*ioA[i][k];
+               outE[j] = theG/theH;
+               theF += outE[j]*ioA[i][j];
+            }
+            theHH = theF/(theH + theH);
+            for (j=1;j<=l;j++)
+            {
+               theF = ioA[i][j];
+               outE[j] = theG = outE[j] - theHH*theF;
+               for (k=1;k<=j;k++)
+               {
+                  ioA[j][k] -= ( theF*outE[k] + theG*ioA[i][k] );
+               }
+            }
+         }
+      }
+      else
+      {
+         outE[i] = ioA[i][l];
+      }
+      outD[i] = theH;
+   }
+
+   outD[1] = 0.0;
+   outE[1] = 0.0;
+
+   // accumulate the transformations
+   for (i=1;i<=inN;i++)
+   {
+      l = i-1;
+      if (outD[i] != 0.0)
+      {
+         for (j=1;j<=l;j++)
+         {
+            theG = 0.0;
+            for (k=1;k<=l;k++) theG += ioA[i][k]*ioA[k][j];
+            for (k=1;k<=l;k++) ioA[k][j] -= theG*ioA[k][i];
+         }
+      }
+      outD[i] = ioA[i][i];
+      ioA[i][i] = 1.0;
+      for (j=1;j<=l;j++) ioA[j][i] = ioA[i][j] = 0.0;
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// DiagonalizeTridiagonal()
+//
+// Eigenvalues and eigenvectors of the symmetric tridiagonal matrix with
+// diagonal ioD[1...inN] and off-diagonal ioE[2...inN], by QL iteration
+// with implicit shifts (NR tqli, pg. 480).  ioZ[i][1...inN] holds on
+// entry row i of the transposed Tridiagonalize() transformation, and on
+// return the eigenvector of eigenvalue ioD[i].  (NR works on columns;
+// rows keep the rotations on contiguous memory.)
+//
+// called by:  Build()
+//---------------------------------------------------------------------------
+void ReducedMirrorModel::DiagonalizeTridiagonal(double  *ioD,
+                                                double  *ioE,
+                                                int      inN,
+                                                double **ioZ)
+{
+   int    m, l, theIteration, i, k;
+   double s, r, p, g, f, dd, c, b;
+   double *theRowA, *theRowB;
+
+   for (i=2;i<=inN;i++) ioE[i-1] = ioE[i];
+   ioE[inN] = 0.0;
+
+   for (l=1;l<=inN;l++)
+   {
+      theIteration = 0;
+      do
+      {
+         for (m=l;m<=inN-1;m++)
+         {
+            dd = fabs(ioD[m]) + fabs(ioD[m+1]);
+            if ( (double)(fabs(ioE[m]) + dd) == dd ) break;
+         }
+         if (m != l)
+         {
+            if (theIteration++ == 30)
+            {
+               nrerror("ReducedMirrorModel:  too many iterations in QL");
+            }
+            g = (ioD[l+1] - ioD[l])/(2.0*ioE[l]);
+            r = Pythag(g,1.0);
+            g = ioD[m] - ioD[l] + ioE[l]/(g + (g >= 0.0 ? fabs(r) : -fabs(r)));
+            s = c = 1.0;
+            p = 0.0;
+            for (i=m-1;i>=l;i--)
+            {
+               f = s*ioE[i];
+               b = c*ioE[i];
+               ioE[i+1] = (r = Pythag(f,g));
+               if (r == 0.0)
+               {
+                  ioD[i+1] -= p;
+                  ioE[m] = 0.0;
+                  break;
+               }
+               s = f/r;
+               c = g/r;
+               g = ioD[i+1] - p;
+               r = (ioD[i] - g)*s + 2.0*c*b;
+               ioD[i+1] = g + (p = s*r);
+               g = c*r - b;
+
+               theRowA = ioZ[i];
+               theRowB = ioZ[i+1];
+               for (k=1;k<=inN;k++)
+               {
+                  f = theRowB[k];
+                  theRowB[k] = s*theRowA[k] + c*f;
+                  theRowA[k] = c*theRowA[k] - s*f;
+               }
+            }
+            if (r == 0.0 && i >= l) continue;
+            ioD[l] -= p;
+            ioE[l] = g;
+            ioE[m] = 0.0;
+         }
+      } while (m != l);
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// ComputeDeflection()
+//
+// Membrane deflection (m) of the model for the electrode voltages squared
+// inVoltageSquared[0...NumActuators-1] (V^2):  modal coefficients
+// S_r V_r^T V^2, then the sum of the basis shapes.
+//
+// called by:  MembranePDEProblem::TestReducedMirrorModel()
+//---------------------------------------------------------------------------
+void ReducedMirrorModel::ComputeDeflection(const double *inVoltageSquared,
+                                           Grid2d       &outDeflection_MKS)
+{
+   double *theModalRow;
+   double *theRow;
+   double *theBasisRow;
+   double  theSum;
+
+   if ( outDeflection_MKS.Rows() != N+1 ||
+        outDeflection_MKS.Columns() != N+1 )
+   {
+      nrerror("ReducedMirrorModel::ComputeDeflection:  grid size mismatch");
+   }
+
+   for (int i=0;i<NumModes;i++)
+   {
+      theModalRow = ModalMatrix + i*NumActuators;
+      theSum = 0;
+      for (int k=0;k<NumActuators;k++)
+      {
+         theSum += theModalRow[k]*inVoltageSquared[k];
+      }
+      ModalCoeff[i] = theSum;
+   }
+
+#pragma omp parallel for private(theRow,theBasisRow)
+   for (int r=0;r<=N;r++)
+   {
+      theRow = outDeflection_MKS[r];
+      for (int j=0;j<=N;j++) theRow[j] = 0;
+
+      for (int i=0;i<NumModes;i++)
+      {
+         theBasisRow = Basis[i][r];
+         for (int j=0;j<=N;j++)
+         {
+            theRow[j] += ModalCoeff[i]*theBasisRow[j];
+         }
+      }
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// ErrorBound()
+//
+// Bound on the deflection error of ComputeDeflection() at any grid point
+// (m), relative to the influence matrix:  the 2-norm of the error,
+// | S' V'^T V^2 |, from the dropped rows of ModalMatrix.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+double ReducedMirrorModel::ErrorBound(const double *inVoltageSquared)
+{
+   double *theModalRow;
+   double  theSum;
+   double  theNorm = 0;
+
+   for (int i=NumModes;i<NumActuators;i++)
+   {
+      theModalRow = ModalMatrix + i*NumActuators;
+      theSum = 0;
+      for (int k=0;k<NumActuators;k++)
+      {
+         theSum += theModalRow[k]*inVoltageSquared[k];
+      }
+      theNorm += theSum*theSum;
+   }
+
+   return sqrt(theNorm);
+}
+
+
+
+//---------------------------------------------------------------------------
+// WriteToFile()
+//
+// Writes the model to a binary file:  "WFRM", REDUCED_MODEL_FILE_VERSION,
+// N, h, NumActuators, NumModes, SingularValue[], ModalMatrix[] (all
+// NumActuators rows), and the rows of each basis shape.
+//
+// return value:  FALSE if the file could not be written.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+bool ReducedMirrorModel::WriteToFile(const char *inFileName)
+{
+   int  theVersion = REDUCED_MODEL_FILE_VERSION;
+   bool theStatus;
+
+   fstream iofile(inFileName, ios::out | ios::binary);
+
+   if (iofile.fail())
+   {
+      return false;
+   }
+
+   iofile.write("WFRM",4);
+   iofile.write((char *)&theVersion,sizeof(int));
+   iofile.write((char *)&N,sizeof(int));
+   iofile.write((char *)&GridSpacing_MKS,sizeof(double));
+   iofile.write((char *)&NumActuators,sizeof(int));
+   iofile.write((char *)&NumModes,sizeof(int));
+
+   iofile.write((char *)SingularValue,NumActuators*sizeof(double));
+   iofile.write((char *)ModalMatrix,NumActuators*NumActuators*sizeof(double));
+   for (int i=0;i<NumModes;i++)
+   {
+      for (int r=0;r<=N;r++)
+      {
+         iofile.write((char *)Basis[i][r],(N+1)*sizeof(double));
+      }
+   }
+
+   theStatus = !iofile.fail();
+   iofile.close();
+
+   return theStatus;
+}
+
+
+
+//---------------------------------------------------------------------------
+// ReadFromFile()
+//
+// Reads a model written by WriteToFile(), replacing the current one.
+//
+// return value:  FALSE if the file could not be read, or is not a reduced
+//                model file.  The model is then empty.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+bool ReducedMirrorModel::ReadFromFile(const char *inFileName)
+{
+   char theMagic[4];
+   int  theVersion;
+
+   Clear();
+
+   fstream iofile(inFileName, ios::in | ios::binary);
+
+   if (iofile.fail())
+   {
+      return false;
+   }
+
+   iofile.read(theMagic,4);
+   iofile.read((char *)&theVersion,sizeof(int));
+   if ( iofile.fail() ||
+        theMagic[0] != 'W' || theMagic[1] != 'F' ||
+        theMagic[2] != 'R' || theMagic[3] != 'M' ||
+        theVersion != REDUCED_MODEL_FILE_VERSION )
+   {
+      iofile.close();
+      return false;
+   }
+
+   iofile.read((char *)&N,sizeof(int));
+   iofile.read((char *)&GridSpacing_MKS,sizeof(double));
+   iofile.read((char *)&NumActuators,sizeof(int));
+   iofile.read((char *)&NumModes,sizeof(int));
+   if ( iofile.fail() || N < 0 || NumActuators < 1 ||
+        NumModes < 0 || NumModes > NumActuators )
+   {
+      NumActuators = 0;
+      NumModes = 0;
+      iofile.close();
+      return false;
+   }
+
+   SingularValue = new double[NumActuators];
+   ModalMatrix   = new double[NumActuators*NumActuators];
+   ModalCoeff    = new double[NumModes > 0 ? NumModes : 1];
+   Basis         = new Grid2d[NumModes > 0 ? NumModes : 1];
+
+   iofile.read((char *)SingularValue,NumActuators*sizeof(double));
+   iofile.read((char *)ModalMatrix,NumActuators*NumActuators*sizeof(double));
+   for (int i=0;i<NumModes;i++)
+   {
+      Basis[i].Allocate(N,N);
+      for (int r=0;r<=N;r++)
+      {
+         iofile.read((char *)Basis[i][r],(N+1)*sizeof(double));
+      }
+   }
+
+   if (iofile.fail())
+   {
+      iofile.close();
+      Clear();
+      return false;
+   }
+   iofile.close();
+
+   return true;
+}
@@ -0,0 +1,92 @@
+//---------------------------------------------------------------------------
+// ReducedMirrorModel.h                               C++ Header file
+//
+// Class definition for the ReducedMirrorModel class.  Reduced order model
+// of the membrane mirror, built from an InfluenceMatrix A (grid points x
+// electrodes, deflection per V^2):  the truncated singular value
+// decomposition
+//
+//    A  =  U S V^T  ~  U_r S_r V_r^T,
+//
+// with the r largest singular values s_1 >= ... >= s_r.  The columns of
+// U_r (Basis) are orthonormal membrane shapes; the r x NumActuators
+// modal matrix S_r V_r^T maps the electrode V^2 to their coefficients.
+// The deflection for electrode voltages V_k is then one small matrix-
+// vector product and a sum of r shapes (ComputeDeflection()), in place
+// of a solve of the Poisson equation.
+//
+// The deflection error of the model is the part of A v in the dropped
+// modes, with 2-norm
+//
+//    | A v - U_r S_r V_r^T v |  =  | S' V'^T v |   <=   s_(r+1) |v|
+//
+// (S', V' the dropped singular values and vectors), which bounds the
+// error at every grid point.  ErrorBound() evaluates | S' V'^T V^2 |,
+// at the cost of a NumActuators^2 matrix-vector product;  the worst case
+// s_(r+1) |V^2| is usually far larger.  ErrorBound()/(N+1) is the rms
+// error over the grid.  The error is relative to the
+// influence matrix, which itself drops values below its threshold.
+//
+// The decomposition is computed from the eigenvalues and vectors of
+// A^T A (method of snapshots), by Householder reduction and QL iteration
+// (Numerical Recipes in C, Ch 11.2-11.3).  Singular values below
+// ~1e-7 s_1 are lost to round-off in A^T A.  Building the model costs
+// O(NumActuators^2 x values of A), and is done offline;  WriteToFile()
+// and ReadFromFile() store the model in a binary file.
+//---------------------------------------------------------------------------
+#ifndef ReducedMirrorModelH
+#define ReducedMirrorModelH
+#include "Grid2d.h"
+#include "InfluenceMatrix.h"
+
+
+#define REDUCED_MODEL_FILE_VERSION    1
+
+
+class ReducedMirrorModel
+{
+   private:
+
+       int       N;                   // membrane intervals per side
+       double    GridSpacing_MKS;     // h
+
+       int       NumActuators;
+       int       NumModes;            // r
+
+       double   *SingularValue;       // all, descending, 0...NumActuators-1
+       double   *ModalMatrix;         // S V^T, NumActuators x NumActuators;
+                                      // rows 0...NumModes-1 are S_r V_r^T
+       Grid2d   *Basis;               // U_r, 0...NumModes-1
+       double   *ModalCoeff;          // work, 0...NumModes-1
+
+       void   Clear();
+       void   Tridiagonalize(double **ioA, int inN, double *outD, double *outE);
+       void   DiagonalizeTridiagonal(double *ioD, double *ioE, int inN,
+                                     double **ioZ);
+
+   public:
+
+       ReducedMirrorModel();
+       ~ReducedMirrorModel();
+
+       void   Build(InfluenceMatrix &inMatrix,
+                    double           inTolerance,
+                    int              inMaxModes);
+
+       void   ComputeDeflection(const double *inVoltageSquared,
+                                Grid2d       &outDeflection_MKS);
+       double ErrorBound(const double *inVoltageSquared);
+
+       bool   WriteToFile(const char *inFileName);
+       bool   ReadFromFile(const char *inFileName);
+
+       int    ArrayDimension() { return N; }
+       double MeshSize_MKS()   { return GridSpacing_MKS; }
+       int    Actuators()      { return NumActuators; }
+       int    Modes()          { return NumModes; }
+       double Singular(int inIndex) { return SingularValue[inIndex]; }
+
+};
+
+
+#endif
@@ -45,9 +45,9 @@ Wavefront::Wavefront()
    ROIDataFileName ="WavefrontROIData.txt";
 
 
-   Phase_rad   = matrix(0,ArrayDimension,0,ArrayDimension);
-   Phase_um    = matrix(0,ArrayDimension,0,ArrayDimension);
-   Phase_Graph = matrix(0,ArrayDimension,0,ArrayDimension);
+   Phase_rad.Allocate(ArrayDimension,ArrayDimension);
+   Phase_um.Allocate(ArrayDimension,ArrayDimension);
+   Phase_Graph.Allocate(ArrayDimension,ArrayDimension);
    for (int i=0;i<ArrayDimension;i++)
    {
       for (int j=0;j<ArrayDimension;j++)
@@ -93,8 +93,9 @@ Wavefront::Wavefront(double      inWidth_mm,
    ROIDataFileName ="WavefrontROIData.txt";
 
 
-   Phase_rad   = matrix(0,ArrayDimension,0,ArrayDimension);
-   Phase_Graph = matrix(0,ArrayDimension,0,ArrayDimension);
+   Phase_rad.Allocate(ArrayDimension,ArrayDimension);
+   Phase_um.Allocate(ArrayDimension,ArrayDimension);
+   Phase_Graph.Allocate(ArrayDimension,ArrayDimension);
    for (int i=0;i<ArrayDimension;i++)
    {
       for (int j=0;j<ArrayDimension;j++)
@@ -142,9 +143,9 @@ Wavefront::Wavefront(double inWidth_mm,
    ROIDataFileName =    "WavefrontROIData.txt";
 
 
-   Phase_rad   = matrix(0,ArrayDimension,0,ArrayDimension);
-   Phase_um    = matrix(0,ArrayDimension,0,ArrayDimension);
-   Phase_Graph = matrix(0,ArrayDimension,0,ArrayDimension);
+   Phase_rad.Allocate(ArrayDimension,ArrayDimension);
+   Phase_um.Allocate(ArrayDimension,ArrayDimension);
+   Phase_Graph.Allocate(ArrayDimension,ArrayDimension);
    for (int i=0;i<ArrayDimension;i++)
    {
       for (int j=0;j<ArrayDimension;j++)
@@ -197,10 +198,10 @@ void Wavefront::ScaleDataForGraphicsDisplay()
 // are either not displayed, or drawn in green.
 //
 // NOTE: array indexing is 0...N (inclusive).  This is not a mistake!
-// There is no memory leak because numerical recipes routine matrix()
-// allocates memory from 0...N inclusive.  This indexing convention is
-// carried over from MembranePDEproblem, and it facilitates graphics
-// operations.
+// There is no memory leak because Grid2d, like numerical recipes
+// routine matrix(), allocates memory from 0...N inclusive.  This
+// indexing convention is carried over from MembranePDEproblem, and it
+// facilitates graphics operations.
 //
 // called by:  TForm1::PaintBox2OnPaint()
 //
@@ -774,24 +775,3 @@ double Wavefront::Theta_rad(int inRow, int inColumn)
     }
 
 }
-
-
-//--------------------------------------------------------------------------
-// matrix()
-//
-// shamelessly lifted from Numerical Recipes
-//
-// called by:  Wavefront()
-//--------------------------------------------------------------------------
-double **Wavefront::matrix(int nrl, int nrh, int ncl, int nch)
-{
-   int i;
-   double **m;
-   m=(double **) malloc((unsigned) (nrh-nrl+1)*sizeof(double*));
-   m-=nrl;
-   for (i=nrl;i<=nrh;i++)   {
-      m[i]=(double *) malloc((unsigned) (nch-ncl+1)*sizeof(double));
-      m[i]-=ncl;
-   }
-   return m;
-}
@@ -23,6 +23,7 @@
 #include <fstream.h>
 #include <iostream.h>
 #include "Graphics3d.h"
+#include "Grid2d.h"
 
 
 class Wavefront
@@ -41,8 +42,6 @@ class Wavefront
    bool     PointIsWithinPupil(int inRowIndex, int inColumnIndex);
    bool     PointIsWithinROI(int inRowIndex, int inColumnIndex);
 
-   double **matrix(int nrl, int nrh, int ncl, int nch);
-
 
   public:
 
@@ -61,9 +60,9 @@ class Wavefront
    double       Wavelength_nm;
    double       Wavelength_MKS;
 
-   double     **Phase_rad;
-   double     **Phase_um;
-   double     **Phase_Graph;
+   Grid2d       Phase_rad;              // 0...ArrayDimension inclusive
+   Grid2d       Phase_um;
+   Grid2d       Phase_Graph;
 
 
    Wavefront();
@@ -201,6 +201,9 @@ void __fastcall TWavefrontGUIForm::ImagElectrodePaintBoxPaint(TObject *Sender)
 // This method and the TForm::TForm() constructor are the only methods
 // that call the MembranePDEproblem::MembranePDEproblem() constructor.
 //
+// If only the aberration coefficients have changed, the existing
+// AberratedWavefront is kept, and its basis images re-used.
+//
 // called by:
 //             TWavefrontGUIForm::RunElectrodeSolverExecute()
 //             TWavefrontGUIForm::FileNewExecute()
@@ -213,16 +216,29 @@ void TWavefrontGUIForm::Reset_Wavefront()
    // allocated on first call to this method.   However, compiler
    // doesn't seem to mind 'delete'-ing them anyways.  plk 5/1/2003
 
-   delete theWavefront;
    delete theMembraneInverseProblem;
 
-   theWavefront = new AberratedWavefront(theWavefrontWidth_mm,
-                                         theWavefrontArrayDimension,
-                                         theWavefrontROIDimension_mm,
-                                         theWavefrontPupilRadius_mm,
-                                         theWavefrontZOffset_um,
-                                         theAberrationCoeff);
-   Memo1->Lines->Add("Created Aberrated Wavefront.");
+   if (theWavefront != NULL &&
+       theWavefront->HasGeometry(theWavefrontWidth_mm,
+                                 theWavefrontArrayDimension,
+                                 theWavefrontROIDimension_mm,
+                                 theWavefrontPupilRadius_mm,
+                                 theWavefrontZOffset_um))
+   {
+      theWavefront->SetAberrationCoefficients(theAberrationCoeff);
+      Memo1->Lines->Add("Updated Aberrated Wavefront.");
+   }
+   else
+   {
+      delete theWavefront;
+      theWavefront = new AberratedWavefront(theWavefrontWidth_mm,
+                                            theWavefrontArrayDimension,
+                                            theWavefrontROIDimension_mm,
+                                            theWavefrontPupilRadius_mm,
+                                            theWavefrontZOffset_um,
+                                            theAberrationCoeff);
+      Memo1->Lines->Add("Created Aberrated Wavefront.");
+   }
    Memo1->Lines->Add(" ");
 
    if (theWavefrontIsBiased)
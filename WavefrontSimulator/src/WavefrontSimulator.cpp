@@ -22,6 +22,14 @@ USEFORM("EditBiasLensDlg.cpp", EditBiasLensDialog);
 USEUNIT("Lens.cpp");
 USEUNIT("ZOffsetZernikePolynomial.cpp");
 USEFORM("WavefrontZOffsetDlg.cpp", WavefrontZOffsetDialog);
+USEUNIT("MultigridPoisson.cpp");
+USEUNIT("DSTPoisson.cpp");
+USEUNIT("PoissonStencil.cpp");
+USEUNIT("Grid2d.cpp");
+USEUNIT("NewtonKrylov.cpp");
+USEUNIT("InfluenceMatrix.cpp");
+USEUNIT("ReducedMirrorModel.cpp");
+USEUNIT("ZernikeBasis.cpp");
 //---------------------------------------------------------------------------
 WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
 {
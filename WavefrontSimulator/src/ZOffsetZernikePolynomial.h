@@ -20,6 +20,7 @@ class ZOffsetZernikePolynomial : public ZernikePolynomial
 
 
   void   SetOffset(double inOffset_um) {ZOffset_um = inOffset_um;}
+  double GetOffset(void) { return ZOffset_um; }
 
   double Evaluate(const double inR);
   double Evaluate(const double inR, const double inTheta);
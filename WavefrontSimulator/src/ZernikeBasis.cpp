@@ -0,0 +1,434 @@
+//---------------------------------------------------------------------------
+// ZernikeBasis.cpp                                   C++ class
+//
+// Evaluates all Zernike polynomials up to a given radial order at once,
+// by radial and angular recurrences.  See ZernikeBasis.h
+//
+// called by:  AberratedWavefront::ConstructZernikeExpansion()
+//             AberratedWavefront::BuildBasisImages()
+//---------------------------------------------------------------------------
+#include <math.h>
+#include <stdlib.h>
+
+#include "ZernikeBasis.h"
+#include "ZernikePolynomial.h"
+#include "NumRecipes.h"
+
+
+
+//---------------------------------------------------------------------------
+// ZernikeBasis()
+//
+// Basis of all Zernike polynomials with radial order 0...inMaxRadialOrder,
+// ie. Index 0...(n_max+1)(n_max+2)/2 - 1.  inMaxRadialOrder = 10 gives
+// the 66 polynomials of AberratedWavefront.
+//
+// called by:  AberratedWavefront::ConstructZernikeExpansion()
+//             AberratedWavefront::BuildBasisImages()
+//---------------------------------------------------------------------------
+ZernikeBasis::ZernikeBasis(int inMaxRadialOrder)
+{
+   int theN, theM, theJ;
+
+   if (inMaxRadialOrder < 0)
+      nrerror("ZernikeBasis:  negative radial order");
+
+   MaxRadialOrder = inMaxRadialOrder;
+   NumModes = (MaxRadialOrder+1)*(MaxRadialOrder+2)/2;
+
+   // OSA normalization, as ZernikePolynomial::SetIndex()
+   Normalization = new double[NumModes];
+   theJ = 0;
+   for (theN=0;theN<=MaxRadialOrder;theN++)
+   {
+      for (theM=-theN;theM<=theN;theM+=2)
+      {
+         if (theM == 0)
+            Normalization[theJ] = sqrt( (double)(theN+1) );
+         else
+            Normalization[theJ] = sqrt( 2.0*(theN+1) );
+         theJ++;
+      }
+   }
+
+   CosTheta    = new double[ZERNIKE_BASIS_BLOCK];
+   SinTheta    = new double[ZERNIKE_BASIS_BLOCK];
+   Cos         = new double[(MaxRadialOrder+1)*ZERNIKE_BASIS_BLOCK];
+   Sin         = new double[(MaxRadialOrder+1)*ZERNIKE_BASIS_BLOCK];
+   Radial      = new double[3*(MaxRadialOrder+1)*ZERNIKE_BASIS_BLOCK];
+   RadialSlope = new double[3*(MaxRadialOrder+1)*ZERNIKE_BASIS_BLOCK];
+}
+
+
+
+ZernikeBasis::~ZernikeBasis()
+{
+   delete [] Normalization;
+   delete [] CosTheta;
+   delete [] SinTheta;
+   delete [] Cos;
+   delete [] Sin;
+   delete [] Radial;
+   delete [] RadialSlope;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Evaluate()
+//
+// All polynomials, and optionally dZ/dr and dZ/dtheta, at the point
+// (inX, inY), in units of the pupil radius.  outZ[j], j = 0...NumModes-1.
+//
+// called by:  not called within the application
+//---------------------------------------------------------------------------
+void ZernikeBasis::Evaluate(double  inX,
+                            double  inY,
+                            double *outZ,
+                            double *outdZdR,
+                            double *outdZdTheta)
+{
+   EvaluateBlock(1, &inX, &inY, outZ, 1, outdZdR, outdZdTheta);
+}
+
+
+
+//---------------------------------------------------------------------------
+// Evaluate()
+//
+// All polynomials at inNumPoints points (inX[p], inY[p]):  the value of
+// Z_j at point p goes to outZ[j*inStride + p], inStride >= inNumPoints.
+// Likewise dZ/dr and dZ/dtheta, if outdZdR, outdZdTheta are given.
+//
+// called by:  AberratedWavefront::ConstructZernikeExpansion()
+//             AberratedWavefront::BuildBasisImages()
+//---------------------------------------------------------------------------
+void ZernikeBasis::Evaluate(int           inNumPoints,
+                            const double *inX,
+                            const double *inY,
+                            double       *outZ,
+                            int           inStride,
+                            double       *outdZdR,
+                            double       *outdZdTheta)
+{
+   int theFirst, theCount;
+
+   for (theFirst=0;theFirst<inNumPoints;theFirst+=ZERNIKE_BASIS_BLOCK)
+   {
+      theCount = inNumPoints - theFirst;
+      if (theCount > ZERNIKE_BASIS_BLOCK) theCount = ZERNIKE_BASIS_BLOCK;
+
+      EvaluateBlock(theCount, inX + theFirst, inY + theFirst,
+                    outZ + theFirst, inStride,
+                    outdZdR     ? outdZdR + theFirst     : 0,
+                    outdZdTheta ? outdZdTheta + theFirst : 0);
+   }
+}
+
+
+
+//---------------------------------------------------------------------------
+// TestEvaluate()
+//
+// Checks Evaluate() against ZernikePolynomial::Evaluate() and
+// RadialDerivative(), at the points of an inNumPoints x inNumPoints grid
+// over [-1,1] x [-1,1] that lie within the pupil, evaluated one grid row
+// at a time as AberratedWavefront does.  RadialDerivative() leaves out
+// the sign of Evaluate() for m < 0, which is put back here.  dZ/dtheta
+// has no counterpart in ZernikePolynomial, and is not checked.
+//
+// return value:   the largest difference of Z or dZ/dr over all points
+//                 and polynomials (the polynomials are of order 1), or
+//                 -1 if MaxRadialOrder is above the MAXPOLYNOMIALDEGREE
+//                 of ZernikePolynomial.
+//
+// called by:  not called within the application (diagnostic)
+//---------------------------------------------------------------------------
+double ZernikeBasis::TestEvaluate(int inNumPoints)
+{
+   ZernikePolynomial *thePolynomial;
+   double *theX, *theY;
+   double *theZ, *thedZdR, *thedZdTheta;
+   double  theR, theTheta, theSign;
+   double  theMaxDifference = 0;
+   int     theNumInPupil;
+
+   if (MaxRadialOrder > MAXPOLYNOMIALDEGREE || inNumPoints < 2) return -1.0;
+
+   thePolynomial = new ZernikePolynomial[NumModes];
+   for (int j=0;j<NumModes;j++)
+   {
+      thePolynomial[j].SetIndex(j);
+   }
+
+   theX        = new double[inNumPoints];
+   theY        = new double[inNumPoints];
+   theZ        = new double[NumModes*inNumPoints];
+   thedZdR     = new double[NumModes*inNumPoints];
+   thedZdTheta = new double[NumModes*inNumPoints];
+
+   for (int i=0;i<inNumPoints;i++)
+   {
+      theNumInPupil = 0;
+      for (int k=0;k<inNumPoints;k++)
+      {
+         theX[theNumInPupil] = -1 + 2.0*i/(inNumPoints-1);
+         theY[theNumInPupil] = -1 + 2.0*k/(inNumPoints-1);
+         if ( theX[theNumInPupil]*theX[theNumInPupil] +
+              theY[theNumInPupil]*theY[theNumInPupil] <= 1 ) theNumInPupil++;
+      }
+
+      Evaluate(theNumInPupil, theX, theY, theZ, inNumPoints,
+               thedZdR, thedZdTheta);
+
+      for (int p=0;p<theNumInPupil;p++)
+      {
+         theR = sqrt( theX[p]*theX[p] + theY[p]*theY[p] );
+         theTheta = (theR == 0) ? 0 : atan2(theY[p],theX[p]);
+
+         for (int j=0;j<NumModes;j++)
+         {
+            theSign = (thePolynomial[j].GetAzimuthalFrequency() < 0) ? -1 : 1;
+
+            if ( fabs( theZ[j*inNumPoints+p] -
+                       thePolynomial[j].Evaluate(theR,theTheta) ) >
+                 theMaxDifference )
+            {
+               theMaxDifference = fabs( theZ[j*inNumPoints+p] -
+                                  thePolynomial[j].Evaluate(theR,theTheta) );
+            }
+            if ( fabs( thedZdR[j*inNumPoints+p] -
+                       theSign*thePolynomial[j].RadialDerivative(theR,theTheta) ) >
+                 theMaxDifference )
+            {
+               theMaxDifference = fabs( thedZdR[j*inNumPoints+p] -
+                     theSign*thePolynomial[j].RadialDerivative(theR,theTheta) );
+            }
+         }
+      }
+   }
+
+   delete [] thedZdTheta;
+   delete [] thedZdR;
+   delete [] theZ;
+   delete [] theY;
+   delete [] theX;
+   delete [] thePolynomial;
+
+   return theMaxDifference;
+}
+
+
+
+//---------------------------------------------------------------------------
+// EvaluateBlock()
+//
+// Evaluate() for at most ZERNIKE_BASIS_BLOCK points.  The radial
+// polynomials of order n are computed from those of order n-1 and n-2,
+// kept in the three cyclic rows of Radial[] (RadialSlope[] for the
+// derivatives), and the polynomials of order n written out before going
+// on to order n+1.
+//
+// called by:  Evaluate()
+//---------------------------------------------------------------------------
+void ZernikeBasis::EvaluateBlock(int           inNumPoints,
+                                 const double *inX,
+                                 const double *inY,
+                                 double       *outZ,
+                                 int           inStride,
+                                 double       *outdZdR,
+                                 double       *outdZdTheta)
+{
+   const int B     = ZERNIKE_BASIS_BLOCK;
+   const int theNP = inNumPoints;
+   const int theRowSize = (MaxRadialOrder+1)*B;
+
+   bool   theSlopes = (outdZdR != 0);
+
+   double theRadius[ZERNIKE_BASIS_BLOCK];
+   double theR2;
+
+   double *c1 = CosTheta;
+   double *s1 = SinTheta;
+   double *theCm, *theCm1, *theCm2;
+   double *theSm, *theSm1, *theSm2;
+
+   double *theRn, *theRn1, *theRn2;     // R^m_n, R^m_(n-1), R^m_(n-2)
+   double *theSn, *theSn1, *theSn2;     // slopes of same
+   double *theR, *theA, *theB, *theC;
+   double *theS, *theSA, *theSB, *theSC;
+
+   double *theZ, *thedR, *thedT;
+   double *theAng;
+   double  theNorm;
+
+   int    theN, theM, theAbsM, theJ, p;
+
+
+   // radius, cos(theta), sin(theta).  theta = 0 at the origin.
+   for (p=0;p<theNP;p++)
+   {
+      theR2 = inX[p]*inX[p] + inY[p]*inY[p];
+      theRadius[p] = sqrt(theR2);
+      if (theR2 > 0)
+      {
+         c1[p] = inX[p]/theRadius[p];
+         s1[p] = inY[p]/theRadius[p];
+      }
+      else
+      {
+         c1[p] = 1;
+         s1[p] = 0;
+      }
+   }
+
+   // cos(m theta), sin(m theta) by Chebyshev recurrence
+   for (p=0;p<theNP;p++)
+   {
+      Cos[p] = 1;
+      Sin[p] = 0;
+   }
+   for (theM=1;theM<=MaxRadialOrder;theM++)
+   {
+      theCm  = Cos + theM*B;
+      theSm  = Sin + theM*B;
+      theCm1 = theCm - B;
+      theSm1 = theSm - B;
+      if (theM == 1)
+      {
+         for (p=0;p<theNP;p++)
+         {
+            theCm[p] = c1[p];
+            theSm[p] = s1[p];
+         }
+      }
+      else
+      {
+         theCm2 = theCm1 - B;
+         theSm2 = theSm1 - B;
+         for (p=0;p<theNP;p++)
+         {
+            theCm[p] = 2*c1[p]*theCm1[p] - theCm2[p];
+            theSm[p] = 2*c1[p]*theSm1[p] - theSm2[p];
+         }
+      }
+   }
+
+
+   theJ = 0;
+   for (theN=0;theN<=MaxRadialOrder;theN++)
+   {
+      theRn  = Radial + (theN%3)*theRowSize;
+      theRn1 = Radial + ((theN+2)%3)*theRowSize;
+      theRn2 = Radial + ((theN+1)%3)*theRowSize;
+      theSn  = RadialSlope + (theN%3)*theRowSize;
+      theSn1 = RadialSlope + ((theN+2)%3)*theRowSize;
+      theSn2 = RadialSlope + ((theN+1)%3)*theRowSize;
+
+      // R^n_n = r^n
+      theR = theRn + theN*B;
+      theS = theSn + theN*B;
+      if (theN == 0)
+      {
+         for (p=0;p<theNP;p++)
+         {
+            theR[p] = 1;
+            theS[p] = 0;
+         }
+      }
+      else
+      {
+         theA  = theRn1 + (theN-1)*B;
+         theSA = theSn1 + (theN-1)*B;
+         for (p=0;p<theNP;p++)
+         {
+            theR[p] = theRadius[p]*theA[p];
+         }
+         if (theSlopes)
+         {
+            for (p=0;p<theNP;p++)
+            {
+               theS[p] = theA[p] + theRadius[p]*theSA[p];
+            }
+         }
+      }
+
+      // R^m_n = r (R^|m-1|_(n-1) + R^(m+1)_(n-1)) - R^m_(n-2),  m < n
+      for (theM=theN-2;theM>=0;theM-=2)
+      {
+         theR  = theRn  + theM*B;
+         theA  = theRn1 + abs(theM-1)*B;
+         theB  = theRn1 + (theM+1)*B;
+         theC  = theRn2 + theM*B;
+         for (p=0;p<theNP;p++)
+         {
+            theR[p] = theRadius[p]*(theA[p] + theB[p]) - theC[p];
+         }
+         if (theSlopes)
+         {
+            theS  = theSn  + theM*B;
+            theSA = theSn1 + abs(theM-1)*B;
+            theSB = theSn1 + (theM+1)*B;
+            theSC = theSn2 + theM*B;
+            for (p=0;p<theNP;p++)
+            {
+               theS[p] = theA[p] + theB[p] +
+                         theRadius[p]*(theSA[p] + theSB[p]) - theSC[p];
+            }
+         }
+      }
+
+      // the polynomials of radial order n:  m = -n, -n+2, ..., n
+      for (theM=-theN;theM<=theN;theM+=2)
+      {
+         theAbsM = abs(theM);
+         theNorm = Normalization[theJ];
+         theR    = theRn + theAbsM*B;
+         theS    = theSn + theAbsM*B;
+         theZ    = outZ + theJ*inStride;
+
+         if (theM == 0)
+         {
+            for (p=0;p<theNP;p++)
+               theZ[p] = theNorm*theR[p];
+            if (outdZdR)
+            {
+               thedR = outdZdR + theJ*inStride;
+               for (p=0;p<theNP;p++)
+                  thedR[p] = theNorm*theS[p];
+            }
+            if (outdZdTheta)
+            {
+               thedT = outdZdTheta + theJ*inStride;
+               for (p=0;p<theNP;p++)
+                  thedT[p] = 0;
+            }
+         }
+         else
+         {
+            // cos(m theta) for m > 0, sin(|m| theta) for m < 0
+            theAng = (theM > 0 ? Cos : Sin) + theAbsM*B;
+            for (p=0;p<theNP;p++)
+               theZ[p] = theNorm*theR[p]*theAng[p];
+            if (outdZdR)
+            {
+               thedR = outdZdR + theJ*inStride;
+               for (p=0;p<theNP;p++)
+                  thedR[p] = theNorm*theS[p]*theAng[p];
+            }
+            if (outdZdTheta)
+            {
+               // d/dtheta cos(m theta) = -m sin(m theta),
+               // d/dtheta sin(|m| theta) = |m| cos(|m| theta)
+               thedT  = outdZdTheta + theJ*inStride;
+               theAng = (theM > 0 ? Sin : Cos) + theAbsM*B;
+               theNorm *= (theM > 0 ? -theAbsM : theAbsM);
+               for (p=0;p<theNP;p++)
+                  thedT[p] = theNorm*theR[p]*theAng[p];
+            }
+         }
+         theJ++;
+      }
+   }
+
+}
@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------
+// ZernikeBasis.h                                     C++ Header file
+//
+// Class definition for the ZernikeBasis class.  Evaluates all Zernike
+// polynomials Z_0 ... Z_(NumModes-1) of radial order n <= MaxRadialOrder
+// at once, at one point or at a vector of points, with the Index,
+// Normalization and sign conventions of ZernikePolynomial (Thibos et al.):
+//
+//    Z_j(r,theta) = Normalization(j) * R^|m|_n(r) * sin( |m| theta )   m < 0
+//    Z_j(r,theta) = Normalization(j) * R^m_n(r)   * cos( m theta )     m >= 0
+//
+// ZernikePolynomial::Evaluate() sums pow(r, power) over the radial terms
+// and calls cos() or sin() for every polynomial.  Here, each point costs
+// one sqrt and a fixed number of multiply-adds per polynomial:
+//
+//   - the radial polynomials by the three-term recurrence
+//
+//       R^n_n(r) = r R^(n-1)_(n-1)(r)
+//       R^m_n(r) = r [ R^|m-1|_(n-1)(r) + R^(m+1)_(n-1)(r) ] - R^m_(n-2)(r),
+//
+//     which is stable on 0 <= r <= 1 (no cancellation of large terms, as
+//     in the explicit sum at high order);
+//
+//   - the angular factors by the Chebyshev recurrence
+//
+//       cos((m+1) theta) = 2 cos(theta) cos(m theta) - cos((m-1) theta),
+//
+//     the same for sin, starting from cos(theta) = x/r, sin(theta) = y/r.
+//
+// Points are given in Cartesian coordinates, in units of the pupil radius,
+// so that no atan2() is needed;  theta = 0 at the origin, as
+// Wavefront::Theta_rad().  Points are processed in blocks of
+// ZERNIKE_BASIS_BLOCK, each recurrence step a loop over the block, which
+// the compiler can vectorize.
+//
+// Gradients are optional and given in polar form, dZ/dr and dZ/dtheta,
+// both of Z_j as above, sign included.
+//
+// The work arrays make one ZernikeBasis usable by one thread at a time.
+//---------------------------------------------------------------------------
+#ifndef ZernikeBasisH
+#define ZernikeBasisH
+
+
+#define ZERNIKE_BASIS_BLOCK   64       // points per recurrence pass
+
+
+class ZernikeBasis
+{
+   private:
+
+       int       MaxRadialOrder;        // n_max
+       int       NumModes;              // (n_max+1)(n_max+2)/2
+
+       double   *Normalization;         // 0...NumModes-1
+
+       // work, ZERNIKE_BASIS_BLOCK values per row
+       double   *CosTheta, *SinTheta;   // cos(theta), sin(theta)
+       double   *Cos, *Sin;             // cos(m theta), sin(m theta), m=0...n_max
+       double   *Radial;                // R^m_n for n, n-1, n-2 (cyclic)
+       double   *RadialSlope;           // dR^m_n/dr, the same
+
+       void   EvaluateBlock(int           inNumPoints,
+                            const double *inX,
+                            const double *inY,
+                            double       *outZ,
+                            int           inStride,
+                            double       *outdZdR,
+                            double       *outdZdTheta);
+
+   public:
+
+       ZernikeBasis(int inMaxRadialOrder);
+       ~ZernikeBasis();
+
+       // all polynomials at one point:  outZ[j], j = 0...NumModes-1
+       void   Evaluate(double  inX,
+                       double  inY,
+                       double *outZ,
+                       double *outdZdR     = 0,
+                       double *outdZdTheta = 0);
+
+       // all polynomials at inNumPoints points:
+       // outZ[j*inStride + p], p = 0...inNumPoints-1
+       void   Evaluate(int           inNumPoints,
+                       const double *inX,
+                       const double *inY,
+                       double       *outZ,
+                       int           inStride,
+                       double       *outdZdR     = 0,
+                       double       *outdZdTheta = 0);
+
+       double TestEvaluate(int inNumPoints);
+
+       int    Modes()            { return NumModes; }
+       int    RadialOrder()      { return MaxRadialOrder; }
+
+};
+
+
+#endif